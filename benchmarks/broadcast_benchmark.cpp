@@ -0,0 +1,127 @@
+// Broadcast fan-out: per-recipient copies vs one shared packet
+//
+// Usage: broadcast_benchmark [recipients] [messageBytes] [rounds]
+//
+// Each round one message goes to every recipient, each with its own
+// cipher stream, and ends up framed and encrypted in that recipient's send
+// buffer. Two modes:
+//   copy   - the previous path: copy the message into each recipient's
+//            queue, encrypt the copy in place, then frame it
+//   shared - serialize once into a SharedPacket that every queue
+//            references; the cipher reads it and writes into the buffer
+// Both must produce the same bytes on the wire.
+
+#include "network/PacketEncryption.h"
+#include "network/SharedPacket.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+using namespace clonemine;
+
+namespace {
+    constexpr size_t FRAME_HEADER_SIZE = 4;
+
+    struct Recipient {
+        std::unique_ptr<network::PacketEncryption> encryption;
+        std::vector<std::vector<uint8_t>> copies;
+        std::vector<network::SharedPacket> packets;
+        std::vector<uint8_t> sendBuffer;
+    };
+
+    void writeHeader(uint8_t* out, size_t size) {
+        out[0] = static_cast<uint8_t>(size & 0xFF);
+        out[1] = static_cast<uint8_t>((size >> 8) & 0xFF);
+        out[2] = static_cast<uint8_t>((size >> 16) & 0xFF);
+        out[3] = static_cast<uint8_t>((size >> 24) & 0xFF);
+    }
+
+    std::vector<Recipient> makeRecipients(int count) {
+        std::vector<Recipient> recipients(count);
+        for (auto& recipient : recipients) {
+            recipient.encryption = std::make_unique<network::PacketEncryption>("CloneMineSharedSecret2024");
+        }
+        return recipients;
+    }
+
+    void serveCopies(std::vector<Recipient>& recipients, const std::vector<uint8_t>& message) {
+        for (auto& recipient : recipients) {
+            recipient.copies.push_back(message);
+        }
+        for (auto& recipient : recipients) {
+            for (auto& body : recipient.copies) {
+                recipient.encryption->encrypt(body);
+                recipient.sendBuffer.resize(FRAME_HEADER_SIZE + body.size());
+                writeHeader(recipient.sendBuffer.data(), body.size());
+                std::copy(body.begin(), body.end(), recipient.sendBuffer.begin() + FRAME_HEADER_SIZE);
+            }
+            recipient.copies.clear();
+        }
+    }
+
+    void serveShared(std::vector<Recipient>& recipients, const std::vector<uint8_t>& message) {
+        auto packet = network::SharedPacket::create(message);
+        for (auto& recipient : recipients) {
+            recipient.packets.push_back(packet);
+        }
+        for (auto& recipient : recipients) {
+            for (const auto& queued : recipient.packets) {
+                recipient.sendBuffer.resize(FRAME_HEADER_SIZE + queued.size());
+                writeHeader(recipient.sendBuffer.data(), queued.size());
+                recipient.encryption->encrypt(queued.data(), recipient.sendBuffer.data() + FRAME_HEADER_SIZE,
+                                              queued.size());
+            }
+            recipient.packets.clear();
+        }
+    }
+
+    template <typename Serve>
+    double run(std::vector<Recipient>& recipients, const std::vector<uint8_t>& message, int rounds, Serve serve) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < rounds; ++i) {
+            serve(recipients, message);
+        }
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 1000;
+    int messageBytes = argc > 2 ? std::atoi(argv[2]) : 256;
+    int rounds = argc > 3 ? std::atoi(argv[3]) : 2000;
+    if (count <= 0 || messageBytes <= 0 || rounds <= 0) {
+        std::cerr << "Usage: broadcast_benchmark [recipients] [messageBytes] [rounds]" << std::endl;
+        return 1;
+    }
+
+    std::vector<uint8_t> message(messageBytes);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    // Same wire bytes from both paths, round after round
+    auto copyRecipients = makeRecipients(count);
+    auto sharedRecipients = makeRecipients(count);
+    uint64_t mismatches = 0;
+    for (int i = 0; i < 3; ++i) {
+        serveCopies(copyRecipients, message);
+        serveShared(sharedRecipients, message);
+        for (int r = 0; r < count; ++r) {
+            mismatches += copyRecipients[r].sendBuffer != sharedRecipients[r].sendBuffer;
+        }
+    }
+
+    double copyUs = run(copyRecipients, message, rounds, serveCopies);
+    double sharedUs = run(sharedRecipients, message, rounds, serveShared);
+
+    std::cout << count << " recipients, " << messageBytes << "-byte message, " << rounds << " rounds" << std::endl;
+    std::cout << std::fixed << std::setprecision(1)
+              << "copy    " << std::setw(10) << copyUs << " us/broadcast" << std::endl
+              << "shared  " << std::setw(10) << sharedUs << " us/broadcast"
+              << std::setprecision(2) << std::setw(8) << copyUs / sharedUs << "x" << std::endl
+              << mismatches << " send buffers differing between the two" << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
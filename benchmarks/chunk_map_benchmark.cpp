@@ -0,0 +1,80 @@
+// Chunk map contention benchmark
+//
+// Usage: chunk_map_benchmark [readers] [workers] [seconds]
+//
+// Reader threads issue random getBlock() calls around the player while the
+// generation pool fills and publishes chunks, and the main thread walks the
+// player forward so chunks keep loading and unloading underneath the readers.
+
+#include "world/ChunkManager.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace clonemine;
+
+int main(int argc, char* argv[]) {
+    unsigned readers = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 4;
+    unsigned workers = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 2;
+    int seconds = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    ChunkManager chunkManager(workers);
+    std::atomic<bool> running{true};
+    std::atomic<int> playerX{0};
+    std::atomic<uint64_t> totalReads{0};
+    std::atomic<uint64_t> totalHits{0};
+
+    std::vector<std::thread> readerThreads;
+    for (unsigned i = 0; i < readers; ++i) {
+        readerThreads.emplace_back([&, i]() {
+            std::mt19937 rng(1234 + i);
+            std::uniform_int_distribution<int> horizontal(-16 * CHUNK_SIZE_X, 16 * CHUNK_SIZE_X);
+            std::uniform_int_distribution<int> vertical(0, CHUNK_SIZE_Y - 1);
+
+            uint64_t reads = 0;
+            uint64_t hits = 0;
+            while (running.load(std::memory_order_relaxed)) {
+                glm::ivec3 pos(playerX.load(std::memory_order_relaxed) + horizontal(rng),
+                               vertical(rng), horizontal(rng));
+                if (chunkManager.getBlock(pos)) {
+                    hits++;
+                }
+                reads++;
+            }
+            totalReads += reads;
+            totalHits += hits;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    auto end = start + std::chrono::seconds(seconds);
+    while (std::chrono::steady_clock::now() < end) {
+        // Walk one block per tick (~20 blocks/s) to keep chunks streaming
+        int x = playerX.fetch_add(1) + 1;
+        chunkManager.update(glm::vec3(static_cast<float>(x), 64.0f, 0.0f), 0.05f);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    running = false;
+    for (auto& thread : readerThreads) {
+        thread.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ChunkGenerationStats gen = chunkManager.getGenerationStats();
+
+    std::cout << "readers=" << readers << " workers=" << chunkManager.getWorkerCount()
+              << " seconds=" << elapsed << std::endl;
+    std::cout << "  reads/sec:            " << static_cast<uint64_t>(totalReads / elapsed)
+              << " (" << (totalReads ? 100.0 * totalHits / totalReads : 0.0) << "% loaded)" << std::endl;
+    std::cout << "  chunks generated/sec: " << gen.generatedCount / elapsed << std::endl;
+    std::cout << "  avg generation ms:    " << gen.averageGenerationMs << std::endl;
+    std::cout << "  avg queue wait ms:    " << gen.averageQueueWaitMs << std::endl;
+    std::cout << "  loaded chunks:        " << chunkManager.getChunkCount() << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Particle effect checks and CPU simulation cost (no graphics device needed)
+//
+// Usage: effect_benchmark [frames]
+//
+// Plays a fixed script of spells, explosions, rings and auras through the
+// CPU path of EffectRenderer at a fixed time step.
+// Checks, each failing the run:
+//   repeat - two renderers given the same seed produce the same particles,
+//            byte for byte, after every frame
+//   reseed - reseeding a renderer once its particles have died replays
+//            the script exactly
+//   seed   - a different seed changes the particles
+// Only the CPU path is covered: the GPU path uses GLSL cos/sin and its own
+// ordering, so it is not expected to match these bytes.
+// Then the time per updateParticles() call at the script's load.
+
+#include "rendering/EffectRenderer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace clonemine;
+
+namespace {
+    constexpr float FRAME_TIME = 1.0f / 60.0f;
+    // Longer than any effect's lifetime, so the renderer ends up empty
+    constexpr int DRAIN_FRAMES = 240;
+
+    // Spawn this frame's share of the script
+    void playFrame(EffectRenderer& effects, int frame) {
+        const float t = static_cast<float>(frame) * FRAME_TIME;
+        const glm::vec3 caster(8.0f * std::cos(t), 70.0f, 8.0f * std::sin(t));
+        const glm::vec3 target(0.0f, 68.0f, 0.0f);
+
+        if (frame % 3 == 0) effects.spawnFireball(caster, target);
+        if (frame % 5 == 0) effects.spawnFrostbolt(caster + glm::vec3(0.0f, 1.0f, 0.0f), target);
+        if (frame % 20 == 0) effects.spawnExplosion(target, 4.0f);
+        if (frame % 30 == 0) effects.spawnHealingEffect(caster);
+        effects.renderGroundCircle(target, 3.0f, glm::vec4(0.9f, 0.2f, 0.1f, 0.6f));
+        effects.renderAura(caster, static_cast<ElementalDamageType>(frame % 13));
+    }
+
+    bool sameParticles(const std::vector<Particle>& a, const std::vector<Particle>& b) {
+        return a.size() == b.size() && (a.empty() || std::memcmp(a.data(), b.data(), a.size() * sizeof(Particle)) == 0);
+    }
+
+    // Every frame's particles for one run of the script
+    std::vector<std::vector<Particle>> record(EffectRenderer& effects, uint32_t seed, int frames) {
+        std::vector<std::vector<Particle>> history;
+        history.reserve(frames);
+        effects.setSeed(seed);
+        for (int frame = 0; frame < frames; ++frame) {
+            playFrame(effects, frame);
+            effects.updateParticles(FRAME_TIME);
+            history.push_back(effects.getParticles());
+        }
+        return history;
+    }
+
+    // Frames whose particles differ between the two runs
+    int countMismatches(const std::vector<std::vector<Particle>>& a, const std::vector<std::vector<Particle>>& b) {
+        int mismatches = 0;
+        for (size_t frame = 0; frame < a.size(); ++frame) {
+            if (!sameParticles(a[frame], b[frame])) {
+                ++mismatches;
+            }
+        }
+        return mismatches;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 600;
+    if (frames <= 0) {
+        std::cerr << "Usage: effect_benchmark [frames]" << std::endl;
+        return 1;
+    }
+
+    constexpr uint32_t SEED = 0x5eed1234u;
+    bool failed = false;
+
+    EffectRenderer first;
+    EffectRenderer second;
+    auto firstRun = record(first, SEED, frames);
+    auto secondRun = record(second, SEED, frames);
+    int repeatMismatches = countMismatches(firstRun, secondRun);
+
+    for (int i = 0; i < DRAIN_FRAMES; ++i) {
+        first.updateParticles(FRAME_TIME);
+    }
+    int reseedMismatches = -1;
+    if (first.getParticles().empty() && first.getPendingEmitterCount() == 0) {
+        reseedMismatches = countMismatches(firstRun, record(first, SEED, frames));
+    }
+
+    EffectRenderer other;
+    int seedMismatches = countMismatches(firstRun, record(other, SEED + 1, frames));
+
+    size_t peak = 0;
+    for (const auto& particles : firstRun) {
+        peak = std::max(peak, particles.size());
+    }
+    std::cout << frames << " frames, up to " << peak << " particles: " << repeatMismatches
+              << " frames differing between runs with the same seed, " << reseedMismatches
+              << " after reseeding, " << seedMismatches << " differing with another seed" << std::endl;
+
+    if (repeatMismatches != 0) {
+        std::cerr << "FAIL: the same seed gave different particles" << std::endl;
+        failed = true;
+    }
+    if (reseedMismatches != 0) {
+        std::cerr << "FAIL: reseeding did not replay the particles" << std::endl;
+        failed = true;
+    }
+    if (seedMismatches == 0) {
+        std::cerr << "FAIL: the seed does not affect the particles" << std::endl;
+        failed = true;
+    }
+
+    EffectRenderer timed;
+    timed.setSeed(SEED);
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; ++frame) {
+        playFrame(timed, frame);
+        timed.updateParticles(FRAME_TIME);
+    }
+    double elapsedUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    std::cout << std::fixed << std::setprecision(2) << "CPU simulation: " << elapsedUs / frames
+              << " us per frame" << std::endl;
+
+    return failed ? 1 : 0;
+}
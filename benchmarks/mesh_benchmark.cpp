@@ -0,0 +1,319 @@
+// Chunk meshing benchmark (no graphics device needed)
+//
+// Usage: mesh_benchmark [chunks]
+//
+// Generates terrain chunks and meshes each one with the naive and greedy
+// meshers in the packed and full vertex formats, reporting vertices,
+// indices, bytes and build time per chunk. Also checks that both meshers
+// cover the same face area and that packed vertices decode to the full ones.
+// Chunks form a grid, so the neighbour-aware pass culls faces against the
+// adjacent chunks' borders and times border-only remeshes against full ones.
+// Finally each level-of-detail mesh is built from downsampled blocks, with
+// its neighbours downsampled to the same level.
+
+#include "rendering/ChunkMesher.h"
+#include "world/TerrainGenerator.h"
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace clonemine;
+
+namespace {
+    constexpr int SIZE = ChunkMesher::CHUNK_SIZE;
+    constexpr int HEIGHT = ChunkMesher::CHUNK_HEIGHT;
+    constexpr int WATER_LEVEL = 60;
+
+    BlockType toRenderBlock(uint8_t code, int y) {
+        switch (code) {
+            case TerrainBlock::AIR: return y < WATER_LEVEL ? BlockType::WATER : BlockType::AIR;
+            case TerrainBlock::GRASS: return BlockType::GRASS;
+            case TerrainBlock::DIRT: return BlockType::DIRT;
+            case TerrainBlock::SAND: return BlockType::SAND;
+            case TerrainBlock::OBSIDIAN: return BlockType::OBSIDIAN;
+            case TerrainBlock::BEDROCK: return BlockType::OBSIDIAN;
+            case TerrainBlock::DIAMOND_ORE: return BlockType::DIAMOND_ORE;
+            case TerrainBlock::GOLD_ORE: return BlockType::GOLD_ORE;
+            case TerrainBlock::SNOW: return BlockType::ICE;
+            default: return BlockType::STONE;
+        }
+    }
+
+    struct TestChunk {
+        glm::ivec3 position;
+        std::vector<BlockType> blocks;
+        uint16_t sectionMask = 0;
+        std::array<ChunkBorderSlice, ChunkMesher::HORIZONTAL_FACES> edges{};
+        ChunkNeighborBorders neighbors;
+    };
+
+    TestChunk generateChunk(const TerrainGenerator& generator, int chunkX, int chunkZ) {
+        TestChunk chunk;
+        chunk.position = glm::ivec3(chunkX, 0, chunkZ);
+        chunk.blocks.resize(SIZE * HEIGHT * SIZE);
+
+        TerrainColumns columns;
+        generator.generateColumns(chunkX, chunkZ, columns);
+        std::array<uint8_t, HEIGHT> column;
+        for (int z = 0; z < SIZE; ++z) {
+            for (int x = 0; x < SIZE; ++x) {
+                column.fill(TerrainBlock::AIR);
+                generator.fillColumn(columns, x, z, column.data());
+                for (int y = 0; y < HEIGHT; ++y) {
+                    BlockType type = toRenderBlock(column[y], y);
+                    chunk.blocks[x + z * SIZE + y * SIZE * SIZE] = type;
+                    if (type != BlockType::AIR) {
+                        chunk.sectionMask |= static_cast<uint16_t>(1u << (y / ChunkMesher::SECTION_HEIGHT));
+                    }
+                }
+            }
+        }
+        for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+            ChunkMesher::extractBorder(chunk.blocks, face, chunk.edges[face]);
+        }
+        return chunk;
+    }
+
+    // Point each chunk at the border slices of its grid neighbours
+    void linkNeighbors(std::vector<TestChunk>& chunks) {
+        const glm::ivec3 offsets[ChunkMesher::HORIZONTAL_FACES] = {{0, 0, 1}, {0, 0, -1}, {-1, 0, 0}, {1, 0, 0}};
+        std::map<std::pair<int, int>, size_t> byPosition;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            byPosition[{chunks[i].position.x, chunks[i].position.z}] = i;
+        }
+        for (TestChunk& chunk : chunks) {
+            for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+                glm::ivec3 pos = chunk.position + offsets[face];
+                auto it = byPosition.find({pos.x, pos.z});
+                if (it != byPosition.end()) {
+                    chunk.neighbors.slices[face] = &chunks[it->second].edges[ChunkMesher::oppositeFace(face)];
+                }
+            }
+        }
+    }
+
+    bool samePackedVertices(const ChunkMeshData& a, const ChunkMeshData& b) {
+        if (a.packedVertices.size() != b.packedVertices.size() || a.indices != b.indices) {
+            return false;
+        }
+        for (size_t i = 0; i < a.packedVertices.size(); ++i) {
+            if (a.packedVertices[i].data != b.packedVertices[i].data ||
+                a.packedVertices[i].texture != b.packedVertices[i].texture) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Face area per (normal, texture, light); must match between meshers
+    using AreaKey = std::tuple<int, int, int, uint32_t, int>;
+
+    void accumulateArea(const std::vector<BlockVertex>& vertices, std::map<AreaKey, double>& area) {
+        for (size_t i = 0; i + 3 < vertices.size(); i += 4) {
+            const BlockVertex& v = vertices[i];
+            AreaKey key{static_cast<int>(v.normal.x), static_cast<int>(v.normal.y), static_cast<int>(v.normal.z),
+                        v.textureIndex, static_cast<int>(std::lround(v.lightLevel * 255.0f))};
+            area[key] += glm::length(vertices[i + 1].position - vertices[i].position) *
+                         glm::length(vertices[i + 2].position - vertices[i + 1].position);
+        }
+    }
+
+    // Packed vertices must decode to exactly the full-format vertices
+    bool packedMatchesFull(const TestChunk& chunk, const ChunkMeshData& packed, const ChunkMeshData& full) {
+        if (packed.packedVertices.size() != full.vertices.size() || packed.indices != full.indices) {
+            return false;
+        }
+        const glm::vec3 origin(chunk.position.x * SIZE, 0.0f, chunk.position.z * SIZE);
+        for (size_t i = 0; i < full.vertices.size(); ++i) {
+            const PackedBlockVertex& p = packed.packedVertices[i];
+            const BlockVertex& f = full.vertices[i];
+            glm::vec3 position = origin + glm::vec3(p.getLocalPosition());
+            glm::vec2 texCoord = p.getTexCoord();
+            if (position.x != f.position.x || position.y != f.position.y || position.z != f.position.z ||
+                texCoord.x != f.texCoord.x || texCoord.y != f.texCoord.y ||
+                p.getTextureIndex() != f.textureIndex || p.getLight() / 255.0f != f.lightLevel) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    struct Result {
+        double vertices = 0;
+        double indices = 0;
+        double vertexBytes = 0;
+        double bytes = 0;
+        double seconds = 0;
+    };
+
+    Result run(ChunkMesher& mesher, MeshingMode mode, VertexFormat format, const std::vector<TestChunk>& chunks,
+               std::map<AreaKey, double>* area, bool useNeighbors = false) {
+        Result result;
+        ChunkMeshData mesh;
+        mesh.format = format;
+        for (const TestChunk& chunk : chunks) {
+            auto start = std::chrono::steady_clock::now();
+            mesher.build(mode, chunk.position, chunk.blocks, chunk.sectionMask, mesh,
+                         useNeighbors ? chunk.neighbors : ChunkNeighborBorders{});
+            result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            result.vertices += static_cast<double>(mesh.getVertexCount());
+            result.indices += static_cast<double>(mesh.indices.size());
+            result.vertexBytes += static_cast<double>(mesh.getVertexBytes());
+            result.bytes += static_cast<double>(mesh.getVertexBytes() + mesh.getIndexBytes());
+            if (area) {
+                accumulateArea(mesh.vertices, *area);
+            }
+        }
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 64;
+    if (count <= 0) {
+        std::cerr << "Usage: mesh_benchmark [chunks]" << std::endl;
+        return 1;
+    }
+
+    TerrainGenerator generator(12345);
+    std::vector<TestChunk> chunks;
+    for (int i = 0; i < count; ++i) {
+        chunks.push_back(generateChunk(generator, i % 16 - 8, i / 16 - 8));
+    }
+    linkNeighbors(chunks);
+
+    ChunkMesher mesher;
+    std::map<AreaKey, double> naiveArea;
+    std::map<AreaKey, double> greedyArea;
+    run(mesher, MeshingMode::Naive, VertexFormat::Full, chunks, &naiveArea);
+    run(mesher, MeshingMode::Greedy, VertexFormat::Full, chunks, &greedyArea);
+    if (naiveArea != greedyArea) {
+        std::cerr << "Greedy mesh does not cover the same faces as the naive mesh" << std::endl;
+        return 1;
+    }
+    std::cout << "Coverage: greedy and naive meshes match over " << count << " chunks" << std::endl;
+
+    ChunkMeshData packed;
+    ChunkMeshData full;
+    full.format = VertexFormat::Full;
+    for (const TestChunk& chunk : chunks) {
+        for (MeshingMode mode : {MeshingMode::Naive, MeshingMode::Greedy}) {
+            mesher.build(mode, chunk.position, chunk.blocks, chunk.sectionMask, packed);
+            mesher.build(mode, chunk.position, chunk.blocks, chunk.sectionMask, full);
+            if (!packedMatchesFull(chunk, packed, full)) {
+                std::cerr << "Packed vertices do not decode to the full format" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "Packed format: decodes to the full format exactly" << std::endl;
+
+    Result baseline = run(mesher, MeshingMode::Naive, VertexFormat::Full, chunks, nullptr);
+    for (MeshingMode mode : {MeshingMode::Naive, MeshingMode::Greedy}) {
+        for (VertexFormat format : {VertexFormat::Full, VertexFormat::Packed}) {
+            Result result = run(mesher, mode, format, chunks, nullptr);
+            std::cout << "  " << getMeshingModeName(mode) << "/" << getVertexFormatName(format) << ": "
+                      << result.vertices / count << " vertices, "
+                      << result.indices / count << " indices, "
+                      << result.vertexBytes / count / 1024.0 << " KB vertices, "
+                      << result.bytes / count / 1024.0 << " KB total, "
+                      << result.seconds / count * 1000.0 << " ms per chunk ("
+                      << result.bytes / baseline.bytes * 100.0 << "% of naive/full bytes)" << std::endl;
+        }
+    }
+
+    // Border parts rebuilt alone must equal those from a full split build
+    std::map<AreaKey, double> naiveCulled;
+    std::map<AreaKey, double> greedyCulled;
+    run(mesher, MeshingMode::Naive, VertexFormat::Full, chunks, &naiveCulled, true);
+    run(mesher, MeshingMode::Greedy, VertexFormat::Full, chunks, &greedyCulled, true);
+    if (naiveCulled != greedyCulled) {
+        std::cerr << "Neighbour-aware greedy and naive meshes cover different faces" << std::endl;
+        return 1;
+    }
+
+    ChunkMeshParts parts;
+    ChunkMeshData border;
+    double fullSeconds = 0.0;
+    double borderSeconds = 0.0;
+    for (const TestChunk& chunk : chunks) {
+        auto start = std::chrono::steady_clock::now();
+        mesher.build(MeshingMode::Greedy, chunk.position, chunk.blocks, chunk.sectionMask, chunk.neighbors, parts);
+        fullSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+            start = std::chrono::steady_clock::now();
+            mesher.buildBorder(MeshingMode::Greedy, chunk.position, face, chunk.edges[face],
+                               chunk.neighbors.slices[face], chunk.sectionMask, border);
+            borderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (!samePackedVertices(border, parts.borders[face])) {
+                std::cerr << "Border-only remesh differs from the full build" << std::endl;
+                return 1;
+            }
+        }
+    }
+    std::cout << "Neighbour culling: border remeshes match full builds" << std::endl;
+
+    for (MeshingMode mode : {MeshingMode::Naive, MeshingMode::Greedy}) {
+        Result isolated = run(mesher, mode, VertexFormat::Packed, chunks, nullptr);
+        Result culled = run(mesher, mode, VertexFormat::Packed, chunks, nullptr, true);
+        std::cout << "  " << getMeshingModeName(mode) << "/packed with neighbours: "
+                  << culled.vertices / count << " vertices per chunk ("
+                  << (1.0 - culled.vertices / isolated.vertices) * 100.0 << "% fewer than isolated)" << std::endl;
+    }
+    std::cout << "  full rebuild " << fullSeconds / count * 1000.0 << " ms, one border remesh "
+              << borderSeconds / (count * ChunkMesher::HORIZONTAL_FACES) * 1000.0 << " ms" << std::endl;
+
+    std::cout << "Level of detail (greedy/packed with neighbours):" << std::endl;
+    Result fullDetail;
+    for (int level = 0; level <= ChunkMesher::MAX_LOD_LEVEL; ++level) {
+        std::vector<TestChunk> lodChunks = chunks;
+        double downsampleSeconds = 0.0;
+        for (size_t i = 0; i < chunks.size(); ++i) {
+            auto start = std::chrono::steady_clock::now();
+            ChunkMesher::downsample(chunks[i].blocks, level, lodChunks[i].blocks);
+            downsampleSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+                ChunkMesher::extractBorder(lodChunks[i].blocks, face, lodChunks[i].edges[face]);
+            }
+        }
+        linkNeighbors(lodChunks);
+
+        Result result;
+        ChunkMeshData mesh;
+        for (const TestChunk& chunk : lodChunks) {
+            auto start = std::chrono::steady_clock::now();
+            mesher.build(MeshingMode::Greedy, chunk.position, chunk.blocks, chunk.sectionMask, chunk.neighbors,
+                         parts, level);
+            result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            parts.assemble(mesh);
+            result.vertices += static_cast<double>(mesh.getVertexCount());
+            result.bytes += static_cast<double>(mesh.getVertexBytes() + mesh.getIndexBytes());
+
+            for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+                mesher.buildBorder(MeshingMode::Greedy, chunk.position, face, chunk.edges[face],
+                                   chunk.neighbors.slices[face], chunk.sectionMask, border, level);
+                if (!samePackedVertices(border, parts.borders[face])) {
+                    std::cerr << "LOD " << level << " border remesh differs from the full build" << std::endl;
+                    return 1;
+                }
+            }
+        }
+        if (level == 0) {
+            fullDetail = result;
+        }
+        std::cout << "  LOD " << level << " (" << (1 << level) << "x): "
+                  << result.vertices / count << " vertices, "
+                  << result.bytes / count / 1024.0 << " KB, "
+                  << (downsampleSeconds + result.seconds) / count * 1000.0 << " ms per chunk, "
+                  << downsampleSeconds / count * 1000.0 << " ms of it downsampling ("
+                  << result.bytes / fullDetail.bytes * 100.0 << "% of full-detail bytes)" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,309 @@
+// Frame submission benchmark for WorldRenderer (no graphics device needed)
+//
+// Usage: render_submit_benchmark [entities] [frames]
+//
+// Scatters a mix of players, monsters, NPCs, projectiles and effects around
+// the camera and measures the CPU cost of submitting one frame:
+//   legacy   - the previous path: per-frame copies of string-carrying
+//              entities into queues, a sqrt distance test per entity and
+//              a log line per rendered entity (written to memory here; the
+//              old code wrote to std::cout, which is slower still)
+//   distance - retained entities and string-free render packets, culled by
+//              range only so the work matches the legacy path
+//   packets  - the same with batched view frustum culling
+//   logged   - the frustum-culled path with the opt-in debug log on
+// Heap allocations per frame are counted through a global operator new.
+
+#include "rendering/WorldRenderer.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::atomic<uint64_t> g_allocations{0};
+}
+
+void* operator new(std::size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+using namespace clonemine;
+
+namespace {
+    // The entity layout before render names were interned
+    struct LegacyEntity {
+        uint32_t id;
+        RenderEntityType type;
+        glm::vec3 position;
+        glm::vec3 rotation;
+        glm::vec3 scale{1.0f, 1.0f, 1.0f};
+        std::string modelName;
+        std::string textureName;
+        float animationTime{0.0f};
+        std::string currentAnimation;
+        bool visible{true};
+        float alpha{1.0f};
+        std::string effectType;
+        float effectDuration{0.0f};
+        float effectTimeRemaining{0.0f};
+        glm::vec3 effectColor{1.0f, 1.0f, 1.0f};
+    };
+
+    struct Spawn {
+        RenderEntityType type;
+        std::string name;
+        glm::vec3 position;
+    };
+
+    const char* MONSTERS[] = {"zombie", "skeleton", "spider", "creeper", "golem"};
+    const char* NPCS[] = {"merchant", "guard", "blacksmith"};
+    const char* PROJECTILES[] = {"arrow", "fire_bolt", "ice_bolt"};
+    const char* SCHOOLS[] = {"fire", "ice", "arcane", "shadow"};
+    const char* ABILITIES[] = {"buff", "debuff", "damage", "heal"};
+
+    std::vector<Spawn> makeSpawns(int count) {
+        std::mt19937 rng(1234);
+        std::uniform_real_distribution<float> horizontal(-150.0f, 150.0f);
+        std::uniform_real_distribution<float> vertical(60.0f, 80.0f);
+        std::uniform_int_distribution<int> kind(0, 99);
+
+        std::vector<Spawn> spawns;
+        spawns.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            Spawn spawn;
+            spawn.position = glm::vec3(horizontal(rng), vertical(rng), horizontal(rng));
+            int k = kind(rng);
+            if (k < 20) {
+                spawn.type = RenderEntityType::PLAYER;
+                spawn.name = "player" + std::to_string(i);
+            } else if (k < 60) {
+                spawn.type = RenderEntityType::MONSTER;
+                spawn.name = MONSTERS[i % 5];
+            } else if (k < 75) {
+                spawn.type = RenderEntityType::NPC;
+                spawn.name = NPCS[i % 3];
+            } else if (k < 90) {
+                spawn.type = RenderEntityType::PROJECTILE;
+                spawn.name = PROJECTILES[i % 3];
+            } else if (k < 95) {
+                spawn.type = RenderEntityType::SPELL_EFFECT;
+                spawn.name = SCHOOLS[i % 4];
+            } else {
+                spawn.type = RenderEntityType::ABILITY_EFFECT;
+                spawn.name = ABILITIES[i % 4];
+            }
+            spawns.push_back(std::move(spawn));
+        }
+        return spawns;
+    }
+
+    LegacyEntity makeLegacy(uint32_t id, const Spawn& spawn) {
+        LegacyEntity entity;
+        entity.id = id;
+        entity.type = spawn.type;
+        entity.position = spawn.position;
+        entity.rotation = glm::vec3(0.0f);
+        entity.modelName = spawn.name;
+        entity.textureName = spawn.name + "_texture";
+        entity.currentAnimation = "idle";
+        entity.effectType = spawn.type == RenderEntityType::PROJECTILE ? spawn.name : std::string();
+        return entity;
+    }
+
+    // Drift every entity a little each frame, as the game loop would
+    glm::vec3 drift(const glm::vec3& position, int frame, uint32_t id) {
+        float t = static_cast<float>(frame) * 0.016f + static_cast<float>(id);
+        return position + glm::vec3(std::sin(t), 0.0f, std::cos(t)) * 0.05f;
+    }
+
+    struct Result {
+        double msPerFrame = 0.0;
+        double allocationsPerFrame = 0.0;
+        size_t rendered = 0;
+    };
+
+    Result runLegacy(const std::vector<Spawn>& spawns, const RenderSettings& settings, const glm::vec3& camera,
+                     int frames) {
+        std::vector<LegacyEntity> entities;
+        for (size_t i = 0; i < spawns.size(); ++i) {
+            entities.push_back(makeLegacy(static_cast<uint32_t>(i), spawns[i]));
+        }
+
+        auto maxDistance = [&settings](RenderEntityType type) {
+            switch (type) {
+                case RenderEntityType::PLAYER: return settings.playerRenderDistance;
+                case RenderEntityType::MONSTER: return settings.monsterRenderDistance;
+                case RenderEntityType::NPC: return settings.npcRenderDistance;
+                case RenderEntityType::PROJECTILE: return settings.projectileRenderDistance;
+                case RenderEntityType::SPELL_EFFECT: return settings.spellRenderDistance;
+                default: return settings.abilityRenderDistance;
+            }
+        };
+
+        std::ostringstream log;
+        std::vector<LegacyEntity> queue;
+        Result result;
+        const uint64_t allocationsBefore = g_allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            log.str({});
+            queue.clear();
+            for (LegacyEntity& entity : entities) {
+                entity.position = drift(entity.position, frame, entity.id);
+                queue.push_back(entity);
+            }
+            for (const LegacyEntity& entity : queue) {
+                glm::vec3 diff = entity.position - camera;
+                float distance = std::sqrt(diff.x * diff.x + diff.y * diff.y + diff.z * diff.z);
+                if (distance > maxDistance(entity.type)) continue;
+                log << "[WorldRenderer] Rendering '" << entity.modelName << "' (" << entity.effectType
+                    << ") at distance " << distance << " units" << std::endl;
+                result.rendered++;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.msPerFrame = seconds * 1000.0 / frames;
+        result.allocationsPerFrame = static_cast<double>(g_allocations.load() - allocationsBefore) / frames;
+        result.rendered /= frames;
+        return result;
+    }
+
+    Result runPackets(const std::vector<Spawn>& spawns, const RenderSettings& settings, const glm::vec3& camera,
+                      const glm::mat4* viewProj, int frames, std::ostream* debugLog) {
+        WorldRenderer renderer;
+        renderer.setRenderSettings(settings);
+        renderer.setCameraPosition(camera);
+        if (viewProj) {
+            renderer.setViewProjection(*viewProj);
+        }
+        renderer.setDebugLog(debugLog);
+
+        std::vector<RenderHandle> handles;
+        for (size_t i = 0; i < spawns.size(); ++i) {
+            const Spawn& spawn = spawns[i];
+            uint32_t id = static_cast<uint32_t>(i);
+            glm::vec3 rotation(0.0f);
+            switch (spawn.type) {
+                case RenderEntityType::PLAYER:
+                    handles.push_back(renderer.addPlayer(
+                        RenderEntityFactory::createPlayerEntity(id, spawn.name, spawn.position, rotation)));
+                    break;
+                case RenderEntityType::MONSTER:
+                    handles.push_back(renderer.addMonster(
+                        RenderEntityFactory::createMonsterEntity(id, spawn.name, spawn.position, rotation)));
+                    break;
+                case RenderEntityType::NPC:
+                    handles.push_back(renderer.addNPC(
+                        RenderEntityFactory::createNPCEntity(id, spawn.name, spawn.position, rotation)));
+                    break;
+                case RenderEntityType::PROJECTILE:
+                    handles.push_back(renderer.addProjectile(
+                        RenderEntityFactory::createProjectileEntity(id, spawn.name, spawn.position, rotation)));
+                    break;
+                case RenderEntityType::SPELL_EFFECT:
+                    handles.push_back(renderer.addSpellEffect(RenderEntityFactory::createSpellEffect(
+                        id, spawn.name + "_bolt", spawn.name, spawn.position, spawn.position, 1e9f)));
+                    break;
+                default:
+                    handles.push_back(renderer.addAbilityEffect(RenderEntityFactory::createAbilityEffect(
+                        id, spawn.name + "_aura", spawn.position, spawn.name, 1e9f)));
+                    break;
+            }
+        }
+
+        std::ostringstream* memoryLog = dynamic_cast<std::ostringstream*>(debugLog);
+        std::vector<glm::vec3> positions;
+        for (const Spawn& spawn : spawns) {
+            positions.push_back(spawn.position);
+        }
+
+        Result result;
+        const uint64_t allocationsBefore = g_allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        for (int frame = 0; frame < frames; ++frame) {
+            if (memoryLog) {
+                memoryLog->str({});
+            }
+            for (size_t i = 0; i < handles.size(); ++i) {
+                positions[i] = drift(positions[i], frame, static_cast<uint32_t>(i));
+                renderer.updateEntityPosition(handles[i], positions[i]);
+            }
+            renderer.beginFrame();
+            renderer.renderEntities();
+            result.rendered += renderer.getRenderPackets().size();
+            renderer.endFrame();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        result.msPerFrame = seconds * 1000.0 / frames;
+        result.allocationsPerFrame = static_cast<double>(g_allocations.load() - allocationsBefore) / frames;
+        result.rendered /= frames;
+        return result;
+    }
+
+    void print(const char* name, const Result& result, size_t entities, double baselineMs) {
+        std::cout << std::left << std::setw(9) << name << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << result.msPerFrame << " ms/frame" << std::setprecision(1)
+                  << std::setw(9) << result.msPerFrame * 1e6 / static_cast<double>(entities) << " ns/entity"
+                  << std::setw(9) << result.allocationsPerFrame << " allocs/frame"
+                  << std::setw(7) << result.rendered << " rendered"
+                  << std::setprecision(2) << std::setw(8) << baselineMs / result.msPerFrame << "x" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 5000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 200;
+    if (count <= 0 || frames <= 0) {
+        std::cerr << "Usage: render_submit_benchmark [entities] [frames]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Spawn> spawns = makeSpawns(count);
+    RenderSettings settings;
+    settings.setPreset(3);
+
+    // Camera above the middle of the crowd, looking along -Z
+    const glm::vec3 camera(0.0f, 70.0f, 0.0f);
+    glm::mat4 view = glm::lookAt(camera, camera + glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, 1000.0f);
+    glm::mat4 viewProj = projection * view;
+
+    std::cout << count << " entities, " << frames << " frames" << std::endl;
+    std::cout << "sizeof: legacy entity " << sizeof(LegacyEntity) << " B, RenderEntity " << sizeof(RenderEntity)
+              << " B, RenderPacket " << sizeof(RenderPacket) << " B" << std::endl;
+
+    std::ostringstream debugLog;
+    Result legacy = runLegacy(spawns, settings, camera, frames);
+    Result distance = runPackets(spawns, settings, camera, nullptr, frames, nullptr);
+    Result packets = runPackets(spawns, settings, camera, &viewProj, frames, nullptr);
+    Result logged = runPackets(spawns, settings, camera, &viewProj, frames, &debugLog);
+
+    print("legacy", legacy, spawns.size(), legacy.msPerFrame);
+    print("distance", distance, spawns.size(), legacy.msPerFrame);
+    print("packets", packets, spawns.size(), legacy.msPerFrame);
+    print("logged", logged, spawns.size(), legacy.msPerFrame);
+    std::cout << "(legacy and distance cull by range only; packets and logged also cull against the view frustum)"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,249 @@
+// Player state replication load test with simulated bots (no sockets)
+//
+// Usage: replication_benchmark [bots] [seconds] [worldSize]
+//
+// Bots wander a square world at walking speed (some stand still) and the
+// server side of broadcastPlayerStates runs at 60 Hz. Two modes:
+//   legacy - every player's full PlayerStateUpdate to every other player
+//   interest - StateReplicator: area of interest, tiered send rates and
+//              quantised deltas against each bot's acknowledged snapshot
+// Bytes include the 4-byte frame header. Each bot decodes its snapshots,
+// checks them against what the server meant to send and acknowledges them
+// after a simulated round trip; a few snapshots are lost on the way, as
+// when GameSession drops them under its send budget. CPU is the tick
+// thread's time for building and queueing the messages.
+
+#include "server/StateReplicator.h"
+#include "network/NetworkMessage.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace clonemine;
+
+namespace {
+    constexpr int TICK_RATE = 60;
+    constexpr float TICK_TIME = 1.0f / TICK_RATE;
+    constexpr float WALK_SPEED = 4.3f;
+    constexpr int ACK_DELAY_TICKS = 6;      // 100 ms round trip
+    constexpr double LOSS_RATE = 0.02;      // Snapshots dropped before the wire
+    constexpr uint32_t FRAME_HEADER_SIZE = 4;
+
+    struct Bot {
+        uint32_t id;
+        glm::vec3 position;
+        glm::vec3 velocity{0.0f};
+        float yaw = 0.0f;
+        float pitch = 0.0f;
+        float health = 100.0f;
+        float resource = 100.0f;
+        float turnTimer = 0.0f;
+        bool idle = false;
+
+        server::SnapshotHistory history;
+        network::PlayerSnapshotDecoder decoder;
+        std::deque<std::pair<int, uint32_t>> acks; // Arrival tick, sequence
+        std::vector<std::vector<uint8_t>> outbox;  // Like ServerPlayer's
+    };
+
+    struct Result {
+        double bytesPerSecond = 0.0;
+        double messagesPerSecond = 0.0;
+        double msPerTick = 0.0;
+        double worstMsPerTick = 0.0;
+        double averageInterest = 0.0;
+        uint64_t decodeFailures = 0;
+        uint64_t mismatches = 0;
+    };
+
+    std::vector<Bot> makeBots(int count, float worldSize, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> coordinate(-worldSize / 2.0f, worldSize / 2.0f);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Bot> bots(count);
+        for (int i = 0; i < count; ++i) {
+            bots[i].id = static_cast<uint32_t>(i + 1);
+            bots[i].position = glm::vec3(coordinate(rng), 64.0f, coordinate(rng));
+            bots[i].idle = unit(rng) < 0.3f;
+        }
+        return bots;
+    }
+
+    void moveBots(std::vector<Bot>& bots, float worldSize, std::mt19937& rng) {
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (auto& bot : bots) {
+            if (bot.idle) {
+                continue;
+            }
+            bot.turnTimer -= TICK_TIME;
+            if (bot.turnTimer <= 0.0f) {
+                bot.turnTimer = 1.0f + unit(rng) * 4.0f;
+                bot.yaw = unit(rng) * 360.0f;
+                bot.pitch = (unit(rng) - 0.5f) * 40.0f;
+            }
+            float yawRad = glm::radians(bot.yaw);
+            bot.velocity = glm::vec3(std::sin(yawRad), 0.0f, std::cos(yawRad)) * WALK_SPEED;
+            bot.position += bot.velocity * TICK_TIME;
+            bot.position.x = std::clamp(bot.position.x, -worldSize / 2.0f, worldSize / 2.0f);
+            bot.position.z = std::clamp(bot.position.z, -worldSize / 2.0f, worldSize / 2.0f);
+        }
+    }
+
+    template <typename Mode>
+    Result run(std::vector<Bot> bots, float worldSize, int ticks, Mode mode) {
+        std::mt19937 rng(7);
+        Result result;
+        uint64_t bytes = 0;
+        uint64_t messages = 0;
+        double totalMs = 0.0;
+
+        for (int t = 0; t < ticks; ++t) {
+            moveBots(bots, worldSize, rng);
+            for (auto& bot : bots) {
+                bot.outbox.clear();
+            }
+
+            auto start = std::chrono::steady_clock::now();
+            mode.serve(bots, t);
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            totalMs += ms;
+            result.worstMsPerTick = std::max(result.worstMsPerTick, ms);
+
+            for (const auto& bot : bots) {
+                for (const auto& message : bot.outbox) {
+                    bytes += FRAME_HEADER_SIZE + message.size();
+                }
+                messages += bot.outbox.size();
+            }
+            mode.deliver(bots, t, result);
+        }
+
+        double seconds = static_cast<double>(ticks) / TICK_RATE;
+        result.bytesPerSecond = static_cast<double>(bytes) / seconds;
+        result.messagesPerSecond = static_cast<double>(messages) / seconds;
+        result.msPerTick = totalMs / ticks;
+        result.averageInterest /= ticks;
+        return result;
+    }
+
+    // The previous broadcastPlayerStates: serialize each player once and
+    // copy it to every other player
+    struct LegacyMode {
+        void serve(std::vector<Bot>& bots, int) {
+            for (const auto& bot : bots) {
+                network::PlayerStateUpdate update;
+                update.playerId = bot.id;
+                update.position = bot.position;
+                update.velocity = bot.velocity;
+                update.yaw = bot.yaw;
+                update.pitch = bot.pitch;
+                update.health = bot.health;
+                update.resource = bot.resource;
+                auto data = update.serialize();
+                for (auto& other : bots) {
+                    if (other.id != bot.id) {
+                        other.outbox.push_back(data);
+                    }
+                }
+            }
+        }
+
+        void deliver(std::vector<Bot>& bots, int, Result& result) {
+            result.averageInterest += static_cast<double>(bots.size() - 1);
+        }
+    };
+
+    struct InterestMode {
+        server::StateReplicator replicator;
+        std::mt19937 loss{11};
+
+        void serve(std::vector<Bot>& bots, int tick) {
+            // Acknowledgements that made it back by now
+            for (auto& bot : bots) {
+                while (!bot.acks.empty() && bot.acks.front().first <= tick) {
+                    bot.history.acknowledge(bot.acks.front().second);
+                    bot.acks.pop_front();
+                }
+            }
+
+            replicator.beginTick();
+            for (auto& bot : bots) {
+                replicator.addPlayer(network::QuantizedPlayerState::quantize(bot.id, bot.position, bot.velocity,
+                                                                            bot.yaw, bot.pitch,
+                                                                            bot.health, bot.resource),
+                                     bot.position, &bot.history);
+            }
+            replicator.replicate(static_cast<uint32_t>(tick), [&bots](uint32_t id, const std::vector<uint8_t>& data) {
+                bots[id - 1].outbox.push_back(data);
+            });
+        }
+
+        // Client side
+        void deliver(std::vector<Bot>& bots, int tick, Result& result) {
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            for (auto& bot : bots) {
+                result.averageInterest += static_cast<double>(bot.history.getLastSent().size()) / bots.size();
+                if (bot.outbox.empty()) {
+                    continue;
+                }
+                if (unit(loss) < LOSS_RATE) {
+                    bot.outbox.clear();
+                    continue;
+                }
+                if (!bot.decoder.decode(bot.outbox.front())) {
+                    ++result.decodeFailures;
+                    continue;
+                }
+                if (bot.decoder.getView() != bot.history.getLastSent()) {
+                    ++result.mismatches;
+                }
+                bot.acks.emplace_back(tick + ACK_DELAY_TICKS, bot.decoder.getSequence());
+            }
+        }
+    };
+
+    void print(const char* name, const Result& result, int bots, double baselineBytes) {
+        std::cout << std::left << std::setw(9) << name << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << result.bytesPerSecond / 1024.0 << " KiB/s"
+                  << std::setw(9) << result.bytesPerSecond / 1024.0 / bots << " KiB/s/bot"
+                  << std::setprecision(0) << std::setw(10) << result.messagesPerSecond << " msg/s"
+                  << std::setprecision(3) << std::setw(9) << result.msPerTick << " ms/tick"
+                  << std::setw(9) << result.worstMsPerTick << " worst"
+                  << std::setprecision(1) << std::setw(7) << result.averageInterest << " in view"
+                  << std::setw(8) << baselineBytes / result.bytesPerSecond << "x" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 500;
+    int seconds = argc > 2 ? std::atoi(argv[2]) : 10;
+    float worldSize = argc > 3 ? static_cast<float>(std::atof(argv[3])) : 1024.0f;
+    if (count <= 1 || seconds <= 0 || worldSize <= 0.0f) {
+        std::cerr << "Usage: replication_benchmark [bots] [seconds] [worldSize]" << std::endl;
+        return 1;
+    }
+
+    std::vector<Bot> bots = makeBots(count, worldSize, 42);
+    int ticks = seconds * TICK_RATE;
+    std::cout << count << " bots in a " << worldSize << " x " << worldSize << " world, " << ticks
+              << " ticks at " << TICK_RATE << " Hz, interest radius " << server::StateReplicator::INTEREST_RADIUS
+              << std::endl;
+
+    // The legacy cost is the same every tick, so a second of it will do
+    Result legacy = run(bots, worldSize, std::min(ticks, TICK_RATE), LegacyMode{});
+    Result interest = run(bots, worldSize, ticks, InterestMode{});
+
+    print("legacy", legacy, count, legacy.bytesPerSecond);
+    print("interest", interest, count, legacy.bytesPerSecond);
+    std::cout << "interest: " << interest.decodeFailures << " decode failures, " << interest.mismatches
+              << " views differing from the server's (" << LOSS_RATE * 100.0 << "% of snapshots lost, acks after "
+              << ACK_DELAY_TICKS << " ticks)" << std::endl;
+    return interest.decodeFailures == 0 && interest.mismatches == 0 ? 0 : 1;
+}
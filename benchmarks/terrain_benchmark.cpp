@@ -0,0 +1,122 @@
+// Terrain generation benchmark
+//
+// Usage: terrain_benchmark [chunks]
+//
+// Compares chunks/sec of the per-block TerrainGenerator::getBlockType path
+// against the batched column path at each supported SIMD level, and checks
+// that every path produces bit-identical columns and blocks.
+
+#include "world/TerrainGenerator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace clonemine;
+
+namespace {
+    constexpr int SIZE = TerrainColumns::SIZE;
+    constexpr int HEIGHT = TerrainColumns::HEIGHT;
+
+    // Keeps the optimiser from discarding generated blocks
+    uint64_t g_checksum = 0;
+
+    void generateLegacy(const TerrainGenerator& generator, int chunkX, int chunkZ) {
+        for (int y = 0; y < HEIGHT; ++y) {
+            for (int z = 0; z < SIZE; ++z) {
+                for (int x = 0; x < SIZE; ++x) {
+                    g_checksum += generator.getBlockType(chunkX * SIZE + x, y, chunkZ * SIZE + z);
+                }
+            }
+        }
+    }
+
+    void generateBatched(const TerrainGenerator& generator, int chunkX, int chunkZ, TerrainColumns& columns) {
+        generator.generateColumns(chunkX, chunkZ, columns);
+        for (int y = 0; y < HEIGHT; ++y) {
+            for (int z = 0; z < SIZE; ++z) {
+                for (int x = 0; x < SIZE; ++x) {
+                    g_checksum += generator.getBlockType(columns, x, y, z);
+                }
+            }
+        }
+    }
+
+    template <typename Fn>
+    double chunksPerSecond(int chunks, Fn&& generate) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < chunks; ++i) {
+            generate(i % 64 - 32, i / 64 - 8);
+        }
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return chunks / elapsed;
+    }
+
+    // Compare every level against the scalar reference and the legacy path
+    bool verifyDeterminism(TerrainGenerator& generator, SimdLevel best) {
+        TerrainColumns reference;
+        TerrainColumns columns;
+        for (int chunkX = -3; chunkX <= 3; ++chunkX) {
+            for (int chunkZ = -3; chunkZ <= 3; ++chunkZ) {
+                generator.setSimdLevel(SimdLevel::Scalar);
+                generator.generateColumns(chunkX * 37, chunkZ * 53, reference);
+
+                for (int level = 0; level <= static_cast<int>(best); ++level) {
+                    generator.setSimdLevel(static_cast<SimdLevel>(level));
+                    generator.generateColumns(chunkX * 37, chunkZ * 53, columns);
+                    if (std::memcmp(reference.heights.data(), columns.heights.data(), sizeof(columns.heights)) != 0 ||
+                        std::memcmp(reference.oreField.data(), columns.oreField.data(), sizeof(columns.oreField)) != 0 ||
+                        reference.biomes != columns.biomes) {
+                        std::cerr << "Mismatch at level " << getSimdLevelName(static_cast<SimdLevel>(level)) << std::endl;
+                        return false;
+                    }
+                }
+
+                for (int y = 0; y < HEIGHT; ++y) {
+                    for (int z = 0; z < SIZE; ++z) {
+                        for (int x = 0; x < SIZE; ++x) {
+                            uint8_t legacy = generator.getBlockType(reference.originX + x, y, reference.originZ + z);
+                            if (legacy != generator.getBlockType(reference, x, y, z)) {
+                                std::cerr << "Block mismatch against per-block path" << std::endl;
+                                return false;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int chunks = argc > 1 ? std::atoi(argv[1]) : 256;
+
+    TerrainGenerator generator(12345);
+    SimdLevel best = detectSimdLevel();
+
+    if (!verifyDeterminism(generator, best)) {
+        return 1;
+    }
+    std::cout << "Determinism: all paths bit-identical (best level " << getSimdLevelName(best) << ")" << std::endl;
+
+    // The per-block path is much slower; time fewer chunks
+    int legacyChunks = std::max(1, chunks / 16);
+    double legacy = chunksPerSecond(legacyChunks, [&](int x, int z) { generateLegacy(generator, x, z); });
+    std::cout << "  per-block getBlockType: " << legacy << " chunks/sec" << std::endl;
+
+    TerrainColumns columns;
+    for (int level = 0; level <= static_cast<int>(best); ++level) {
+        generator.setSimdLevel(static_cast<SimdLevel>(level));
+        double noiseOnly = chunksPerSecond(chunks, [&](int x, int z) { generator.generateColumns(x, z, columns); });
+        double batched = chunksPerSecond(chunks, [&](int x, int z) { generateBatched(generator, x, z, columns); });
+        std::cout << "  batched " << getSimdLevelName(static_cast<SimdLevel>(level)) << ": "
+                  << batched << " chunks/sec (" << batched / legacy << "x), noise only "
+                  << noiseOnly << " chunks/sec" << std::endl;
+    }
+
+    std::cout << "checksum " << g_checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,341 @@
+// Wire codec checks and throughput: schema codec vs the hand-written one
+//
+// Usage: wire_codec_benchmark [iterations] [fuzzCases]
+//
+// Checks, each failing the run:
+//   compat     - every message encodes to the same bytes as the previous
+//                push_back serializers below
+//   round-trip - random messages of every type decode to what was encoded
+//   fuzz       - random bytes, bit flips and every truncation of valid
+//                messages; decoding must stay in bounds (build with
+//                -fsanitize=address to be sure) and truncations must fail
+// Then throughput for chat and player state messages:
+//   legacy  - the previous serialize(): a new vector, byte by byte
+//   append  - appendMessage into a reused buffer
+//   scratch - encodeScratch into the thread's buffer
+//   parse   - the previous hand parser (owning strings) vs decodeView
+
+#include "network/NetworkMessage.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace clonemine;
+
+namespace {
+    // The serializers this codec replaced, kept as the wire reference
+    namespace legacy {
+        void writeUint32(std::vector<uint8_t>& buffer, uint32_t value) {
+            buffer.push_back(static_cast<uint8_t>(value & 0xFF));
+            buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
+            buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
+            buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
+        }
+
+        void writeFloat(std::vector<uint8_t>& buffer, float value) {
+            uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(float));
+            writeUint32(buffer, bits);
+        }
+
+        void writeVec3(std::vector<uint8_t>& buffer, const glm::vec3& vec) {
+            writeFloat(buffer, vec.x);
+            writeFloat(buffer, vec.y);
+            writeFloat(buffer, vec.z);
+        }
+
+        void writeString(std::vector<uint8_t>& buffer, const std::string& str) {
+            writeUint32(buffer, static_cast<uint32_t>(str.size()));
+            buffer.insert(buffer.end(), str.begin(), str.end());
+        }
+
+        std::vector<uint8_t> serialize(const network::ConnectRequest& m) {
+            std::vector<uint8_t> buffer;
+            buffer.push_back(static_cast<uint8_t>(m.type));
+            writeUint32(buffer, m.playerId);
+            writeString(buffer, m.playerName);
+            return buffer;
+        }
+
+        std::vector<uint8_t> serialize(const network::ConnectResponse& m) {
+            std::vector<uint8_t> buffer;
+            buffer.push_back(static_cast<uint8_t>(m.type));
+            buffer.push_back(m.accepted ? 1 : 0);
+            writeUint32(buffer, m.assignedPlayerId);
+            writeString(buffer, m.message);
+            return buffer;
+        }
+
+        std::vector<uint8_t> serialize(const network::PlayerInput& m) {
+            std::vector<uint8_t> buffer;
+            buffer.push_back(static_cast<uint8_t>(m.type));
+            writeUint32(buffer, m.playerId);
+            writeVec3(buffer, m.movement);
+            writeFloat(buffer, m.yaw);
+            writeFloat(buffer, m.pitch);
+            buffer.push_back(m.jump ? 1 : 0);
+            buffer.push_back(m.crouch ? 1 : 0);
+            writeUint32(buffer, m.timestamp);
+            return buffer;
+        }
+
+        std::vector<uint8_t> serialize(const network::PlayerStateUpdate& m) {
+            std::vector<uint8_t> buffer;
+            buffer.reserve(m.getSize());
+            buffer.push_back(static_cast<uint8_t>(m.type));
+            writeUint32(buffer, m.playerId);
+            writeVec3(buffer, m.position);
+            writeVec3(buffer, m.velocity);
+            writeFloat(buffer, m.yaw);
+            writeFloat(buffer, m.pitch);
+            writeFloat(buffer, m.health);
+            writeFloat(buffer, m.resource);
+            writeUint32(buffer, m.timestamp);
+            return buffer;
+        }
+
+        std::vector<uint8_t> serialize(const network::SnapshotAck& m) {
+            std::vector<uint8_t> buffer;
+            buffer.push_back(static_cast<uint8_t>(m.type));
+            writeUint32(buffer, m.sequence);
+            return buffer;
+        }
+
+        std::vector<uint8_t> serialize(const network::PlayerSpawn& m) {
+            std::vector<uint8_t> buffer;
+            buffer.push_back(static_cast<uint8_t>(m.type));
+            writeUint32(buffer, m.playerId);
+            writeVec3(buffer, m.position);
+            writeString(buffer, m.playerName);
+            writeString(buffer, m.className);
+            return buffer;
+        }
+
+        std::vector<uint8_t> serialize(const network::PlayerDespawn& m) {
+            std::vector<uint8_t> buffer;
+            buffer.push_back(static_cast<uint8_t>(m.type));
+            writeUint32(buffer, m.playerId);
+            return buffer;
+        }
+
+        std::vector<uint8_t> serialize(const network::ChatMessage& m) {
+            std::vector<uint8_t> buffer;
+            buffer.reserve(m.getSize());
+            buffer.push_back(static_cast<uint8_t>(m.type));
+            writeString(buffer, m.sender);
+            writeString(buffer, m.message);
+            return buffer;
+        }
+
+        // GameServer::handleChatMessage's parser
+        bool parseChat(const std::vector<uint8_t>& data, std::string& sender, std::string& message) {
+            if (data.size() < 10 || data[0] != static_cast<uint8_t>(network::MessageType::CHAT_MESSAGE)) {
+                return false;
+            }
+            size_t offset = 1;
+            uint32_t senderLen = data[offset] | (data[offset+1] << 8) |
+                                (data[offset+2] << 16) | (data[offset+3] << 24);
+            offset += 4;
+            if (offset + senderLen + 4 > data.size()) return false;
+            sender.assign(data.begin() + offset, data.begin() + offset + senderLen);
+            offset += senderLen;
+            uint32_t msgLen = data[offset] | (data[offset+1] << 8) |
+                             (data[offset+2] << 16) | (data[offset+3] << 24);
+            offset += 4;
+            if (offset + msgLen > data.size()) return false;
+            message.assign(data.begin() + offset, data.begin() + offset + msgLen);
+            return true;
+        }
+    }
+
+    struct Random {
+        std::mt19937 rng{1234};
+
+        uint32_t u32() { return static_cast<uint32_t>(rng()); }
+        bool flag() { return (rng() & 1) != 0; }
+        float real() { return std::uniform_real_distribution<float>(-1000.0f, 1000.0f)(rng); }
+        glm::vec3 vec() { return glm::vec3(real(), real(), real()); }
+        std::string text(size_t maxLength = 64) {
+            std::string s(rng() % (maxLength + 1), ' ');
+            for (auto& c : s) {
+                c = static_cast<char>(rng() % 256);
+            }
+            return s;
+        }
+    };
+
+    void randomize(network::ConnectRequest& m, Random& r) { m.playerId = r.u32(); m.playerName = r.text(); }
+    void randomize(network::ConnectResponse& m, Random& r) {
+        m.accepted = r.flag(); m.assignedPlayerId = r.u32(); m.message = r.text();
+    }
+    void randomize(network::PlayerInput& m, Random& r) {
+        m.playerId = r.u32(); m.movement = r.vec(); m.yaw = r.real(); m.pitch = r.real();
+        m.jump = r.flag(); m.crouch = r.flag(); m.timestamp = r.u32();
+    }
+    void randomize(network::PlayerStateUpdate& m, Random& r) {
+        m.playerId = r.u32(); m.position = r.vec(); m.velocity = r.vec(); m.yaw = r.real(); m.pitch = r.real();
+        m.health = r.real(); m.resource = r.real(); m.timestamp = r.u32();
+    }
+    void randomize(network::SnapshotAck& m, Random& r) { m.sequence = r.u32(); }
+    void randomize(network::PlayerSpawn& m, Random& r) {
+        m.playerId = r.u32(); m.position = r.vec(); m.playerName = r.text(); m.className = r.text();
+    }
+    void randomize(network::PlayerDespawn& m, Random& r) { m.playerId = r.u32(); }
+    void randomize(network::ChatMessage& m, Random& r) { m.sender = r.text(); m.message = r.text(256); }
+
+    // Same schema fields, compared through the codec's own view
+    template <typename Message>
+    bool sameFields(const Message& a, const Message& b) {
+        return std::apply([&](auto... fields) { return ((a.*fields == b.*fields) && ...); },
+                          network::WireSchema<Message>::fields);
+    }
+
+    struct Failures {
+        uint64_t compat = 0;
+        uint64_t roundTrip = 0;
+        uint64_t fuzz = 0;
+    };
+
+    template <typename Message>
+    void check(Random& random, int cases, Failures& failures) {
+        std::vector<uint8_t> buffer;
+        for (int i = 0; i < cases; ++i) {
+            Message message;
+            randomize(message, random);
+
+            auto encoded = message.serialize();
+            if (encoded != legacy::serialize(message) || encoded.size() != message.getSize() ||
+                encoded.size() < network::minWireSize<Message>()) {
+                ++failures.compat;
+            }
+
+            Message decoded;
+            if (!network::decodeMessage(encoded, decoded) || !sameFields(message, decoded)) {
+                ++failures.roundTrip;
+            }
+
+            // Every proper prefix is truncated; none may decode
+            for (size_t length = 0; length < encoded.size(); ++length) {
+                network::MessageView<Message> view;
+                if (network::decodeView<Message>(std::span<const uint8_t>(encoded.data(), length), view)) {
+                    ++failures.fuzz;
+                }
+            }
+
+            // Flipped bytes and random garbage may decode or not, but in bounds
+            buffer = encoded;
+            for (int flips = 0; flips < 4; ++flips) {
+                buffer[random.u32() % buffer.size()] ^= static_cast<uint8_t>(1 + random.u32() % 255);
+                network::MessageView<Message> view;
+                network::decodeView<Message>(buffer, view);
+            }
+            buffer.resize(random.u32() % 64);
+            for (auto& byte : buffer) {
+                byte = static_cast<uint8_t>(random.u32());
+            }
+            if (!buffer.empty()) {
+                buffer[0] = static_cast<uint8_t>(network::WireSchema<Message>::type);
+            }
+            network::MessageView<Message> view;
+            network::decodeView<Message>(buffer, view);
+        }
+    }
+
+    template <typename Function>
+    double nsPerCall(int iterations, Function function) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            function(i);
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+
+    volatile size_t g_sink; // Keeps results alive
+
+    template <typename Message>
+    void benchmarkEncode(const char* name, const Message& message, int iterations) {
+        std::vector<uint8_t> reused;
+        double legacyNs = nsPerCall(iterations, [&](int) { g_sink = legacy::serialize(message).size(); });
+        double appendNs = nsPerCall(iterations, [&](int) {
+            reused.clear();
+            network::appendMessage(message, reused);
+            g_sink = reused.size();
+        });
+        double scratchNs = nsPerCall(iterations, [&](int) { g_sink = network::encodeScratch(message).size(); });
+
+        std::cout << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(1)
+                  << " legacy " << std::setw(7) << legacyNs << " ns"
+                  << "   append " << std::setw(7) << appendNs << " ns"
+                  << "   scratch " << std::setw(7) << scratchNs << " ns"
+                  << std::setprecision(2) << std::setw(8) << legacyNs / appendNs << "x" << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    int fuzzCases = argc > 2 ? std::atoi(argv[2]) : 2000;
+    if (iterations <= 0 || fuzzCases <= 0) {
+        std::cerr << "Usage: wire_codec_benchmark [iterations] [fuzzCases]" << std::endl;
+        return 1;
+    }
+
+    Random random;
+    Failures failures;
+    check<network::ConnectRequest>(random, fuzzCases, failures);
+    check<network::ConnectResponse>(random, fuzzCases, failures);
+    check<network::PlayerInput>(random, fuzzCases, failures);
+    check<network::PlayerStateUpdate>(random, fuzzCases, failures);
+    check<network::SnapshotAck>(random, fuzzCases, failures);
+    check<network::PlayerSpawn>(random, fuzzCases, failures);
+    check<network::PlayerDespawn>(random, fuzzCases, failures);
+    check<network::ChatMessage>(random, fuzzCases, failures);
+
+    // LoginRequest is new, so it has no legacy encoding: round trip only
+    for (int i = 0; i < fuzzCases; ++i) {
+        network::LoginRequest login;
+        login.username = random.text();
+        login.password = random.text();
+        network::LoginRequest decoded;
+        if (!network::decodeMessage(login.serialize(), decoded) || !sameFields(login, decoded)) {
+            ++failures.roundTrip;
+        }
+    }
+
+    std::cout << fuzzCases << " random messages of each type: " << failures.compat << " differing from the "
+              << "previous encoding, " << failures.roundTrip << " round-trip failures, " << failures.fuzz
+              << " truncations decoded" << std::endl;
+
+    network::ChatMessage chat;
+    chat.sender = "Adventurer";
+    chat.message = "Anyone up for the dungeon run tonight? Meet at the north gate.";
+    network::PlayerStateUpdate state;
+    randomize(state, random);
+
+    std::cout << iterations << " iterations" << std::endl;
+    benchmarkEncode("ChatMessage", chat, iterations);
+    benchmarkEncode("PlayerStateUpdate", state, iterations);
+
+    auto chatData = chat.serialize();
+    std::string sender;
+    std::string message;
+    double legacyParseNs = nsPerCall(iterations, [&](int) {
+        legacy::parseChat(chatData, sender, message);
+        g_sink = message.size();
+    });
+    double viewParseNs = nsPerCall(iterations, [&](int) {
+        network::MessageView<network::ChatMessage> view;
+        network::decodeView<network::ChatMessage>(chatData, view);
+        g_sink = std::get<1>(view).size();
+    });
+    std::cout << std::left << std::setw(20) << "ChatMessage parse" << std::right << std::fixed
+              << std::setprecision(1) << " legacy " << std::setw(7) << legacyParseNs << " ns"
+              << "   view   " << std::setw(7) << viewParseNs << " ns"
+              << std::setprecision(2) << std::setw(27) << legacyParseNs / viewParseNs << "x" << std::endl;
+
+    return failures.compat == 0 && failures.roundTrip == 0 && failures.fuzz == 0 ? 0 : 1;
+}
@@ -0,0 +1,20 @@
+#version 450
+
+layout(set = 0, binding = 0) uniform sampler2D blockAtlas;
+
+layout(location = 0) in vec2 fragTexCoord;
+layout(location = 1) flat in uint fragTile;
+layout(location = 2) in float fragLight;
+layout(location = 3) in vec3 fragNormal;
+
+layout(location = 0) out vec4 outColor;
+
+const float TILES_PER_ROW = 16.0;
+
+void main() {
+    // Repeat the tile across merged quads
+    vec2 tile = vec2(float(fragTile % 16u), float(fragTile / 16u));
+    vec2 uv = (tile + fract(fragTexCoord)) / TILES_PER_ROW;
+    vec4 color = texture(blockAtlas, uv);
+    outColor = vec4(color.rgb * fragLight, color.a);
+}
@@ -0,0 +1,56 @@
+#version 450
+
+// Packed chunk vertex (PackedBlockVertex in rendering/ChunkMesher.h)
+//   x: pos x:5 y:9 z:5 | face:3 | corner:2 | light:8
+//   y: atlas tile:8 | quad length u:9 | quad length v:9
+layout(location = 0) in uvec2 inPacked;
+
+// Written by the cull pass. The section id is firstSection plus
+// gl_InstanceIndex: either firstInstance of the indirect draw carries it
+// (see chunk_cull.comp) or, with one draw per section, firstSection does.
+struct ChunkSection {
+    vec4 origin;
+    vec4 bounds;
+    uint indexCount;
+    uint firstIndex;
+    int vertexOffset;
+    uint padding;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Sections { ChunkSection sections[]; };
+
+layout(push_constant) uniform ChunkConstants {
+    mat4 viewProj;
+    uint firstSection;
+} chunk;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragTile;
+layout(location = 2) out float fragLight;
+layout(location = 3) out vec3 fragNormal;
+
+const vec3 FACE_NORMALS[6] = vec3[](
+    vec3(0.0, 0.0, 1.0),
+    vec3(0.0, 0.0, -1.0),
+    vec3(-1.0, 0.0, 0.0),
+    vec3(1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0),
+    vec3(0.0, -1.0, 0.0)
+);
+
+void main() {
+    uint data = inPacked.x;
+    vec3 local = vec3(float(data & 31u), float((data >> 5) & 511u), float((data >> 14) & 31u));
+    uint face = (data >> 19) & 7u;
+    uint corner = (data >> 22) & 3u;
+
+    float uLength = float((inPacked.y >> 8) & 511u);
+    float vLength = float((inPacked.y >> 17) & 511u);
+    fragTexCoord = vec2((corner == 1u || corner == 2u) ? uLength : 0.0,
+                        (corner >= 2u) ? vLength : 0.0);
+    fragTile = inPacked.y & 255u;
+    fragLight = float(data >> 24) / 255.0;
+    fragNormal = FACE_NORMALS[face];
+
+    gl_Position = chunk.viewProj * vec4(sections[chunk.firstSection + uint(gl_InstanceIndex)].origin.xyz + local, 1.0);
+}
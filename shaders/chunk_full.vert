@@ -0,0 +1,28 @@
+#version 450
+
+// Full-format chunk vertex (BlockVertex in rendering/ChunkMesher.h), already
+// in world space. Debug fallback for the packed format in chunk.vert; feeds
+// the same chunk.frag.
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in float inLight;
+layout(location = 4) in uint inTile;
+
+layout(push_constant) uniform ChunkConstants {
+    mat4 viewProj;
+    uint firstSection; // Unused; shares ChunkPushConstants with chunk.vert
+} chunk;
+
+layout(location = 0) out vec2 fragTexCoord;
+layout(location = 1) flat out uint fragTile;
+layout(location = 2) out float fragLight;
+layout(location = 3) out vec3 fragNormal;
+
+void main() {
+    fragTexCoord = inTexCoord;
+    fragTile = inTile;
+    fragLight = inLight;
+    fragNormal = inNormal;
+    gl_Position = chunk.viewProj * vec4(inPosition, 1.0);
+}
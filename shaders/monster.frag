@@ -0,0 +1,15 @@
+#version 450
+
+layout(location = 0) in vec3 fragColor;
+layout(location = 1) in vec3 fragNormal;
+layout(location = 2) in vec2 fragTexCoord;
+layout(location = 3) in float fragAlpha;
+
+layout(location = 0) out vec4 outColor;
+
+const vec3 LIGHT_DIRECTION = vec3(0.4, 0.8, 0.3);
+
+void main() {
+    float diffuse = max(dot(normalize(fragNormal), normalize(LIGHT_DIRECTION)), 0.0);
+    outColor = vec4(fragColor * (0.4 + 0.6 * diffuse), fragAlpha);
+}
@@ -0,0 +1,43 @@
+#version 450
+
+// MonsterVertex in rendering/MonsterRenderer.h
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec2 inTexCoord;
+layout(location = 3) in vec3 inColor;
+layout(location = 4) in uint inBone;
+
+// GpuMonsterInstance; gl_InstanceIndex includes the draw's firstInstance,
+// which is where this model's instances start
+struct MonsterInstance {
+    mat4 transform;
+    vec4 tint;
+    float animationTime;
+    uint firstBone;
+    uint padding0;
+    uint padding1;
+};
+
+layout(std430, set = 0, binding = 0) readonly buffer Instances { MonsterInstance instances[]; };
+layout(std430, set = 0, binding = 1) readonly buffer Bones { mat4 bones[]; };
+
+layout(push_constant) uniform MonsterConstants {
+    mat4 viewProj;
+} monster;
+
+layout(location = 0) out vec3 fragColor;
+layout(location = 1) out vec3 fragNormal;
+layout(location = 2) out vec2 fragTexCoord;
+layout(location = 3) out float fragAlpha;
+
+void main() {
+    MonsterInstance instance = instances[gl_InstanceIndex];
+    mat4 model = instance.transform * bones[instance.firstBone + inBone];
+
+    fragColor = inColor * instance.tint.rgb;
+    fragNormal = normalize(mat3(model) * inNormal);
+    fragTexCoord = inTexCoord;
+    fragAlpha = instance.tint.a;
+
+    gl_Position = monster.viewProj * model * vec4(inPosition, 1.0);
+}
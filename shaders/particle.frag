@@ -0,0 +1,13 @@
+#version 450
+
+layout(location = 0) in vec4 fragColor;
+layout(location = 1) in vec2 fragCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    // Soft round particle
+    float falloff = 1.0 - dot(fragCoord, fragCoord);
+    if (falloff <= 0.0) discard;
+    outColor = vec4(fragColor.rgb, fragColor.a * falloff);
+}
@@ -0,0 +1,42 @@
+#version 450
+
+// Camera-facing quad per particle; drawn with 6 vertices per instance and
+// no vertex buffer. gl_InstanceIndex is the particle.
+
+struct Particle {
+    vec3 position;
+    float size;
+    vec3 velocity;
+    float lifetime;
+    vec4 color;
+    float maxLifetime;
+    float gravity;
+    uint padding0;
+    uint padding1;
+};
+
+layout(std430, set = 0, binding = 2) readonly buffer Particles { Particle particles[]; };
+
+layout(push_constant) uniform ParticleConstants {
+    mat4 viewProj;
+    vec4 cameraRight;
+    vec4 cameraUp;
+} camera;
+
+layout(location = 0) out vec4 fragColor;
+layout(location = 1) out vec2 fragCoord;
+
+const vec2 CORNERS[6] = vec2[](
+    vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),
+    vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0)
+);
+
+void main() {
+    Particle p = particles[gl_InstanceIndex];
+    vec2 corner = CORNERS[gl_VertexIndex];
+    vec3 offset = (camera.cameraRight.xyz * corner.x + camera.cameraUp.xyz * corner.y) * (p.size * 0.5);
+
+    fragColor = p.color;
+    fragCoord = corner;
+    gl_Position = camera.viewProj * vec4(p.position + offset, 1.0);
+}
@@ -1,5 +1,6 @@
 #include "ClientApplication.h"
 #include "../network/NetworkMessage.h"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 
@@ -245,36 +246,14 @@ void ClientApplication::handleNetworkMessage(const std::vector<uint8_t>& data) {
     
     switch (type) {
         case network::MessageType::PLAYER_STATE_UPDATE: {
-            if (data.size() < 50) break;
+            network::MessageView<network::PlayerStateUpdate> update;
+            if (!network::decodeView<network::PlayerStateUpdate>(data, update)) break;
             
-            // Parse player state update
-            uint32_t playerId = data[1] | (data[2] << 8) | (data[3] << 16) | (data[4] << 24);
-            
-            // Read position (3 floats)
-            float px, py, pz;
-            std::memcpy(&px, &data[5], sizeof(float));
-            std::memcpy(&py, &data[9], sizeof(float));
-            std::memcpy(&pz, &data[13], sizeof(float));
-            
-            // Read velocity (3 floats)
-            float vx, vy, vz;
-            std::memcpy(&vx, &data[17], sizeof(float));
-            std::memcpy(&vy, &data[21], sizeof(float));
-            std::memcpy(&vz, &data[25], sizeof(float));
-            
-            // Read rotation (2 floats)
-            float yaw, pitch;
-            std::memcpy(&yaw, &data[29], sizeof(float));
-            std::memcpy(&pitch, &data[33], sizeof(float));
-            
-            // Read health and resource (2 floats)
-            float health, resource;
-            std::memcpy(&health, &data[37], sizeof(float));
-            std::memcpy(&resource, &data[41], sizeof(float));
+            auto& [playerId, position, velocity, yaw, pitch, health, resource, timestamp] = update;
             
             if (playerId == m_networkClient->getPlayerId()) {
                 // Update local player with authoritative state
-                m_localPlayer.setPosition(glm::vec3(px, py, pz));
+                m_localPlayer.setPosition(position);
                 m_localPlayer.setRotation(yaw, pitch);
                 m_localPlayer.setHealth(health);
                 m_localPlayer.setResource(resource);
@@ -285,7 +264,7 @@ void ClientApplication::handleNetworkMessage(const std::vector<uint8_t>& data) {
                     m_remotePlayers[playerId] = Player();
                 }
                 
-                m_remotePlayers[playerId].setPosition(glm::vec3(px, py, pz));
+                m_remotePlayers[playerId].setPosition(position);
                 m_remotePlayers[playerId].setRotation(yaw, pitch);
                 m_remotePlayers[playerId].setHealth(health);
                 m_remotePlayers[playerId].setResource(resource);
@@ -293,31 +272,57 @@ void ClientApplication::handleNetworkMessage(const std::vector<uint8_t>& data) {
             break;
         }
         
-        case network::MessageType::PLAYER_SPAWN: {
-            if (data.size() < 20) break;
+        case network::MessageType::PLAYER_STATE_SNAPSHOT: {
+            if (!m_snapshotDecoder.decode(data)) {
+                // The next snapshot on a baseline we have will fix it
+                std::cerr << "Dropped undecodable player snapshot" << std::endl;
+                break;
+            }
             
-            uint32_t playerId = data[1] | (data[2] << 8) | (data[3] << 16) | (data[4] << 24);
+            // The snapshot is everyone within range; the rest are out of sight
+            const network::PlayerSnapshotView& view = m_snapshotDecoder.getView();
+            for (auto it = m_remotePlayers.begin(); it != m_remotePlayers.end();) {
+                auto state = std::lower_bound(view.begin(), view.end(), it->first,
+                    [](const network::QuantizedPlayerState& s, uint32_t id) { return s.playerId < id; });
+                bool inView = state != view.end() && state->playerId == it->first;
+                it = inView ? std::next(it) : m_remotePlayers.erase(it);
+            }
+            for (const auto& state : view) {
+                Player& player = m_remotePlayers[state.playerId];
+                player.setPosition(state.getPosition());
+                player.setRotation(state.getYaw(), state.getPitch());
+                player.setHealth(state.getHealth());
+                player.setResource(state.getResource());
+            }
             
-            // Parse spawn position
-            float px, py, pz;
-            std::memcpy(&px, &data[5], sizeof(float));
-            std::memcpy(&py, &data[9], sizeof(float));
-            std::memcpy(&pz, &data[13], sizeof(float));
+            network::SnapshotAck ack;
+            ack.playerId = m_networkClient->getPlayerId();
+            ack.sequence = m_snapshotDecoder.getSequence();
+            m_networkClient->sendMessage(ack);
+            break;
+        }
+        
+        case network::MessageType::PLAYER_SPAWN: {
+            network::MessageView<network::PlayerSpawn> spawn;
+            if (!network::decodeView<network::PlayerSpawn>(data, spawn)) break;
+            
+            auto& [playerId, position, playerName, className] = spawn;
             
             if (playerId != m_networkClient->getPlayerId()) {
                 // Add remote player
                 m_remotePlayers[playerId] = Player();
-                m_remotePlayers[playerId].setPosition(glm::vec3(px, py, pz));
+                m_remotePlayers[playerId].setPosition(position);
                 
-                std::cout << "Remote player " << playerId << " spawned" << std::endl;
+                std::cout << "Remote player " << playerId << " (" << playerName << ") spawned" << std::endl;
             }
             break;
         }
         
         case network::MessageType::PLAYER_DESPAWN: {
-            if (data.size() < 5) break;
+            network::MessageView<network::PlayerDespawn> despawn;
+            if (!network::decodeView<network::PlayerDespawn>(data, despawn)) break;
             
-            uint32_t playerId = data[1] | (data[2] << 8) | (data[3] << 16) | (data[4] << 24);
+            auto [playerId] = despawn;
             
             auto it = m_remotePlayers.find(playerId);
             if (it != m_remotePlayers.end()) {
@@ -328,29 +333,10 @@ void ClientApplication::handleNetworkMessage(const std::vector<uint8_t>& data) {
         }
         
         case network::MessageType::CHAT_MESSAGE: {
-            if (data.size() < 10) break;
-            
-            // Parse chat message
-            size_t offset = 1;
-            
-            // Read sender length
-            uint32_t senderLen = data[offset] | (data[offset+1] << 8) | 
-                                (data[offset+2] << 16) | (data[offset+3] << 24);
-            offset += 4;
-            
-            if (offset + senderLen + 4 > data.size()) break;
-            
-            std::string sender(data.begin() + offset, data.begin() + offset + senderLen);
-            offset += senderLen;
-            
-            // Read message length
-            uint32_t msgLen = data[offset] | (data[offset+1] << 8) | 
-                             (data[offset+2] << 16) | (data[offset+3] << 24);
-            offset += 4;
-            
-            if (offset + msgLen > data.size()) break;
+            network::MessageView<network::ChatMessage> chat;
+            if (!network::decodeView<network::ChatMessage>(data, chat)) break;
             
-            std::string message(data.begin() + offset, data.begin() + offset + msgLen);
+            auto& [sender, message] = chat;
             
             // Add to chat messages
             ChatMessage chatMsg;
@@ -8,6 +8,7 @@
 #include "../rendering/Renderer.h"
 #include "../world/World.h"
 #include "../world/Player.h"
+#include "../network/PlayerSnapshot.h"
 #include "../plugin/PluginManager.h"
 #include <memory>
 #include <string_view>
@@ -96,6 +97,7 @@ private:
     
     // Client-side players (for rendering other players)
     std::unordered_map<uint32_t, Player> m_remotePlayers;
+    network::PlayerSnapshotDecoder m_snapshotDecoder;
     Player m_localPlayer; // Local player for input prediction
     
     // Camera
@@ -7,7 +7,8 @@ namespace client {
 NetworkClient::NetworkClient() {
     // Initialize encryption with a shared secret key
     // TODO: In production, use proper key exchange mechanism
-    m_encryption = std::make_unique<network::PacketEncryption>("CloneMineSharedSecret2024");
+    m_sendEncryption = std::make_unique<network::PacketEncryption>("CloneMineSharedSecret2024");
+    m_receiveEncryption = std::make_unique<network::PacketEncryption>("CloneMineSharedSecret2024");
 }
 
 NetworkClient::~NetworkClient() {
@@ -34,7 +35,7 @@ bool NetworkClient::connect(const std::string& host, uint16_t port, const std::s
         auto data = request.serialize();
         
         // Encrypt the data
-        m_encryption->encrypt(data);
+        m_sendEncryption->encrypt(data);
         
         // Send data size first
         uint32_t size = static_cast<uint32_t>(data.size());
@@ -60,17 +61,13 @@ bool NetworkClient::connect(const std::string& host, uint16_t port, const std::s
         asio::read(*m_socket, asio::buffer(responseData));
         
         // Decrypt the response
-        m_encryption->decrypt(responseData);
+        m_receiveEncryption->decrypt(responseData);
         
         // Parse response
-        if (responseData.size() >= 6 && 
-            responseData[0] == static_cast<uint8_t>(network::MessageType::CONNECT_RESPONSE)) {
-            
-            bool accepted = responseData[1] != 0;
-            m_playerId = responseData[2] |
-                        (responseData[3] << 8) |
-                        (responseData[4] << 16) |
-                        (responseData[5] << 24);
+        network::MessageView<network::ConnectResponse> response;
+        if (network::decodeView<network::ConnectResponse>(responseData, response)) {
+            auto& [accepted, assignedPlayerId, message] = response;
+            m_playerId = assignedPlayerId;
             
             if (accepted) {
                 m_connected = true;
@@ -114,6 +111,7 @@ void NetworkClient::disconnect() {
             std::vector<uint8_t> disconnectMsg = {
                 static_cast<uint8_t>(network::MessageType::DISCONNECT)
             };
+            m_sendEncryption->encrypt(disconnectMsg);
             
             uint32_t size = static_cast<uint32_t>(disconnectMsg.size());
             std::vector<uint8_t> sizeBuffer(4);
@@ -146,7 +144,7 @@ void NetworkClient::sendMessage(const network::NetworkMessage& message) {
         auto data = message.serialize();
         
         // Encrypt the data before sending
-        m_encryption->encrypt(data);
+        m_sendEncryption->encrypt(data);
         
         // Send data size first
         uint32_t size = static_cast<uint32_t>(data.size());
@@ -188,7 +186,7 @@ void NetworkClient::receiveMessages() {
             asio::read(*m_socket, asio::buffer(messageData));
             
             // Decrypt the received data
-            m_encryption->decrypt(messageData);
+            m_receiveEncryption->decrypt(messageData);
             
             // Queue message for processing
             {
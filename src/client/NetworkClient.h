@@ -51,8 +51,9 @@ private:
     std::queue<std::vector<uint8_t>> m_messageQueue;
     std::mutex m_queueMutex;
     
-    // Encryption
-    std::unique_ptr<network::PacketEncryption> m_encryption;
+    // Encryption, one key stream per direction to match the server
+    std::unique_ptr<network::PacketEncryption> m_sendEncryption;
+    std::unique_ptr<network::PacketEncryption> m_receiveEncryption;
 };
 
 } // namespace client
@@ -21,6 +21,8 @@ struct ServerConfig {
     // Game Server
     std::string gameServerHost{"localhost"};
     uint16_t gameServerPort{25565};
+    uint32_t gameSendBudgetKB{256};               // Per-connection send queue limit
+    std::string gameSendOverflowPolicy{"drop"};   // "drop" state updates or "disconnect"
     
     // Chat Server
     std::string chatServerHost{"localhost"};
@@ -68,6 +70,8 @@ struct ServerConfig {
             else if (key == "characterServerPort") characterServerPort = static_cast<uint16_t>(std::stoi(value));
             else if (key == "gameServerHost") gameServerHost = value;
             else if (key == "gameServerPort") gameServerPort = static_cast<uint16_t>(std::stoi(value));
+            else if (key == "gameSendBudgetKB") gameSendBudgetKB = static_cast<uint32_t>(std::stoul(value));
+            else if (key == "gameSendOverflowPolicy") gameSendOverflowPolicy = value;
             else if (key == "chatServerHost") chatServerHost = value;
             else if (key == "chatServerPort") chatServerPort = static_cast<uint16_t>(std::stoi(value));
             else if (key == "questServerHost") questServerHost = value;
@@ -98,7 +102,9 @@ struct ServerConfig {
         
         file << "# Game Server\n";
         file << "gameServerHost=" << gameServerHost << "\n";
-        file << "gameServerPort=" << gameServerPort << "\n\n";
+        file << "gameServerPort=" << gameServerPort << "\n";
+        file << "gameSendBudgetKB=" << gameSendBudgetKB << "\n";
+        file << "gameSendOverflowPolicy=" << gameSendOverflowPolicy << "\n\n";
         
         file << "# Chat Server\n";
         file << "chatServerHost=" << chatServerHost << "\n";
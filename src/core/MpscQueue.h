@@ -0,0 +1,68 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+namespace clonemine {
+
+// Unbounded lock-free multi-producer / single-consumer queue.
+//
+// Producers link a node with one atomic exchange and never block each
+// other or the consumer. Only one thread may call tryPop(). A value pushed
+// concurrently with tryPop() may show up on the next call instead.
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() : m_head(new Node), m_tail(m_head.load(std::memory_order_relaxed)) {}
+
+    ~MpscQueue() {
+        while (Node* node = m_tail) {
+            m_tail = node->next.load(std::memory_order_relaxed);
+            delete node;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Safe from any thread
+    void push(T value) {
+        Node* node = new Node;
+        node->value.emplace(std::move(value));
+        m_size.fetch_add(1, std::memory_order_relaxed);
+        Node* previous = m_head.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    // Consumer thread only
+    bool tryPop(T& out) {
+        Node* next = m_tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        out = std::move(*next->value);
+        next->value.reset();
+        delete m_tail;
+        m_tail = next; // next becomes the new stub node
+        m_size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Approximate while producers are active
+    size_t size() const { return m_size.load(std::memory_order_relaxed); }
+    bool empty() const { return size() == 0; }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        std::optional<T> value;
+    };
+
+    alignas(64) std::atomic<Node*> m_head; // Producers: most recently pushed node
+    alignas(64) Node* m_tail;              // Consumer: stub before the oldest value
+    std::atomic<size_t> m_size{0};
+};
+
+} // namespace clonemine
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace clonemine {
+
+// Handle into a SlotMap. The generation makes handles to erased values
+// invalid, even after their slot is reused.
+struct SlotHandle {
+    uint32_t index = UINT32_MAX;
+    uint32_t generation = 0;
+
+    [[nodiscard]] bool valid() const noexcept { return index != UINT32_MAX; }
+    bool operator==(const SlotHandle& other) const = default;
+};
+
+// Values stored densely for iteration, addressed by stable handles.
+//
+// Insert and erase are O(1): erase moves the last value into the hole, so
+// dense indices change but handles do not. Containers that mirror the dense
+// order (e.g. SoA arrays) repeat the same swap-and-pop with the index that
+// erase() returns.
+template <typename T>
+class SlotMap {
+public:
+    SlotHandle insert(T value) {
+        uint32_t index;
+        if (!m_freeSlots.empty()) {
+            index = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            index = static_cast<uint32_t>(m_slots.size());
+            m_slots.emplace_back();
+        }
+
+        Slot& slot = m_slots[index];
+        slot.dense = static_cast<uint32_t>(m_values.size());
+        m_values.push_back(std::move(value));
+        m_denseToSlot.push_back(index);
+        return {index, slot.generation};
+    }
+
+    // Dense index the value occupied, or UINT32_MAX if the handle is stale
+    uint32_t erase(SlotHandle handle) {
+        if (!contains(handle)) return UINT32_MAX;
+        uint32_t dense = m_slots[handle.index].dense;
+        eraseAt(dense);
+        return dense;
+    }
+
+    // Erase by dense index, e.g. while walking values() backwards
+    void eraseAt(uint32_t dense) {
+        const uint32_t last = static_cast<uint32_t>(m_values.size() - 1);
+        const uint32_t index = m_denseToSlot[dense];
+        if (dense != last) {
+            m_values[dense] = std::move(m_values[last]);
+            m_denseToSlot[dense] = m_denseToSlot[last];
+            m_slots[m_denseToSlot[dense]].dense = dense;
+        }
+        m_values.pop_back();
+        m_denseToSlot.pop_back();
+
+        Slot& slot = m_slots[index];
+        slot.dense = UINT32_MAX;
+        slot.generation++;
+        m_freeSlots.push_back(index);
+    }
+
+    [[nodiscard]] bool contains(SlotHandle handle) const {
+        return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation &&
+               m_slots[handle.index].dense != UINT32_MAX;
+    }
+
+    // Null if the handle is stale
+    T* get(SlotHandle handle) { return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr; }
+    const T* get(SlotHandle handle) const {
+        return contains(handle) ? &m_values[m_slots[handle.index].dense] : nullptr;
+    }
+
+    // Value in a live slot by handle index, e.g. for spatial indices keyed
+    // by slot rather than by handle
+    T& atSlot(uint32_t index) { return m_values[m_slots[index].dense]; }
+    const T& atSlot(uint32_t index) const { return m_values[m_slots[index].dense]; }
+
+    // Dense index of a live handle
+    [[nodiscard]] uint32_t getDenseIndex(SlotHandle handle) const { return m_slots[handle.index].dense; }
+    [[nodiscard]] SlotHandle getHandle(uint32_t dense) const {
+        uint32_t index = m_denseToSlot[dense];
+        return {index, m_slots[index].generation};
+    }
+
+    std::vector<T>& values() { return m_values; }
+    const std::vector<T>& values() const { return m_values; }
+    [[nodiscard]] size_t size() const noexcept { return m_values.size(); }
+    [[nodiscard]] bool empty() const noexcept { return m_values.empty(); }
+
+    // Invalidates every handle
+    void clear() {
+        for (uint32_t index : m_denseToSlot) {
+            m_slots[index].dense = UINT32_MAX;
+            m_slots[index].generation++;
+            m_freeSlots.push_back(index);
+        }
+        m_values.clear();
+        m_denseToSlot.clear();
+    }
+
+private:
+    struct Slot {
+        uint32_t dense = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+    std::vector<T> m_values;
+    std::vector<uint32_t> m_denseToSlot;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+};
+
+} // namespace clonemine
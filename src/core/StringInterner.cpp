@@ -0,0 +1,50 @@
+#include "StringInterner.h"
+#include <mutex>
+
+namespace clonemine {
+
+StringInterner::StringInterner() {
+    m_strings.emplace_back();
+    m_ids.emplace(std::string_view(m_strings.front()), EMPTY);
+}
+
+StringInterner::Id StringInterner::intern(std::string_view text) {
+    {
+        std::shared_lock lock(m_mutex);
+        auto it = m_ids.find(text);
+        if (it != m_ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock lock(m_mutex);
+    // Another thread may have added it between the two locks
+    auto it = m_ids.find(text);
+    if (it != m_ids.end()) {
+        return it->second;
+    }
+
+    Id id = static_cast<Id>(m_strings.size());
+    const std::string& stored = m_strings.emplace_back(text);
+    m_ids.emplace(std::string_view(stored), id);
+    return id;
+}
+
+StringInterner::Id StringInterner::find(std::string_view text) const {
+    std::shared_lock lock(m_mutex);
+    auto it = m_ids.find(text);
+    return it != m_ids.end() ? it->second : EMPTY;
+}
+
+const std::string& StringInterner::getString(Id id) const {
+    std::shared_lock lock(m_mutex);
+    static const std::string unknown;
+    return id < m_strings.size() ? m_strings[id] : unknown;
+}
+
+size_t StringInterner::size() const {
+    std::shared_lock lock(m_mutex);
+    return m_strings.size();
+}
+
+} // namespace clonemine
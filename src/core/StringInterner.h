@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace clonemine {
+
+// Maps strings to small integer ids that compare and hash as integers.
+//
+// Ids are dense and never reused; id 0 is the empty string. Strings are
+// stored once and stay at the same address, so getString() references
+// remain valid for the interner's lifetime. Safe to use from any thread.
+class StringInterner {
+public:
+    using Id = uint32_t;
+    static constexpr Id EMPTY = 0;
+
+    StringInterner();
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    Id intern(std::string_view text);
+    // EMPTY if the string was never interned
+    Id find(std::string_view text) const;
+    const std::string& getString(Id id) const;
+
+    size_t size() const;
+
+private:
+    mutable std::shared_mutex m_mutex;
+    std::deque<std::string> m_strings;                   // By id
+    std::unordered_map<std::string_view, Id> m_ids;      // Views into m_strings
+};
+
+} // namespace clonemine
@@ -1,129 +1,80 @@
 #include "NetworkMessage.h"
-#include <cstring>
 
 namespace clonemine {
 namespace network {
 
-// Helper functions for serialization
-static void writeUint32(std::vector<uint8_t>& buffer, uint32_t value) {
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-}
+// The layouts are the WireSchema specializations in NetworkMessage.h
 
-static void writeFloat(std::vector<uint8_t>& buffer, float value) {
-    uint32_t bits;
-    std::memcpy(&bits, &value, sizeof(float));
-    writeUint32(buffer, bits);
+std::vector<uint8_t> ConnectRequest::serialize() const {
+    return encodeMessage(*this);
 }
 
-static void writeVec3(std::vector<uint8_t>& buffer, const glm::vec3& vec) {
-    writeFloat(buffer, vec.x);
-    writeFloat(buffer, vec.y);
-    writeFloat(buffer, vec.z);
+size_t ConnectRequest::getSize() const {
+    return wireSize(*this);
 }
 
-static void writeString(std::vector<uint8_t>& buffer, const std::string& str) {
-    writeUint32(buffer, static_cast<uint32_t>(str.size()));
-    buffer.insert(buffer.end(), str.begin(), str.end());
+std::vector<uint8_t> LoginRequest::serialize() const {
+    return encodeMessage(*this);
 }
 
-// ConnectRequest implementation
-std::vector<uint8_t> ConnectRequest::serialize() const {
-    std::vector<uint8_t> buffer;
-    buffer.reserve(getSize());
-    
-    buffer.push_back(static_cast<uint8_t>(type));
-    writeUint32(buffer, playerId);
-    writeString(buffer, playerName);
-    
-    return buffer;
+size_t LoginRequest::getSize() const {
+    return wireSize(*this);
 }
 
-// ConnectResponse implementation
 std::vector<uint8_t> ConnectResponse::serialize() const {
-    std::vector<uint8_t> buffer;
-    buffer.reserve(getSize());
-    
-    buffer.push_back(static_cast<uint8_t>(type));
-    buffer.push_back(accepted ? 1 : 0);
-    writeUint32(buffer, assignedPlayerId);
-    writeString(buffer, message);
-    
-    return buffer;
-}
-
-// PlayerInput implementation
+    return encodeMessage(*this);
+}
+
+size_t ConnectResponse::getSize() const {
+    return wireSize(*this);
+}
+
 std::vector<uint8_t> PlayerInput::serialize() const {
-    std::vector<uint8_t> buffer;
-    buffer.reserve(getSize());
-    
-    buffer.push_back(static_cast<uint8_t>(type));
-    writeUint32(buffer, playerId);
-    writeVec3(buffer, movement);
-    writeFloat(buffer, yaw);
-    writeFloat(buffer, pitch);
-    buffer.push_back(jump ? 1 : 0);
-    buffer.push_back(crouch ? 1 : 0);
-    writeUint32(buffer, timestamp);
-    
-    return buffer;
-}
-
-// PlayerStateUpdate implementation
+    return encodeMessage(*this);
+}
+
+size_t PlayerInput::getSize() const {
+    return wireSize(*this);
+}
+
+std::vector<uint8_t> SnapshotAck::serialize() const {
+    return encodeMessage(*this);
+}
+
+size_t SnapshotAck::getSize() const {
+    return wireSize(*this);
+}
+
 std::vector<uint8_t> PlayerStateUpdate::serialize() const {
-    std::vector<uint8_t> buffer;
-    buffer.reserve(getSize());
-    
-    buffer.push_back(static_cast<uint8_t>(type));
-    writeUint32(buffer, playerId);
-    writeVec3(buffer, position);
-    writeVec3(buffer, velocity);
-    writeFloat(buffer, yaw);
-    writeFloat(buffer, pitch);
-    writeFloat(buffer, health);
-    writeFloat(buffer, resource);
-    writeUint32(buffer, timestamp);
-    
-    return buffer;
-}
-
-// PlayerSpawn implementation
+    return encodeMessage(*this);
+}
+
+size_t PlayerStateUpdate::getSize() const {
+    return wireSize(*this);
+}
+
 std::vector<uint8_t> PlayerSpawn::serialize() const {
-    std::vector<uint8_t> buffer;
-    buffer.reserve(getSize());
-    
-    buffer.push_back(static_cast<uint8_t>(type));
-    writeUint32(buffer, playerId);
-    writeVec3(buffer, position);
-    writeString(buffer, playerName);
-    writeString(buffer, className);
-    
-    return buffer;
-}
-
-// PlayerDespawn implementation
+    return encodeMessage(*this);
+}
+
+size_t PlayerSpawn::getSize() const {
+    return wireSize(*this);
+}
+
 std::vector<uint8_t> PlayerDespawn::serialize() const {
-    std::vector<uint8_t> buffer;
-    buffer.reserve(getSize());
-    
-    buffer.push_back(static_cast<uint8_t>(type));
-    writeUint32(buffer, playerId);
-    
-    return buffer;
+    return encodeMessage(*this);
+}
+
+size_t PlayerDespawn::getSize() const {
+    return wireSize(*this);
 }
 
-// ChatMessage implementation
 std::vector<uint8_t> ChatMessage::serialize() const {
-    std::vector<uint8_t> buffer;
-    buffer.reserve(getSize());
-    
-    buffer.push_back(static_cast<uint8_t>(type));
-    writeString(buffer, sender);
-    writeString(buffer, message);
-    
-    return buffer;
+    return encodeMessage(*this);
+}
+
+size_t ChatMessage::getSize() const {
+    return wireSize(*this);
 }
 
 } // namespace network
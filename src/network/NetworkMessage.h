@@ -1,7 +1,9 @@
 #pragma once
 
+#include "WireCodec.h"
 #include <cstdint>
 #include <string>
+#include <tuple>
 #include <vector>
 #include <glm/glm.hpp>
 
@@ -14,12 +16,15 @@ enum class MessageType : uint8_t {
     CONNECT_REQUEST = 0,
     CONNECT_RESPONSE = 1,
     DISCONNECT = 2,
+    LOGIN_REQUEST = 3, // To the login server
     
     // Player state
     PLAYER_INPUT = 10,
     PLAYER_STATE_UPDATE = 11,
     PLAYER_SPAWN = 12,
     PLAYER_DESPAWN = 13,
+    PLAYER_STATE_SNAPSHOT = 14, // See PlayerSnapshot.h
+    SNAPSHOT_ACK = 15,
     
     // World updates
     WORLD_STATE = 20,
@@ -42,10 +47,11 @@ struct NetworkMessage {
     
     virtual ~NetworkMessage() = default;
     
-    // Serialize to byte buffer
+    // Serialize to byte buffer; see WireSchema below for the layouts and
+    // WireCodec.h for encoding into a reused buffer instead
     virtual std::vector<uint8_t> serialize() const = 0;
     
-    // Get message size for pre-allocation
+    // Serialized size in bytes
     virtual size_t getSize() const = 0;
 };
 
@@ -56,7 +62,18 @@ struct ConnectRequest : NetworkMessage {
     ConnectRequest() { type = MessageType::CONNECT_REQUEST; }
     
     std::vector<uint8_t> serialize() const override;
-    size_t getSize() const override { return sizeof(MessageType) + sizeof(uint32_t) + playerName.size(); }
+    size_t getSize() const override;
+};
+
+// Login with account credentials, to the login server
+struct LoginRequest : NetworkMessage {
+    std::string username;
+    std::string password;
+    
+    LoginRequest() { type = MessageType::LOGIN_REQUEST; }
+    
+    std::vector<uint8_t> serialize() const override;
+    size_t getSize() const override;
 };
 
 // Connect response from server
@@ -68,7 +85,7 @@ struct ConnectResponse : NetworkMessage {
     ConnectResponse() { type = MessageType::CONNECT_RESPONSE; }
     
     std::vector<uint8_t> serialize() const override;
-    size_t getSize() const override { return sizeof(MessageType) + sizeof(bool) + sizeof(uint32_t) + sizeof(uint32_t) + message.size(); }
+    size_t getSize() const override;
 };
 
 // Player input from client
@@ -83,7 +100,7 @@ struct PlayerInput : NetworkMessage {
     PlayerInput() { type = MessageType::PLAYER_INPUT; }
     
     std::vector<uint8_t> serialize() const override;
-    size_t getSize() const override { return sizeof(MessageType) + sizeof(uint32_t) + sizeof(glm::vec3) + sizeof(float) * 2 + sizeof(bool) * 2 + sizeof(uint32_t); }
+    size_t getSize() const override;
 };
 
 // Player state update from server
@@ -99,7 +116,18 @@ struct PlayerStateUpdate : NetworkMessage {
     PlayerStateUpdate() { type = MessageType::PLAYER_STATE_UPDATE; }
     
     std::vector<uint8_t> serialize() const override;
-    size_t getSize() const override { return sizeof(MessageType) + sizeof(uint32_t) * 2 + sizeof(glm::vec3) * 2 + sizeof(float) * 4 + sizeof(uint32_t); }
+    size_t getSize() const override;
+};
+
+// Client acknowledges the newest PLAYER_STATE_SNAPSHOT it applied, which
+// the server may then use as a delta baseline
+struct SnapshotAck : NetworkMessage {
+    uint32_t sequence{0};
+    
+    SnapshotAck() { type = MessageType::SNAPSHOT_ACK; }
+    
+    std::vector<uint8_t> serialize() const override;
+    size_t getSize() const override;
 };
 
 // Player spawn notification
@@ -111,7 +139,7 @@ struct PlayerSpawn : NetworkMessage {
     PlayerSpawn() { type = MessageType::PLAYER_SPAWN; }
     
     std::vector<uint8_t> serialize() const override;
-    size_t getSize() const override { return sizeof(MessageType) + sizeof(uint32_t) + sizeof(glm::vec3) + sizeof(uint32_t) * 2 + playerName.size() + className.size(); }
+    size_t getSize() const override;
 };
 
 // Player despawn notification (disconnect/logout)
@@ -119,7 +147,7 @@ struct PlayerDespawn : NetworkMessage {
     PlayerDespawn() { type = MessageType::PLAYER_DESPAWN; }
     
     std::vector<uint8_t> serialize() const override;
-    size_t getSize() const override { return sizeof(MessageType) + sizeof(uint32_t); }
+    size_t getSize() const override;
 };
 
 // Chat message
@@ -130,7 +158,72 @@ struct ChatMessage : NetworkMessage {
     ChatMessage() { type = MessageType::CHAT_MESSAGE; }
     
     std::vector<uint8_t> serialize() const override;
-    size_t getSize() const override { return sizeof(MessageType) + sizeof(uint32_t) * 2 + sender.size() + message.size(); }
+    size_t getSize() const override;
+};
+
+// Wire layouts: the type byte, then these fields in order. Integers and
+// floats are 4 bytes little-endian, bools 1 byte, vectors 3 floats and
+// strings a 4-byte length and their bytes.
+
+template <>
+struct WireSchema<ConnectRequest> {
+    static constexpr MessageType type = MessageType::CONNECT_REQUEST;
+    static constexpr std::tuple fields{&ConnectRequest::playerId, &ConnectRequest::playerName};
+};
+
+template <>
+struct WireSchema<LoginRequest> {
+    static constexpr MessageType type = MessageType::LOGIN_REQUEST;
+    static constexpr std::tuple fields{&LoginRequest::username, &LoginRequest::password};
+};
+
+template <>
+struct WireSchema<ConnectResponse> {
+    static constexpr MessageType type = MessageType::CONNECT_RESPONSE;
+    static constexpr std::tuple fields{&ConnectResponse::accepted, &ConnectResponse::assignedPlayerId,
+                                       &ConnectResponse::message};
+};
+
+template <>
+struct WireSchema<PlayerInput> {
+    static constexpr MessageType type = MessageType::PLAYER_INPUT;
+    static constexpr std::tuple fields{&PlayerInput::playerId, &PlayerInput::movement, &PlayerInput::yaw,
+                                       &PlayerInput::pitch, &PlayerInput::jump, &PlayerInput::crouch,
+                                       &PlayerInput::timestamp};
+};
+
+template <>
+struct WireSchema<PlayerStateUpdate> {
+    static constexpr MessageType type = MessageType::PLAYER_STATE_UPDATE;
+    static constexpr std::tuple fields{&PlayerStateUpdate::playerId, &PlayerStateUpdate::position,
+                                       &PlayerStateUpdate::velocity, &PlayerStateUpdate::yaw,
+                                       &PlayerStateUpdate::pitch, &PlayerStateUpdate::health,
+                                       &PlayerStateUpdate::resource, &PlayerStateUpdate::timestamp};
+};
+
+template <>
+struct WireSchema<SnapshotAck> {
+    static constexpr MessageType type = MessageType::SNAPSHOT_ACK;
+    static constexpr std::tuple fields{&SnapshotAck::sequence};
+};
+
+template <>
+struct WireSchema<PlayerSpawn> {
+    static constexpr MessageType type = MessageType::PLAYER_SPAWN;
+    static constexpr std::tuple fields{&PlayerSpawn::playerId, &PlayerSpawn::position, &PlayerSpawn::playerName,
+                                       &PlayerSpawn::className};
+};
+
+template <>
+struct WireSchema<PlayerDespawn> {
+    static constexpr MessageType type = MessageType::PLAYER_DESPAWN;
+    static constexpr std::tuple fields{&PlayerDespawn::playerId};
+};
+
+template <>
+struct WireSchema<ChatMessage> {
+    static constexpr MessageType type = MessageType::CHAT_MESSAGE;
+    static constexpr std::tuple fields{&ChatMessage::sender, &ChatMessage::message};
 };
 
 } // namespace network
@@ -11,11 +11,15 @@ PacketEncryption::PacketEncryption(const std::string& secretKey) {
 }
 
 void PacketEncryption::encrypt(std::vector<uint8_t>& data) {
-    if (data.empty()) return;
+    encrypt(data.data(), data.data(), data.size());
+}
+
+void PacketEncryption::encrypt(const uint8_t* input, uint8_t* output, size_t size) {
+    if (size == 0) return;
     
     // XOR encryption with rotating key
-    for (size_t i = 0; i < data.size(); ++i) {
-        data[i] ^= getKeyByte(i);
+    for (size_t i = 0; i < size; ++i) {
+        output[i] = input[i] ^ getKeyByte(i);
     }
     
     // Increment counter for next encryption
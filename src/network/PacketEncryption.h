@@ -22,6 +22,10 @@ public:
     // Encrypt data in-place
     void encrypt(std::vector<uint8_t>& data);
     
+    // Encrypt size bytes from input into output (which may be input), so a
+    // shared packet can be written straight into a send buffer
+    void encrypt(const uint8_t* input, uint8_t* output, size_t size);
+    
     // Decrypt data in-place
     void decrypt(std::vector<uint8_t>& data);
     
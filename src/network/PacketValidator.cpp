@@ -100,6 +100,10 @@ size_t PacketValidator::getMinimumSize(MessageType type) {
             return 50; // type + playerId + movement + rotation + flags + timestamp
         case MessageType::PLAYER_STATE_UPDATE:
             return 50; // type + playerId + position + velocity + rotation + health + resource + timestamp
+        case MessageType::PLAYER_STATE_SNAPSHOT:
+            return 15; // type + sequence + baseline + server time + entry count
+        case MessageType::SNAPSHOT_ACK:
+            return 5;  // type + sequence
         case MessageType::PLAYER_SPAWN:
             return 20; // type + playerId + position + minimum strings
         case MessageType::PLAYER_DESPAWN:
@@ -121,6 +125,10 @@ size_t PacketValidator::getMaximumSize(MessageType type) {
             return 100;
         case MessageType::PLAYER_STATE_UPDATE:
             return 100;
+        case MessageType::PLAYER_STATE_SNAPSHOT:
+            return 64 * 1024; // Whole area of interest on a baseline miss
+        case MessageType::SNAPSHOT_ACK:
+            return 5;
         case MessageType::PLAYER_SPAWN:
             return 512;
         case MessageType::CHUNK_DATA:
@@ -0,0 +1,314 @@
+#include "PlayerSnapshot.h"
+#include "NetworkMessage.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace clonemine {
+namespace network {
+
+namespace {
+    constexpr size_t HEADER_SIZE = 1 + 4 + 4 + 4 + 2;
+
+    template <typename T>
+    T quantizeClamped(float value, float scale) {
+        float scaled = std::round(value * scale);
+        if (!std::isfinite(scaled)) {
+            return 0;
+        }
+        scaled = std::clamp(scaled, static_cast<float>(std::numeric_limits<T>::min()),
+                            static_cast<float>(std::numeric_limits<T>::max()));
+        return static_cast<T>(scaled);
+    }
+
+    // id, mask, absolute position, velocity, rotation, health, resource
+    constexpr size_t MAX_ENTRY_SIZE = 4 + 1 + 12 + 6 + 4 + 2 + 2;
+
+    // Writers into space the encoder reserved up front
+    uint8_t* putUint16(uint8_t* p, uint16_t value) {
+        p[0] = static_cast<uint8_t>(value & 0xFF);
+        p[1] = static_cast<uint8_t>(value >> 8);
+        return p + 2;
+    }
+
+    uint8_t* putUint32(uint8_t* p, uint32_t value) {
+        p[0] = static_cast<uint8_t>(value & 0xFF);
+        p[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        p[2] = static_cast<uint8_t>((value >> 16) & 0xFF);
+        p[3] = static_cast<uint8_t>((value >> 24) & 0xFF);
+        return p + 4;
+    }
+
+    // Bounds-checked little-endian reads
+    struct Reader {
+        const std::vector<uint8_t>& data;
+        size_t offset;
+
+        bool has(size_t bytes) const { return offset + bytes <= data.size(); }
+
+        uint16_t readUint16() {
+            uint16_t value = static_cast<uint16_t>(data[offset] | (data[offset + 1] << 8));
+            offset += 2;
+            return value;
+        }
+
+        uint32_t readUint32() {
+            uint32_t value = data[offset] | (data[offset + 1] << 8) | (data[offset + 2] << 16) |
+                             (static_cast<uint32_t>(data[offset + 3]) << 24);
+            offset += 4;
+            return value;
+        }
+    };
+
+    uint8_t* putRemoved(uint8_t* p, uint32_t playerId) {
+        p = putUint32(p, playerId);
+        *p++ = SnapshotField::REMOVED;
+        return p;
+    }
+
+    uint8_t* putEntry(uint8_t* p, const QuantizedPlayerState* old, const QuantizedPlayerState& state) {
+        uint8_t mask = 0;
+        std::array<int32_t, 3> delta{};
+        if (!old || old->position != state.position) {
+            mask |= SnapshotField::POSITION;
+            if (old) {
+                bool fits = true;
+                for (int axis = 0; axis < 3; ++axis) {
+                    delta[axis] = state.position[axis] - old->position[axis];
+                    fits = fits && delta[axis] >= std::numeric_limits<int16_t>::min() &&
+                           delta[axis] <= std::numeric_limits<int16_t>::max();
+                }
+                if (fits) {
+                    mask = (mask & ~SnapshotField::POSITION) | SnapshotField::POSITION_DELTA;
+                }
+            }
+        }
+        if (!old || old->velocity != state.velocity) mask |= SnapshotField::VELOCITY;
+        if (!old || old->yaw != state.yaw || old->pitch != state.pitch) mask |= SnapshotField::ROTATION;
+        if (!old || old->health != state.health) mask |= SnapshotField::HEALTH;
+        if (!old || old->resource != state.resource) mask |= SnapshotField::RESOURCE;
+
+        p = putUint32(p, state.playerId);
+        *p++ = mask;
+        if (mask & SnapshotField::POSITION) {
+            for (int32_t value : state.position) {
+                p = putUint32(p, static_cast<uint32_t>(value));
+            }
+        }
+        if (mask & SnapshotField::POSITION_DELTA) {
+            for (int32_t value : delta) {
+                p = putUint16(p, static_cast<uint16_t>(static_cast<int16_t>(value)));
+            }
+        }
+        if (mask & SnapshotField::VELOCITY) {
+            for (int16_t value : state.velocity) {
+                p = putUint16(p, static_cast<uint16_t>(value));
+            }
+        }
+        if (mask & SnapshotField::ROTATION) {
+            p = putUint16(p, state.yaw);
+            p = putUint16(p, static_cast<uint16_t>(state.pitch));
+        }
+        if (mask & SnapshotField::HEALTH) p = putUint16(p, state.health);
+        if (mask & SnapshotField::RESOURCE) p = putUint16(p, state.resource);
+        return p;
+    }
+}
+
+QuantizedPlayerState QuantizedPlayerState::quantize(uint32_t playerId, const glm::vec3& position,
+                                                    const glm::vec3& velocity, float yaw, float pitch,
+                                                    float health, float resource) {
+    QuantizedPlayerState state;
+    state.playerId = playerId;
+    for (int axis = 0; axis < 3; ++axis) {
+        state.position[axis] = quantizeClamped<int32_t>(position[axis], POSITION_SCALE);
+        state.velocity[axis] = quantizeClamped<int16_t>(velocity[axis], VELOCITY_SCALE);
+    }
+
+    // Any yaw, wrapped to [0, 360)
+    float wrapped = std::isfinite(yaw) ? std::fmod(yaw, 360.0f) : 0.0f;
+    if (wrapped < 0.0f) {
+        wrapped += 360.0f;
+    }
+    state.yaw = static_cast<uint16_t>(static_cast<uint32_t>(std::round(wrapped * YAW_SCALE)) & 0xFFFF);
+    state.pitch = quantizeClamped<int16_t>(pitch, PITCH_SCALE);
+    state.health = quantizeClamped<uint16_t>(health, STAT_SCALE);
+    state.resource = quantizeClamped<uint16_t>(resource, STAT_SCALE);
+    return state;
+}
+
+glm::vec3 QuantizedPlayerState::getPosition() const {
+    return glm::vec3(static_cast<float>(position[0]), static_cast<float>(position[1]),
+                     static_cast<float>(position[2])) / POSITION_SCALE;
+}
+
+glm::vec3 QuantizedPlayerState::getVelocity() const {
+    return glm::vec3(static_cast<float>(velocity[0]), static_cast<float>(velocity[1]),
+                     static_cast<float>(velocity[2])) / VELOCITY_SCALE;
+}
+
+float QuantizedPlayerState::getYaw() const { return static_cast<float>(yaw) / YAW_SCALE; }
+float QuantizedPlayerState::getPitch() const { return static_cast<float>(pitch) / PITCH_SCALE; }
+float QuantizedPlayerState::getHealth() const { return static_cast<float>(health) / STAT_SCALE; }
+float QuantizedPlayerState::getResource() const { return static_cast<float>(resource) / STAT_SCALE; }
+
+size_t encodePlayerSnapshot(uint32_t sequence, uint32_t baselineSequence, uint32_t serverTime,
+                            const PlayerSnapshotView* baseline, const PlayerSnapshotView& view,
+                            std::vector<uint8_t>& out) {
+    static const PlayerSnapshotView empty;
+    const PlayerSnapshotView& base = baseline ? *baseline : empty;
+
+    // Room for the worst case, trimmed at the end
+    size_t start = out.size();
+    out.resize(start + HEADER_SIZE + (view.size() + base.size()) * MAX_ENTRY_SIZE);
+    uint8_t* p = out.data() + start;
+    *p++ = static_cast<uint8_t>(MessageType::PLAYER_STATE_SNAPSHOT);
+    p = putUint32(p, sequence);
+    p = putUint32(p, baseline ? baselineSequence : 0);
+    p = putUint32(p, serverTime);
+    uint8_t* countField = p;
+    p += 2;
+
+    // Merge the two id-sorted lists
+    size_t count = 0;
+    size_t b = 0;
+    for (const auto& state : view) {
+        while (b < base.size() && base[b].playerId < state.playerId) {
+            p = putRemoved(p, base[b].playerId);
+            ++b;
+            ++count;
+        }
+        const QuantizedPlayerState* old = nullptr;
+        if (b < base.size() && base[b].playerId == state.playerId) {
+            old = &base[b];
+            ++b;
+        }
+        if (old && *old == state) {
+            continue;
+        }
+        p = putEntry(p, old, state);
+        ++count;
+    }
+    for (; b < base.size(); ++b) {
+        p = putRemoved(p, base[b].playerId);
+        ++count;
+    }
+
+    putUint16(countField, static_cast<uint16_t>(count));
+    out.resize(static_cast<size_t>(p - out.data()));
+    return count;
+}
+
+bool PlayerSnapshotDecoder::decode(const std::vector<uint8_t>& data) {
+    Reader reader{data, 0};
+    if (!reader.has(HEADER_SIZE) ||
+        data[0] != static_cast<uint8_t>(MessageType::PLAYER_STATE_SNAPSHOT)) {
+        return false;
+    }
+    reader.offset = 1;
+    uint32_t sequence = reader.readUint32();
+    uint32_t baselineSequence = reader.readUint32();
+    uint32_t serverTime = reader.readUint32();
+    uint16_t count = reader.readUint16();
+
+    static const PlayerSnapshotView empty;
+    const PlayerSnapshotView* base = &empty;
+    if (sequence == 0) {
+        return false;
+    }
+    if (baselineSequence != 0) {
+        if (baselineSequence >= sequence || sequence - baselineSequence >= WINDOW ||
+            m_sequences[baselineSequence % WINDOW] != baselineSequence) {
+            return false;
+        }
+        base = &m_views[baselineSequence % WINDOW];
+    }
+
+    PlayerSnapshotView view;
+    view.reserve(base->size() + count);
+    size_t b = 0;
+    uint32_t lastId = 0;
+    for (uint16_t i = 0; i < count; ++i) {
+        if (!reader.has(5)) {
+            return false;
+        }
+        uint32_t playerId = reader.readUint32();
+        uint8_t mask = data[reader.offset++];
+        if ((i > 0 && playerId <= lastId) ||
+            (mask & (SnapshotField::POSITION | SnapshotField::POSITION_DELTA)) ==
+                (SnapshotField::POSITION | SnapshotField::POSITION_DELTA)) {
+            return false;
+        }
+        lastId = playerId;
+
+        // Unchanged players between the previous entry and this one
+        while (b < base->size() && (*base)[b].playerId < playerId) {
+            view.push_back((*base)[b++]);
+        }
+        const QuantizedPlayerState* old = nullptr;
+        if (b < base->size() && (*base)[b].playerId == playerId) {
+            old = &(*base)[b++];
+        }
+
+        if (mask & SnapshotField::REMOVED) {
+            if (!old) {
+                return false;
+            }
+            continue;
+        }
+
+        // A new player has to come with everything
+        constexpr uint8_t FULL = SnapshotField::POSITION | SnapshotField::VELOCITY | SnapshotField::ROTATION |
+                                 SnapshotField::HEALTH | SnapshotField::RESOURCE;
+        if (!old && (mask & FULL) != FULL) {
+            return false;
+        }
+
+        QuantizedPlayerState state = old ? *old : QuantizedPlayerState{};
+        state.playerId = playerId;
+        if (mask & SnapshotField::POSITION) {
+            if (!reader.has(12)) return false;
+            for (auto& value : state.position) {
+                value = static_cast<int32_t>(reader.readUint32());
+            }
+        }
+        if (mask & SnapshotField::POSITION_DELTA) {
+            if (!reader.has(6)) return false;
+            for (auto& value : state.position) {
+                value += static_cast<int16_t>(reader.readUint16());
+            }
+        }
+        if (mask & SnapshotField::VELOCITY) {
+            if (!reader.has(6)) return false;
+            for (auto& value : state.velocity) {
+                value = static_cast<int16_t>(reader.readUint16());
+            }
+        }
+        if (mask & SnapshotField::ROTATION) {
+            if (!reader.has(4)) return false;
+            state.yaw = reader.readUint16();
+            state.pitch = static_cast<int16_t>(reader.readUint16());
+        }
+        if (mask & SnapshotField::HEALTH) {
+            if (!reader.has(2)) return false;
+            state.health = reader.readUint16();
+        }
+        if (mask & SnapshotField::RESOURCE) {
+            if (!reader.has(2)) return false;
+            state.resource = reader.readUint16();
+        }
+        view.push_back(state);
+    }
+    while (b < base->size()) {
+        view.push_back((*base)[b++]);
+    }
+
+    m_views[sequence % WINDOW] = std::move(view);
+    m_sequences[sequence % WINDOW] = sequence;
+    m_sequence = sequence;
+    m_serverTime = serverTime;
+    return true;
+}
+
+} // namespace network
+} // namespace clonemine
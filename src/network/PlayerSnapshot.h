@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace clonemine {
+namespace network {
+
+// Player state as it goes over the wire, quantised so that equal values
+// compare equal and unchanged fields can be left out of a delta
+struct QuantizedPlayerState {
+    static constexpr float POSITION_SCALE = 64.0f;   // 1/64 block
+    static constexpr float VELOCITY_SCALE = 128.0f;  // 1/128 block per second, up to 256
+    static constexpr float YAW_SCALE = 65536.0f / 360.0f;
+    static constexpr float PITCH_SCALE = 256.0f;     // 1/256 degree
+    static constexpr float STAT_SCALE = 10.0f;       // Health and resource in tenths, up to 6553
+
+    uint32_t playerId{0};
+    std::array<int32_t, 3> position{};
+    std::array<int16_t, 3> velocity{};
+    uint16_t yaw{0};
+    int16_t pitch{0};
+    uint16_t health{0};
+    uint16_t resource{0};
+
+    static QuantizedPlayerState quantize(uint32_t playerId, const glm::vec3& position, const glm::vec3& velocity,
+                                         float yaw, float pitch, float health, float resource);
+
+    glm::vec3 getPosition() const;
+    glm::vec3 getVelocity() const;
+    float getYaw() const;
+    float getPitch() const;
+    float getHealth() const;
+    float getResource() const;
+
+    bool operator==(const QuantizedPlayerState&) const = default;
+};
+
+// One recipient's view of the other players, sorted by playerId
+using PlayerSnapshotView = std::vector<QuantizedPlayerState>;
+
+// PLAYER_STATE_SNAPSHOT: the recipient's whole view, written as a delta
+// against an earlier snapshot the client acknowledged (or against nothing).
+//
+//   type, sequence (u32), baseline sequence (u32, 0 = none),
+//   server time ms (u32), entry count (u16), then per entry:
+//   playerId (u32), field mask (u8), the fields in mask order
+//
+// Players in the baseline but missing from the view are sent as REMOVED;
+// players whose quantised state matches the baseline are left out.
+namespace SnapshotField {
+    constexpr uint8_t REMOVED = 0x01;
+    constexpr uint8_t POSITION = 0x02;        // 3 x i32
+    constexpr uint8_t POSITION_DELTA = 0x04;  // 3 x i16 from the baseline position
+    constexpr uint8_t VELOCITY = 0x08;        // 3 x i16
+    constexpr uint8_t ROTATION = 0x10;        // u16 yaw, i16 pitch
+    constexpr uint8_t HEALTH = 0x20;          // u16
+    constexpr uint8_t RESOURCE = 0x40;        // u16
+}
+
+// Appends the message to out; returns the number of entries written
+size_t encodePlayerSnapshot(uint32_t sequence, uint32_t baselineSequence, uint32_t serverTime,
+                            const PlayerSnapshotView* baseline, const PlayerSnapshotView& view,
+                            std::vector<uint8_t>& out);
+
+// Client side: rebuilds each view from the snapshots it kept. Holds as
+// many snapshots as the server may use as a baseline.
+class PlayerSnapshotDecoder {
+public:
+    static constexpr uint32_t WINDOW = 32;
+
+    // False for a malformed message or an unknown baseline
+    bool decode(const std::vector<uint8_t>& data);
+
+    // The last decoded snapshot, which the client should acknowledge
+    uint32_t getSequence() const { return m_sequence; }
+    uint32_t getServerTime() const { return m_serverTime; }
+    const PlayerSnapshotView& getView() const { return m_views[m_sequence % WINDOW]; }
+
+private:
+    std::array<PlayerSnapshotView, WINDOW> m_views;
+    std::array<uint32_t, WINDOW> m_sequences{};
+    uint32_t m_sequence{0};
+    uint32_t m_serverTime{0};
+};
+
+} // namespace network
+} // namespace clonemine
@@ -0,0 +1,136 @@
+#include "SharedPacket.h"
+#include <array>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace clonemine {
+namespace network {
+
+// Header in front of the payload
+struct SharedPacket::Block {
+    std::atomic<uint32_t> refs;
+    uint32_t size;
+    uint32_t sizeClass;
+
+    uint8_t* payload() { return reinterpret_cast<uint8_t*>(this + 1); }
+};
+
+namespace {
+    // Payload capacities; larger packets go straight to the heap
+    constexpr std::array<size_t, 6> SLAB_SIZES{128, 512, 2048, 8192, 32768, 131072};
+    constexpr uint32_t NO_SLAB = SLAB_SIZES.size();
+
+    // Free blocks kept per slab; the rest go back to the heap
+    constexpr size_t MAX_FREE_BLOCKS = 256;
+
+    // Blocks are allocated on the tick thread and released on io threads
+    struct Slab {
+        std::mutex mutex;
+        std::vector<void*> free;
+    };
+
+    std::array<Slab, SLAB_SIZES.size()>& getSlabs() {
+        // Never destroyed, so packets released during shutdown are safe
+        static auto* slabs = new std::array<Slab, SLAB_SIZES.size()>();
+        return *slabs;
+    }
+
+    uint32_t findSizeClass(size_t size) {
+        for (uint32_t i = 0; i < SLAB_SIZES.size(); ++i) {
+            if (size <= SLAB_SIZES[i]) {
+                return i;
+            }
+        }
+        return NO_SLAB;
+    }
+
+    void* allocateBlock(uint32_t sizeClass, size_t size) {
+        if (sizeClass == NO_SLAB) {
+            return ::operator new(sizeof(SharedPacket::Block) + size);
+        }
+        Slab& slab = getSlabs()[sizeClass];
+        {
+            std::lock_guard<std::mutex> lock(slab.mutex);
+            if (!slab.free.empty()) {
+                void* memory = slab.free.back();
+                slab.free.pop_back();
+                return memory;
+            }
+        }
+        return ::operator new(sizeof(SharedPacket::Block) + SLAB_SIZES[sizeClass]);
+    }
+
+    void freeBlock(SharedPacket::Block* block) {
+        uint32_t sizeClass = block->sizeClass;
+        block->~Block();
+        if (sizeClass != NO_SLAB) {
+            Slab& slab = getSlabs()[sizeClass];
+            std::lock_guard<std::mutex> lock(slab.mutex);
+            if (slab.free.size() < MAX_FREE_BLOCKS) {
+                slab.free.push_back(block);
+                return;
+            }
+        }
+        ::operator delete(block);
+    }
+}
+
+SharedPacket SharedPacket::create(const uint8_t* data, size_t size) {
+    uint32_t sizeClass = findSizeClass(size);
+    auto* block = new (allocateBlock(sizeClass, size)) Block{{1}, static_cast<uint32_t>(size), sizeClass};
+    if (size > 0) {
+        std::memcpy(block->payload(), data, size);
+    }
+    return SharedPacket(block);
+}
+
+SharedPacket::SharedPacket(const SharedPacket& other) noexcept : m_block(other.m_block) {
+    if (m_block) {
+        m_block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+SharedPacket& SharedPacket::operator=(const SharedPacket& other) noexcept {
+    if (m_block != other.m_block) {
+        release();
+        m_block = other.m_block;
+        if (m_block) {
+            m_block->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return *this;
+}
+
+SharedPacket& SharedPacket::operator=(SharedPacket&& other) noexcept {
+    if (this != &other) {
+        release();
+        m_block = other.m_block;
+        other.m_block = nullptr;
+    }
+    return *this;
+}
+
+void SharedPacket::release() noexcept {
+    // The last holder frees the block once every other holder's reads are done
+    if (m_block && m_block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        freeBlock(m_block);
+    }
+    m_block = nullptr;
+}
+
+const uint8_t* SharedPacket::data() const noexcept {
+    return m_block ? m_block->payload() : nullptr;
+}
+
+size_t SharedPacket::size() const noexcept {
+    return m_block ? m_block->size : 0;
+}
+
+uint32_t SharedPacket::useCount() const noexcept {
+    return m_block ? m_block->refs.load(std::memory_order_relaxed) : 0;
+}
+
+} // namespace network
+} // namespace clonemine
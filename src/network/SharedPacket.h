@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace clonemine {
+namespace network {
+
+// An immutable, reference-counted message body that any number of
+// recipients can queue without copying it.
+//
+// The reference count and size sit in a small header directly in front
+// of the payload, in one block taken from a size-class slab; released
+// blocks go back to their slab instead of the heap. Copies share the
+// block and are safe to release from any thread.
+class SharedPacket {
+public:
+    SharedPacket() = default;
+    ~SharedPacket() { release(); }
+
+    SharedPacket(const SharedPacket& other) noexcept;
+    SharedPacket& operator=(const SharedPacket& other) noexcept;
+    SharedPacket(SharedPacket&& other) noexcept : m_block(other.m_block) { other.m_block = nullptr; }
+    SharedPacket& operator=(SharedPacket&& other) noexcept;
+
+    // The one copy of a serialized message
+    static SharedPacket create(const uint8_t* data, size_t size);
+    static SharedPacket create(std::span<const uint8_t> data) { return create(data.data(), data.size()); }
+
+    [[nodiscard]] const uint8_t* data() const noexcept;
+    [[nodiscard]] size_t size() const noexcept;
+    [[nodiscard]] bool empty() const noexcept { return size() == 0; }
+    uint8_t operator[](size_t index) const noexcept { return data()[index]; }
+
+    // Holders of this block, for tests and stats
+    [[nodiscard]] uint32_t useCount() const noexcept;
+
+    struct Block;
+
+private:
+    explicit SharedPacket(Block* block) noexcept : m_block(block) {}
+    void release() noexcept;
+
+    Block* m_block = nullptr;
+};
+
+} // namespace network
+} // namespace clonemine
@@ -0,0 +1,13 @@
+#include "WireCodec.h"
+
+namespace clonemine {
+namespace network {
+
+std::vector<uint8_t>& getScratchBuffer() {
+    // Grows to the thread's largest message and stays there
+    thread_local std::vector<uint8_t> buffer;
+    return buffer;
+}
+
+} // namespace network
+} // namespace clonemine
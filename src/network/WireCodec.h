@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace clonemine {
+namespace network {
+
+// Little-endian writer into a buffer the caller sized, usually with
+// wireSize(). Writes past the end are dropped and flag an overflow.
+class ByteWriter {
+public:
+    ByteWriter(uint8_t* data, size_t capacity) : m_data(data), m_capacity(capacity) {}
+
+    void writeUint8(uint8_t value) {
+        if (reserve(1)) {
+            m_data[m_offset++] = value;
+        }
+    }
+
+    void writeUint32(uint32_t value) {
+        if (!reserve(4)) {
+            return;
+        }
+        uint8_t* out = m_data + m_offset;
+        out[0] = static_cast<uint8_t>(value & 0xFF);
+        out[1] = static_cast<uint8_t>((value >> 8) & 0xFF);
+        out[2] = static_cast<uint8_t>((value >> 16) & 0xFF);
+        out[3] = static_cast<uint8_t>((value >> 24) & 0xFF);
+        m_offset += 4;
+    }
+
+    void writeFloat(float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(float));
+        writeUint32(bits);
+    }
+
+    void writeBytes(const void* data, size_t size) {
+        if (size > 0 && reserve(size)) {
+            std::memcpy(m_data + m_offset, data, size);
+            m_offset += size;
+        }
+    }
+
+    size_t getOffset() const { return m_offset; }
+    bool hasOverflowed() const { return m_overflowed; }
+
+private:
+    bool reserve(size_t size) {
+        if (m_overflowed || size > m_capacity - m_offset) {
+            m_overflowed = true;
+            return false;
+        }
+        return true;
+    }
+
+    uint8_t* m_data;
+    size_t m_capacity;
+    size_t m_offset{0};
+    bool m_overflowed{false};
+};
+
+// Little-endian reader over a received message; every read checks the
+// bytes are there and fails, reading nothing, if not
+class ByteReader {
+public:
+    explicit ByteReader(std::span<const uint8_t> data) : m_data(data) {}
+
+    bool readUint8(uint8_t& value) {
+        if (getRemaining() < 1) {
+            return false;
+        }
+        value = m_data[m_offset++];
+        return true;
+    }
+
+    bool readUint32(uint32_t& value) {
+        if (getRemaining() < 4) {
+            return false;
+        }
+        const uint8_t* in = m_data.data() + m_offset;
+        value = in[0] | (in[1] << 8) | (in[2] << 16) | (static_cast<uint32_t>(in[3]) << 24);
+        m_offset += 4;
+        return true;
+    }
+
+    bool readFloat(float& value) {
+        uint32_t bits;
+        if (!readUint32(bits)) {
+            return false;
+        }
+        std::memcpy(&value, &bits, sizeof(float));
+        return true;
+    }
+
+    // A view of the next size bytes, not a copy
+    bool readBytes(size_t size, std::span<const uint8_t>& bytes) {
+        if (getRemaining() < size) {
+            return false;
+        }
+        bytes = m_data.subspan(m_offset, size);
+        m_offset += size;
+        return true;
+    }
+
+    size_t getRemaining() const { return m_data.size() - m_offset; }
+
+private:
+    std::span<const uint8_t> m_data;
+    size_t m_offset{0};
+};
+
+// How one field type goes on the wire. View is what decoding yields:
+// the value itself, or for strings a view into the received bytes.
+template <typename T>
+struct WireField;
+
+template <>
+struct WireField<bool> {
+    using View = bool;
+    static constexpr size_t MIN_SIZE = 1;
+    static size_t size(bool) { return 1; }
+    static void write(ByteWriter& writer, bool value) { writer.writeUint8(value ? 1 : 0); }
+    static bool read(ByteReader& reader, bool& value) {
+        uint8_t byte;
+        if (!reader.readUint8(byte)) {
+            return false;
+        }
+        value = byte != 0;
+        return true;
+    }
+};
+
+template <>
+struct WireField<uint32_t> {
+    using View = uint32_t;
+    static constexpr size_t MIN_SIZE = 4;
+    static size_t size(uint32_t) { return 4; }
+    static void write(ByteWriter& writer, uint32_t value) { writer.writeUint32(value); }
+    static bool read(ByteReader& reader, uint32_t& value) { return reader.readUint32(value); }
+};
+
+template <>
+struct WireField<float> {
+    using View = float;
+    static constexpr size_t MIN_SIZE = 4;
+    static size_t size(float) { return 4; }
+    static void write(ByteWriter& writer, float value) { writer.writeFloat(value); }
+    static bool read(ByteReader& reader, float& value) { return reader.readFloat(value); }
+};
+
+template <>
+struct WireField<glm::vec3> {
+    using View = glm::vec3;
+    static constexpr size_t MIN_SIZE = 12;
+    static size_t size(const glm::vec3&) { return 12; }
+    static void write(ByteWriter& writer, const glm::vec3& value) {
+        writer.writeFloat(value.x);
+        writer.writeFloat(value.y);
+        writer.writeFloat(value.z);
+    }
+    static bool read(ByteReader& reader, glm::vec3& value) {
+        return reader.readFloat(value.x) && reader.readFloat(value.y) && reader.readFloat(value.z);
+    }
+};
+
+// 32-bit length, then the bytes
+template <>
+struct WireField<std::string> {
+    using View = std::string_view;
+    static constexpr size_t MIN_SIZE = 4;
+    static size_t size(const std::string& value) { return 4 + value.size(); }
+    static void write(ByteWriter& writer, const std::string& value) {
+        writer.writeUint32(static_cast<uint32_t>(value.size()));
+        writer.writeBytes(value.data(), value.size());
+    }
+    static bool read(ByteReader& reader, std::string_view& value) {
+        uint32_t length;
+        std::span<const uint8_t> bytes;
+        if (!reader.readUint32(length) || !reader.readBytes(length, bytes)) {
+            return false;
+        }
+        value = std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        return true;
+    }
+};
+
+// A message's wire layout, declared once next to the message: its type
+// byte, then its fields in wire order as member pointers. For example
+//
+//   template <>
+//   struct WireSchema<ChatMessage> {
+//       static constexpr MessageType type = MessageType::CHAT_MESSAGE;
+//       static constexpr std::tuple fields{&ChatMessage::sender, &ChatMessage::message};
+//   };
+template <typename Message>
+struct WireSchema;
+
+namespace detail {
+    template <typename Pointer>
+    struct MemberType;
+
+    template <typename Class, typename T>
+    struct MemberType<T Class::*> {
+        using type = T;
+    };
+
+    template <typename Fields>
+    struct FieldTypes;
+
+    template <typename... Pointers>
+    struct FieldTypes<std::tuple<Pointers...>> {
+        using Values = std::tuple<typename MemberType<Pointers>::type...>;
+        using Views = std::tuple<typename WireField<typename MemberType<Pointers>::type>::View...>;
+        static constexpr size_t MIN_SIZE = (size_t{0} + ... + WireField<typename MemberType<Pointers>::type>::MIN_SIZE);
+    };
+
+    template <typename Message>
+    using SchemaFields = FieldTypes<std::remove_cv_t<decltype(WireSchema<Message>::fields)>>;
+
+    template <typename Message, size_t... I>
+    bool readFields(ByteReader& reader, typename SchemaFields<Message>::Views& view, std::index_sequence<I...>) {
+        using Values = typename SchemaFields<Message>::Values;
+        return (WireField<std::tuple_element_t<I, Values>>::read(reader, std::get<I>(view)) && ...);
+    }
+
+    template <typename Message, size_t... I>
+    void assignFields(Message& message, const typename SchemaFields<Message>::Views& view, std::index_sequence<I...>) {
+        using Values = typename SchemaFields<Message>::Values;
+        ((message.*std::get<I>(WireSchema<Message>::fields) = std::tuple_element_t<I, Values>(std::get<I>(view))), ...);
+    }
+}
+
+// A decoded message's fields in schema order; bind them with
+// auto& [sender, message] = view
+template <typename Message>
+using MessageView = typename detail::SchemaFields<Message>::Views;
+
+// Smallest valid encoding: the type byte, fixed fields and empty strings
+template <typename Message>
+constexpr size_t minWireSize() {
+    return 1 + detail::SchemaFields<Message>::MIN_SIZE;
+}
+
+template <typename Message>
+size_t wireSize(const Message& message) {
+    return std::apply([&message](auto... fields) {
+        return (size_t{1} + ... + WireField<std::remove_cvref_t<decltype(message.*fields)>>::size(message.*fields));
+    }, WireSchema<Message>::fields);
+}
+
+template <typename Message>
+void writeMessage(ByteWriter& writer, const Message& message) {
+    writer.writeUint8(static_cast<uint8_t>(WireSchema<Message>::type));
+    std::apply([&writer, &message](auto... fields) {
+        (WireField<std::remove_cvref_t<decltype(message.*fields)>>::write(writer, message.*fields), ...);
+    }, WireSchema<Message>::fields);
+}
+
+// Appends to out with a single resize; reusing out keeps its capacity
+template <typename Message>
+void appendMessage(const Message& message, std::vector<uint8_t>& out) {
+    size_t offset = out.size();
+    size_t size = wireSize(message);
+    out.resize(offset + size);
+    ByteWriter writer(out.data() + offset, size);
+    writeMessage(writer, message);
+}
+
+template <typename Message>
+std::vector<uint8_t> encodeMessage(const Message& message) {
+    std::vector<uint8_t> buffer;
+    appendMessage(message, buffer);
+    return buffer;
+}
+
+// This thread's reusable encode buffer
+std::vector<uint8_t>& getScratchBuffer();
+
+// Encodes into this thread's scratch buffer, valid until the thread's
+// next encodeScratch; for messages copied straight on, e.g. into a
+// SharedPacket, so nothing is allocated once the buffer has grown
+template <typename Message>
+std::span<const uint8_t> encodeScratch(const Message& message) {
+    std::vector<uint8_t>& buffer = getScratchBuffer();
+    buffer.clear();
+    appendMessage(message, buffer);
+    return buffer;
+}
+
+// Decodes without copying: strings in view point into data, which must
+// outlive it. Fails on the wrong type byte or a truncated field; bytes
+// after the last field are ignored.
+template <typename Message>
+bool decodeView(std::span<const uint8_t> data, MessageView<Message>& view) {
+    ByteReader reader(data);
+    uint8_t type;
+    if (!reader.readUint8(type) || type != static_cast<uint8_t>(WireSchema<Message>::type)) {
+        return false;
+    }
+    return detail::readFields<Message>(reader, view, std::make_index_sequence<std::tuple_size_v<MessageView<Message>>>());
+}
+
+// Decodes into an owning message, copying its strings
+template <typename Message>
+bool decodeMessage(std::span<const uint8_t> data, Message& message) {
+    MessageView<Message> view;
+    if (!decodeView<Message>(data, view)) {
+        return false;
+    }
+    detail::assignFields(message, view, std::make_index_sequence<std::tuple_size_v<MessageView<Message>>>());
+    return true;
+}
+
+} // namespace network
+} // namespace clonemine
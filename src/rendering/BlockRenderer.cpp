@@ -1,265 +1,597 @@
 #include "BlockRenderer.h"
+#include "Frustum.h"
+#include <algorithm>
+#include <cstddef>
 #include <cstring>
+#include <iostream>
 
 namespace clonemine {
 
-BlockRenderer::BlockRenderer(VkDevice device, VkPhysicalDevice physicalDevice)
-    : m_device(device), m_physicalDevice(physicalDevice) {
+namespace {
+    // Chunk offset across each horizontal face (0=+Z, 1=-Z, 2=-X, 3=+X)
+    const glm::ivec3 FACE_OFFSETS[ChunkMesher::HORIZONTAL_FACES] = {
+        {0, 0, 1}, {0, 0, -1}, {-1, 0, 0}, {1, 0, 0}
+    };
+    
+    // World block ids (ChunkManager's BlockType) -> render block types
+    constexpr std::array<BlockType, WORLD_BLOCK_ID_COUNT> WORLD_BLOCK_TYPES = {
+        BlockType::AIR,         // AIR
+        BlockType::STONE,       // STONE
+        BlockType::DIRT,        // DIRT
+        BlockType::GRASS,       // GRASS
+        BlockType::WOOD,        // WOOD
+        BlockType::SAND,        // SAND
+        BlockType::COBBLESTONE, // GRAVEL
+        BlockType::WATER,       // WATER
+        BlockType::LAVA,        // LAVA
+        BlockType::GLASS,       // GLASS
+        BlockType::OBSIDIAN,    // OBSIDIAN
+        BlockType::GOLD_ORE,    // GOLD_ORE
+        BlockType::DIAMOND_ORE, // DIAMOND_ORE
+        BlockType::STONE,       // IRON_ORE
+        BlockType::STONE,       // COAL_ORE
+        BlockType::OBSIDIAN,    // BEDROCK
+        BlockType::ICE          // SNOW
+    };
+}
+
+BlockRenderer::BlockRenderer(VkDevice device, GpuMemoryArena& arena, const IndirectDrawFeatures& drawFeatures,
+                             unsigned meshWorkers)
+    : m_device(device),
+      m_meshJobs(std::make_unique<MeshJobSystem>(meshWorkers)),
+      m_stagingRing(std::make_unique<StagingRing>(device, arena, STAGING_RING_SIZE, FRAMES_IN_FLIGHT)),
+      m_meshHeap(std::make_unique<GpuBufferHeap>(device, arena, MESH_HEAP_SIZE,
+                                                 VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, FRAMES_IN_FLIGHT)),
+      m_cullPass(std::make_unique<ChunkCullPass>(device, arena, drawFeatures, MAX_CULLED_CHUNKS,
+                                                 FRAMES_IN_FLIGHT, "shaders/chunk_cull.comp.spv")) {
 }
 
 BlockRenderer::~BlockRenderer() {
-    for (auto& [pos, mesh] : m_chunkMeshes) {
-        destroyChunkMesh(mesh);
+    // Stop the workers before the meshes they might still report on go away;
+    // the heap releases every chunk's range at once
+    m_meshJobs.reset();
+}
+
+void BlockRenderer::buildChunkMesh(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks, ChunkMesh& mesh,
+                                   uint16_t sectionMask) {
+    meshChunk(m_meshingMode, chunkPos, blocks, mesh, sectionMask);
+}
+
+void BlockRenderer::greedyMesh(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks, ChunkMesh& mesh,
+                               uint16_t sectionMask) {
+    meshChunk(MeshingMode::Greedy, chunkPos, blocks, mesh, sectionMask);
+}
+
+void BlockRenderer::meshChunk(MeshingMode mode, const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+                              ChunkMesh& mesh, uint16_t sectionMask) {
+    const int lodLevel = selectLodLevel(chunkPos, mesh.pendingLodLevel);
+    const std::vector<BlockType>* source = &blocks;
+    if (lodLevel > 0) {
+        ChunkMesher::downsample(blocks, lodLevel, m_lodBlocks);
+        source = &m_lodBlocks;
+    }
+    
+    auto edges = std::make_shared<ChunkEdges>();
+    for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+        ChunkMesher::extractBorder(*source, face, (*edges)[face]);
+    }
+    mesh.edges = std::move(edges);
+    mesh.sectionMask = sectionMask;
+    mesh.lodLevel = mesh.pendingLodLevel = lodLevel;
+    
+    mesh.parts.setFormat(m_vertexFormat);
+    m_mesher.build(mode, chunkPos, *source, sectionMask, getNeighborBorders(chunkPos, lodLevel), mesh.parts,
+                   lodLevel);
+    mesh.parts.assemble(mesh.geometry, mesh.sections);
+    mesh.needsRebuild = false;
+    
+    // Only meshes the renderer tracks get GPU buffers; this build also
+    // supersedes any snapshot still being meshed in the background
+    auto it = m_chunkMeshes.find(chunkPos);
+    if (it != m_chunkMeshes.end() && &it->second == &mesh) {
+        mesh.version++;
+        queueUpload(chunkPos, mesh);
     }
 }
 
-void BlockRenderer::buildChunkMesh(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks, ChunkMesh& mesh) {
-    mesh.vertices.clear();
-    mesh.indices.clear();
-    
-    constexpr int CHUNK_SIZE = 16;
-    constexpr int CHUNK_HEIGHT = 256;
-    
-    // Iterate through all blocks in chunk
-    for (int x = 0; x < CHUNK_SIZE; ++x) {
-        for (int y = 0; y < CHUNK_HEIGHT; ++y) {
-            for (int z = 0; z < CHUNK_SIZE; ++z) {
-                int idx = x + z * CHUNK_SIZE + y * CHUNK_SIZE * CHUNK_SIZE;
-                BlockType type = blocks[idx];
-                
-                if (type == BlockType::AIR) continue;
-                
-                glm::vec3 blockPos(
-                    chunkPos.x * CHUNK_SIZE + x,
-                    y,
-                    chunkPos.z * CHUNK_SIZE + z
-                );
-                
-                // Check each face (0=front, 1=back, 2=left, 3=right, 4=top, 5=bottom)
-                for (int face = 0; face < 6; ++face) {
-                    if (shouldRenderFace(blocks, x, y, z, face)) {
-                        // Simple lighting based on face direction and height
-                        float light = (face == 4) ? 1.0f : 0.7f + (y / 256.0f) * 0.3f;
-                        addFace(mesh, blockPos, face, type, light);
-                    }
+void BlockRenderer::rebuildBorder(const glm::ivec3& chunkPos, ChunkMesh& mesh, int face) {
+    ChunkNeighborBorders neighbors = getNeighborBorders(chunkPos, mesh.lodLevel);
+    m_mesher.buildBorder(m_meshingMode, chunkPos, face, (*mesh.edges)[face], neighbors.slices[face],
+                         mesh.sectionMask, mesh.parts.borders[face], mesh.lodLevel);
+    m_borderRemeshCount++;
+}
+
+void BlockRenderer::remeshBorder(const glm::ivec3& chunkPos, ChunkMesh& mesh, int face) {
+    rebuildBorder(chunkPos, mesh, face);
+    mesh.parts.assemble(mesh.geometry, mesh.sections);
+    queueUpload(chunkPos, mesh);
+}
+
+void BlockRenderer::remeshNeighborBorders(const glm::ivec3& chunkPos, const ChunkEdges* oldEdges,
+                                          const ChunkEdges& newEdges) {
+    // Neighbours only need the border that touches an edge which changed
+    for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+        if (oldEdges && (*oldEdges)[face] == newEdges[face]) continue;
+        
+        auto neighbor = m_chunkMeshes.find(chunkPos + FACE_OFFSETS[face]);
+        if (neighbor != m_chunkMeshes.end() && neighbor->second.edges) {
+            remeshBorder(neighbor->first, neighbor->second, ChunkMesher::oppositeFace(face));
+        }
+    }
+}
+
+ChunkEdgesPtr BlockRenderer::getNeighborEdges(const glm::ivec3& chunkPos, int face, int lodLevel) const {
+    auto it = m_chunkMeshes.find(chunkPos + FACE_OFFSETS[face]);
+    return it != m_chunkMeshes.end() && it->second.lodLevel == lodLevel ? it->second.edges : nullptr;
+}
+
+ChunkNeighborBorders BlockRenderer::getNeighborBorders(const glm::ivec3& chunkPos, int lodLevel) const {
+    // Chunks still waiting for their first mesh count as not loaded, and so
+    // do chunks on another level: their edges are sampled differently
+    ChunkNeighborBorders neighbors;
+    for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+        auto it = m_chunkMeshes.find(chunkPos + FACE_OFFSETS[face]);
+        if (it != m_chunkMeshes.end() && it->second.edges && it->second.lodLevel == lodLevel) {
+            neighbors.slices[face] = &(*it->second.edges)[ChunkMesher::oppositeFace(face)];
+        }
+    }
+    return neighbors;
+}
+
+int BlockRenderer::selectLodLevel(const glm::ivec3& chunkPos, int currentLevel) const {
+    const float centerX = (chunkPos.x + 0.5f) * ChunkMesher::CHUNK_SIZE;
+    const float centerZ = (chunkPos.z + 0.5f) * ChunkMesher::CHUNK_SIZE;
+    const float distance = glm::length(glm::vec2(centerX - m_lodCenter.x, centerZ - m_lodCenter.z));
+    
+    auto levelAt = [this](float d) {
+        int level = 0;
+        for (float start = m_lodDistance; level < m_maxLodLevel && d >= start; start *= 2.0f) {
+            level++;
+        }
+        return level;
+    };
+    
+    // Near a ring edge keep the current level, so walking along the edge
+    // does not remesh chunks back and forth
+    if (currentLevel >= levelAt(distance - LOD_HYSTERESIS) && currentLevel <= levelAt(distance + LOD_HYSTERESIS)) {
+        return currentLevel;
+    }
+    return levelAt(distance);
+}
+
+void BlockRenderer::setLodDistance(float firstDistance, int maxLevel) {
+    m_lodDistance = std::max(0.0f, firstDistance);
+    m_maxLodLevel = std::clamp(maxLevel, 0, ChunkMesher::MAX_LOD_LEVEL);
+}
+
+void BlockRenderer::collectLodChanges(const glm::vec3& cameraPos, std::vector<glm::ivec3>& changed) {
+    m_lodCenter = cameraPos;
+    changed.clear();
+    for (const auto& [pos, mesh] : m_chunkMeshes) {
+        if (selectLodLevel(pos, mesh.pendingLodLevel) != mesh.pendingLodLevel) {
+            changed.push_back(pos);
+        }
+    }
+}
+
+int BlockRenderer::getLodLevel(const glm::ivec3& chunkPos) const {
+    auto it = m_chunkMeshes.find(chunkPos);
+    return it != m_chunkMeshes.end() ? it->second.lodLevel : 0;
+}
+
+void BlockRenderer::queueUpload(const glm::ivec3& chunkPos, ChunkMesh& mesh) {
+    if (!mesh.uploadQueued) {
+        mesh.uploadQueued = true;
+        m_uploadQueue.push_back(chunkPos);
+    }
+}
+
+void BlockRenderer::applyMeshResult(MeshJobResult& result) {
+    auto it = m_chunkMeshes.find(result.chunkPos);
+    if (it == m_chunkMeshes.end() || it->second.version != result.version) {
+        m_staleResults++;
+        return;
+    }
+    
+    ChunkMesh& mesh = it->second;
+    ChunkEdgesPtr oldEdges = std::move(mesh.edges);
+    const bool levelChanged = mesh.lodLevel != result.lodLevel;
+    mesh.parts = std::move(result.parts);
+    mesh.edges = std::move(result.edges);
+    mesh.sectionMask = result.sectionMask;
+    mesh.lodLevel = result.lodLevel;
+    mesh.needsRebuild = false;
+    
+    // Neighbours that changed while the job ran make its borders out of date
+    for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+        if (getNeighborEdges(result.chunkPos, face, mesh.lodLevel) != result.neighbors[face]) {
+            rebuildBorder(result.chunkPos, mesh, face);
+        }
+    }
+    mesh.parts.assemble(mesh.geometry, mesh.sections);
+    queueUpload(result.chunkPos, mesh);
+    
+    // After a level change every neighbour border pairs up differently
+    remeshNeighborBorders(result.chunkPos, levelChanged ? nullptr : oldEdges.get(), *mesh.edges);
+}
+
+void BlockRenderer::processMeshUpdates(VkCommandBuffer cmd, uint32_t frameSlot) {
+    // This slot's previous frame has finished on the GPU
+    m_meshHeap->beginFrame(frameSlot);
+    m_stagingRing->beginFrame(frameSlot);
+    
+    MeshJobResult result;
+    while (m_meshJobs->tryCollect(result)) {
+        applyMeshResult(result);
+    }
+    
+    bool barrierRecorded = false;
+    
+    // Unloads leave holes; compact once they fragment the heap badly. This
+    // runs before the uploads so no move reads a range copied this frame
+    if (m_defragRequested) {
+        // Freed ranges only become gaps once their frame retires, so keep
+        // checking until none are pending
+        GpuHeapStats heap = m_meshHeap->getStats();
+        VkDeviceSize moved = 0;
+        if (heap.ranges.getFragmentation() > DEFRAG_THRESHOLD) {
+            beginTransfers(cmd, barrierRecorded);
+            moved = m_meshHeap->defragment(cmd, m_uploadBudget);
+        }
+        m_defragRequested = moved > 0 || heap.retiredRanges > 0;
+        
+        // Moved meshes need their draws pointed at the new offsets
+        if (moved > 0) {
+            for (auto& [pos, mesh] : m_chunkMeshes) {
+                if (mesh.allocation.valid() && m_meshHeap->getOffset(mesh.allocation) != mesh.tableOffset) {
+                    writeSections(pos, mesh);
                 }
             }
         }
     }
     
-    // Create Vulkan buffers
-    if (!mesh.vertices.empty()) {
-        createVertexBuffer(mesh);
-        createIndexBuffer(mesh);
+    // Copy queued meshes until the budget is spent; the rest wait a frame
+    VkDeviceSize frameBytes = 0;
+    while (!m_uploadQueue.empty()) {
+        auto it = m_chunkMeshes.find(m_uploadQueue.front());
+        if (it == m_chunkMeshes.end() || !it->second.uploadQueued) {
+            m_uploadQueue.pop_front();
+            continue;
+        }
+        
+        ChunkMesh& mesh = it->second;
+        VkDeviceSize bytes = mesh.geometry.getVertexBytes() + mesh.geometry.getIndexBytes();
+        if (frameBytes > 0 && frameBytes + bytes > m_uploadBudget) break;
+        if (bytes > m_stagingRing->getCapacity() || bytes > m_meshHeap->getCapacity()) {
+            std::cerr << "Chunk mesh of " << bytes << " bytes does not fit the staging ring or mesh heap" << std::endl;
+            mesh.uploadQueued = false;
+            m_uploadQueue.pop_front();
+            continue;
+        }
+        if (!uploadMesh(cmd, mesh, barrierRecorded)) break;
+        writeSections(it->first, mesh);
+        
+        mesh.uploadQueued = false;
+        m_uploadQueue.pop_front();
+        frameBytes += bytes;
+        m_uploadedMeshes++;
     }
     
-    mesh.needsRebuild = false;
+    if (m_cullPass->hasTableUpdates()) {
+        beginTransfers(cmd, barrierRecorded);
+        m_cullPass->recordTableUpdates(cmd, *m_stagingRing);
+    }
+    
+    if (barrierRecorded) {
+        // Make the copies visible to this frame's culling and vertex fetch
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT |
+                                VK_ACCESS_SHADER_READ_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    }
+    
+    m_stagingRing->endFrame();
+    m_lastFrameBytes = frameBytes;
+    m_uploadedBytes += frameBytes;
 }
 
-bool BlockRenderer::shouldRenderFace(const std::vector<BlockType>& blocks, int x, int y, int z, int face) {
-    constexpr int CHUNK_SIZE = 16;
-    constexpr int CHUNK_HEIGHT = 256;
-    
-    int nx = x, ny = y, nz = z;
-    
-    // Calculate neighbor position based on face
-    switch (face) {
-        case 0: ++nz; break; // front
-        case 1: --nz; break; // back
-        case 2: --nx; break; // left
-        case 3: ++nx; break; // right
-        case 4: ++ny; break; // top
-        case 5: --ny; break; // bottom
+bool BlockRenderer::uploadMesh(VkCommandBuffer cmd, ChunkMesh& mesh, bool& barrierRecorded) {
+    const ChunkMeshData& geometry = mesh.geometry;
+    if (geometry.empty()) {
+        m_meshHeap->free(mesh.allocation);
+        mesh.indexCount = 0;
+        return true;
     }
     
-    // Check bounds
-    if (nx < 0 || nx >= CHUNK_SIZE || 
-        ny < 0 || ny >= CHUNK_HEIGHT || 
-        nz < 0 || nz >= CHUNK_SIZE) {
-        return true; // Render faces at chunk boundaries
+    const VkDeviceSize vertexBytes = geometry.getVertexBytes();
+    const VkDeviceSize indexBytes = geometry.getIndexBytes();
+    GpuHeapHandle allocation = m_meshHeap->allocate(vertexBytes + indexBytes, MESH_ALIGNMENT);
+    if (!allocation.valid()) {
+        // Retry next frame, once retired ranges are back or after compaction
+        m_defragRequested = true;
+        return false;
     }
     
-    int neighborIdx = nx + nz * CHUNK_SIZE + ny * CHUNK_SIZE * CHUNK_SIZE;
-    BlockType neighbor = blocks[neighborIdx];
-    
-    // Don't render face if neighbor is opaque
-    return !isSolid(neighbor) || isTransparent(neighbor);
-}
-
-void BlockRenderer::addFace(ChunkMesh& mesh, const glm::vec3& pos, int face, BlockType type, float light) {
-    uint32_t baseIdx = static_cast<uint32_t>(mesh.vertices.size());
-    
-    // Face vertices (positions relative to block)
-    glm::vec3 verts[4];
-    glm::vec3 normal;
-    
-    switch (face) {
-        case 0: // Front (+Z)
-            verts[0] = {0, 0, 1}; verts[1] = {1, 0, 1};
-            verts[2] = {1, 1, 1}; verts[3] = {0, 1, 1};
-            normal = {0, 0, 1};
-            break;
-        case 1: // Back (-Z)
-            verts[0] = {1, 0, 0}; verts[1] = {0, 0, 0};
-            verts[2] = {0, 1, 0}; verts[3] = {1, 1, 0};
-            normal = {0, 0, -1};
-            break;
-        case 2: // Left (-X)
-            verts[0] = {0, 0, 0}; verts[1] = {0, 0, 1};
-            verts[2] = {0, 1, 1}; verts[3] = {0, 1, 0};
-            normal = {-1, 0, 0};
-            break;
-        case 3: // Right (+X)
-            verts[0] = {1, 0, 1}; verts[1] = {1, 0, 0};
-            verts[2] = {1, 1, 0}; verts[3] = {1, 1, 1};
-            normal = {1, 0, 0};
-            break;
-        case 4: // Top (+Y)
-            verts[0] = {0, 1, 1}; verts[1] = {1, 1, 1};
-            verts[2] = {1, 1, 0}; verts[3] = {0, 1, 0};
-            normal = {0, 1, 0};
-            break;
-        case 5: // Bottom (-Y)
-            verts[0] = {0, 0, 0}; verts[1] = {1, 0, 0};
-            verts[2] = {1, 0, 1}; verts[3] = {0, 0, 1};
-            normal = {0, -1, 0};
-            break;
+    VkDeviceSize stagingOffset = 0;
+    void* mapped = nullptr;
+    if (!m_stagingRing->allocate(vertexBytes + indexBytes, MESH_ALIGNMENT, stagingOffset, mapped)) {
+        m_meshHeap->free(allocation);
+        return false;
     }
     
-    glm::vec2 texCoords = getTextureCoords(type, face);
-    float texSize = 1.0f / BLOCKS_PER_ROW;
+    const void* vertexData = geometry.format == VertexFormat::Packed
+        ? static_cast<const void*>(geometry.packedVertices.data())
+        : static_cast<const void*>(geometry.vertices.data());
+    std::memcpy(mapped, vertexData, vertexBytes);
+    std::memcpy(static_cast<uint8_t*>(mapped) + vertexBytes, geometry.indices.data(), indexBytes);
     
-    // Add 4 vertices for the face
-    for (int i = 0; i < 4; ++i) {
-        BlockVertex vertex;
-        vertex.position = pos + verts[i];
-        vertex.normal = normal;
-        vertex.lightLevel = light;
-        
-        // Texture coordinates
-        float u = texCoords.x + ((i == 1 || i == 2) ? texSize : 0.0f);
-        float v = texCoords.y + ((i >= 2) ? texSize : 0.0f);
-        vertex.texCoord = {u, v};
-        
-        mesh.vertices.push_back(vertex);
+    beginTransfers(cmd, barrierRecorded);
+    VkBufferCopy copy{stagingOffset, m_meshHeap->getOffset(allocation), vertexBytes + indexBytes};
+    vkCmdCopyBuffer(cmd, m_stagingRing->getBuffer(), m_meshHeap->getBuffer(), 1, &copy);
+    
+    // The old range stays readable until this frame slot comes round again
+    m_meshHeap->free(mesh.allocation);
+    mesh.allocation = allocation;
+    mesh.uploadedFormat = geometry.format;
+    mesh.indexOffset = vertexBytes;
+    mesh.indexCount = static_cast<uint32_t>(geometry.indices.size());
+    return true;
+}
+
+void BlockRenderer::writeSections(const glm::ivec3& chunkPos, ChunkMesh& mesh) {
+    // Indirect draws address the heap in packed vertices, so full-format
+    // meshes leave the cull table and are drawn per chunk instead
+    if (mesh.uploadedFormat == VertexFormat::Full) {
+        if (mesh.cullSlot != UINT32_MAX) {
+            m_cullPass->freeChunk(mesh.cullSlot);
+            mesh.cullSlot = UINT32_MAX;
+        }
+        if (mesh.allocation.valid()) {
+            m_fullMeshes.insert(chunkPos);
+            mesh.tableOffset = m_meshHeap->getOffset(mesh.allocation);
+        } else {
+            m_fullMeshes.erase(chunkPos);
+        }
+        return;
     }
+    m_fullMeshes.erase(chunkPos);
     
-    // Add indices for two triangles
-    mesh.indices.push_back(baseIdx);
-    mesh.indices.push_back(baseIdx + 1);
-    mesh.indices.push_back(baseIdx + 2);
+    const bool drawable = mesh.allocation.valid();
+    if (mesh.cullSlot == UINT32_MAX) {
+        if (!drawable) return;
+        if (!m_cullPass->allocateChunk(mesh.cullSlot)) {
+            if (!m_cullTableFull) {
+                std::cerr << "Chunk cull table is full; more than " << MAX_CULLED_CHUNKS
+                          << " chunks will not be drawn" << std::endl;
+                m_cullTableFull = true;
+            }
+            return;
+        }
+    }
     
-    mesh.indices.push_back(baseIdx);
-    mesh.indices.push_back(baseIdx + 2);
-    mesh.indices.push_back(baseIdx + 3);
+    ChunkSectionTable table{};
+    if (drawable) {
+        const VkDeviceSize heapOffset = m_meshHeap->getOffset(mesh.allocation);
+        const uint32_t baseIndex = static_cast<uint32_t>((heapOffset + mesh.indexOffset) / sizeof(uint32_t));
+        const glm::vec4 origin(chunkPos.x * ChunkMesher::CHUNK_SIZE, 0.0f, chunkPos.z * ChunkMesher::CHUNK_SIZE, 0.0f);
+        for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+            const ChunkSectionRange& range = mesh.sections[s];
+            table[s].origin = origin;
+            table[s].bounds = glm::vec4(range.minY, range.maxY, 0.0f, 0.0f);
+            table[s].indexCount = range.indexCount;
+            table[s].firstIndex = baseIndex + range.firstIndex;
+            table[s].vertexOffset = static_cast<int32_t>(heapOffset / sizeof(PackedBlockVertex));
+        }
+        mesh.tableOffset = heapOffset;
+    }
+    m_cullPass->setSections(mesh.cullSlot, table);
 }
 
-glm::vec2 BlockRenderer::getTextureCoords(BlockType type, int face) {
-    // Map block types to texture atlas positions
-    int texX = 0, texY = 0;
-    
-    switch (type) {
-        case BlockType::STONE:
-            texX = 0; texY = 0;
-            break;
-        case BlockType::DIRT:
-            texX = 1; texY = 0;
-            break;
-        case BlockType::GRASS:
-            // Different textures for top, sides, bottom
-            if (face == 4) { texX = 2; texY = 0; } // Top
-            else if (face == 5) { texX = 1; texY = 0; } // Bottom (dirt)
-            else { texX = 3; texY = 0; } // Sides
-            break;
-        case BlockType::WOOD:
-            texX = 4; texY = 0;
-            break;
-        case BlockType::LEAVES:
-            texX = 5; texY = 0;
-            break;
-        case BlockType::SAND:
-            texX = 6; texY = 0;
-            break;
-        case BlockType::WATER:
-            texX = 7; texY = 0;
-            break;
-        case BlockType::GLASS:
-            texX = 8; texY = 0;
-            break;
-        default:
-            texX = 0; texY = 0;
-            break;
+void BlockRenderer::beginTransfers(VkCommandBuffer cmd, bool& barrierRecorded) {
+    if (!barrierRecorded) {
+        // The other frame in flight may still be culling or drawing from
+        // the heap and the section table, and earlier frames' copies must
+        // land before defragmentation reads them back
+        VkMemoryBarrier barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                             VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+        barrierRecorded = true;
+    }
+}
+
+void BlockRenderer::getVertexInputDescription(VertexFormat format, VkVertexInputBindingDescription& binding,
+                                              std::vector<VkVertexInputAttributeDescription>& attributes) {
+    binding = {};
+    binding.binding = 0;
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    attributes.clear();
+    
+    if (format == VertexFormat::Packed) {
+        // Both words as one uvec2; the shader unpacks the fields
+        binding.stride = sizeof(PackedBlockVertex);
+        attributes.push_back({0, 0, VK_FORMAT_R32G32_UINT, 0});
+        return;
     }
     
-    float texSize = 1.0f / BLOCKS_PER_ROW;
-    return {texX * texSize, texY * texSize};
+    binding.stride = sizeof(BlockVertex);
+    attributes.push_back({0, 0, VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(BlockVertex, position))});
+    attributes.push_back({1, 0, VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(BlockVertex, normal))});
+    attributes.push_back({2, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(BlockVertex, texCoord))});
+    attributes.push_back({3, 0, VK_FORMAT_R32_SFLOAT, static_cast<uint32_t>(offsetof(BlockVertex, lightLevel))});
+    attributes.push_back({4, 0, VK_FORMAT_R32_UINT, static_cast<uint32_t>(offsetof(BlockVertex, textureIndex))});
 }
 
-bool BlockRenderer::isTransparent(BlockType type) {
-    return type == BlockType::AIR || 
-           type == BlockType::WATER || 
-           type == BlockType::GLASS ||
-           type == BlockType::LEAVES;
+size_t BlockRenderer::getMeshMemoryUsage() const {
+    size_t bytes = 0;
+    for (const auto& [pos, mesh] : m_chunkMeshes) {
+        bytes += mesh.geometry.getVertexBytes() + mesh.geometry.getIndexBytes();
+    }
+    return bytes;
 }
 
-bool BlockRenderer::isSolid(BlockType type) {
-    return type != BlockType::AIR && type != BlockType::WATER;
+bool BlockRenderer::shouldRenderFace(const std::vector<BlockType>& blocks, int x, int y, int z, int face) {
+    return ChunkMesher::shouldRenderFace(blocks, x, y, z, face);
 }
 
-void BlockRenderer::createVertexBuffer(ChunkMesh& mesh) {
-    // Placeholder - actual Vulkan buffer creation would go here
-    (void)mesh;
+glm::vec2 BlockRenderer::getTextureCoords(BlockType type, int face) {
+    uint32_t index = ChunkMesher::getTextureIndex(type, face);
+    float texSize = 1.0f / BLOCKS_PER_ROW;
+    return {(index % BLOCKS_PER_ROW) * texSize, (index / BLOCKS_PER_ROW) * texSize};
+}
+
+bool BlockRenderer::isTransparent(BlockType type) {
+    return ChunkMesher::isTransparent(type);
 }
 
-void BlockRenderer::createIndexBuffer(ChunkMesh& mesh) {
-    // Placeholder - actual Vulkan buffer creation would go here
-    (void)mesh;
+bool BlockRenderer::isSolid(BlockType type) {
+    return ChunkMesher::isSolid(type);
 }
 
 void BlockRenderer::destroyChunkMesh(ChunkMesh& mesh) {
-    if (mesh.vertexBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(m_device, mesh.vertexBuffer, nullptr);
-        mesh.vertexBuffer = VK_NULL_HANDLE;
+    m_meshHeap->free(mesh.allocation);
+    if (mesh.cullSlot != UINT32_MAX) {
+        m_cullPass->freeChunk(mesh.cullSlot);
+        mesh.cullSlot = UINT32_MAX;
     }
-    if (mesh.indexBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(m_device, mesh.indexBuffer, nullptr);
-        mesh.indexBuffer = VK_NULL_HANDLE;
-    }
-    if (mesh.vertexMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(m_device, mesh.vertexMemory, nullptr);
-        mesh.vertexMemory = VK_NULL_HANDLE;
+    mesh.indexOffset = 0;
+    mesh.indexCount = 0;
+}
+
+void BlockRenderer::updateChunk(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+                                uint16_t sectionMask) {
+    ChunkMesh& mesh = m_chunkMeshes[chunkPos];
+    mesh.version++;
+    mesh.needsRebuild = true;
+    
+    MeshJob job;
+    job.chunkPos = chunkPos;
+    job.version = mesh.version;
+    job.blocks = blocks;
+    job.sectionMask = sectionMask;
+    job.lodLevel = mesh.pendingLodLevel = selectLodLevel(chunkPos, mesh.pendingLodLevel);
+    for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+        job.neighbors[face] = getNeighborEdges(chunkPos, face, job.lodLevel);
     }
-    if (mesh.indexMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(m_device, mesh.indexMemory, nullptr);
-        mesh.indexMemory = VK_NULL_HANDLE;
+    job.mode = m_meshingMode;
+    job.format = m_vertexFormat;
+    m_meshJobs->submit(std::move(job));
+}
+
+void BlockRenderer::updateChunk(const EditedChunk& chunk) {
+    std::vector<BlockType> blocks(chunk.blockIds.size());
+    for (size_t i = 0; i < blocks.size(); ++i) {
+        const uint8_t id = chunk.blockIds[i];
+        blocks[i] = id < WORLD_BLOCK_TYPES.size() ? WORLD_BLOCK_TYPES[id] : BlockType::STONE;
     }
+    updateChunk(chunk.position, blocks, chunk.sectionMask);
 }
 
-void BlockRenderer::updateChunk(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks) {
+void BlockRenderer::removeChunk(const glm::ivec3& chunkPos) {
     auto it = m_chunkMeshes.find(chunkPos);
-    if (it == m_chunkMeshes.end()) {
-        ChunkMesh& mesh = m_chunkMeshes[chunkPos];
-        buildChunkMesh(chunkPos, blocks, mesh);
-    } else {
-        destroyChunkMesh(it->second);
-        buildChunkMesh(chunkPos, blocks, it->second);
+    if (it == m_chunkMeshes.end()) return;
+    
+    // Any job still running for it is dropped when it completes
+    const bool wasMeshed = it->second.edges != nullptr;
+    destroyChunkMesh(it->second);
+    m_chunkMeshes.erase(it);
+    m_fullMeshes.erase(chunkPos);
+    m_defragRequested = true;
+    if (!wasMeshed) return;
+    
+    for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+        auto neighbor = m_chunkMeshes.find(chunkPos + FACE_OFFSETS[face]);
+        if (neighbor != m_chunkMeshes.end() && neighbor->second.edges) {
+            remeshBorder(neighbor->first, neighbor->second, ChunkMesher::oppositeFace(face));
+        }
     }
 }
 
+MeshUploadStats BlockRenderer::getUploadStats() const {
+    MeshUploadStats stats;
+    stats.jobs = m_meshJobs->getStats();
+    stats.pendingUploads = m_uploadQueue.size();
+    stats.uploadedMeshes = m_uploadedMeshes;
+    stats.uploadedBytes = m_uploadedBytes;
+    stats.lastFrameBytes = m_lastFrameBytes;
+    stats.staleResults = m_staleResults;
+    stats.stagingUsed = m_stagingRing->getUsedBytes();
+    return stats;
+}
+
+void BlockRenderer::setChunkPipeline(VkPipeline pipeline, VkPipelineLayout layout) {
+    m_chunkPipeline = pipeline;
+    m_chunkPipelineLayout = layout;
+}
+
+void BlockRenderer::cullChunks(VkCommandBuffer cmd, uint32_t frameSlot, const glm::mat4& viewProj,
+                               const glm::vec3& cameraPos) {
+    m_cullPass->cull(cmd, frameSlot, viewProj, cameraPos, m_renderDistance);
+    m_culledSlot = frameSlot;
+}
+
+void BlockRenderer::setFullPipeline(VkPipeline pipeline, VkPipelineLayout layout) {
+    m_fullPipeline = pipeline;
+    m_fullPipelineLayout = layout;
+}
+
 void BlockRenderer::render(VkCommandBuffer cmd, const glm::mat4& viewProj, const glm::vec3& cameraPos) {
-    // Render all chunks within view distance
-    (void)cmd;
-    (void)viewProj;
-    (void)cameraPos;
+    if (m_fullPipeline != VK_NULL_HANDLE && !m_fullMeshes.empty()) {
+        drawFullMeshes(cmd, viewProj, cameraPos);
+    }
     
-    // Actual rendering code would bind pipeline, descriptor sets, and draw each chunk
+    // Visibility was decided by cullChunks; the camera is already in its draws
+    if (m_chunkPipeline == VK_NULL_HANDLE || m_culledSlot == UINT32_MAX) return;
+    
+    VkDescriptorSet sections = m_cullPass->getDescriptorSet(m_culledSlot);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_chunkPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_chunkPipelineLayout, 0, 1, &sections,
+                            0, nullptr);
+    
+    ChunkPushConstants constants{viewProj, 0};
+    vkCmdPushConstants(cmd, m_chunkPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+    
+    // Every chunk lives in the one heap; the draws carry the offsets
+    VkBuffer heap = m_meshHeap->getBuffer();
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &heap, &offset);
+    vkCmdBindIndexBuffer(cmd, heap, 0, VK_INDEX_TYPE_UINT32);
+    
+    m_cullPass->draw(cmd, m_culledSlot, m_chunkPipelineLayout,
+                     static_cast<uint32_t>(offsetof(ChunkPushConstants, firstSection)));
 }
 
-void BlockRenderer::greedyMesh(const std::vector<BlockType>& blocks, ChunkMesh& mesh) {
-    // Greedy meshing optimization - combines adjacent same-type faces
-    // Implementation would scan for runs of identical faces and merge them
-    (void)blocks;
-    (void)mesh;
+void BlockRenderer::drawFullMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj, const glm::vec3& cameraPos) {
+    // Vertices are in world space; each chunk binds its own heap range
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_fullPipeline);
+    ChunkPushConstants constants{viewProj, 0};
+    vkCmdPushConstants(cmd, m_fullPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+    
+    const Frustum frustum = Frustum::fromViewProj(viewProj);
+    const VkBuffer heap = m_meshHeap->getBuffer();
+    for (const glm::ivec3& pos : m_fullMeshes) {
+        const ChunkMesh& mesh = m_chunkMeshes.at(pos);
+        if (mesh.indexCount == 0) continue;
+        
+        const glm::vec3 min(pos.x * ChunkMesher::CHUNK_SIZE, 0.0f, pos.z * ChunkMesher::CHUNK_SIZE);
+        const glm::vec3 max = min + glm::vec3(ChunkMesher::CHUNK_SIZE, ChunkMesher::CHUNK_HEIGHT,
+                                              ChunkMesher::CHUNK_SIZE);
+        if (glm::distance(glm::clamp(cameraPos, min, max), cameraPos) > m_renderDistance) continue;
+        if (!frustum.intersectsAabb(min, max)) continue;
+        
+        const VkDeviceSize offset = m_meshHeap->getOffset(mesh.allocation);
+        vkCmdBindVertexBuffers(cmd, 0, 1, &heap, &offset);
+        vkCmdBindIndexBuffer(cmd, heap, offset + mesh.indexOffset, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(cmd, mesh.indexCount, 1, 0, 0, 0);
+    }
 }
 
 } // namespace clonemine
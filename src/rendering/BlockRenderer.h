@@ -1,70 +1,172 @@
 #pragma once
 
+#include "ChunkCullPass.h"
+#include "ChunkMesher.h"
+#include "GpuBufferHeap.h"
+#include "MeshJobSystem.h"
+#include "StagingRing.h"
+#include "world/EditedChunk.h"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <array>
+#include <deque>
+#include <memory>
+#include <ostream>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 
 namespace clonemine {
 
-enum class BlockType : uint8_t {
-    AIR = 0,
-    STONE,
-    DIRT,
-    GRASS,
-    WOOD,
-    LEAVES,
-    SAND,
-    WATER,
-    GLASS,
-    COBBLESTONE,
-    BRICK,
-    OBSIDIAN,
-    GOLD_ORE,
-    DIAMOND_ORE,
-    EMERALD_ORE,
-    ICE,
-    LAVA
-};
-
-struct BlockVertex {
-    glm::vec3 position;
-    glm::vec3 normal;
-    glm::vec2 texCoord;
-    float lightLevel;
+// Push constants for the packed format (see shaders/chunk.vert); chunk
+// origins come from the cull pass's section table
+struct ChunkPushConstants {
+    glm::mat4 viewProj;
+    uint32_t firstSection = 0; // Set by the cull pass when it draws sections one by one
 };
 
 struct ChunkMesh {
-    std::vector<BlockVertex> vertices;
-    std::vector<uint32_t> indices;
-    VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    VkBuffer indexBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory vertexMemory = VK_NULL_HANDLE;
-    VkDeviceMemory indexMemory = VK_NULL_HANDLE;
+    ChunkMeshData geometry;  // Assembled from parts for upload
+    ChunkMeshParts parts;
+    ChunkEdgesPtr edges;     // Own boundary planes, read by neighbours (null until meshed)
+    uint16_t sectionMask = ALL_CHUNK_SECTIONS;
+    uint64_t version = 0;    // Latest snapshot handed to the mesher
+    GpuHeapHandle allocation; // Vertices then indices in the shared mesh heap
+    VkDeviceSize indexOffset = 0; // From the start of the allocation
+    VertexFormat uploadedFormat = VertexFormat::Packed; // Of the allocation
+    uint32_t indexCount = 0;  // Indices currently on the GPU
+    ChunkSectionRanges sections; // Index ranges per vertical section, for culling
+    uint32_t cullSlot = UINT32_MAX; // Entries in the cull table
+    VkDeviceSize tableOffset = 0; // Heap offset the cull table entries point at
+    int lodLevel = 0;         // Level of parts and edges
+    int pendingLodLevel = 0;  // Level of the latest snapshot handed to the mesher
+    bool uploadQueued = false;
     bool needsRebuild = true;
 };
 
+// Snapshot of background meshing and upload counters
+struct MeshUploadStats {
+    MeshJobStats jobs;
+    size_t pendingUploads = 0;
+    uint64_t uploadedMeshes = 0;
+    uint64_t uploadedBytes = 0;
+    VkDeviceSize lastFrameBytes = 0;
+    uint64_t staleResults = 0;   // Finished after a newer snapshot or removal
+    VkDeviceSize stagingUsed = 0;
+};
+
 class BlockRenderer {
 public:
-    BlockRenderer(VkDevice device, VkPhysicalDevice physicalDevice);
+    static constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+    
+    // meshWorkers = 0 picks one per spare hardware thread
+    // drawFeatures picks how the culled sections are drawn (see ChunkCullPass)
+    // GPU buffers are placed in arena, which must outlive the renderer
+    BlockRenderer(VkDevice device, GpuMemoryArena& arena, const IndirectDrawFeatures& drawFeatures,
+                  unsigned meshWorkers = 0);
     ~BlockRenderer();
 
-    // Build mesh for a chunk (16x256x16 blocks)
-    void buildChunkMesh(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks, ChunkMesh& mesh);
+    // Build mesh for a chunk (16x256x16 blocks) on the calling thread; sections
+    // not in sectionMask are skipped. The upload happens in processMeshUpdates.
+    void buildChunkMesh(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks, ChunkMesh& mesh,
+                        uint16_t sectionMask = ALL_CHUNK_SECTIONS);
+    
+    // Cull chunk sections on the GPU for frameSlot. Record after
+    // processMeshUpdates and outside the render pass.
+    void cullChunks(VkCommandBuffer cmd, uint32_t frameSlot, const glm::mat4& viewProj, const glm::vec3& cameraPos);
     
-    // Render all visible chunks
+    // Render the sections the last cullChunks kept, with one indirect draw
+    // where the device allows it, then any full-format chunks
     void render(VkCommandBuffer cmd, const glm::mat4& viewProj, const glm::vec3& cameraPos);
     
-    // Update a chunk's mesh
-    void updateChunk(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks);
+    // Packed-format chunk pipeline; its layout must use getChunkSetLayout()
+    // as set 0 and ChunkPushConstants for the vertex stage
+    void setChunkPipeline(VkPipeline pipeline, VkPipelineLayout layout);
+    
+    // Full-format chunk pipeline (see shaders/chunk_full.vert): BlockVertex
+    // input and ChunkPushConstants for the vertex stage. The cull pass only
+    // handles packed meshes, so these are culled on the CPU and drawn one
+    // chunk at a time.
+    void setFullPipeline(VkPipeline pipeline, VkPipelineLayout layout);
+    VkDescriptorSetLayout getChunkSetLayout() const { return m_cullPass->getSetLayout(); }
+    
+    // Sections further than this (in blocks) are culled
+    void setRenderDistance(float distance) { m_renderDistance = distance; }
+    float getRenderDistance() const { return m_renderDistance; }
+    
+    // Terrain level of detail: chunks centred beyond firstDistance blocks
+    // are meshed downsampled to 2x2x2-block cells, beyond twice that to 4x4x4
+    // and so on up to maxLevel. Neighbours on different levels do not cull
+    // their shared edge against each other, so both keep their edge walls
+    // and no gap opens where the two surfaces disagree.
+    void setLodDistance(float firstDistance, int maxLevel = ChunkMesher::MAX_LOD_LEVEL);
+    float getLodDistance() const { return m_lodDistance; }
+    int getMaxLodLevel() const { return m_maxLodLevel; }
+    
+    // Move the LOD rings to the camera and list the chunks that now belong
+    // on another level. Resubmit each with updateChunk (or remove it); until
+    // then it is listed again on every call.
+    void collectLodChanges(const glm::vec3& cameraPos, std::vector<glm::ivec3>& changed);
+    
+    // Level a chunk's current mesh was built at (0 = full detail)
+    int getLodLevel(const glm::ivec3& chunkPos) const;
+    
+    // Queue a chunk for background remeshing from a snapshot of its blocks.
+    // Call whenever the chunk changed; repeated calls before a worker starts
+    // collapse into one job. Loaded neighbours whose touching edge changed
+    // only get that border part remeshed.
+    void updateChunk(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+                     uint16_t sectionMask = ALL_CHUNK_SECTIONS);
+    
+    // Same, for a chunk edited in the world (ChunkManager::collectEditedChunks);
+    // world blocks without their own texture map to the closest render type
+    void updateChunk(const EditedChunk& chunk);
+    
+    // Once per frame on the render thread, after waiting on frameSlot's fence
+    // and before the render pass: applies finished meshes and records their
+    // buffer copies into cmd, up to the upload budget.
+    void processMeshUpdates(VkCommandBuffer cmd, uint32_t frameSlot);
+    
+    // Staging bytes copied per frame; at least one mesh always goes through
+    void setUploadBudget(VkDeviceSize bytesPerFrame) { m_uploadBudget = bytesPerFrame; }
+    VkDeviceSize getUploadBudget() const { return m_uploadBudget; }
+    
+    MeshUploadStats getUploadStats() const;
+    
+    // Shared vertex/index heap occupancy
+    GpuHeapStats getMeshHeapStats() const { return m_meshHeap->getStats(); }
+    void dumpMeshHeapStats(std::ostream& out) const { m_meshHeap->dumpStats(out); }
+    
+    // Drop a chunk's mesh; neighbours re-expose the faces that touched it
+    void removeChunk(const glm::ivec3& chunkPos);
+    
+    // Border-only rebuilds triggered by neighbour loads and edits
+    uint64_t getBorderRemeshCount() const { return m_borderRemeshCount; }
     
     // Face culling: only render visible faces
     bool shouldRenderFace(const std::vector<BlockType>& blocks, int x, int y, int z, int face);
     
-    // Greedy meshing optimization
-    void greedyMesh(const std::vector<BlockType>& blocks, ChunkMesh& mesh);
+    // Greedy meshing optimization: merges coplanar faces of equal type and light
+    void greedyMesh(const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks, ChunkMesh& mesh,
+                    uint16_t sectionMask = ALL_CHUNK_SECTIONS);
+    
+    // Mesher used by buildChunkMesh/updateChunk (greedy by default)
+    void setMeshingMode(MeshingMode mode) { m_meshingMode = mode; }
+    MeshingMode getMeshingMode() const { return m_meshingMode; }
+    
+    // Vertex format for new meshes (packed by default; full for debugging,
+    // which needs setFullPipeline)
+    void setVertexFormat(VertexFormat format) { m_vertexFormat = format; }
+    VertexFormat getVertexFormat() const { return m_vertexFormat; }
+    
+    // Pipeline vertex input for a format
+    static void getVertexInputDescription(VertexFormat format, VkVertexInputBindingDescription& binding,
+                                          std::vector<VkVertexInputAttributeDescription>& attributes);
     
-    // Get texture coordinates for block type
+    // CPU-side bytes of all chunk meshes (vertices + indices)
+    size_t getMeshMemoryUsage() const;
+    
+    // Get atlas origin of the texture for a block face
     glm::vec2 getTextureCoords(BlockType type, int face);
     
     // Check if block is transparent
@@ -74,17 +176,67 @@ public:
     static bool isSolid(BlockType type);
 
 private:
-    void createVertexBuffer(ChunkMesh& mesh);
-    void createIndexBuffer(ChunkMesh& mesh);
+    void beginTransfers(VkCommandBuffer cmd, bool& barrierRecorded);
     void destroyChunkMesh(ChunkMesh& mesh);
-    
-    // Add a face to the mesh
-    void addFace(ChunkMesh& mesh, const glm::vec3& pos, int face, BlockType type, float light);
+    bool uploadMesh(VkCommandBuffer cmd, ChunkMesh& mesh, bool& barrierRecorded);
+    void writeSections(const glm::ivec3& chunkPos, ChunkMesh& mesh);
+    void drawFullMeshes(VkCommandBuffer cmd, const glm::mat4& viewProj, const glm::vec3& cameraPos);
+    void queueUpload(const glm::ivec3& chunkPos, ChunkMesh& mesh);
+    void applyMeshResult(MeshJobResult& result);
+    void meshChunk(MeshingMode mode, const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+                   ChunkMesh& mesh, uint16_t sectionMask);
+    void rebuildBorder(const glm::ivec3& chunkPos, ChunkMesh& mesh, int face);
+    void remeshBorder(const glm::ivec3& chunkPos, ChunkMesh& mesh, int face);
+    void remeshNeighborBorders(const glm::ivec3& chunkPos, const ChunkEdges* oldEdges, const ChunkEdges& newEdges);
+    // Neighbours meshed at another level count as not loaded
+    ChunkEdgesPtr getNeighborEdges(const glm::ivec3& chunkPos, int face, int lodLevel) const;
+    ChunkNeighborBorders getNeighborBorders(const glm::ivec3& chunkPos, int lodLevel) const;
+    int selectLodLevel(const glm::ivec3& chunkPos, int currentLevel) const;
     
     VkDevice m_device;
-    VkPhysicalDevice m_physicalDevice;
     std::unordered_map<glm::ivec3, ChunkMesh> m_chunkMeshes;
     
+    ChunkMesher m_mesher; // Render-thread builds and border remeshes
+    std::vector<BlockType> m_lodBlocks; // Downsampled copy for render-thread builds
+    MeshingMode m_meshingMode = MeshingMode::Greedy;
+    VertexFormat m_vertexFormat = VertexFormat::Packed;
+    uint64_t m_borderRemeshCount = 0;
+    
+    // Background meshing and uploads
+    std::unique_ptr<MeshJobSystem> m_meshJobs;
+    std::unique_ptr<StagingRing> m_stagingRing;
+    std::unique_ptr<GpuBufferHeap> m_meshHeap;
+    bool m_defragRequested = false;
+    std::deque<glm::ivec3> m_uploadQueue;
+    VkDeviceSize m_uploadBudget = 2 * 1024 * 1024;
+    uint64_t m_uploadedMeshes = 0;
+    uint64_t m_uploadedBytes = 0;
+    VkDeviceSize m_lastFrameBytes = 0;
+    uint64_t m_staleResults = 0;
+    
+    // GPU culling and indirect drawing
+    std::unique_ptr<ChunkCullPass> m_cullPass;
+    VkPipeline m_chunkPipeline{VK_NULL_HANDLE};
+    VkPipelineLayout m_chunkPipelineLayout{VK_NULL_HANDLE};
+    VkPipeline m_fullPipeline{VK_NULL_HANDLE};
+    VkPipelineLayout m_fullPipelineLayout{VK_NULL_HANDLE};
+    std::unordered_set<glm::ivec3> m_fullMeshes; // Uploaded full-format chunks
+    float m_renderDistance = 256.0f;
+    uint32_t m_culledSlot = UINT32_MAX; // Frame slot of the last cullChunks
+    bool m_cullTableFull = false;
+    
+    // Terrain LOD rings around the last collectLodChanges camera
+    float m_lodDistance = 128.0f;
+    int m_maxLodLevel = ChunkMesher::MAX_LOD_LEVEL;
+    glm::vec3 m_lodCenter{0.0f};
+    
+    static constexpr VkDeviceSize STAGING_RING_SIZE = 16 * 1024 * 1024;
+    static constexpr VkDeviceSize MESH_HEAP_SIZE = 256 * 1024 * 1024;
+    static constexpr VkDeviceSize MESH_ALIGNMENT = 16;
+    static constexpr double DEFRAG_THRESHOLD = 0.5; // Heap fragmentation that triggers compaction
+    static constexpr uint32_t MAX_CULLED_CHUNKS = 8192;
+    static constexpr float LOD_HYSTERESIS = 8.0f; // Blocks past a ring edge before a chunk switches level
+    
     // Atlas: 16x16 block textures in 256x256 atlas
     static constexpr int ATLAS_SIZE = 256;
     static constexpr int BLOCK_TEX_SIZE = 16;
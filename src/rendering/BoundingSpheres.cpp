@@ -0,0 +1,117 @@
+#include "BoundingSpheres.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CLONEMINE_CULL_SSE 1
+#include <emmintrin.h>
+#endif
+
+namespace clonemine {
+
+void BoundingSpheres::push(const glm::vec3& center, float r) {
+    x.push_back(center.x);
+    y.push_back(center.y);
+    z.push_back(center.z);
+    radius.push_back(r);
+}
+
+void BoundingSpheres::set(size_t index, const glm::vec3& center, float r) {
+    x[index] = center.x;
+    y[index] = center.y;
+    z[index] = center.z;
+    radius[index] = r;
+}
+
+void BoundingSpheres::swapRemove(size_t index) {
+    for (std::vector<float>* component : {&x, &y, &z, &radius}) {
+        (*component)[index] = component->back();
+        component->pop_back();
+    }
+}
+
+void BoundingSpheres::clear() {
+    x.clear();
+    y.clear();
+    z.clear();
+    radius.clear();
+}
+
+bool isSphereVisible(const Frustum& frustum, const glm::vec3& camera, float maxDistance,
+                     const glm::vec3& center, float radius) {
+    // The SSE kernel below mirrors these expressions operation for operation
+    const float dx = center.x - camera.x;
+    const float dy = center.y - camera.y;
+    const float dz = center.z - camera.z;
+    if (dx * dx + dy * dy + dz * dz > maxDistance * maxDistance) {
+        return false;
+    }
+
+    for (const auto& plane : frustum.planes) {
+        if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t cullSpheres(const Frustum& frustum, const glm::vec3& camera, float maxDistance,
+                   const BoundingSpheres& spheres, std::vector<uint8_t>& visible) {
+    const size_t count = spheres.size();
+    visible.resize(count);
+    size_t visibleCount = 0;
+    size_t done = 0;
+
+#ifdef CLONEMINE_CULL_SSE
+    done = count & ~size_t{3};
+
+    const __m128 camX = _mm_set1_ps(camera.x);
+    const __m128 camY = _mm_set1_ps(camera.y);
+    const __m128 camZ = _mm_set1_ps(camera.z);
+    const __m128 maxDistSq = _mm_set1_ps(maxDistance * maxDistance);
+    const __m128 zero = _mm_setzero_ps();
+
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (size_t p = 0; p < 6; ++p) {
+        planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+
+    for (size_t i = 0; i < done; i += 4) {
+        const __m128 x = _mm_loadu_ps(spheres.x.data() + i);
+        const __m128 y = _mm_loadu_ps(spheres.y.data() + i);
+        const __m128 z = _mm_loadu_ps(spheres.z.data() + i);
+        const __m128 negRadius = _mm_sub_ps(zero, _mm_loadu_ps(spheres.radius.data() + i));
+
+        const __m128 dx = _mm_sub_ps(x, camX);
+        const __m128 dy = _mm_sub_ps(y, camY);
+        const __m128 dz = _mm_sub_ps(z, camZ);
+        const __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+        __m128 inside = _mm_cmple_ps(distSq, maxDistSq);
+
+        for (size_t p = 0; p < 6; ++p) {
+            const __m128 d = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(planeX[p], x), _mm_mul_ps(planeY[p], y)),
+                                                   _mm_mul_ps(planeZ[p], z)),
+                                        planeW[p]);
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(d, negRadius));
+        }
+
+        const int mask = _mm_movemask_ps(inside);
+        for (size_t lane = 0; lane < 4; ++lane) {
+            const uint8_t in = (mask >> lane) & 1;
+            visible[i + lane] = in;
+            visibleCount += in;
+        }
+    }
+#endif
+
+    // Scalar path and any tail that does not fill a vector
+    for (size_t i = done; i < count; ++i) {
+        const bool in = isSphereVisible(frustum, camera, maxDistance, spheres.getCenter(i), spheres.radius[i]);
+        visible[i] = in ? 1 : 0;
+        visibleCount += in ? 1 : 0;
+    }
+    return visibleCount;
+}
+
+} // namespace clonemine
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Frustum.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace clonemine {
+
+// Bounding spheres as one array per component, in the same order as the
+// objects they bound, so the culler loads four spheres per instruction
+struct BoundingSpheres {
+    std::vector<float> x;
+    std::vector<float> y;
+    std::vector<float> z;
+    std::vector<float> radius;
+
+    void push(const glm::vec3& center, float r);
+    void set(size_t index, const glm::vec3& center, float r);
+    // Last sphere moves into index, matching SlotMap::erase
+    void swapRemove(size_t index);
+    void clear();
+
+    [[nodiscard]] size_t size() const noexcept { return x.size(); }
+    [[nodiscard]] glm::vec3 getCenter(size_t index) const { return {x[index], y[index], z[index]}; }
+};
+
+// Sphere is kept when its centre is within maxDistance of the camera and it
+// touches every frustum plane's inner side (same test as
+// Frustum::intersectsSphere)
+bool isSphereVisible(const Frustum& frustum, const glm::vec3& camera, float maxDistance,
+                     const glm::vec3& center, float radius);
+
+// visible[i] = 1 if sphere i passes isSphereVisible, else 0. SSE where
+// available; every lane does the same float operations as the scalar test,
+// so the results match it exactly. Returns the number of visible spheres.
+size_t cullSpheres(const Frustum& frustum, const glm::vec3& camera, float maxDistance,
+                   const BoundingSpheres& spheres, std::vector<uint8_t>& visible);
+
+} // namespace clonemine
@@ -0,0 +1,329 @@
+#include "ChunkCullPass.h"
+#include "Frustum.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace clonemine {
+
+namespace {
+    // Push constants of shaders/chunk_cull.comp
+    struct CullConstants {
+        glm::vec4 planes[6];
+        glm::vec4 camera; // xyz = position, w = render distance
+        uint32_t sectionCount;
+        uint32_t compact;
+        uint32_t instanceIds;
+        uint32_t padding;
+    };
+    static_assert(sizeof(CullConstants) <= 128, "Push constants must fit the guaranteed minimum");
+
+    constexpr uint32_t WORKGROUP_SIZE = 64;
+    // Covers minStorageBufferOffsetAlignment on every conformant device
+    constexpr VkDeviceSize REGION_ALIGNMENT = 256;
+
+    VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    std::vector<char> readFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + filename);
+        }
+
+        size_t fileSize = static_cast<size_t>(file.tellg());
+        std::vector<char> buffer(fileSize);
+
+        file.seekg(0);
+        file.read(buffer.data(), fileSize);
+        return buffer;
+    }
+}
+
+ChunkCullPass::ChunkCullPass(VkDevice device, GpuMemoryArena& arena, const IndirectDrawFeatures& features,
+                             uint32_t maxChunks, uint32_t framesInFlight, const std::string& shaderPath)
+    : m_device(device), m_arena(arena), m_maxChunks(maxChunks), m_frames(framesInFlight),
+      m_drawEach(!features.multiDrawIndirect || !features.drawIndirectFirstInstance),
+      m_useDrawCount(features.drawIndirectCount && !m_drawEach),
+      m_table(static_cast<size_t>(maxChunks) * CHUNK_SECTION_COUNT), m_chunkDirty(maxChunks, false) {
+    createBuffer();
+    createDescriptors();
+    createPipeline(shaderPath);
+}
+
+ChunkCullPass::~ChunkCullPass() {
+    if (m_pipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, m_pipeline, nullptr);
+    }
+    if (m_pipelineLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(m_device, m_pipelineLayout, nullptr);
+    }
+    if (m_descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+    }
+    if (m_setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+    }
+    if (m_buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(m_device, m_buffer, nullptr);
+    }
+    m_arena.free(m_allocation);
+}
+
+void ChunkCullPass::createBuffer() {
+    const VkDeviceSize sections = static_cast<VkDeviceSize>(m_maxChunks) * CHUNK_SECTION_COUNT;
+    m_tableBytes = alignUp(sections * sizeof(GpuChunkSection), REGION_ALIGNMENT);
+    m_drawsBytes = alignUp(sections * sizeof(VkDrawIndexedIndirectCommand), REGION_ALIGNMENT);
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = m_tableBytes + m_frames * (m_drawsBytes + REGION_ALIGNMENT);
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                       VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create chunk cull buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_device, m_buffer, &memRequirements);
+
+    m_allocation = m_arena.allocate(memRequirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    vkBindBufferMemory(m_device, m_buffer, m_allocation.memory, m_allocation.offset);
+}
+
+void ChunkCullPass::createDescriptors() {
+    // 0 = section table (also read by chunk.vert), 1 = draw commands, 2 = draw count
+    std::array<VkDescriptorSetLayoutBinding, 3> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    bindings[0].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create chunk cull descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = static_cast<uint32_t>(bindings.size()) * m_frames;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = m_frames;
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create chunk cull descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(m_frames, m_setLayout);
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = m_frames;
+    allocInfo.pSetLayouts = layouts.data();
+
+    m_descriptorSets.resize(m_frames);
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, m_descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate chunk cull descriptor sets!");
+    }
+
+    for (uint32_t frame = 0; frame < m_frames; ++frame) {
+        std::array<VkDescriptorBufferInfo, 3> buffers = {{
+            {m_buffer, 0, m_tableBytes},
+            {m_buffer, getDrawsOffset(frame), m_drawsBytes},
+            {m_buffer, getCountOffset(frame), sizeof(uint32_t)},
+        }};
+
+        std::array<VkWriteDescriptorSet, 3> writes{};
+        for (uint32_t i = 0; i < writes.size(); ++i) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = m_descriptorSets[frame];
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &buffers[i];
+        }
+        vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+void ChunkCullPass::createPipeline(const std::string& shaderPath) {
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.offset = 0;
+    pushRange.size = sizeof(CullConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &m_setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushRange;
+
+    if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_pipelineLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create chunk cull pipeline layout!");
+    }
+
+    std::vector<char> code = readFile(shaderPath);
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = code.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(m_device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create shader module!");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_pipelineLayout;
+
+    VkResult result = vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &m_pipeline);
+    vkDestroyShaderModule(m_device, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create chunk cull pipeline!");
+    }
+}
+
+VkDeviceSize ChunkCullPass::getDrawsOffset(uint32_t frameSlot) const {
+    return m_tableBytes + frameSlot * (m_drawsBytes + REGION_ALIGNMENT);
+}
+
+VkDeviceSize ChunkCullPass::getCountOffset(uint32_t frameSlot) const {
+    return getDrawsOffset(frameSlot) + m_drawsBytes;
+}
+
+bool ChunkCullPass::allocateChunk(uint32_t& chunkSlot) {
+    if (!m_freeChunks.empty()) {
+        chunkSlot = m_freeChunks.back();
+        m_freeChunks.pop_back();
+        return true;
+    }
+    if (m_highWater == m_maxChunks) {
+        return false;
+    }
+    chunkSlot = m_highWater++;
+    return true;
+}
+
+void ChunkCullPass::freeChunk(uint32_t chunkSlot) {
+    // Zero entries draw nothing until the slot is reused
+    setSections(chunkSlot, ChunkSectionTable{});
+    m_freeChunks.push_back(chunkSlot);
+}
+
+void ChunkCullPass::setSections(uint32_t chunkSlot, const ChunkSectionTable& sections) {
+    std::copy(sections.begin(), sections.end(), m_table.begin() + chunkSlot * CHUNK_SECTION_COUNT);
+    if (!m_chunkDirty[chunkSlot]) {
+        m_chunkDirty[chunkSlot] = true;
+        m_dirtyChunks.push_back(chunkSlot);
+    }
+}
+
+void ChunkCullPass::recordTableUpdates(VkCommandBuffer cmd, StagingRing& staging) {
+    constexpr VkDeviceSize CHUNK_BYTES = sizeof(ChunkSectionTable);
+
+    std::vector<VkBufferCopy> copies;
+    copies.reserve(m_dirtyChunks.size());
+    size_t written = 0;
+    for (; written < m_dirtyChunks.size(); ++written) {
+        VkDeviceSize stagingOffset = 0;
+        void* mapped = nullptr;
+        if (!staging.allocate(CHUNK_BYTES, 16, stagingOffset, mapped)) break;
+
+        uint32_t chunkSlot = m_dirtyChunks[written];
+        std::memcpy(mapped, &m_table[chunkSlot * CHUNK_SECTION_COUNT], CHUNK_BYTES);
+        copies.push_back({stagingOffset, chunkSlot * CHUNK_BYTES, CHUNK_BYTES});
+        m_chunkDirty[chunkSlot] = false;
+    }
+    m_dirtyChunks.erase(m_dirtyChunks.begin(), m_dirtyChunks.begin() + written);
+
+    if (!copies.empty()) {
+        vkCmdCopyBuffer(cmd, staging.getBuffer(), m_buffer, static_cast<uint32_t>(copies.size()), copies.data());
+    }
+}
+
+void ChunkCullPass::cull(VkCommandBuffer cmd, uint32_t frameSlot, const glm::mat4& viewProj,
+                         const glm::vec3& cameraPos, float renderDistance) {
+    const uint32_t sectionCount = getSectionCount();
+
+    if (m_useDrawCount) {
+        vkCmdFillBuffer(cmd, m_buffer, getCountOffset(frameSlot), sizeof(uint32_t), 0);
+
+        VkMemoryBarrier clearBarrier{};
+        clearBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+        clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+        vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                             1, &clearBarrier, 0, nullptr, 0, nullptr);
+    }
+
+    if (sectionCount > 0) {
+        Frustum frustum = Frustum::fromViewProj(viewProj);
+        CullConstants constants{};
+        for (size_t i = 0; i < frustum.planes.size(); ++i) {
+            constants.planes[i] = frustum.planes[i];
+        }
+        constants.camera = glm::vec4(cameraPos, renderDistance);
+        constants.sectionCount = sectionCount;
+        constants.compact = m_useDrawCount ? 1 : 0;
+        constants.instanceIds = m_drawEach ? 0 : 1;
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_pipelineLayout, 0, 1,
+                                &m_descriptorSets[frameSlot], 0, nullptr);
+        vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(cmd, (sectionCount + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    VkMemoryBarrier drawBarrier{};
+    drawBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    drawBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    drawBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &drawBarrier, 0, nullptr, 0, nullptr);
+}
+
+void ChunkCullPass::draw(VkCommandBuffer cmd, uint32_t frameSlot, VkPipelineLayout layout,
+                         uint32_t sectionIdOffset) const {
+    const uint32_t sectionCount = getSectionCount();
+    if (sectionCount == 0) return;
+
+    constexpr uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+    if (m_drawEach) {
+        // The draws still come from the cull pass; empty and freed sections
+        // are skipped on the CPU side
+        for (uint32_t id = 0; id < sectionCount; ++id) {
+            if (m_table[id].indexCount == 0) continue;
+            vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_VERTEX_BIT, sectionIdOffset, sizeof(id), &id);
+            vkCmdDrawIndexedIndirect(cmd, m_buffer, getDrawsOffset(frameSlot) + id * stride, 1, stride);
+        }
+    } else if (m_useDrawCount) {
+        vkCmdDrawIndexedIndirectCount(cmd, m_buffer, getDrawsOffset(frameSlot), m_buffer,
+                                      getCountOffset(frameSlot), sectionCount, stride);
+    } else {
+        vkCmdDrawIndexedIndirect(cmd, m_buffer, getDrawsOffset(frameSlot), sectionCount, stride);
+    }
+}
+
+} // namespace clonemine
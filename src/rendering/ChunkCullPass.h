@@ -0,0 +1,112 @@
+#pragma once
+
+#include "ChunkMesher.h"
+#include "GpuMemoryArena.h"
+#include "StagingRing.h"
+#include "VulkanDevice.h"
+#include <vulkan/vulkan.h>
+#include <glm/glm.hpp>
+#include <array>
+#include <string>
+#include <vector>
+
+namespace clonemine {
+
+// One chunk section in the cull table (std430, see shaders/chunk_cull.comp)
+struct GpuChunkSection {
+    glm::vec4 origin{0.0f};   // xyz = chunk origin in world space
+    glm::vec4 bounds{0.0f};   // x = lowest local y, y = highest local y
+    uint32_t indexCount = 0;  // 0 = nothing to draw
+    uint32_t firstIndex = 0;  // Into the mesh heap bound as a uint32 index buffer
+    int32_t vertexOffset = 0; // Into the mesh heap bound as the vertex buffer
+    uint32_t padding = 0;
+};
+static_assert(sizeof(GpuChunkSection) == 48, "Must match ChunkSection in chunk_cull.comp");
+
+using ChunkSectionTable = std::array<GpuChunkSection, CHUNK_SECTION_COUNT>;
+
+// Compute pass that culls every chunk section against the view frustum and
+// render distance and writes the indirect draws for the survivors.
+//
+// Each chunk owns CHUNK_SECTION_COUNT consecutive table entries, and only
+// entries that changed are copied to the GPU. Per frame the CPU records one
+// dispatch and, with multiDrawIndirect and drawIndirectFirstInstance, one
+// draw however many chunks are loaded. Without them each live section gets
+// its own single-command indirect draw.
+class ChunkCullPass {
+public:
+    // The buffer comes from arena, which must outlive the pass.
+    // Throws std::runtime_error if the shader or GPU objects cannot be created
+    ChunkCullPass(VkDevice device, GpuMemoryArena& arena, const IndirectDrawFeatures& features,
+                  uint32_t maxChunks, uint32_t framesInFlight, const std::string& shaderPath);
+    ~ChunkCullPass();
+
+    ChunkCullPass(const ChunkCullPass&) = delete;
+    ChunkCullPass& operator=(const ChunkCullPass&) = delete;
+
+    // Table entries for one chunk; false when the table is full
+    bool allocateChunk(uint32_t& chunkSlot);
+    void freeChunk(uint32_t chunkSlot);
+    void setSections(uint32_t chunkSlot, const ChunkSectionTable& sections);
+
+    bool hasTableUpdates() const { return !m_dirtyChunks.empty(); }
+    // Copy changed entries through the staging ring; entries that do not
+    // fit stay pending. The caller orders the copies with barriers.
+    void recordTableUpdates(VkCommandBuffer cmd, StagingRing& staging);
+
+    // Outside the render pass, once the table copies are visible to compute
+    void cull(VkCommandBuffer cmd, uint32_t frameSlot, const glm::mat4& viewProj, const glm::vec3& cameraPos,
+              float renderDistance);
+
+    // Inside the render pass, with a pipeline using getSetLayout() as set 0
+    // and the mesh heap bound as vertex and index buffer. When sections are
+    // drawn one by one, each section id is pushed to the vertex stage as a
+    // uint at sectionIdOffset of layout's push constants.
+    void draw(VkCommandBuffer cmd, uint32_t frameSlot, VkPipelineLayout layout, uint32_t sectionIdOffset) const;
+
+    // Compacted draws with vkCmdDrawIndexedIndirectCount; otherwise every
+    // slot is drawn and culled ones get zero instances
+    bool usesDrawCount() const { return m_useDrawCount; }
+    // One indirect draw per section, without firstInstance
+    bool drawsEachSection() const { return m_drawEach; }
+
+    [[nodiscard]] VkDescriptorSetLayout getSetLayout() const noexcept { return m_setLayout; }
+    [[nodiscard]] VkDescriptorSet getDescriptorSet(uint32_t frameSlot) const { return m_descriptorSets[frameSlot]; }
+    [[nodiscard]] uint32_t getSectionCount() const noexcept { return m_highWater * CHUNK_SECTION_COUNT; }
+
+private:
+    void createBuffer();
+    void createDescriptors();
+    void createPipeline(const std::string& shaderPath);
+
+    VkDeviceSize getDrawsOffset(uint32_t frameSlot) const;
+    VkDeviceSize getCountOffset(uint32_t frameSlot) const;
+
+    VkDevice m_device;
+    GpuMemoryArena& m_arena;
+    uint32_t m_maxChunks;
+    uint32_t m_frames;
+    bool m_drawEach;
+    bool m_useDrawCount;
+
+    // Table, then per frame slot its draw commands and draw count
+    VkBuffer m_buffer{VK_NULL_HANDLE};
+    GpuMemoryAllocation m_allocation;
+    VkDeviceSize m_tableBytes = 0;
+    VkDeviceSize m_drawsBytes = 0;
+
+    VkDescriptorSetLayout m_setLayout{VK_NULL_HANDLE};
+    VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+    std::vector<VkDescriptorSet> m_descriptorSets;
+    VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+    VkPipeline m_pipeline{VK_NULL_HANDLE};
+
+    // CPU copy of the table and the chunks whose entries changed
+    std::vector<GpuChunkSection> m_table;
+    std::vector<uint32_t> m_dirtyChunks;
+    std::vector<bool> m_chunkDirty;
+    std::vector<uint32_t> m_freeChunks;
+    uint32_t m_highWater = 0;
+};
+
+} // namespace clonemine
@@ -0,0 +1,600 @@
+#include "ChunkMesher.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace clonemine {
+
+namespace {
+    constexpr int SIZE = ChunkMesher::CHUNK_SIZE;
+    constexpr int HEIGHT = ChunkMesher::CHUNK_HEIGHT;
+
+    // Quad corners for a unit block, per face, in triangle-fan order
+    constexpr int FACE_CORNERS[6][4][3] = {
+        {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}, // Front (+Z)
+        {{1, 0, 0}, {0, 0, 0}, {0, 1, 0}, {1, 1, 0}}, // Back (-Z)
+        {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}}, // Left (-X)
+        {{1, 0, 1}, {1, 0, 0}, {1, 1, 0}, {1, 1, 1}}, // Right (+X)
+        {{0, 1, 1}, {1, 1, 1}, {1, 1, 0}, {0, 1, 0}}, // Top (+Y)
+        {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}  // Bottom (-Y)
+    };
+
+    constexpr float FACE_NORMALS[6][3] = {
+        {0, 0, 1}, {0, 0, -1}, {-1, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, -1, 0}
+    };
+
+    // Axis the face points along (0=x, 1=y, 2=z) and its direction
+    constexpr int FACE_AXIS[6] = {2, 2, 0, 0, 1, 1};
+    constexpr int FACE_SIGN[6] = {1, -1, -1, 1, 1, -1};
+
+    // In-plane axes used to lay out a slice for each normal axis
+    constexpr int SLICE_U[3] = {2, 0, 0};
+    constexpr int SLICE_V[3] = {1, 2, 1};
+    constexpr int AXIS_DIMS[3] = {SIZE, HEIGHT, SIZE};
+
+    inline int blockIndex(int x, int y, int z) {
+        return x + z * SIZE + y * SIZE * SIZE;
+    }
+
+    inline bool inSectionMask(uint16_t sectionMask, int y) {
+        return (sectionMask & (1u << (y / ChunkMesher::SECTION_HEIGHT))) != 0;
+    }
+
+    // A face is hidden only behind an opaque block
+    inline bool isFaceVisibleAgainst(BlockType neighbor) {
+        return !ChunkMesher::isSolid(neighbor) || ChunkMesher::isTransparent(neighbor);
+    }
+
+    // Downsampled blocks share one light level per cell, so its faces merge
+    inline uint8_t getCellFaceLight(int face, int y, int lodLevel) {
+        return ChunkMesher::getFaceLight(face, (y >> lodLevel) << lodLevel);
+    }
+
+    // Merge key for greedy meshing; 0 means no face
+    inline uint32_t faceKey(BlockType type, uint32_t light) {
+        return ((static_cast<uint32_t>(type) + 1) << 8) | light;
+    }
+}
+
+const char* getMeshingModeName(MeshingMode mode) {
+    switch (mode) {
+        case MeshingMode::Naive: return "naive";
+        case MeshingMode::Greedy: return "greedy";
+    }
+    return "unknown";
+}
+
+const char* getVertexFormatName(VertexFormat format) {
+    switch (format) {
+        case VertexFormat::Packed: return "packed";
+        case VertexFormat::Full: return "full";
+    }
+    return "unknown";
+}
+
+PackedBlockVertex PackedBlockVertex::pack(const glm::ivec3& localPosition, int face, int corner, uint8_t light,
+                                          uint32_t textureIndex, int uLength, int vLength) {
+    PackedBlockVertex vertex;
+    vertex.data = static_cast<uint32_t>(localPosition.x) |
+                  (static_cast<uint32_t>(localPosition.y) << 5) |
+                  (static_cast<uint32_t>(localPosition.z) << 14) |
+                  (static_cast<uint32_t>(face) << 19) |
+                  (static_cast<uint32_t>(corner) << 22) |
+                  (static_cast<uint32_t>(light) << 24);
+    vertex.texture = (textureIndex & 0xFF) |
+                     (static_cast<uint32_t>(uLength) << 8) |
+                     (static_cast<uint32_t>(vLength) << 17);
+    return vertex;
+}
+
+glm::vec2 PackedBlockVertex::getTexCoord() const {
+    const int corner = getCorner();
+    const float uLength = static_cast<float>((texture >> 8) & 0x1FF);
+    const float vLength = static_cast<float>((texture >> 17) & 0x1FF);
+    return {(corner == 1 || corner == 2) ? uLength : 0.0f, (corner >= 2) ? vLength : 0.0f};
+}
+
+void ChunkMeshParts::setFormat(VertexFormat format) {
+    core.format = format;
+    for (auto& border : borders) {
+        border.format = format;
+    }
+}
+
+void ChunkMeshParts::assemble(ChunkMeshData& out) const {
+    out.clear();
+    out.format = core.format;
+
+    auto append = [&out](const ChunkMeshData& part) {
+        const uint32_t base = static_cast<uint32_t>(out.getVertexCount());
+        out.packedVertices.insert(out.packedVertices.end(), part.packedVertices.begin(), part.packedVertices.end());
+        out.vertices.insert(out.vertices.end(), part.vertices.begin(), part.vertices.end());
+        for (uint32_t index : part.indices) {
+            out.indices.push_back(base + index);
+        }
+    };
+
+    append(core);
+    for (const auto& border : borders) {
+        append(border);
+    }
+}
+
+void ChunkMeshParts::assemble(ChunkMeshData& out, ChunkSectionRanges& sections) const {
+    out.clear();
+    out.format = core.format;
+    sections = {};
+
+    const bool packed = core.format == VertexFormat::Packed;
+    auto cornerY = [packed](const ChunkMeshData& part, size_t vertex) {
+        return packed ? part.packedVertices[vertex].getLocalPosition().y
+                      : static_cast<int>(part.vertices[vertex].position.y);
+    };
+    auto quadSection = [&](const ChunkMeshData& part, size_t quad, int& minY, int& maxY) {
+        minY = maxY = cornerY(part, quad * 4);
+        for (size_t i = 1; i < 4; ++i) {
+            int y = cornerY(part, quad * 4 + i);
+            minY = std::min(minY, y);
+            maxY = std::max(maxY, y);
+        }
+        return std::min(minY / ChunkMesher::SECTION_HEIGHT, CHUNK_SECTION_COUNT - 1);
+    };
+
+    // Every part is a list of quads: 4 vertices and 6 indices each.
+    // Count per section first, then place each quad in its section's slot.
+    std::array<uint32_t, CHUNK_SECTION_COUNT> quadCounts{};
+    std::array<const ChunkMeshData*, 5> parts = {&core, &borders[0], &borders[1], &borders[2], &borders[3]};
+    size_t totalQuads = 0;
+    for (const ChunkMeshData* part : parts) {
+        size_t quads = part->indices.size() / 6;
+        for (size_t q = 0; q < quads; ++q) {
+            int minY = 0;
+            int maxY = 0;
+            quadCounts[quadSection(*part, q, minY, maxY)]++;
+        }
+        totalQuads += quads;
+    }
+
+    std::array<uint32_t, CHUNK_SECTION_COUNT> nextQuad{};
+    uint32_t firstQuad = 0;
+    for (int s = 0; s < CHUNK_SECTION_COUNT; ++s) {
+        sections[s].firstIndex = firstQuad * 6;
+        sections[s].indexCount = quadCounts[s] * 6;
+        sections[s].minY = static_cast<uint16_t>(ChunkMesher::CHUNK_HEIGHT);
+        nextQuad[s] = firstQuad;
+        firstQuad += quadCounts[s];
+    }
+
+    if (packed) {
+        out.packedVertices.resize(totalQuads * 4);
+    } else {
+        out.vertices.resize(totalQuads * 4);
+    }
+    out.indices.resize(totalQuads * 6);
+
+    for (const ChunkMeshData* part : parts) {
+        size_t quads = part->indices.size() / 6;
+        for (size_t q = 0; q < quads; ++q) {
+            int minY = 0;
+            int maxY = 0;
+            int section = quadSection(*part, q, minY, maxY);
+            ChunkSectionRange& range = sections[section];
+            range.minY = static_cast<uint16_t>(std::min<int>(range.minY, minY));
+            range.maxY = static_cast<uint16_t>(std::max<int>(range.maxY, maxY));
+
+            const uint32_t slot = nextQuad[section]++;
+            if (packed) {
+                std::copy_n(part->packedVertices.begin() + q * 4, 4, out.packedVertices.begin() + slot * 4);
+            } else {
+                std::copy_n(part->vertices.begin() + q * 4, 4, out.vertices.begin() + slot * 4);
+            }
+            const uint32_t oldBase = static_cast<uint32_t>(q * 4);
+            for (size_t i = 0; i < 6; ++i) {
+                out.indices[slot * 6 + i] = part->indices[q * 6 + i] - oldBase + slot * 4;
+            }
+        }
+    }
+
+    for (auto& range : sections) {
+        if (range.indexCount == 0) {
+            range.minY = 0;
+        }
+    }
+}
+
+void ChunkMesher::extractBorder(const std::vector<BlockType>& blocks, int face, ChunkBorderSlice& out) {
+    const int axis = FACE_AXIS[face];
+    const int slice = FACE_SIGN[face] > 0 ? SIZE - 1 : 0;
+    for (int y = 0; y < HEIGHT; ++y) {
+        for (int i = 0; i < SIZE; ++i) {
+            out[y * SIZE + i] = axis == 0 ? blocks[blockIndex(slice, y, i)] : blocks[blockIndex(i, y, slice)];
+        }
+    }
+}
+
+void ChunkMesher::downsample(const std::vector<BlockType>& blocks, int lodLevel, std::vector<BlockType>& out) {
+    lodLevel = std::clamp(lodLevel, 0, MAX_LOD_LEVEL);
+    out.resize(blocks.size());
+    if (lodLevel == 0) {
+        std::copy(blocks.begin(), blocks.end(), out.begin());
+        return;
+    }
+
+    const int cell = 1 << lodLevel;
+    const int cellVolume = cell * cell * cell;
+    constexpr int TYPE_COUNT = static_cast<int>(BlockType::LAVA) + 1;
+
+    // Per column, the block at the top of the solid run just scanned, i.e.
+    // what the column shows from above there. Cells are coloured by it, so
+    // grass stays on top of hills and sand on beaches. Layers of cells are
+    // visited top down so the runs carry over from the layer above.
+    std::array<BlockType, SIZE * SIZE> runTop{};
+    std::array<bool, SIZE * SIZE> aboveSolid{};
+    std::array<int, TYPE_COUNT> votes{};
+
+    for (int cy = HEIGHT - cell; cy >= 0; cy -= cell) {
+        // Layers of open sky need no voting
+        auto layerBegin = blocks.begin() + blockIndex(0, cy, 0);
+        auto layerEnd = layerBegin + SIZE * SIZE * cell;
+        if (std::all_of(layerBegin, layerEnd, [](BlockType type) { return type == BlockType::AIR; })) {
+            runTop.fill(BlockType::AIR);
+            aboveSolid.fill(false);
+            std::fill(out.begin() + blockIndex(0, cy, 0), out.begin() + blockIndex(0, cy + cell, 0), BlockType::AIR);
+            continue;
+        }
+
+        for (int cz = 0; cz < SIZE; cz += cell) {
+            for (int cx = 0; cx < SIZE; cx += cell) {
+                // Count filled blocks, and vote with the surface over each
+                // column's topmost one; ties go to the lower type
+                int filled = 0;
+                int best = 0;
+                for (int z = cz; z < cz + cell; ++z) {
+                    for (int x = cx; x < cx + cell; ++x) {
+                        const int column = x + z * SIZE;
+                        bool topFound = false;
+                        for (int y = cy + cell - 1; y >= cy; --y) {
+                            const BlockType type = blocks[blockIndex(x, y, z)];
+                            const bool solid = isSolid(type);
+                            if (!(solid && aboveSolid[column])) {
+                                runTop[column] = type;
+                            }
+                            aboveSolid[column] = solid;
+                            if (type == BlockType::AIR) continue;
+                            filled++;
+                            if (!topFound) {
+                                const int vote = static_cast<int>(runTop[column]);
+                                if (++votes[vote] > votes[best] || (votes[vote] == votes[best] && vote < best)) {
+                                    best = vote;
+                                }
+                                topFound = true;
+                            }
+                        }
+                    }
+                }
+
+                const BlockType type = filled * 2 >= cellVolume ? static_cast<BlockType>(best) : BlockType::AIR;
+                votes.fill(0);
+
+                for (int y = cy; y < cy + cell; ++y) {
+                    for (int z = cz; z < cz + cell; ++z) {
+                        std::fill_n(out.begin() + blockIndex(cx, y, z), cell, type);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ChunkMesher::build(MeshingMode mode, const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+                        uint16_t sectionMask, ChunkMeshData& out, const ChunkNeighborBorders& neighbors) {
+    out.clear();
+
+    for (int face = 0; face < 6; ++face) {
+        const ChunkBorderSlice* neighbor = face < HORIZONTAL_FACES ? neighbors.slices[face] : nullptr;
+        meshFace(mode, chunkPos, blocks, sectionMask, face, neighbor, 0, out, out);
+    }
+}
+
+void ChunkMesher::build(MeshingMode mode, const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+                        uint16_t sectionMask, const ChunkNeighborBorders& neighbors, ChunkMeshParts& out,
+                        int lodLevel) {
+    out.core.clear();
+    for (auto& border : out.borders) {
+        border.clear();
+    }
+
+    for (int face = 0; face < 6; ++face) {
+        if (face < HORIZONTAL_FACES) {
+            meshFace(mode, chunkPos, blocks, sectionMask, face, neighbors.slices[face], lodLevel,
+                     out.core, out.borders[face]);
+        } else {
+            meshFace(mode, chunkPos, blocks, sectionMask, face, nullptr, lodLevel, out.core, out.core);
+        }
+    }
+}
+
+void ChunkMesher::buildBorder(MeshingMode mode, const glm::ivec3& chunkPos, int face, const ChunkBorderSlice& own,
+                              const ChunkBorderSlice* neighbor, uint16_t sectionMask, ChunkMeshData& out,
+                              int lodLevel) {
+    out.clear();
+
+    // Border slices share the mask layout (v = y, u = x or z), one entry
+    // per cell
+    const int cell = 1 << lodLevel;
+    const int cells = SIZE / cell;
+    m_mask.assign(static_cast<size_t>(cells) * (HEIGHT / cell), 0);
+    bool any = false;
+    for (int y = 0; y < HEIGHT; y += cell) {
+        if (!inSectionMask(sectionMask, y)) continue;
+
+        const uint32_t light = getCellFaceLight(face, y, lodLevel);
+        uint32_t* row = &m_mask[(y / cell) * cells];
+        for (int i = 0; i < SIZE; i += cell) {
+            const BlockType type = own[y * SIZE + i];
+            const BlockType next = neighbor ? (*neighbor)[y * SIZE + i] : BlockType::AIR;
+            if (type != BlockType::AIR && isFaceVisibleAgainst(next)) {
+                row[i / cell] = faceKey(type, light);
+                any = true;
+            }
+        }
+    }
+
+    if (any) {
+        emitMask(mode, chunkPos, face, FACE_SIGN[face] > 0 ? SIZE - 1 : 0, cell, out);
+    }
+}
+
+void ChunkMesher::meshFace(MeshingMode mode, const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+                           uint16_t sectionMask, int face, const ChunkBorderSlice* neighbor, int lodLevel,
+                           ChunkMeshData& interior, ChunkMeshData& border) {
+    const int axis = FACE_AXIS[face];
+    const int uAxis = SLICE_U[axis];
+    const int vAxis = SLICE_V[axis];
+    const int uSize = AXIS_DIMS[uAxis];
+
+    // Downsampled blocks are uniform across each cell, so one block per
+    // cell is read and each mask entry stands for a whole cell face
+    const int cell = 1 << lodLevel;
+    const int uCells = uSize / cell;
+    const int vCells = AXIS_DIMS[vAxis] / cell;
+    m_mask.assign(static_cast<size_t>(uCells) * vCells, 0);
+
+    // Index step along each axis, and towards the face's neighbour
+    const int strides[3] = {1, SIZE * SIZE, SIZE};
+    const int neighborOffset = strides[axis] * FACE_SIGN[face];
+
+    // Only the layer of each cell that carries its faces in this direction
+    for (int slice = FACE_SIGN[face] > 0 ? cell - 1 : 0; slice < AXIS_DIMS[axis]; slice += cell) {
+        if (axis == 1 && !inSectionMask(sectionMask, slice)) continue;
+
+        // On the chunk edge the neighbour comes from the adjacent chunk's
+        // border slice (visible while it is not loaded), open sky above the
+        // world, and nothing below it, since the world floor is never seen
+        const int neighborSlice = slice + FACE_SIGN[face];
+        const bool edge = neighborSlice < 0 || neighborSlice >= AXIS_DIMS[axis];
+        if (edge && face == 5) continue;
+
+        // Mark visible faces in this slice; key 0 means no face.
+        // Keys combine block type and light so only identical faces merge.
+        bool any = false;
+        for (int cv = 0; cv < vCells; ++cv) {
+            const int v = cv * cell;
+            uint32_t* row = &m_mask[cv * uCells];
+            if (vAxis == 1 && !inSectionMask(sectionMask, v)) {
+                std::fill(row, row + uCells, 0u);
+                continue;
+            }
+
+            const int y = axis == 1 ? slice : v;
+            const uint32_t light = getCellFaceLight(face, y, lodLevel);
+            const int rowStart = slice * strides[axis] + v * strides[vAxis];
+            for (int cu = 0; cu < uCells; ++cu) {
+                const int u = cu * cell;
+                const int index = rowStart + u * strides[uAxis];
+                const BlockType type = blocks[index];
+                uint32_t key = 0;
+                if (type != BlockType::AIR) {
+                    BlockType next = BlockType::AIR;
+                    if (!edge) {
+                        next = blocks[index + neighborOffset];
+                    } else if (neighbor) {
+                        next = (*neighbor)[v * uSize + u];
+                    }
+                    if (isFaceVisibleAgainst(next)) {
+                        key = faceKey(type, light);
+                        any = true;
+                    }
+                }
+                row[cu] = key;
+            }
+        }
+
+        if (any) {
+            emitMask(mode, chunkPos, face, slice, cell, edge ? border : interior);
+        }
+    }
+}
+
+void ChunkMesher::emitMask(MeshingMode mode, const glm::ivec3& chunkPos, int face, int slice, int cell,
+                           ChunkMeshData& out) {
+    const int axis = FACE_AXIS[face];
+    const int uAxis = SLICE_U[axis];
+    const int vAxis = SLICE_V[axis];
+    const int uSize = AXIS_DIMS[uAxis] / cell;
+    const int vSize = AXIS_DIMS[vAxis] / cell;
+    const bool merge = mode == MeshingMode::Greedy;
+
+    // Grow each unvisited face into the widest, then tallest, rectangle
+    // (or emit it alone when not merging)
+    for (int v = 0; v < vSize; ++v) {
+        for (int u = 0; u < uSize;) {
+            const uint32_t key = m_mask[v * uSize + u];
+            if (key == 0) {
+                ++u;
+                continue;
+            }
+
+            int width = 1;
+            while (merge && u + width < uSize && m_mask[v * uSize + u + width] == key) {
+                ++width;
+            }
+
+            int height = 1;
+            for (; merge && v + height < vSize; ++height) {
+                const uint32_t* row = &m_mask[(v + height) * uSize + u];
+                bool match = true;
+                for (int k = 0; k < width; ++k) {
+                    if (row[k] != key) {
+                        match = false;
+                        break;
+                    }
+                }
+                if (!match) break;
+            }
+
+            for (int dv = 0; dv < height; ++dv) {
+                for (int du = 0; du < width; ++du) {
+                    m_mask[(v + dv) * uSize + u + du] = 0;
+                }
+            }
+
+            glm::ivec3 origin;
+            glm::ivec3 extent(1);
+            origin[axis] = slice;
+            origin[uAxis] = u * cell;
+            origin[vAxis] = v * cell;
+            extent[uAxis] = width * cell;
+            extent[vAxis] = height * cell;
+
+            addQuad(out, chunkPos, origin, extent, face,
+                    static_cast<BlockType>((key >> 8) - 1), static_cast<uint8_t>(key & 0xFF));
+            u += width;
+        }
+    }
+}
+
+bool ChunkMesher::shouldRenderFace(const std::vector<BlockType>& blocks, int x, int y, int z, int face,
+                                   const ChunkNeighborBorders& neighbors) {
+    int n[3] = {x, y, z};
+    n[FACE_AXIS[face]] += FACE_SIGN[face];
+
+    // Open sky above the world, and the floor below it is never seen
+    if (n[1] >= HEIGHT) return true;
+    if (n[1] < 0) return false;
+
+    // Across a chunk edge, use the neighbour's border if it is loaded
+    if (n[0] < 0 || n[0] >= SIZE || n[2] < 0 || n[2] >= SIZE) {
+        const ChunkBorderSlice* neighbor = neighbors.slices[face];
+        return !neighbor || isFaceVisibleAgainst((*neighbor)[y * SIZE + (FACE_AXIS[face] == 0 ? z : x)]);
+    }
+
+    // Don't render face if neighbor is opaque
+    return isFaceVisibleAgainst(blocks[blockIndex(n[0], n[1], n[2])]);
+}
+
+void ChunkMesher::addQuad(ChunkMeshData& out, const glm::ivec3& chunkPos, const glm::ivec3& origin,
+                          const glm::ivec3& extent, int face, BlockType type, uint8_t light) {
+    const int (*corners)[3] = FACE_CORNERS[face];
+    const uint32_t textureIndex = getTextureIndex(type, face);
+
+    // Texture repeats once per block along each quad edge
+    int uLength = 0;
+    int vLength = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        uLength += std::abs(corners[1][axis] - corners[0][axis]) * extent[axis];
+        vLength += std::abs(corners[2][axis] - corners[1][axis]) * extent[axis];
+    }
+
+    uint32_t baseIdx;
+    if (out.format == VertexFormat::Packed) {
+        baseIdx = static_cast<uint32_t>(out.packedVertices.size());
+        for (int i = 0; i < 4; ++i) {
+            glm::ivec3 corner(corners[i][0], corners[i][1], corners[i][2]);
+            out.packedVertices.push_back(PackedBlockVertex::pack(origin + corner * extent, face, i, light,
+                                                                 textureIndex, uLength, vLength));
+        }
+    } else {
+        baseIdx = static_cast<uint32_t>(out.vertices.size());
+        const glm::vec3 chunkOrigin(chunkPos.x * SIZE, 0.0f, chunkPos.z * SIZE);
+
+        BlockVertex vertex;
+        vertex.normal = glm::vec3(FACE_NORMALS[face][0], FACE_NORMALS[face][1], FACE_NORMALS[face][2]);
+        vertex.lightLevel = light / 255.0f;
+        vertex.textureIndex = textureIndex;
+        for (int i = 0; i < 4; ++i) {
+            glm::ivec3 corner(corners[i][0], corners[i][1], corners[i][2]);
+            vertex.position = chunkOrigin + glm::vec3(origin + corner * extent);
+            vertex.texCoord = {(i == 1 || i == 2) ? static_cast<float>(uLength) : 0.0f,
+                               (i >= 2) ? static_cast<float>(vLength) : 0.0f};
+            out.vertices.push_back(vertex);
+        }
+    }
+
+    // Two triangles
+    out.indices.push_back(baseIdx);
+    out.indices.push_back(baseIdx + 1);
+    out.indices.push_back(baseIdx + 2);
+
+    out.indices.push_back(baseIdx);
+    out.indices.push_back(baseIdx + 2);
+    out.indices.push_back(baseIdx + 3);
+}
+
+uint8_t ChunkMesher::getFaceLight(int face, int y) {
+    // Simple lighting based on face direction and height
+    float light = (face == 4) ? 1.0f : 0.7f + (y / 256.0f) * 0.3f;
+    return static_cast<uint8_t>(light * 255.0f + 0.5f);
+}
+
+uint32_t ChunkMesher::getTextureIndex(BlockType type, int face) {
+    // Map block types to texture atlas positions
+    int texX = 0, texY = 0;
+
+    switch (type) {
+        case BlockType::STONE:
+            texX = 0; texY = 0;
+            break;
+        case BlockType::DIRT:
+            texX = 1; texY = 0;
+            break;
+        case BlockType::GRASS:
+            // Different textures for top, sides, bottom
+            if (face == 4) { texX = 2; texY = 0; } // Top
+            else if (face == 5) { texX = 1; texY = 0; } // Bottom (dirt)
+            else { texX = 3; texY = 0; } // Sides
+            break;
+        case BlockType::WOOD:
+            texX = 4; texY = 0;
+            break;
+        case BlockType::LEAVES:
+            texX = 5; texY = 0;
+            break;
+        case BlockType::SAND:
+            texX = 6; texY = 0;
+            break;
+        case BlockType::WATER:
+            texX = 7; texY = 0;
+            break;
+        case BlockType::GLASS:
+            texX = 8; texY = 0;
+            break;
+        default:
+            texX = 0; texY = 0;
+            break;
+    }
+
+    return static_cast<uint32_t>(texY * ATLAS_TILES_PER_ROW + texX);
+}
+
+bool ChunkMesher::isTransparent(BlockType type) {
+    return type == BlockType::AIR ||
+           type == BlockType::WATER ||
+           type == BlockType::GLASS ||
+           type == BlockType::LEAVES;
+}
+
+bool ChunkMesher::isSolid(BlockType type) {
+    return type != BlockType::AIR && type != BlockType::WATER;
+}
+
+} // namespace clonemine
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace clonemine {
+
+enum class BlockType : uint8_t {
+    AIR = 0,
+    STONE,
+    DIRT,
+    GRASS,
+    WOOD,
+    LEAVES,
+    SAND,
+    WATER,
+    GLASS,
+    COBBLESTONE,
+    BRICK,
+    OBSIDIAN,
+    GOLD_ORE,
+    DIAMOND_ORE,
+    EMERALD_ORE,
+    ICE,
+    LAVA
+};
+
+// texCoord is in block units (0..quad size) and repeats inside the atlas
+// tile selected by textureIndex, so merged quads tile instead of stretching
+struct BlockVertex {
+    glm::vec3 position;
+    glm::vec3 normal;
+    glm::vec2 texCoord;
+    float lightLevel;
+    uint32_t textureIndex;
+};
+
+// Compact chunk-mesh vertex (8 bytes instead of 36).
+// Positions are chunk-local quad corners; the vertex shader adds the chunk
+// origin from a push constant (see shaders/chunk.vert).
+//   data:    x:5 y:9 z:5 (corners reach 16/256/16) | face:3 | corner:2 | light:8
+//   texture: atlas tile:8 | quad length along u:9 | along v:9
+// texCoord is rebuilt from the corner id and quad lengths.
+struct PackedBlockVertex {
+    uint32_t data;
+    uint32_t texture;
+
+    static PackedBlockVertex pack(const glm::ivec3& localPosition, int face, int corner, uint8_t light,
+                                  uint32_t textureIndex, int uLength, int vLength);
+
+    glm::ivec3 getLocalPosition() const {
+        return {static_cast<int>(data & 0x1F), static_cast<int>((data >> 5) & 0x1FF),
+                static_cast<int>((data >> 14) & 0x1F)};
+    }
+    int getFace() const { return static_cast<int>((data >> 19) & 0x7); }
+    int getCorner() const { return static_cast<int>((data >> 22) & 0x3); }
+    uint8_t getLight() const { return static_cast<uint8_t>(data >> 24); }
+    uint32_t getTextureIndex() const { return texture & 0xFF; }
+    glm::vec2 getTexCoord() const;
+};
+static_assert(sizeof(PackedBlockVertex) == 8, "Packed vertex must stay 8 bytes");
+
+enum class VertexFormat {
+    Packed, // PackedBlockVertex, chunk-local
+    Full    // BlockVertex in world space; debug fallback
+};
+
+const char* getVertexFormatName(VertexFormat format);
+
+// CPU-side mesh in one vertex format
+struct ChunkMeshData {
+    VertexFormat format = VertexFormat::Packed;
+    std::vector<PackedBlockVertex> packedVertices;
+    std::vector<BlockVertex> vertices;
+    std::vector<uint32_t> indices;
+
+    void clear() {
+        packedVertices.clear();
+        vertices.clear();
+        indices.clear();
+    }
+    bool empty() const { return indices.empty(); }
+    size_t getVertexCount() const { return format == VertexFormat::Packed ? packedVertices.size() : vertices.size(); }
+    size_t getVertexBytes() const {
+        return format == VertexFormat::Packed ? packedVertices.size() * sizeof(PackedBlockVertex)
+                                              : vertices.size() * sizeof(BlockVertex);
+    }
+    size_t getIndexBytes() const { return indices.size() * sizeof(uint32_t); }
+};
+
+// Blocks of one chunk's boundary plane, indexed y * 16 + (x or z)
+using ChunkBorderSlice = std::array<BlockType, 256 * 16>;
+
+// Read-only views of the blocks just across each horizontal chunk edge,
+// indexed by face id (0=+Z, 1=-Z, 2=-X, 3=+X). Null means the neighbour is
+// not loaded; faces towards it stay visible until it arrives.
+struct ChunkNeighborBorders {
+    std::array<const ChunkBorderSlice*, 4> slices{};
+};
+
+// Bit N set = vertical section N (y in [16N, 16N+16)) holds non-air blocks
+constexpr uint16_t ALL_CHUNK_SECTIONS = 0xFFFF;
+constexpr int CHUNK_SECTION_COUNT = 16;
+
+// Indices of the quads whose lowest corner lies in one vertical section,
+// and the chunk-local height they span (merged quads may reach past it)
+struct ChunkSectionRange {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    uint16_t minY = 0;
+    uint16_t maxY = 0;
+};
+using ChunkSectionRanges = std::array<ChunkSectionRange, CHUNK_SECTION_COUNT>;
+
+// Mesh split by what it depends on: borders[f] holds only the direction-f
+// faces on that chunk edge, so a neighbour change rebuilds just one of them
+struct ChunkMeshParts {
+    ChunkMeshData core;
+    std::array<ChunkMeshData, 4> borders;
+
+    void setFormat(VertexFormat format);
+    void assemble(ChunkMeshData& out) const;
+    // Same, with quads grouped by section so each can be drawn and culled alone
+    void assemble(ChunkMeshData& out, ChunkSectionRanges& sections) const;
+};
+
+enum class MeshingMode {
+    Naive,  // One quad per visible face
+    Greedy  // Coplanar faces with equal block type and light merged into rectangles
+};
+
+const char* getMeshingModeName(MeshingMode mode);
+
+// CPU half of chunk meshing; needs no graphics device.
+// Blocks are a 16x256x16 chunk indexed x + z*16 + y*256. Faces on the chunk
+// edges are culled against neighbour border slices; top faces at the world
+// ceiling are kept and bottom faces at the floor are dropped.
+// Face ids: 0=+Z, 1=-Z, 2=-X, 3=+X, 4=+Y, 5=-Y.
+class ChunkMesher {
+public:
+    static constexpr int CHUNK_SIZE = 16;
+    static constexpr int CHUNK_HEIGHT = 256;
+    static constexpr int SECTION_HEIGHT = 16;
+    static constexpr int ATLAS_TILES_PER_ROW = 16;
+    static constexpr int HORIZONTAL_FACES = 4;
+    static constexpr int MAX_LOD_LEVEL = 3; // 8x8x8-block cells
+
+    static int oppositeFace(int face) { return face ^ 1; }
+
+    // This chunk's boundary plane on the given face. A neighbour across
+    // face f uses it as its slices[oppositeFace(f)].
+    static void extractBorder(const std::vector<BlockType>& blocks, int face, ChunkBorderSlice& out);
+
+    // Level-of-detail copy of a chunk for distant rings: every
+    // 2^lodLevel-sided cell becomes one block, solid if at least half of it
+    // is, of the type most columns show on top inside the cell. Level 0
+    // copies the blocks. Meshing the result with the same lodLevel merges
+    // each cell's faces into single quads.
+    static void downsample(const std::vector<BlockType>& blocks, int lodLevel, std::vector<BlockType>& out);
+
+    // Replaces the mesh in out.format; sections not in sectionMask emit no faces
+    void build(MeshingMode mode, const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+               uint16_t sectionMask, ChunkMeshData& out, const ChunkNeighborBorders& neighbors = {});
+
+    // Same faces, split into core and per-edge border parts. For downsampled
+    // blocks pass their lodLevel: the mesher then steps a whole cell at a
+    // time, reading one block per cell, and face light is constant across it.
+    void build(MeshingMode mode, const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+               uint16_t sectionMask, const ChunkNeighborBorders& neighbors, ChunkMeshParts& out,
+               int lodLevel = 0);
+
+    // Rebuild one border part from this chunk's own boundary plane on that
+    // face and the neighbour's (null if unloaded); touches 4K blocks, not 64K
+    void buildBorder(MeshingMode mode, const glm::ivec3& chunkPos, int face, const ChunkBorderSlice& own,
+                     const ChunkBorderSlice* neighbor, uint16_t sectionMask, ChunkMeshData& out,
+                     int lodLevel = 0);
+
+    static bool shouldRenderFace(const std::vector<BlockType>& blocks, int x, int y, int z, int face,
+                                 const ChunkNeighborBorders& neighbors = {});
+    static bool isTransparent(BlockType type);
+    static bool isSolid(BlockType type);
+
+    // Atlas tile (row-major in a 16x16 grid) for a block face
+    static uint32_t getTextureIndex(BlockType type, int face);
+
+    // Face shading quantised to 0-255; greedy merging requires equal levels
+    static uint8_t getFaceLight(int face, int y);
+
+private:
+    // Mesh every slice of one face direction; the edge slice goes to border
+    void meshFace(MeshingMode mode, const glm::ivec3& chunkPos, const std::vector<BlockType>& blocks,
+                  uint16_t sectionMask, int face, const ChunkBorderSlice* neighbor, int lodLevel,
+                  ChunkMeshData& interior, ChunkMeshData& border);
+
+    // Turn the current slice mask (one entry per cell-sided square) into
+    // quads, merged when greedy
+    void emitMask(MeshingMode mode, const glm::ivec3& chunkPos, int face, int slice, int cell, ChunkMeshData& out);
+
+    // Emit one quad at a chunk-local block position covering extent blocks
+    // (extent is 1 along the face normal)
+    static void addQuad(ChunkMeshData& out, const glm::ivec3& chunkPos, const glm::ivec3& origin,
+                        const glm::ivec3& extent, int face, BlockType type, uint8_t light);
+
+    // Per-slice merge keys for greedy meshing, reused between builds
+    std::vector<uint32_t> m_mask;
+};
+
+} // namespace clonemine
@@ -1,118 +1,574 @@
 #include "EffectRenderer.h"
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
 
 namespace clonemine {
 
+namespace {
+    constexpr float TWO_PI = 6.28318530f;
+    constexpr uint32_t WORKGROUP_SIZE = 64;
+    // Covers minStorageBufferOffsetAlignment on every conformant device
+    constexpr VkDeviceSize REGION_ALIGNMENT = 256;
+
+    // Push constants of shaders/particles.comp
+    enum SimulationMode : uint32_t {
+        MODE_SIMULATE = 0,  // Age and move the source particles, append survivors
+        MODE_EMIT = 1,      // Spawn the frame's emitters, append survivors
+        MODE_FINALIZE = 2   // Clamp the count and write the indirect arguments
+    };
+
+    struct SimulationConstants {
+        float deltaTime;
+        uint32_t mode;
+        uint32_t source;       // Which count belongs to the source buffer
+        uint32_t emitterCount;
+        uint32_t newParticles;
+        uint32_t capacity;
+    };
+
+    // Start of the particle buffer (Counters in particles.comp)
+    struct ParticleCounters {
+        uint32_t count[2];
+        uint32_t padding[2];
+        VkDrawIndirectCommand draw;
+        VkDispatchIndirectCommand dispatch;
+        uint32_t padding2;
+    };
+    static_assert(sizeof(ParticleCounters) == 48, "Must match Counters in particles.comp");
+
+    VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    std::vector<char> readFile(const std::string& filename) {
+        std::ifstream file(filename, std::ios::ate | std::ios::binary);
+
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to open file: " + filename);
+        }
+
+        size_t fileSize = static_cast<size_t>(file.tellg());
+        std::vector<char> buffer(fileSize);
+
+        file.seekg(0);
+        file.read(buffer.data(), fileSize);
+        return buffer;
+    }
+
+    // The random and spawn functions below are mirrored in particles.comp;
+    // keep them in step so both paths follow the same formulas
+
+    // PCG hash
+    uint32_t hashUint(uint32_t x) {
+        uint32_t state = x * 747796405u + 2891336453u;
+        uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+
+    // [0, 1) from the top 24 bits, exact in float
+    float randomFloat(uint32_t& state) {
+        state = hashUint(state);
+        return static_cast<float>(state >> 8) * (1.0f / 16777216.0f);
+    }
+
+    Particle spawnParticle(const ParticleEmitter& emitter, uint32_t index) {
+        uint32_t state = hashUint(emitter.seed ^ hashUint(index));
+
+        Particle p;
+        p.position = glm::vec3(emitter.position);
+        p.velocity = glm::vec3(emitter.velocity);
+        p.color = emitter.color;
+        p.size = emitter.size;
+        p.lifetime = 0.0f;
+        p.maxLifetime = emitter.lifetime;
+        p.gravity = emitter.gravity;
+
+        switch (emitter.shape) {
+            case ParticleEmitterShape::POINT: {
+                float x = randomFloat(state) * 2.0f - 1.0f;
+                float y = randomFloat(state) * 2.0f - 1.0f;
+                float z = randomFloat(state) * 2.0f - 1.0f;
+                p.velocity += glm::vec3(x, y, z) * emitter.velocity.w;
+                break;
+            }
+            case ParticleEmitterShape::BURST: {
+                float angle = randomFloat(state) * TWO_PI;
+                float speed = emitter.speed * (0.5f + 0.5f * randomFloat(state));
+                float rise = emitter.velocity.y * randomFloat(state);
+                p.velocity = glm::vec3(std::cos(angle) * speed, rise, std::sin(angle) * speed);
+                break;
+            }
+            case ParticleEmitterShape::RING: {
+                float angle = TWO_PI * static_cast<float>(index) / static_cast<float>(emitter.count);
+                glm::vec3 outward(std::cos(angle), 0.0f, std::sin(angle));
+                p.position += outward * emitter.position.w;
+                p.velocity += glm::vec3(-outward.z, 0.0f, outward.x) * emitter.speed;
+                break;
+            }
+        }
+        return p;
+    }
+
+    // False once the particle has expired
+    bool integrate(Particle& p, float deltaTime) {
+        p.velocity.y -= p.gravity * deltaTime;
+        p.position += p.velocity * deltaTime;
+        p.lifetime += deltaTime;
+        if (p.lifetime >= p.maxLifetime) return false;
+
+        // Fade alpha as particle ages
+        p.color.a = 1.0f - p.lifetime / p.maxLifetime;
+        return true;
+    }
+
+    glm::vec4 getElementColor(ElementalDamageType type) {
+        switch (type) {
+            case ElementalDamageType::FIRE: return {1.0f, 0.45f, 0.1f, 1.0f};
+            case ElementalDamageType::ICE: return {0.5f, 0.8f, 1.0f, 1.0f};
+            case ElementalDamageType::NATURE: return {0.3f, 0.9f, 0.3f, 1.0f};
+            case ElementalDamageType::ACID: return {0.6f, 1.0f, 0.1f, 1.0f};
+            case ElementalDamageType::NECROTIC: return {0.3f, 0.5f, 0.2f, 1.0f};
+            case ElementalDamageType::ARCANE: return {0.7f, 0.4f, 1.0f, 1.0f};
+            case ElementalDamageType::SHADOW: return {0.25f, 0.1f, 0.35f, 1.0f};
+            case ElementalDamageType::RADIANT: return {1.0f, 0.95f, 0.6f, 1.0f};
+            case ElementalDamageType::HOLY: return {1.0f, 0.85f, 0.3f, 1.0f};
+            case ElementalDamageType::LIGHTNING: return {0.8f, 0.9f, 1.0f, 1.0f};
+            case ElementalDamageType::CONJURING: return {0.4f, 0.6f, 0.9f, 1.0f};
+            case ElementalDamageType::PSIONIC: return {1.0f, 0.4f, 0.8f, 1.0f};
+            case ElementalDamageType::WATER: return {0.2f, 0.5f, 1.0f, 1.0f};
+            default: return {0.8f, 0.8f, 0.8f, 1.0f};
+        }
+    }
+}
+
 EffectRenderer::EffectRenderer() {
     m_particles.reserve(10000);
 }
 
-EffectRenderer::~EffectRenderer() = default;
+EffectRenderer::EffectRenderer(VkDevice device, GpuMemoryArena& arena, const std::string& computeShaderPath)
+    : m_gpuSimulated(true), m_device(device), m_arena(&arena) {
+    createBuffers();
+    createDescriptors();
+    createPipeline(computeShaderPath);
+}
+
+EffectRenderer::~EffectRenderer() {
+    if (!m_gpuSimulated) return;
+
+    if (m_computePipeline != VK_NULL_HANDLE) {
+        vkDestroyPipeline(m_device, m_computePipeline, nullptr);
+    }
+    if (m_computeLayout != VK_NULL_HANDLE) {
+        vkDestroyPipelineLayout(m_device, m_computeLayout, nullptr);
+    }
+    if (m_descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+    }
+    if (m_setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+    }
+    for (VkBuffer buffer : {m_particleBuffer, m_emitterBuffer}) {
+        if (buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(m_device, buffer, nullptr);
+        }
+    }
+    m_arena->free(m_emitterAllocation);
+    m_arena->free(m_particleAllocation);
+}
+
+void EffectRenderer::createBuffers() {
+    auto createBuffer = [&](VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                            VkBuffer& buffer, GpuMemoryAllocation& allocation) {
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+        if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+            throw std::runtime_error("Failed to create particle buffer!");
+        }
+
+        VkMemoryRequirements memRequirements;
+        vkGetBufferMemoryRequirements(m_device, buffer, &memRequirements);
+
+        allocation = m_arena->allocate(memRequirements, properties);
+        vkBindBufferMemory(m_device, buffer, allocation.memory, allocation.offset);
+    };
+
+    const VkDeviceSize particleBytes = alignUp(MAX_PARTICLES * sizeof(Particle), REGION_ALIGNMENT);
+    createBuffer(REGION_ALIGNMENT + 2 * particleBytes,
+                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+                 VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, m_particleBuffer, m_particleAllocation);
+
+    const VkDeviceSize emitterBytes = alignUp(MAX_EMITTERS_PER_FRAME * sizeof(ParticleEmitter), REGION_ALIGNMENT);
+    createBuffer(FRAMES_IN_FLIGHT * emitterBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                 VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                 m_emitterBuffer, m_emitterAllocation);
+
+    // The arena keeps host-visible blocks mapped
+    m_emitterMapped = static_cast<uint8_t*>(m_emitterAllocation.mapped);
+}
+
+void EffectRenderer::createDescriptors() {
+    // 0 = counters, 1 = source particles, 2 = target particles (also read by
+    // particle.vert), 3 = emitters
+    std::array<VkDescriptorSetLayoutBinding, 4> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    bindings[2].stageFlags |= VK_SHADER_STAGE_VERTEX_BIT;
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create particle descriptor set layout!");
+    }
+
+    // One set per direction of the ping-pong and frame slot
+    const uint32_t setCount = 2 * FRAMES_IN_FLIGHT;
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = static_cast<uint32_t>(bindings.size()) * setCount;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = setCount;
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create particle descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(setCount, m_setLayout);
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = setCount;
+    allocInfo.pSetLayouts = layouts.data();
+
+    m_descriptorSets.resize(setCount);
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, m_descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate particle descriptor sets!");
+    }
+
+    const VkDeviceSize particleBytes = alignUp(MAX_PARTICLES * sizeof(Particle), REGION_ALIGNMENT);
+    const VkDeviceSize emitterBytes = alignUp(MAX_EMITTERS_PER_FRAME * sizeof(ParticleEmitter), REGION_ALIGNMENT);
+    for (uint32_t source = 0; source < 2; ++source) {
+        for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame) {
+            std::array<VkDescriptorBufferInfo, 4> buffers = {{
+                {m_particleBuffer, 0, sizeof(ParticleCounters)},
+                {m_particleBuffer, REGION_ALIGNMENT + source * particleBytes, particleBytes},
+                {m_particleBuffer, REGION_ALIGNMENT + (1 - source) * particleBytes, particleBytes},
+                {m_emitterBuffer, frame * emitterBytes, emitterBytes},
+            }};
+
+            std::array<VkWriteDescriptorSet, 4> writes{};
+            for (uint32_t i = 0; i < writes.size(); ++i) {
+                writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+                writes[i].dstSet = getDescriptorSet(source, frame);
+                writes[i].dstBinding = i;
+                writes[i].descriptorCount = 1;
+                writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+                writes[i].pBufferInfo = &buffers[i];
+            }
+            vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+        }
+    }
+}
+
+void EffectRenderer::createPipeline(const std::string& shaderPath) {
+    VkPushConstantRange pushRange{};
+    pushRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushRange.offset = 0;
+    pushRange.size = sizeof(SimulationConstants);
+
+    VkPipelineLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &m_setLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushRange;
+
+    if (vkCreatePipelineLayout(m_device, &layoutInfo, nullptr, &m_computeLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create particle pipeline layout!");
+    }
+
+    std::vector<char> code = readFile(shaderPath);
+
+    VkShaderModuleCreateInfo moduleInfo{};
+    moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+    moduleInfo.codeSize = code.size();
+    moduleInfo.pCode = reinterpret_cast<const uint32_t*>(code.data());
+
+    VkShaderModule shaderModule;
+    if (vkCreateShaderModule(m_device, &moduleInfo, nullptr, &shaderModule) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create shader module!");
+    }
+
+    VkComputePipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineInfo.stage.module = shaderModule;
+    pipelineInfo.stage.pName = "main";
+    pipelineInfo.layout = m_computeLayout;
+
+    VkResult result = vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr,
+                                               &m_computePipeline);
+    vkDestroyShaderModule(m_device, shaderModule, nullptr);
+    if (result != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create particle pipeline!");
+    }
+}
+
+void EffectRenderer::setPipeline(VkPipeline pipeline, VkPipelineLayout layout) {
+    m_pipeline = pipeline;
+    m_pipelineLayout = layout;
+}
 
-void EffectRenderer::renderParticles(VkCommandBuffer cmdBuffer) {
-    if (m_particles.empty()) return;
-    
-    buildInstanceBuffer();
-    // Bind particle shader pipeline
-    // Draw instanced particles (all in one draw call)
+void EffectRenderer::setSeed(uint32_t seed) {
+    m_seed = seed;
+    m_emitterSerial = 0;
+}
+
+void EffectRenderer::emit(ParticleEmitter emitter) {
+    if (emitter.count == 0) return;
+    emitter.seed = hashUint(m_seed ^ hashUint(m_emitterSerial++));
+    m_emitters.push_back(emitter);
+}
+
+uint32_t EffectRenderer::packEmitters(std::vector<ParticleEmitter>& packed) {
+    packed.clear();
+    uint32_t total = 0;
+    while (!m_emitters.empty() && packed.size() < MAX_EMITTERS_PER_FRAME) {
+        ParticleEmitter emitter = m_emitters.front();
+        m_emitters.pop_front();
+        emitter.firstParticle = total;
+        total += emitter.count;
+        packed.push_back(emitter);
+    }
+    return total;
 }
 
 void EffectRenderer::updateParticles(float deltaTime) {
-    // Update all particles
-    for (auto& particle : m_particles) {
-        particle.position += particle.velocity * deltaTime;
-        particle.lifetime += deltaTime;
-        
-        // Fade alpha as particle ages
-        float lifePercent = particle.lifetime / particle.maxLifetime;
-        particle.color.a = 1.0f - lifePercent;
+    if (isGpuSimulated()) {
+        m_pendingDelta += deltaTime;
+        return;
+    }
+
+    // Same steps as particles.comp: age the live particles, then spawn the
+    // new ones and give them their first step
+    size_t alive = 0;
+    for (size_t i = 0; i < m_particles.size(); ++i) {
+        Particle particle = m_particles[i];
+        if (integrate(particle, deltaTime)) {
+            m_particles[alive++] = particle;
+        }
+    }
+    m_particles.resize(alive);
+
+    packEmitters(m_packed);
+    for (const ParticleEmitter& emitter : m_packed) {
+        for (uint32_t i = 0; i < emitter.count && m_particles.size() < MAX_PARTICLES; ++i) {
+            Particle particle = spawnParticle(emitter, i);
+            if (integrate(particle, deltaTime)) {
+                m_particles.push_back(particle);
+            }
+        }
     }
-    
-    // Remove dead particles
-    m_particles.erase(
-        std::remove_if(m_particles.begin(), m_particles.end(),
-            [](const Particle& p) { return p.lifetime >= p.maxLifetime; }),
-        m_particles.end()
-    );
 }
 
-void EffectRenderer::spawnFireball(glm::vec3 start, glm::vec3 target) {
-    glm::vec3 direction = glm::normalize(target - start);
-    
-    for (int i = 0; i < 20; ++i) {
-        Particle p;
-        p.position = start;
-        p.velocity = direction * 15.0f + glm::vec3(
-            (rand() % 100 - 50) / 100.0f,
-            (rand() % 100 - 50) / 100.0f,
-            (rand() % 100 - 50) / 100.0f
-        );
-        p.color = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f); // Orange
-        p.lifetime = 0.0f;
-        p.maxLifetime = 1.0f;
-        p.size = 0.3f;
-        m_particles.push_back(p);
+void EffectRenderer::simulate(VkCommandBuffer cmd, uint32_t frameSlot) {
+    if (!isGpuSimulated()) return;
+
+    const uint32_t newParticles = packEmitters(m_packed);
+    if (!m_packed.empty()) {
+        const VkDeviceSize emitterBytes = alignUp(MAX_EMITTERS_PER_FRAME * sizeof(ParticleEmitter), REGION_ALIGNMENT);
+        std::memcpy(m_emitterMapped + frameSlot * emitterBytes, m_packed.data(),
+                    m_packed.size() * sizeof(ParticleEmitter));
     }
+
+    // The previous frame may still be drawing from the buffer about to be
+    // written, and its counters must be visible to the indirect dispatch
+    VkMemoryBarrier previousBarrier{};
+    previousBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    previousBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    previousBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT |
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         1, &previousBarrier, 0, nullptr, 0, nullptr);
+
+    const uint32_t source = m_source;
+    const uint32_t target = 1 - source;
+    if (!m_countersCleared) {
+        vkCmdFillBuffer(cmd, m_particleBuffer, 0, sizeof(ParticleCounters), 0);
+        m_countersCleared = true;
+    } else {
+        vkCmdFillBuffer(cmd, m_particleBuffer, offsetof(ParticleCounters, count) + target * sizeof(uint32_t),
+                        sizeof(uint32_t), 0);
+    }
+
+    VkMemoryBarrier clearBarrier{};
+    clearBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    clearBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    clearBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT |
+                                 VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                         VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0,
+                         1, &clearBarrier, 0, nullptr, 0, nullptr);
+
+    VkDescriptorSet set = getDescriptorSet(source, frameSlot);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_computePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, m_computeLayout, 0, 1, &set, 0, nullptr);
+
+    SimulationConstants constants{};
+    constants.deltaTime = m_pendingDelta;
+    constants.mode = MODE_SIMULATE;
+    constants.source = source;
+    constants.emitterCount = static_cast<uint32_t>(m_packed.size());
+    constants.newParticles = newParticles;
+    constants.capacity = MAX_PARTICLES;
+
+    // Sized by the previous finalize for the source count
+    vkCmdPushConstants(cmd, m_computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+    vkCmdDispatchIndirect(cmd, m_particleBuffer, offsetof(ParticleCounters, dispatch));
+
+    // Both passes append to the target through the same counter
+    if (newParticles > 0) {
+        constants.mode = MODE_EMIT;
+        vkCmdPushConstants(cmd, m_computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+        vkCmdDispatch(cmd, (newParticles + WORKGROUP_SIZE - 1) / WORKGROUP_SIZE, 1, 1);
+    }
+
+    VkMemoryBarrier appendBarrier{};
+    appendBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    appendBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    appendBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0,
+                         1, &appendBarrier, 0, nullptr, 0, nullptr);
+
+    constants.mode = MODE_FINALIZE;
+    vkCmdPushConstants(cmd, m_computeLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(constants), &constants);
+    vkCmdDispatch(cmd, 1, 1, 1);
+
+    VkMemoryBarrier drawBarrier{};
+    drawBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    drawBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    drawBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                         VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0,
+                         1, &drawBarrier, 0, nullptr, 0, nullptr);
+
+    m_drawSet = source * FRAMES_IN_FLIGHT + frameSlot;
+    m_source = target;
+    m_pendingDelta = 0.0f;
+}
+
+void EffectRenderer::renderParticles(VkCommandBuffer cmdBuffer, const glm::mat4& view,
+                                     const glm::mat4& projection) {
+    if (m_pipeline == VK_NULL_HANDLE || m_drawSet == UINT32_MAX) return;
+
+    ParticlePushConstants constants;
+    constants.viewProj = projection * view;
+    // Camera axes in world space are the rows of the view rotation
+    constants.cameraRight = glm::vec4(view[0][0], view[1][0], view[2][0], 0.0f);
+    constants.cameraUp = glm::vec4(view[0][1], view[1][1], view[2][1], 0.0f);
+
+    vkCmdBindPipeline(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    vkCmdBindDescriptorSets(cmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1,
+                            &m_descriptorSets[m_drawSet], 0, nullptr);
+    vkCmdPushConstants(cmdBuffer, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+    // One quad per particle; the count never reaches the CPU
+    vkCmdDrawIndirect(cmdBuffer, m_particleBuffer, offsetof(ParticleCounters, draw), 1,
+                      sizeof(VkDrawIndirectCommand));
+}
+
+void EffectRenderer::spawnFireball(glm::vec3 start, glm::vec3 target) {
+    ParticleEmitter emitter;
+    emitter.position = glm::vec4(start, 0.0f);
+    emitter.velocity = glm::vec4(glm::normalize(target - start) * 15.0f, 0.5f);
+    emitter.color = glm::vec4(1.0f, 0.5f, 0.0f, 1.0f); // Orange
+    emitter.lifetime = 1.0f;
+    emitter.size = 0.3f;
+    emitter.count = 20;
+    emit(emitter);
 }
 
 void EffectRenderer::spawnFrostbolt(glm::vec3 start, glm::vec3 target) {
-    glm::vec3 direction = glm::normalize(target - start);
-    
-    for (int i = 0; i < 15; ++i) {
-        Particle p;
-        p.position = start;
-        p.velocity = direction * 12.0f;
-        p.color = glm::vec4(0.5f, 0.7f, 1.0f, 1.0f); // Light blue
-        p.lifetime = 0.0f;
-        p.maxLifetime = 1.2f;
-        p.size = 0.25f;
-        m_particles.push_back(p);
-    }
+    ParticleEmitter emitter;
+    emitter.position = glm::vec4(start, 0.0f);
+    emitter.velocity = glm::vec4(glm::normalize(target - start) * 12.0f, 0.0f);
+    emitter.color = glm::vec4(0.5f, 0.7f, 1.0f, 1.0f); // Light blue
+    emitter.lifetime = 1.2f;
+    emitter.size = 0.25f;
+    emitter.count = 15;
+    emit(emitter);
 }
 
 void EffectRenderer::spawnHealingEffect(glm::vec3 position) {
-    for (int i = 0; i < 30; ++i) {
-        Particle p;
-        p.position = position;
-        p.velocity = glm::vec3(0.0f, 2.0f, 0.0f); // Rise upward
-        p.color = glm::vec4(0.2f, 1.0f, 0.3f, 1.0f); // Green
-        p.lifetime = 0.0f;
-        p.maxLifetime = 2.0f;
-        p.size = 0.2f;
-        m_particles.push_back(p);
-    }
+    ParticleEmitter emitter;
+    emitter.position = glm::vec4(position, 0.0f);
+    emitter.velocity = glm::vec4(0.0f, 2.0f, 0.0f, 0.0f); // Rise upward
+    emitter.color = glm::vec4(0.2f, 1.0f, 0.3f, 1.0f); // Green
+    emitter.lifetime = 2.0f;
+    emitter.size = 0.2f;
+    emitter.count = 30;
+    emit(emitter);
 }
 
 void EffectRenderer::spawnExplosion(glm::vec3 position, float radius) {
-    for (int i = 0; i < 50; ++i) {
-        Particle p;
-        p.position = position;
-        float angle = (rand() % 360) * 3.14159f / 180.0f;
-        float speed = 5.0f + (rand() % 100) / 20.0f;
-        p.velocity = glm::vec3(
-            cos(angle) * speed,
-            (rand() % 100) / 50.0f,
-            sin(angle) * speed
-        );
-        p.color = glm::vec4(1.0f, 0.3f, 0.0f, 1.0f); // Red-orange
-        p.lifetime = 0.0f;
-        p.maxLifetime = 0.8f;
-        p.size = 0.4f;
-        m_particles.push_back(p);
-    }
+    ParticleEmitter emitter;
+    emitter.shape = ParticleEmitterShape::BURST;
+    emitter.position = glm::vec4(position, 0.0f);
+    emitter.velocity = glm::vec4(0.0f, 2.0f, 0.0f, 0.0f); // Upward kick
+    emitter.color = glm::vec4(1.0f, 0.3f, 0.0f, 1.0f); // Red-orange
+    emitter.lifetime = 0.8f;
+    // The fastest particles reach the edge of the blast
+    emitter.speed = radius / emitter.lifetime;
+    emitter.size = 0.4f;
+    emitter.count = 50;
+    emit(emitter);
 }
 
 void EffectRenderer::renderGroundCircle(glm::vec3 center, float radius, glm::vec4 color) {
-    // Render AOE circle on ground using triangle fan
+    // A ring of short-lived markers on the ground
+    ParticleEmitter emitter;
+    emitter.shape = ParticleEmitterShape::RING;
+    emitter.position = glm::vec4(center, radius);
+    emitter.color = color;
+    emitter.lifetime = 0.05f;
+    emitter.size = 0.15f;
+    emitter.count = static_cast<uint32_t>(std::clamp(radius * 8.0f, 16.0f, 128.0f));
+    emit(emitter);
 }
 
 void EffectRenderer::renderAura(glm::vec3 center, ElementalDamageType type) {
-    // Spawn orbiting particles around center point
-    // Color based on damage type
-}
-
-void EffectRenderer::buildInstanceBuffer() {
-    // Build instance buffer for GPU with all particle transforms
+    // Orbiting particles around center point, colored by damage type
+    ParticleEmitter emitter;
+    emitter.shape = ParticleEmitterShape::RING;
+    emitter.position = glm::vec4(center, 1.5f);
+    emitter.velocity = glm::vec4(0.0f, 0.5f, 0.0f, 0.0f);
+    emitter.color = getElementColor(type);
+    emitter.lifetime = 0.5f;
+    emitter.speed = 1.5f;
+    emitter.size = 0.15f;
+    emitter.count = 24;
+    emit(emitter);
 }
 
 } // namespace clonemine
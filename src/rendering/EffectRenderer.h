@@ -1,43 +1,167 @@
 #pragma once
 
+#include "GpuMemoryArena.h"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <deque>
+#include <string>
 #include <vector>
 #include "../combat/DamageTypes.h"
 
 namespace clonemine {
 
+// One particle (std430, see shaders/particles.comp)
 struct Particle {
-    glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec4 color;
-    float lifetime;
-    float maxLifetime;
-    float size;
+    glm::vec3 position{0.0f};
+    float size = 0.0f;
+    glm::vec3 velocity{0.0f};
+    float lifetime = 0.0f;
+    glm::vec4 color{1.0f};
+    float maxLifetime = 0.0f;
+    float gravity = 0.0f;       // Downward acceleration
+    uint32_t padding[2] = {};
 };
+static_assert(sizeof(Particle) == 64, "Must match Particle in particles.comp");
 
+enum class ParticleEmitterShape : uint32_t {
+    POINT,  // From the origin at the base velocity plus jitter
+    BURST,  // Outwards in random horizontal directions
+    RING    // Evenly around a horizontal circle, orbiting it
+};
+
+// A batch of particles to spawn (std430, see shaders/particles.comp).
+// Particles are derived from the seed and their index alone, so a path
+// spawns the same particles whenever it is given the same seed.
+struct ParticleEmitter {
+    glm::vec4 position{0.0f};   // xyz = origin, w = ring radius
+    glm::vec4 velocity{0.0f};   // xyz = base velocity, w = random jitter per axis
+    glm::vec4 color{1.0f};
+    float lifetime = 1.0f;
+    float size = 0.25f;
+    float gravity = 0.0f;
+    float speed = 0.0f;         // Burst: top outward speed; ring: orbit speed
+    ParticleEmitterShape shape = ParticleEmitterShape::POINT;
+    uint32_t count = 0;
+    uint32_t seed = 0;          // Assigned by EffectRenderer::emit
+    uint32_t firstParticle = 0; // Assigned when the frame's emitters are packed
+};
+static_assert(sizeof(ParticleEmitter) == 80, "Must match Emitter in particles.comp");
+
+struct ParticlePushConstants {
+    glm::mat4 viewProj;
+    glm::vec4 cameraRight;
+    glm::vec4 cameraUp;
+};
+
+// Spell and combat particles.
+//
+// With a device, particles live only on the GPU: spawn calls queue small
+// emitter commands, a compute pass simulates, spawns and compacts the
+// particles between two persistent buffers, and one indirect draw renders
+// them. Without a device the same simulation runs on the CPU, for headless
+// tests and servers; for a fixed seed it reproduces the same particles run
+// after run (see benchmarks/effect_benchmark.cpp). The GPU follows the same
+// formulas, but GLSL cos/sin and its particle order differ, so its results
+// are only close to the CPU's.
 class EffectRenderer {
 public:
+    static constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+    static constexpr uint32_t MAX_PARTICLES = 65536;
+    static constexpr uint32_t MAX_EMITTERS_PER_FRAME = 256;
+
+    // CPU simulation
     EffectRenderer();
+    // GPU simulation with buffers from arena, which must outlive the
+    // renderer; throws std::runtime_error if the compute shader or GPU
+    // objects cannot be created
+    EffectRenderer(VkDevice device, GpuMemoryArena& arena, const std::string& computeShaderPath);
     ~EffectRenderer();
-    
-    void renderParticles(VkCommandBuffer cmdBuffer);
+
+    EffectRenderer(const EffectRenderer&) = delete;
+    EffectRenderer& operator=(const EffectRenderer&) = delete;
+
+    // Advance by deltaTime and spawn the queued emitters. On the GPU path
+    // this only accumulates time; simulate() records the work.
     void updateParticles(float deltaTime);
-    
+
+    // GPU path, outside the render pass, after waiting on frameSlot's fence
+    void simulate(VkCommandBuffer cmd, uint32_t frameSlot);
+
+    // GPU path, inside the render pass: one indirect draw of camera-facing
+    // quads with the pipeline from setPipeline()
+    void renderParticles(VkCommandBuffer cmdBuffer, const glm::mat4& view, const glm::mat4& projection);
+
+    // Particle pipeline; its layout must use getSetLayout() as set 0 and
+    // ParticlePushConstants for the vertex stage. It has no vertex input.
+    void setPipeline(VkPipeline pipeline, VkPipelineLayout layout);
+    [[nodiscard]] VkDescriptorSetLayout getSetLayout() const noexcept { return m_setLayout; }
+
     void spawnFireball(glm::vec3 start, glm::vec3 target);
     void spawnFrostbolt(glm::vec3 start, glm::vec3 target);
     void spawnHealingEffect(glm::vec3 position);
     void spawnExplosion(glm::vec3 position, float radius);
-    
+
+    // Both emit one frame's worth of particles; call every frame while shown
     void renderGroundCircle(glm::vec3 center, float radius, glm::vec4 color);
     void renderAura(glm::vec3 center, ElementalDamageType type);
-    
-    void buildInstanceBuffer();
-    
+
+    // Queue an emitter for the next update
+    void emit(ParticleEmitter emitter);
+
+    // Seed for the emitters queued from now on
+    void setSeed(uint32_t seed);
+
+    bool isGpuSimulated() const { return m_gpuSimulated; }
+    // CPU path only; the GPU keeps its particles to itself
+    const std::vector<Particle>& getParticles() const { return m_particles; }
+    size_t getPendingEmitterCount() const { return m_emitters.size(); }
+
 private:
+    void createBuffers();
+    void createDescriptors();
+    void createPipeline(const std::string& shaderPath);
+
+    // Take up to MAX_EMITTERS_PER_FRAME queued emitters, numbering their
+    // particles consecutively; returns the particle total
+    uint32_t packEmitters(std::vector<ParticleEmitter>& packed);
+
+    VkDescriptorSet getDescriptorSet(uint32_t source, uint32_t frameSlot) const {
+        return m_descriptorSets[source * FRAMES_IN_FLIGHT + frameSlot];
+    }
+
+    std::deque<ParticleEmitter> m_emitters;
+    std::vector<ParticleEmitter> m_packed;
+    uint32_t m_seed = 0;
+    uint32_t m_emitterSerial = 0;
+
+    bool m_gpuSimulated = false;
+
+    // CPU path
     std::vector<Particle> m_particles;
-    VkBuffer m_instanceBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory m_instanceMemory = VK_NULL_HANDLE;
+
+    // GPU path: counters and indirect arguments, then the two particle
+    // buffers that simulation ping-pongs between
+    VkDevice m_device{VK_NULL_HANDLE};
+    GpuMemoryArena* m_arena = nullptr;
+    VkBuffer m_particleBuffer{VK_NULL_HANDLE};
+    GpuMemoryAllocation m_particleAllocation;
+    // Per frame slot: that frame's emitters
+    VkBuffer m_emitterBuffer{VK_NULL_HANDLE};
+    GpuMemoryAllocation m_emitterAllocation;
+    uint8_t* m_emitterMapped = nullptr;
+
+    VkDescriptorSetLayout m_setLayout{VK_NULL_HANDLE};
+    VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+    std::vector<VkDescriptorSet> m_descriptorSets; // By source buffer, then frame slot
+    VkPipelineLayout m_computeLayout{VK_NULL_HANDLE};
+    VkPipeline m_computePipeline{VK_NULL_HANDLE};
+    VkPipeline m_pipeline{VK_NULL_HANDLE};
+    VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+
+    float m_pendingDelta = 0.0f;
+    uint32_t m_source = 0;                  // Buffer the next simulate() reads
+    uint32_t m_drawSet = UINT32_MAX;        // Set of the last simulate(), for drawing
+    bool m_countersCleared = false;
 };
 
 } // namespace clonemine
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+
+namespace clonemine {
+
+// View frustum as six inward-facing planes (xyz = normal, w = distance),
+// ordered left, right, bottom, top, near, far
+struct Frustum {
+    std::array<glm::vec4, 6> planes;
+
+    // Gribb/Hartmann extraction. The near plane uses the -1..1 depth
+    // convention, which is conservative for Vulkan's 0..1 depth.
+    static Frustum fromViewProj(const glm::mat4& viewProj) {
+        auto row = [&viewProj](int i) {
+            return glm::vec4(viewProj[0][i], viewProj[1][i], viewProj[2][i], viewProj[3][i]);
+        };
+
+        Frustum frustum;
+        frustum.planes[0] = row(3) + row(0);
+        frustum.planes[1] = row(3) - row(0);
+        frustum.planes[2] = row(3) + row(1);
+        frustum.planes[3] = row(3) - row(1);
+        frustum.planes[4] = row(3) + row(2);
+        frustum.planes[5] = row(3) - row(2);
+
+        for (auto& plane : frustum.planes) {
+            plane /= glm::length(glm::vec3(plane));
+        }
+        return frustum;
+    }
+
+    bool intersectsAabb(const glm::vec3& min, const glm::vec3& max) const {
+        for (const auto& plane : planes) {
+            // Corner furthest along the plane normal
+            glm::vec3 corner(plane.x >= 0.0f ? max.x : min.x,
+                             plane.y >= 0.0f ? max.y : min.y,
+                             plane.z >= 0.0f ? max.z : min.z);
+            if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool intersectsSphere(const glm::vec3& center, float radius) const {
+        for (const auto& plane : planes) {
+            if (glm::dot(glm::vec3(plane), center) + plane.w < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace clonemine
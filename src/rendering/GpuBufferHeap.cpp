@@ -0,0 +1,160 @@
+#include "GpuBufferHeap.h"
+#include <iomanip>
+#include <stdexcept>
+
+namespace clonemine {
+
+GpuBufferHeap::GpuBufferHeap(VkDevice device, GpuMemoryArena& arena, VkDeviceSize capacity,
+                             VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, uint32_t framesInFlight)
+    : m_device(device), m_arena(arena), m_allocator(capacity), m_retired(framesInFlight) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = capacity;
+    // Defragmentation copies within the buffer
+    bufferInfo.usage = usage | VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create buffer heap!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_device, m_buffer, &memRequirements);
+
+    try {
+        m_allocation = m_arena.allocate(memRequirements, properties);
+    } catch (...) {
+        vkDestroyBuffer(m_device, m_buffer, nullptr);
+        throw;
+    }
+
+    vkBindBufferMemory(m_device, m_buffer, m_allocation.memory, m_allocation.offset);
+
+    // Null unless host-visible; the arena keeps those blocks mapped
+    m_mapped = static_cast<uint8_t*>(m_allocation.mapped);
+}
+
+GpuBufferHeap::~GpuBufferHeap() {
+    if (m_buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(m_device, m_buffer, nullptr);
+    }
+    m_arena.free(m_allocation);
+}
+
+void GpuBufferHeap::beginFrame(uint32_t frameSlot) {
+    m_currentSlot = frameSlot;
+    for (TlsfAllocator::Handle range : m_retired[frameSlot]) {
+        m_allocator.free(range);
+    }
+    m_retired[frameSlot].clear();
+}
+
+GpuHeapHandle GpuBufferHeap::allocate(VkDeviceSize size, VkDeviceSize alignment) {
+    TlsfAllocator::Handle range = m_allocator.allocate(size, alignment);
+    if (range == TlsfAllocator::INVALID_HANDLE) {
+        m_failedAllocations++;
+        return {};
+    }
+
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slot = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    m_slots[slot] = {range, alignment};
+    setOwner(range, slot);
+    return {slot};
+}
+
+void GpuBufferHeap::free(GpuHeapHandle& handle) {
+    if (!handle.valid()) return;
+
+    Slot& slot = m_slots[handle.id];
+    setOwner(slot.range, NO_SLOT);
+    m_retired[m_currentSlot].push_back(slot.range);
+    slot = {};
+    m_freeSlots.push_back(handle.id);
+    handle = {};
+}
+
+VkDeviceSize GpuBufferHeap::getOffset(GpuHeapHandle handle) const {
+    return m_allocator.getOffset(m_slots[handle.id].range);
+}
+
+VkDeviceSize GpuBufferHeap::getSize(GpuHeapHandle handle) const {
+    return m_allocator.getSize(m_slots[handle.id].range);
+}
+
+void* GpuBufferHeap::getMapped(GpuHeapHandle handle) const {
+    return m_mapped ? m_mapped + getOffset(handle) : nullptr;
+}
+
+VkDeviceSize GpuBufferHeap::defragment(VkCommandBuffer cmd, VkDeviceSize maxBytes) {
+    // Walk down from the top of the heap, dropping each range into the
+    // lowest gap that fits. The old range is retired like a free, so frames
+    // in flight still read valid data and no copy overlaps another.
+    std::vector<VkBufferCopy> copies;
+    VkDeviceSize moved = 0;
+
+    std::vector<TlsfAllocator::Handle> ranges = m_allocator.getAllocations();
+    for (auto it = ranges.rbegin(); it != ranges.rend() && moved < maxBytes; ++it) {
+        uint32_t slot = *it < m_rangeOwners.size() ? m_rangeOwners[*it] : NO_SLOT;
+        if (slot == NO_SLOT) continue; // Retired, not live
+
+        VkDeviceSize offset = m_allocator.getOffset(*it);
+        VkDeviceSize size = m_allocator.getSize(*it);
+        TlsfAllocator::Handle target = m_allocator.allocateBelow(size, m_slots[slot].alignment, offset);
+        if (target == TlsfAllocator::INVALID_HANDLE) continue;
+
+        copies.push_back({offset, m_allocator.getOffset(target), size});
+        setOwner(*it, NO_SLOT);
+        m_retired[m_currentSlot].push_back(*it);
+        m_slots[slot].range = target;
+        setOwner(target, slot);
+        moved += size;
+    }
+
+    if (!copies.empty()) {
+        vkCmdCopyBuffer(cmd, m_buffer, m_buffer, static_cast<uint32_t>(copies.size()), copies.data());
+        m_defragMoves += copies.size();
+        m_defragBytes += moved;
+    }
+    return moved;
+}
+
+GpuHeapStats GpuBufferHeap::getStats() const {
+    GpuHeapStats stats;
+    stats.ranges = m_allocator.getStats();
+    for (const auto& retired : m_retired) {
+        stats.retiredRanges += retired.size();
+    }
+    stats.failedAllocations = m_failedAllocations;
+    stats.defragMoves = m_defragMoves;
+    stats.defragBytes = m_defragBytes;
+    return stats;
+}
+
+void GpuBufferHeap::dumpStats(std::ostream& out) const {
+    constexpr double MB = 1024.0 * 1024.0;
+    GpuHeapStats stats = getStats();
+
+    out << std::fixed << std::setprecision(2)
+        << "GPU buffer heap: " << stats.ranges.usedBytes / MB << " / " << stats.ranges.capacity / MB << " MB used, "
+        << stats.ranges.allocationCount << " ranges (" << stats.retiredRanges << " retiring), "
+        << stats.ranges.freeBlockCount << " free ranges, largest " << stats.ranges.largestFreeBlock / MB << " MB, "
+        << stats.ranges.getFragmentation() * 100.0 << "% fragmented\n"
+        << "  " << stats.failedAllocations << " failed allocations, " << stats.defragMoves << " defrag moves ("
+        << stats.defragBytes / MB << " MB)\n";
+}
+
+void GpuBufferHeap::setOwner(TlsfAllocator::Handle range, uint32_t slot) {
+    if (range >= m_rangeOwners.size()) {
+        m_rangeOwners.resize(range + 1, NO_SLOT);
+    }
+    m_rangeOwners[range] = slot;
+}
+
+} // namespace clonemine
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "GpuMemoryArena.h"
+#include "TlsfAllocator.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace clonemine {
+
+// Range inside a GpuBufferHeap. It survives defragmentation; ask the heap
+// for the current offset when recording draws.
+struct GpuHeapHandle {
+    uint32_t id = UINT32_MAX;
+
+    [[nodiscard]] bool valid() const noexcept { return id != UINT32_MAX; }
+};
+
+// Snapshot of a GpuBufferHeap's occupancy
+struct GpuHeapStats {
+    TlsfStats ranges;
+    size_t retiredRanges = 0;     // Freed, waiting for their frame to finish
+    uint64_t failedAllocations = 0;
+    uint64_t defragMoves = 0;
+    uint64_t defragBytes = 0;
+};
+
+// One large buffer sub-allocated into many ranges, e.g. every chunk's
+// vertices and indices. Frees are deferred until the frame slot that freed
+// them comes round again, so frames in flight can keep reading the range.
+class GpuBufferHeap {
+public:
+    // The buffer comes from arena, which must outlive the heap.
+    // Throws std::runtime_error if the buffer cannot be created
+    GpuBufferHeap(VkDevice device, GpuMemoryArena& arena, VkDeviceSize capacity,
+                  VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, uint32_t framesInFlight);
+    ~GpuBufferHeap();
+
+    GpuBufferHeap(const GpuBufferHeap&) = delete;
+    GpuBufferHeap& operator=(const GpuBufferHeap&) = delete;
+
+    // Start recording frameSlot; its previous submission must have completed
+    void beginFrame(uint32_t frameSlot);
+
+    // Invalid handle when no free range fits
+    GpuHeapHandle allocate(VkDeviceSize size, VkDeviceSize alignment);
+    void free(GpuHeapHandle& handle);
+
+    [[nodiscard]] VkDeviceSize getOffset(GpuHeapHandle handle) const;
+    [[nodiscard]] VkDeviceSize getSize(GpuHeapHandle handle) const;
+    // Host-visible heaps only
+    [[nodiscard]] void* getMapped(GpuHeapHandle handle) const;
+
+    // Move live ranges into free space nearer the start, up to maxBytes,
+    // recording the copies into cmd. The caller orders them against vertex
+    // reads and against earlier copies into the heap with barriers. Returns
+    // the bytes moved.
+    VkDeviceSize defragment(VkCommandBuffer cmd, VkDeviceSize maxBytes);
+
+    [[nodiscard]] VkBuffer getBuffer() const noexcept { return m_buffer; }
+    [[nodiscard]] VkDeviceSize getCapacity() const noexcept { return m_allocator.getCapacity(); }
+    GpuHeapStats getStats() const;
+    void dumpStats(std::ostream& out) const;
+
+private:
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    struct Slot {
+        TlsfAllocator::Handle range = TlsfAllocator::INVALID_HANDLE;
+        VkDeviceSize alignment = 0;
+    };
+
+    void setOwner(TlsfAllocator::Handle range, uint32_t slot);
+
+    VkDevice m_device;
+    VkBuffer m_buffer{VK_NULL_HANDLE};
+    GpuMemoryArena& m_arena;
+    GpuMemoryAllocation m_allocation;
+    uint8_t* m_mapped = nullptr;
+
+    TlsfAllocator m_allocator;
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::vector<uint32_t> m_rangeOwners; // Allocator handle -> slot, for defragmentation
+
+    // Ranges freed while each frame slot was recording
+    std::vector<std::vector<TlsfAllocator::Handle>> m_retired;
+    uint32_t m_currentSlot = 0;
+
+    uint64_t m_failedAllocations = 0;
+    uint64_t m_defragMoves = 0;
+    uint64_t m_defragBytes = 0;
+};
+
+} // namespace clonemine
@@ -0,0 +1,167 @@
+#include "GpuMemoryArena.h"
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+namespace clonemine {
+
+GpuMemoryArena::GpuMemoryArena(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize)
+    : m_device(device), m_blockSize(blockSize) {
+    vkGetPhysicalDeviceMemoryProperties(physicalDevice, &m_memoryProperties);
+}
+
+GpuMemoryArena::~GpuMemoryArena() {
+    for (auto& block : m_blocks) {
+        destroyBlock(block);
+    }
+}
+
+GpuMemoryAllocation GpuMemoryArena::allocate(const VkMemoryRequirements& requirements,
+                                             VkMemoryPropertyFlags properties) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
+
+    auto tryBlock = [&](uint32_t index, GpuMemoryAllocation& allocation) {
+        MemoryBlock& block = m_blocks[index];
+        TlsfAllocator::Handle handle = block.allocator->allocate(requirements.size, requirements.alignment);
+        if (handle == TlsfAllocator::INVALID_HANDLE) {
+            return false;
+        }
+        allocation.memory = block.memory;
+        allocation.offset = block.allocator->getOffset(handle);
+        allocation.size = block.allocator->getSize(handle);
+        allocation.mapped = block.mapped ? block.mapped + allocation.offset : nullptr;
+        allocation.block = index;
+        allocation.handle = handle;
+        return true;
+    };
+
+    GpuMemoryAllocation allocation;
+    if (requirements.size <= m_blockSize) {
+        for (uint32_t i = 0; i < m_blocks.size(); ++i) {
+            if (m_blocks[i].memory != VK_NULL_HANDLE && m_blocks[i].memoryType == memoryType &&
+                tryBlock(i, allocation)) {
+                return allocation;
+            }
+        }
+    }
+
+    uint32_t index = createBlock(memoryType, std::max(m_blockSize, requirements.size + requirements.alignment));
+    if (!tryBlock(index, allocation)) {
+        throw std::runtime_error("Failed to sub-allocate device memory!");
+    }
+    return allocation;
+}
+
+void GpuMemoryArena::free(GpuMemoryAllocation& allocation) {
+    if (!allocation.valid()) return;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    MemoryBlock& block = m_blocks[allocation.block];
+    block.allocator->free(allocation.handle);
+    allocation = {};
+
+    if (!block.allocator->empty()) return;
+
+    // Keep one empty block per memory type to avoid reallocating on churn
+    bool hasOtherBlock = false;
+    for (const auto& other : m_blocks) {
+        if (&other != &block && other.memory != VK_NULL_HANDLE && other.memoryType == block.memoryType &&
+            other.allocator->getCapacity() <= m_blockSize) {
+            hasOtherBlock = true;
+            break;
+        }
+    }
+    if (hasOtherBlock || block.allocator->getCapacity() > m_blockSize) {
+        destroyBlock(block);
+    }
+}
+
+uint32_t GpuMemoryArena::getDeviceAllocationCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return static_cast<uint32_t>(std::count_if(m_blocks.begin(), m_blocks.end(), [](const MemoryBlock& block) {
+        return block.memory != VK_NULL_HANDLE;
+    }));
+}
+
+void GpuMemoryArena::dumpStats(std::ostream& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    constexpr double MB = 1024.0 * 1024.0;
+
+    VkDeviceSize totalCapacity = 0;
+    VkDeviceSize totalUsed = 0;
+    uint32_t totalAllocations = 0;
+    uint32_t liveBlocks = 0;
+
+    out << std::fixed << std::setprecision(2);
+    for (size_t i = 0; i < m_blocks.size(); ++i) {
+        const MemoryBlock& block = m_blocks[i];
+        if (block.memory == VK_NULL_HANDLE) continue;
+
+        TlsfStats stats = block.allocator->getStats();
+        out << "  block " << i << " (type " << block.memoryType << (block.mapped ? ", mapped" : "") << "): "
+            << stats.usedBytes / MB << " / " << stats.capacity / MB << " MB, "
+            << stats.allocationCount << " allocations, "
+            << stats.freeBlockCount << " free ranges, largest " << stats.largestFreeBlock / MB << " MB, "
+            << stats.getFragmentation() * 100.0 << "% fragmented\n";
+
+        totalCapacity += stats.capacity;
+        totalUsed += stats.usedBytes;
+        totalAllocations += stats.allocationCount;
+        liveBlocks++;
+    }
+    out << "GPU memory arena: " << liveBlocks << " device allocations, " << totalAllocations
+        << " sub-allocations, " << totalUsed / MB << " / " << totalCapacity / MB << " MB used\n";
+}
+
+uint32_t GpuMemoryArena::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
+    for (uint32_t i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+        if ((typeFilter & (1 << i)) && (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("Failed to find suitable memory type!");
+}
+
+uint32_t GpuMemoryArena::createBlock(uint32_t memoryType, VkDeviceSize size) {
+    MemoryBlock block;
+    block.memoryType = memoryType;
+
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryType;
+
+    if (vkAllocateMemory(m_device, &allocInfo, nullptr, &block.memory) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate device memory block!");
+    }
+
+    if (m_memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        void* mapped = nullptr;
+        vkMapMemory(m_device, block.memory, 0, size, 0, &mapped);
+        block.mapped = static_cast<uint8_t*>(mapped);
+    }
+    block.allocator = std::make_unique<TlsfAllocator>(size);
+
+    for (uint32_t i = 0; i < m_blocks.size(); ++i) {
+        if (m_blocks[i].memory == VK_NULL_HANDLE) {
+            m_blocks[i] = std::move(block);
+            return i;
+        }
+    }
+    m_blocks.push_back(std::move(block));
+    return static_cast<uint32_t>(m_blocks.size() - 1);
+}
+
+void GpuMemoryArena::destroyBlock(MemoryBlock& block) {
+    if (block.memory == VK_NULL_HANDLE) return;
+
+    if (block.mapped) {
+        vkUnmapMemory(m_device, block.memory);
+    }
+    vkFreeMemory(m_device, block.memory, nullptr);
+    block = MemoryBlock{};
+}
+
+} // namespace clonemine
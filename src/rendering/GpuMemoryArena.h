@@ -0,0 +1,71 @@
+#pragma once
+
+#include "TlsfAllocator.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+namespace clonemine {
+
+// A range of device memory handed out by GpuMemoryArena
+struct GpuMemoryAllocation {
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    void* mapped = nullptr; // Host-visible memory only; already offset
+    uint32_t block = 0;
+    TlsfAllocator::Handle handle = TlsfAllocator::INVALID_HANDLE;
+
+    [[nodiscard]] bool valid() const noexcept { return memory != VK_NULL_HANDLE; }
+};
+
+// Device memory pool that sub-allocates buffers from a few large
+// vkAllocateMemory blocks per memory type, so the allocation count stays far
+// below maxMemoryAllocationCount. Host-visible blocks stay mapped for their
+// whole lifetime. Only buffers are placed here, so bufferImageGranularity
+// does not apply.
+class GpuMemoryArena {
+public:
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+
+    GpuMemoryArena(VkDevice device, VkPhysicalDevice physicalDevice, VkDeviceSize blockSize = DEFAULT_BLOCK_SIZE);
+    ~GpuMemoryArena();
+
+    GpuMemoryArena(const GpuMemoryArena&) = delete;
+    GpuMemoryArena& operator=(const GpuMemoryArena&) = delete;
+
+    // Requests larger than a block get a dedicated one.
+    // Throws std::runtime_error when no memory type matches or the device is out of memory.
+    GpuMemoryAllocation allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties);
+    void free(GpuMemoryAllocation& allocation);
+
+    // vkAllocateMemory calls currently live
+    uint32_t getDeviceAllocationCount() const;
+
+    // Per-block occupancy, one line each
+    void dumpStats(std::ostream& out) const;
+
+private:
+    struct MemoryBlock {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        uint32_t memoryType = 0;
+        uint8_t* mapped = nullptr;
+        std::unique_ptr<TlsfAllocator> allocator;
+    };
+
+    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    uint32_t createBlock(uint32_t memoryType, VkDeviceSize size);
+    void destroyBlock(MemoryBlock& block);
+
+    VkDevice m_device;
+    VkDeviceSize m_blockSize;
+    VkPhysicalDeviceMemoryProperties m_memoryProperties{};
+
+    mutable std::mutex m_mutex;
+    std::vector<MemoryBlock> m_blocks; // Destroyed blocks leave a null slot for reuse
+};
+
+} // namespace clonemine
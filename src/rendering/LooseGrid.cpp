@@ -0,0 +1,129 @@
+#include "LooseGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace clonemine {
+
+namespace {
+    // Cell coordinates packed into one key (signed 32-bit each)
+    uint64_t packCell(int32_t cx, int32_t cz) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cz);
+    }
+
+    void unpackCell(uint64_t key, int32_t& cx, int32_t& cz) {
+        cx = static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+        cz = static_cast<int32_t>(static_cast<uint32_t>(key));
+    }
+}
+
+LooseGrid::LooseGrid(float cellSize) : m_cellSize(cellSize) {
+}
+
+uint64_t LooseGrid::getCellKey(const glm::vec3& position) const {
+    return packCell(static_cast<int32_t>(std::floor(position.x / m_cellSize)),
+                    static_cast<int32_t>(std::floor(position.z / m_cellSize)));
+}
+
+void LooseGrid::insert(uint32_t id, const glm::vec3& center, float radius) {
+    if (id >= m_locations.size()) {
+        m_locations.resize(id + 1);
+    }
+    if (m_locations[id].index != UINT32_MAX) {
+        move(id, center, radius);
+        return;
+    }
+
+    const uint64_t key = getCellKey(center);
+    Cell& cell = m_cells[key];
+    if (cell.ids.empty()) {
+        cell.minY = cell.maxY = center.y;
+        cell.maxRadius = radius;
+    } else {
+        cell.minY = std::min(cell.minY, center.y);
+        cell.maxY = std::max(cell.maxY, center.y);
+        cell.maxRadius = std::max(cell.maxRadius, radius);
+    }
+
+    m_locations[id] = {key, static_cast<uint32_t>(cell.ids.size())};
+    cell.ids.push_back(id);
+    cell.spheres.push(center, radius);
+    m_objectCount++;
+}
+
+void LooseGrid::remove(uint32_t id) {
+    if (id >= m_locations.size() || m_locations[id].index == UINT32_MAX) return;
+
+    Location location = m_locations[id];
+    auto it = m_cells.find(location.cell);
+    Cell& cell = it->second;
+
+    cell.spheres.swapRemove(location.index);
+    cell.ids[location.index] = cell.ids.back();
+    cell.ids.pop_back();
+    if (location.index < cell.ids.size()) {
+        m_locations[cell.ids[location.index]].index = location.index;
+    }
+    if (cell.ids.empty()) {
+        m_cells.erase(it);
+    }
+
+    m_locations[id] = {};
+    m_objectCount--;
+}
+
+void LooseGrid::move(uint32_t id, const glm::vec3& center, float radius) {
+    if (id >= m_locations.size() || m_locations[id].index == UINT32_MAX) {
+        insert(id, center, radius);
+        return;
+    }
+
+    const Location& location = m_locations[id];
+    if (location.cell != getCellKey(center)) {
+        remove(id);
+        insert(id, center, radius);
+        return;
+    }
+
+    Cell& cell = m_cells.find(location.cell)->second;
+    cell.spheres.set(location.index, center, radius);
+    cell.minY = std::min(cell.minY, center.y);
+    cell.maxY = std::max(cell.maxY, center.y);
+    cell.maxRadius = std::max(cell.maxRadius, radius);
+}
+
+void LooseGrid::clear() {
+    m_cells.clear();
+    m_locations.clear();
+    m_objectCount = 0;
+}
+
+void LooseGrid::query(const Frustum& frustum, const glm::vec3& camera, float maxDistance,
+                      std::vector<uint32_t>& out) const {
+    for (const auto& [key, cell] : m_cells) {
+        int32_t cx = 0;
+        int32_t cz = 0;
+        unpackCell(key, cx, cz);
+
+        // Every centre in the cell lies in this box
+        const glm::vec3 centersMin(cx * m_cellSize, cell.minY, cz * m_cellSize);
+        const glm::vec3 centersMax((cx + 1) * m_cellSize, cell.maxY, (cz + 1) * m_cellSize);
+
+        const glm::vec3 nearest(std::clamp(camera.x, centersMin.x, centersMax.x),
+                                std::clamp(camera.y, centersMin.y, centersMax.y),
+                                std::clamp(camera.z, centersMin.z, centersMax.z));
+        const glm::vec3 toNearest = nearest - camera;
+        if (glm::dot(toNearest, toNearest) > maxDistance * maxDistance) continue;
+
+        const glm::vec3 loose(cell.maxRadius);
+        if (!frustum.intersectsAabb(centersMin - loose, centersMax + loose)) continue;
+
+        cullSpheres(frustum, camera, maxDistance, cell.spheres, m_visible);
+        for (size_t i = 0; i < cell.ids.size(); ++i) {
+            if (m_visible[i]) {
+                out.push_back(cell.ids[i]);
+            }
+        }
+    }
+}
+
+} // namespace clonemine
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "BoundingSpheres.h"
+#include "Frustum.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace clonemine {
+
+// Loose uniform grid over the XZ plane for objects that rarely move, such
+// as static world objects.
+//
+// An object lives in the one cell that contains its centre, and each cell's
+// bounds are widened by the largest radius inside it, so objects never
+// straddle cells. A query tests only occupied cells against the frustum and
+// then batch-culls the spheres of the cells that pass.
+class LooseGrid {
+public:
+    explicit LooseGrid(float cellSize = 32.0f);
+
+    // ids are chosen by the caller and must be unique; small dense values
+    // (e.g. slot indices) keep the lookup table small
+    void insert(uint32_t id, const glm::vec3& center, float radius);
+    void remove(uint32_t id);
+    void move(uint32_t id, const glm::vec3& center, float radius);
+    void clear();
+
+    // Appends the ids of objects that pass isSphereVisible
+    void query(const Frustum& frustum, const glm::vec3& camera, float maxDistance, std::vector<uint32_t>& out) const;
+
+    [[nodiscard]] size_t size() const noexcept { return m_objectCount; }
+    [[nodiscard]] size_t getCellCount() const noexcept { return m_cells.size(); }
+
+private:
+    struct Cell {
+        BoundingSpheres spheres;
+        std::vector<uint32_t> ids;
+        // Loose bounds: only grow until the cell empties
+        float minY = 0.0f;
+        float maxY = 0.0f;
+        float maxRadius = 0.0f;
+    };
+
+    struct Location {
+        uint64_t cell = 0;
+        uint32_t index = UINT32_MAX; // UINT32_MAX = not in the grid
+    };
+
+    uint64_t getCellKey(const glm::vec3& position) const;
+
+    float m_cellSize;
+    std::unordered_map<uint64_t, Cell> m_cells;
+    std::vector<Location> m_locations; // By id
+    size_t m_objectCount = 0;
+    mutable std::vector<uint8_t> m_visible; // Query scratch
+};
+
+} // namespace clonemine
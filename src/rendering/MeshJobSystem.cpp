@@ -0,0 +1,135 @@
+#include "MeshJobSystem.h"
+#include <chrono>
+
+namespace clonemine {
+
+MeshJobSystem::MeshJobSystem(unsigned workerCount) {
+    if (workerCount == 0) {
+        unsigned hardware = std::thread::hardware_concurrency();
+        workerCount = hardware > 1 ? hardware - 1 : 1;
+    }
+
+    for (unsigned i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(&MeshJobSystem::workerLoop, this);
+    }
+}
+
+MeshJobSystem::~MeshJobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_condition.notify_all();
+
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void MeshJobSystem::submit(MeshJob job) {
+    m_submitted++;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_pending.find(job.chunkPos);
+        if (it != m_pending.end()) {
+            it->second = std::move(job);
+            m_coalesced++;
+            return;
+        }
+        m_order.push_back(job.chunkPos);
+        m_pending.emplace(job.chunkPos, std::move(job));
+    }
+    m_condition.notify_one();
+}
+
+bool MeshJobSystem::tryCollect(MeshJobResult& result) {
+    return m_completed.tryPop(result);
+}
+
+void MeshJobSystem::workerLoop() {
+    // Each worker keeps its own scratch buffers
+    ChunkMesher mesher;
+    std::vector<BlockType> lodBlocks;
+
+    while (true) {
+        MeshJob job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition.wait(lock, [this] { return m_shutdown || !m_order.empty(); });
+            if (m_shutdown) {
+                return;
+            }
+
+            auto it = m_pending.find(m_order.front());
+            m_order.pop_front();
+            job = std::move(it->second);
+            m_pending.erase(it);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        MeshJobResult result;
+        result.chunkPos = job.chunkPos;
+        result.version = job.version;
+        result.sectionMask = job.sectionMask;
+        result.neighbors = job.neighbors;
+        result.lodLevel = job.lodLevel;
+
+        // Neighbours on the same level cull against the downsampled edges
+        const std::vector<BlockType>* blocks = &job.blocks;
+        if (job.lodLevel > 0) {
+            ChunkMesher::downsample(job.blocks, job.lodLevel, lodBlocks);
+            blocks = &lodBlocks;
+        }
+
+        auto edges = std::make_shared<ChunkEdges>();
+        for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+            ChunkMesher::extractBorder(*blocks, face, (*edges)[face]);
+        }
+        result.edges = std::move(edges);
+
+        ChunkNeighborBorders borders;
+        for (int face = 0; face < ChunkMesher::HORIZONTAL_FACES; ++face) {
+            if (job.neighbors[face]) {
+                borders.slices[face] = &(*job.neighbors[face])[ChunkMesher::oppositeFace(face)];
+            }
+        }
+
+        result.parts.setFormat(job.format);
+        mesher.build(job.mode, job.chunkPos, *blocks, job.sectionMask, borders, result.parts, job.lodLevel);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        result.buildMs = elapsed / 1000.0;
+
+        m_built++;
+        m_totalBuildUs += static_cast<uint64_t>(elapsed);
+        uint64_t previousMax = m_maxBuildUs.load();
+        while (static_cast<uint64_t>(elapsed) > previousMax &&
+               !m_maxBuildUs.compare_exchange_weak(previousMax, static_cast<uint64_t>(elapsed))) {
+        }
+
+        m_completed.push(std::move(result));
+    }
+}
+
+MeshJobStats MeshJobSystem::getStats() const {
+    MeshJobStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        stats.queuedJobs = m_order.size();
+    }
+    stats.completedResults = m_completed.size();
+    stats.submittedJobs = m_submitted.load();
+    stats.coalescedJobs = m_coalesced.load();
+    stats.builtMeshes = m_built.load();
+    if (stats.builtMeshes > 0) {
+        stats.averageBuildMs = m_totalBuildUs.load() / 1000.0 / static_cast<double>(stats.builtMeshes);
+    }
+    stats.maxBuildMs = m_maxBuildUs.load() / 1000.0;
+    return stats;
+}
+
+} // namespace clonemine
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "ChunkMesher.h"
+#include "core/MpscQueue.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace clonemine {
+
+// A chunk's four boundary planes (indexed by face), immutable once shared
+using ChunkEdges = std::array<ChunkBorderSlice, ChunkMesher::HORIZONTAL_FACES>;
+using ChunkEdgesPtr = std::shared_ptr<const ChunkEdges>;
+
+// Everything a worker needs, owned by the job so the chunk can keep changing
+struct MeshJob {
+    glm::ivec3 chunkPos{0, 0, 0};
+    uint64_t version = 0; // Results for older versions are discarded
+    std::vector<BlockType> blocks;
+    uint16_t sectionMask = ALL_CHUNK_SECTIONS;
+    std::array<ChunkEdgesPtr, ChunkMesher::HORIZONTAL_FACES> neighbors; // Null = not loaded
+    MeshingMode mode = MeshingMode::Greedy;
+    VertexFormat format = VertexFormat::Packed;
+    int lodLevel = 0; // Blocks are downsampled by the worker; edges come from the result
+};
+
+struct MeshJobResult {
+    glm::ivec3 chunkPos{0, 0, 0};
+    uint64_t version = 0;
+    uint16_t sectionMask = ALL_CHUNK_SECTIONS;
+    ChunkMeshParts parts;
+    ChunkEdgesPtr edges;
+    std::array<ChunkEdgesPtr, ChunkMesher::HORIZONTAL_FACES> neighbors; // As meshed against
+    int lodLevel = 0;
+    double buildMs = 0.0;
+};
+
+// Snapshot of mesh job counters
+struct MeshJobStats {
+    size_t queuedJobs = 0;
+    size_t completedResults = 0; // Finished, not yet collected
+    uint64_t submittedJobs = 0;
+    uint64_t coalescedJobs = 0;  // Replaced by a newer snapshot before starting
+    uint64_t builtMeshes = 0;
+    double averageBuildMs = 0.0;
+    double maxBuildMs = 0.0;
+};
+
+// Worker pool that meshes chunk snapshots in the background.
+//
+// submit() and tryCollect() are called from the render thread. A chunk that
+// is submitted again before a worker picks it up keeps its queue position
+// and takes the newer snapshot. Finished meshes come back through a
+// lock-free queue, so workers never wait on the render thread.
+class MeshJobSystem {
+public:
+    // 0 workers = hardware threads minus one (at least one)
+    explicit MeshJobSystem(unsigned workerCount = 0);
+    ~MeshJobSystem();
+
+    MeshJobSystem(const MeshJobSystem&) = delete;
+    MeshJobSystem& operator=(const MeshJobSystem&) = delete;
+
+    void submit(MeshJob job);
+    bool tryCollect(MeshJobResult& result);
+
+    MeshJobStats getStats() const;
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<glm::ivec3> m_order;
+    std::unordered_map<glm::ivec3, MeshJob> m_pending;
+    bool m_shutdown = false;
+
+    MpscQueue<MeshJobResult> m_completed;
+
+    // Counters
+    std::atomic<uint64_t> m_submitted{0};
+    std::atomic<uint64_t> m_coalesced{0};
+    std::atomic<uint64_t> m_built{0};
+    std::atomic<uint64_t> m_totalBuildUs{0};
+    std::atomic<uint64_t> m_maxBuildUs{0};
+};
+
+} // namespace clonemine
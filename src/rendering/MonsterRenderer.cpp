@@ -1,22 +1,205 @@
 #include "MonsterRenderer.h"
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
 
 namespace clonemine {
 
-MonsterRenderer::MonsterRenderer(VkDevice device, VkPhysicalDevice physicalDevice)
-    : m_device(device), m_physicalDevice(physicalDevice) {
+namespace {
+    constexpr float PI = 3.14159265f;
+    constexpr float TWO_PI = 2.0f * PI;
+    // Covers minStorageBufferOffsetAlignment on every conformant device
+    constexpr VkDeviceSize REGION_ALIGNMENT = 256;
+
+    VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Length of the one-shot animations; looping ones repeat every 2 seconds
+    float getAnimationDuration(MonsterAnimation animation) {
+        switch (animation) {
+            case MonsterAnimation::IDLE: return 2.0f;
+            case MonsterAnimation::WALK: return 1.0f;
+            case MonsterAnimation::ATTACK: return 0.5f;
+            case MonsterAnimation::DAMAGE: return 0.3f;
+            case MonsterAnimation::DEATH: return 1.5f;
+            default: return 1.0f;
+        }
+    }
+
+    glm::mat4 rotateAbout(const glm::vec3& pivot, const glm::vec3& axis, float angle) {
+        glm::mat4 m = glm::translate(glm::mat4(1.0f), pivot);
+        m = glm::rotate(m, angle, axis);
+        return glm::translate(m, -pivot);
+    }
+}
+
+MonsterRenderer::MonsterRenderer(VkDevice device, GpuMemoryArena& arena)
+    : m_device(device), m_arena(arena),
+      m_modelHeap(std::make_unique<GpuBufferHeap>(device, arena, MODEL_HEAP_SIZE,
+                                                  VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+                                                  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                  VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, FRAMES_IN_FLIGHT)) {
+    createInstanceBuffer();
+    createDescriptors();
 }
 
 MonsterRenderer::~MonsterRenderer() {
     for (auto& [name, model] : m_models) {
         destroyModel(model);
     }
+    if (m_descriptorPool != VK_NULL_HANDLE) {
+        vkDestroyDescriptorPool(m_device, m_descriptorPool, nullptr);
+    }
+    if (m_setLayout != VK_NULL_HANDLE) {
+        vkDestroyDescriptorSetLayout(m_device, m_setLayout, nullptr);
+    }
+    if (m_instanceBuffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(m_device, m_instanceBuffer, nullptr);
+    }
+    m_arena.free(m_instanceAllocation);
+}
+
+void MonsterRenderer::createInstanceBuffer() {
+    m_instanceBytes = alignUp(MAX_MONSTER_INSTANCES * sizeof(GpuMonsterInstance), REGION_ALIGNMENT);
+    m_paletteBytes = alignUp(MAX_BONE_MATRICES * sizeof(glm::mat4), REGION_ALIGNMENT);
+
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = FRAMES_IN_FLIGHT * (m_instanceBytes + m_paletteBytes);
+    bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_instanceBuffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create monster instance buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_device, m_instanceBuffer, &memRequirements);
+
+    m_instanceAllocation = m_arena.allocate(memRequirements, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                              VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    vkBindBufferMemory(m_device, m_instanceBuffer, m_instanceAllocation.memory, m_instanceAllocation.offset);
+
+    // Stays mapped for the arena block's lifetime
+    m_instanceMapped = static_cast<uint8_t*>(m_instanceAllocation.mapped);
+}
+
+void MonsterRenderer::createDescriptors() {
+    // 0 = instances, 1 = bone palette
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    for (uint32_t i = 0; i < bindings.size(); ++i) {
+        bindings[i].binding = i;
+        bindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[i].descriptorCount = 1;
+        bindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+
+    if (vkCreateDescriptorSetLayout(m_device, &layoutInfo, nullptr, &m_setLayout) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create monster descriptor set layout!");
+    }
+
+    VkDescriptorPoolSize poolSize{};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = static_cast<uint32_t>(bindings.size()) * FRAMES_IN_FLIGHT;
+
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = FRAMES_IN_FLIGHT;
+
+    if (vkCreateDescriptorPool(m_device, &poolInfo, nullptr, &m_descriptorPool) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create monster descriptor pool!");
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(FRAMES_IN_FLIGHT, m_setLayout);
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = m_descriptorPool;
+    allocInfo.descriptorSetCount = FRAMES_IN_FLIGHT;
+    allocInfo.pSetLayouts = layouts.data();
+
+    m_descriptorSets.resize(FRAMES_IN_FLIGHT);
+    if (vkAllocateDescriptorSets(m_device, &allocInfo, m_descriptorSets.data()) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to allocate monster descriptor sets!");
+    }
+
+    for (uint32_t frame = 0; frame < FRAMES_IN_FLIGHT; ++frame) {
+        std::array<VkDescriptorBufferInfo, 2> buffers = {{
+            {m_instanceBuffer, getInstancesOffset(frame), m_instanceBytes},
+            {m_instanceBuffer, getPaletteOffset(frame), m_paletteBytes},
+        }};
+
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t i = 0; i < writes.size(); ++i) {
+            writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[i].dstSet = m_descriptorSets[frame];
+            writes[i].dstBinding = i;
+            writes[i].descriptorCount = 1;
+            writes[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[i].pBufferInfo = &buffers[i];
+        }
+        vkUpdateDescriptorSets(m_device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+}
+
+VkDeviceSize MonsterRenderer::getInstancesOffset(uint32_t frameSlot) const {
+    return frameSlot * (m_instanceBytes + m_paletteBytes);
+}
+
+VkDeviceSize MonsterRenderer::getPaletteOffset(uint32_t frameSlot) const {
+    return getInstancesOffset(frameSlot) + m_instanceBytes;
+}
+
+void MonsterRenderer::beginFrame(uint32_t frameSlot) {
+    m_modelHeap->beginFrame(frameSlot);
+    m_frameSlot = frameSlot;
+    for (auto& batch : m_batches) {
+        batch.clear();
+    }
+    m_queuedInstances = 0;
+    m_paletteUsed = 0;
+    m_dropped = 0;
+}
+
+void MonsterRenderer::beginBones(MonsterModel& model) {
+    model.bones.clear();
+    model.bones.push_back(MonsterBone{});
+}
+
+uint32_t MonsterRenderer::addBone(MonsterModel& model, MonsterBoneRole role, const glm::vec3& pivot,
+                                  const glm::vec3& axis, float phase) {
+    if (model.bones.size() >= MAX_MONSTER_BONES) {
+        throw std::runtime_error("Monster model has too many bones!");
+    }
+    model.bones.push_back(MonsterBone{role, pivot, axis, phase});
+    return static_cast<uint32_t>(model.bones.size() - 1);
 }
 
 void MonsterRenderer::createBipedModel(const std::string& monsterType, MonsterModel& model) {
     model.type = MonsterModelType::BIPED;
     model.vertices.clear();
     model.indices.clear();
+    beginBones(model);
+    
+    // Facing +Z: the head nods and the limbs swing about X, arms against
+    // the leg on the same side
+    const glm::vec3 xAxis(1.0f, 0.0f, 0.0f);
+    uint32_t head = addBone(model, MonsterBoneRole::HEAD, glm::vec3(0.0f, 1.25f, 0.0f), xAxis);
+    uint32_t leftArm = addBone(model, MonsterBoneRole::ARM, glm::vec3(-0.4f, 1.3f, 0.0f), xAxis, PI);
+    uint32_t rightArm = addBone(model, MonsterBoneRole::ARM, glm::vec3(0.4f, 1.3f, 0.0f), xAxis);
+    uint32_t leftLeg = addBone(model, MonsterBoneRole::LEG, glm::vec3(-0.15f, 0.5f, 0.0f), xAxis);
+    uint32_t rightLeg = addBone(model, MonsterBoneRole::LEG, glm::vec3(0.15f, 0.5f, 0.0f), xAxis, PI);
     
     // Color varies by monster type
     glm::vec3 color(0.5f, 0.5f, 0.5f);
@@ -29,7 +212,7 @@ void MonsterRenderer::createBipedModel(const std::string& monsterType, MonsterMo
     createBlockyHead(model.vertices, model.indices, 
                      glm::vec3(0.0f, 1.5f, 0.0f), 
                      glm::vec3(0.5f, 0.5f, 0.5f), 
-                     color);
+                     color, head);
     
     // Body
     createBlockyBody(model.vertices, model.indices,
@@ -41,23 +224,23 @@ void MonsterRenderer::createBipedModel(const std::string& monsterType, MonsterMo
     createBlockyLimb(model.vertices, model.indices,
                      glm::vec3(-0.4f, 1.0f, 0.0f),
                      glm::vec3(0.2f, 0.6f, 0.2f),
-                     color);
+                     color, leftArm);
     
     createBlockyLimb(model.vertices, model.indices,
                      glm::vec3(0.4f, 1.0f, 0.0f),
                      glm::vec3(0.2f, 0.6f, 0.2f),
-                     color);
+                     color, rightArm);
     
     // Legs (left and right)
     createBlockyLimb(model.vertices, model.indices,
                      glm::vec3(-0.15f, 0.25f, 0.0f),
                      glm::vec3(0.2f, 0.5f, 0.2f),
-                     color);
+                     color, leftLeg);
     
     createBlockyLimb(model.vertices, model.indices,
                      glm::vec3(0.15f, 0.25f, 0.0f),
                      glm::vec3(0.2f, 0.5f, 0.2f),
-                     color);
+                     color, rightLeg);
     
     createVulkanBuffers(model);
 }
@@ -66,6 +249,11 @@ void MonsterRenderer::createQuadrupedModel(const std::string& monsterType, Monst
     model.type = MonsterModelType::QUADRUPED;
     model.vertices.clear();
     model.indices.clear();
+    beginBones(model);
+    
+    // Facing +X, so everything swings about Z
+    const glm::vec3 zAxis(0.0f, 0.0f, 1.0f);
+    uint32_t head = addBone(model, MonsterBoneRole::HEAD, glm::vec3(0.4f, 0.6f, 0.0f), zAxis);
     
     // Color varies by monster type
     glm::vec3 color(0.6f, 0.4f, 0.2f);
@@ -78,7 +266,7 @@ void MonsterRenderer::createQuadrupedModel(const std::string& monsterType, Monst
     createBlockyHead(model.vertices, model.indices,
                      glm::vec3(0.6f, 0.6f, 0.0f),
                      glm::vec3(0.4f, 0.4f, 0.4f),
-                     color);
+                     color, head);
     
     // Body (horizontal)
     createBlockyBody(model.vertices, model.indices,
@@ -86,15 +274,17 @@ void MonsterRenderer::createQuadrupedModel(const std::string& monsterType, Monst
                      glm::vec3(0.8f, 0.5f, 0.4f),
                      color);
     
-    // Four legs
+    // Four legs; diagonal pairs move together
     for (int i = 0; i < 4; ++i) {
         float x = (i % 2 == 0) ? -0.3f : 0.3f;
         float z = (i < 2) ? 0.3f : -0.3f;
+        float phase = (i == 1 || i == 2) ? PI : 0.0f;
+        uint32_t leg = addBone(model, MonsterBoneRole::LEG, glm::vec3(x, 0.5f, z), zAxis, phase);
         
         createBlockyLimb(model.vertices, model.indices,
                         glm::vec3(x, 0.25f, z),
                         glm::vec3(0.15f, 0.5f, 0.15f),
-                        color);
+                        color, leg);
     }
     
     createVulkanBuffers(model);
@@ -104,6 +294,15 @@ void MonsterRenderer::createFlyingModel(const std::string& monsterType, MonsterM
     model.type = MonsterModelType::FLYING;
     model.vertices.clear();
     model.indices.clear();
+    beginBones(model);
+    
+    // Facing +X; the wings hinge at their inner edge and flap mirrored
+    const glm::vec3 yAxis(0.0f, 1.0f, 0.0f);
+    const glm::vec3 zAxis(0.0f, 0.0f, 1.0f);
+    uint32_t head = addBone(model, MonsterBoneRole::HEAD, glm::vec3(0.75f, 0.8f, 0.0f), zAxis);
+    uint32_t leftWing = addBone(model, MonsterBoneRole::WING, glm::vec3(-0.5f, 1.0f, 0.0f), zAxis, PI);
+    uint32_t rightWing = addBone(model, MonsterBoneRole::WING, glm::vec3(0.5f, 1.0f, 0.0f), zAxis);
+    uint32_t tail = addBone(model, MonsterBoneRole::TAIL, glm::vec3(-0.5f, 0.6f, 0.0f), yAxis);
     
     // Color varies by monster type
     glm::vec3 color(0.6f, 0.2f, 0.2f);
@@ -115,7 +314,7 @@ void MonsterRenderer::createFlyingModel(const std::string& monsterType, MonsterM
     createBlockyHead(model.vertices, model.indices,
                      glm::vec3(1.0f, 0.8f, 0.0f),
                      glm::vec3(0.5f, 0.4f, 0.4f),
-                     color);
+                     color, head);
     
     // Body (large)
     createBlockyBody(model.vertices, model.indices,
@@ -128,19 +327,19 @@ void MonsterRenderer::createFlyingModel(const std::string& monsterType, MonsterM
     addCube(model.vertices, model.indices,
             glm::vec3(-1.0f, 1.0f, 0.0f),
             glm::vec3(1.0f, 0.05f, 0.8f),
-            color * 0.9f);
+            color * 0.9f, leftWing);
     
     // Right wing
     addCube(model.vertices, model.indices,
             glm::vec3(1.0f, 1.0f, 0.0f),
             glm::vec3(1.0f, 0.05f, 0.8f),
-            color * 0.9f);
+            color * 0.9f, rightWing);
     
     // Tail
     createBlockyLimb(model.vertices, model.indices,
                      glm::vec3(-0.8f, 0.6f, 0.0f),
                      glm::vec3(0.6f, 0.2f, 0.2f),
-                     color);
+                     color, tail);
     
     createVulkanBuffers(model);
 }
@@ -149,6 +348,7 @@ void MonsterRenderer::createSpecialModel(const std::string& monsterType, Monster
     model.type = MonsterModelType::SPECIAL;
     model.vertices.clear();
     model.indices.clear();
+    beginBones(model);
     
     if (monsterType == "Slime") {
         // Bouncy cube
@@ -168,51 +368,57 @@ void MonsterRenderer::createSpecialModel(const std::string& monsterType, Monster
                 glm::vec3(0.6f, 0.3f, 0.8f),
                 color);
         
-        // 8 legs
+        // 8 legs, scuttling in alternating sets
         for (int i = 0; i < 8; ++i) {
             float angle = (i / 8.0f) * 2.0f * 3.14159f;
             float x = std::cos(angle) * 0.5f;
             float z = std::sin(angle) * 0.5f;
+            uint32_t leg = addBone(model, MonsterBoneRole::LEG, glm::vec3(x, 0.3f, z),
+                                   glm::vec3(0.0f, 1.0f, 0.0f), (i % 2) * PI);
             
             createBlockyLimb(model.vertices, model.indices,
                             glm::vec3(x, 0.15f, z),
                             glm::vec3(0.1f, 0.3f, 0.1f),
-                            color);
+                            color, leg);
         }
     }
     
     createVulkanBuffers(model);
 }
 
-void MonsterRenderer::createBlockyHead(std::vector<MonsterVertex>& verts, 
+void MonsterRenderer::createBlockyHead(std::vector<MonsterVertex>& verts,
                                        std::vector<uint32_t>& indices,
                                        const glm::vec3& position,
                                        const glm::vec3& size,
-                                       const glm::vec3& color) {
-    addCube(verts, indices, position, size, color);
+                                       const glm::vec3& color,
+                                       uint32_t bone) {
+    addCube(verts, indices, position, size, color, bone);
 }
 
 void MonsterRenderer::createBlockyBody(std::vector<MonsterVertex>& verts,
                                        std::vector<uint32_t>& indices,
                                        const glm::vec3& position,
                                        const glm::vec3& size,
-                                       const glm::vec3& color) {
-    addCube(verts, indices, position, size, color);
+                                       const glm::vec3& color,
+                                       uint32_t bone) {
+    addCube(verts, indices, position, size, color, bone);
 }
 
 void MonsterRenderer::createBlockyLimb(std::vector<MonsterVertex>& verts,
                                        std::vector<uint32_t>& indices,
                                        const glm::vec3& position,
                                        const glm::vec3& size,
-                                       const glm::vec3& color) {
-    addCube(verts, indices, position, size, color);
+                                       const glm::vec3& color,
+                                       uint32_t bone) {
+    addCube(verts, indices, position, size, color, bone);
 }
 
 void MonsterRenderer::addCube(std::vector<MonsterVertex>& verts,
                               std::vector<uint32_t>& indices,
                               const glm::vec3& center,
                               const glm::vec3& size,
-                              const glm::vec3& color) {
+                              const glm::vec3& color,
+                              uint32_t bone) {
     uint32_t baseIdx = static_cast<uint32_t>(verts.size());
     
     // 8 vertices of a cube
@@ -250,6 +456,7 @@ void MonsterRenderer::addCube(std::vector<MonsterVertex>& verts,
             v.normal = normals[face];
             v.color = color;
             v.texCoord = glm::vec2(i % 2, i / 2); // Simple UV
+            v.bone = bone;
             verts.push_back(v);
         }
         
@@ -270,17 +477,7 @@ void MonsterRenderer::updateAnimation(AnimationState& anim, float deltaTime) {
     
     // Reset animation time if not looping
     if (!anim.looping) {
-        // Animation durations
-        float duration = 1.0f;
-        switch (anim.current) {
-            case MonsterAnimation::IDLE: duration = 2.0f; break;
-            case MonsterAnimation::WALK: duration = 1.0f; break;
-            case MonsterAnimation::ATTACK: duration = 0.5f; break;
-            case MonsterAnimation::DAMAGE: duration = 0.3f; break;
-            case MonsterAnimation::DEATH: duration = 1.5f; break;
-            default: break;
-        }
-        
+        float duration = getAnimationDuration(anim.current);
         if (anim.time > duration) {
             anim.time = duration;
         }
@@ -295,73 +492,215 @@ void MonsterRenderer::updateAnimation(AnimationState& anim, float deltaTime) {
 void MonsterRenderer::applyAnimation(const MonsterModel& model,
                                      const AnimationState& anim,
                                      std::vector<glm::mat4>& boneTransforms) {
-    // Simple procedural animation based on animation type
-    (void)model;
-    (void)anim;
-    (void)boneTransforms;
-    
-    // In a full implementation, this would apply skeletal animation transforms
+    boneTransforms.resize(model.bones.size());
+    computeBones(model, anim, boneTransforms.data());
 }
 
-MonsterModel* MonsterRenderer::getModel(const std::string& monsterType) {
-    auto it = m_models.find(monsterType);
-    if (it == m_models.end()) {
-        // Create model on first access
-        MonsterModel& model = m_models[monsterType];
-        
-        // Determine model type and create
-        if (monsterType == "Wolf" || monsterType == "Bear" || monsterType == "Lion") {
-            createQuadrupedModel(monsterType, model);
-        }
-        else if (monsterType == "Dragon" || monsterType == "Wyvern") {
-            createFlyingModel(monsterType, model);
-        }
-        else if (monsterType == "Slime" || monsterType == "Spider") {
-            createSpecialModel(monsterType, model);
+void MonsterRenderer::computeBones(const MonsterModel& model, const AnimationState& anim, glm::mat4* bones) {
+    // Looping rates are whole cycles per 2 seconds, so the wrap in
+    // updateAnimation is seamless
+    const float t = anim.time;
+    const float progress = std::clamp(t / getAnimationDuration(anim.current), 0.0f, 1.0f);
+    glm::mat4 root(1.0f);
+    float swing = 0.05f;   // Limb amplitude in radians
+    float rate = 0.5f;     // Cycles per second
+    float armLift = 0.0f;
+    float headNod = 0.0f;
+    
+    switch (anim.current) {
+        case MonsterAnimation::IDLE:
+            root = glm::translate(root, glm::vec3(0.0f, 0.02f * std::sin(t * PI), 0.0f));
+            headNod = 0.05f * std::sin(t * PI);
+            break;
+        case MonsterAnimation::WALK:
+            swing = 0.6f;
+            rate = 1.0f;
+            break;
+        case MonsterAnimation::RUN:
+            swing = 1.0f;
+            rate = 2.0f;
+            root = glm::translate(root, glm::vec3(0.0f, 0.05f * std::abs(std::sin(t * TWO_PI * rate)), 0.0f));
+            break;
+        case MonsterAnimation::ATTACK:
+            armLift = 1.6f * std::sin(progress * PI);
+            headNod = 0.2f * std::sin(progress * PI);
+            break;
+        case MonsterAnimation::DAMAGE:
+            root = rotateAbout(glm::vec3(0.0f), glm::vec3(1.0f, 0.0f, 0.0f), -0.3f * std::sin(progress * PI));
+            break;
+        case MonsterAnimation::DEATH:
+            root = rotateAbout(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f), progress * PI * 0.5f);
+            swing = 0.0f;
+            break;
+        case MonsterAnimation::SPECIAL: {
+            float squash = 0.15f * std::sin(t * TWO_PI);
+            root = glm::scale(root, glm::vec3(1.0f + squash, 1.0f - squash, 1.0f + squash));
+            break;
         }
-        else {
-            createBipedModel(monsterType, model);
+    }
+    
+    const float cycle = t * TWO_PI * rate;
+    for (size_t i = 0; i < model.bones.size(); ++i) {
+        const MonsterBone& bone = model.bones[i];
+        float angle = 0.0f;
+        switch (bone.role) {
+            case MonsterBoneRole::BODY: break;
+            case MonsterBoneRole::HEAD: angle = headNod; break;
+            case MonsterBoneRole::ARM: angle = swing * std::sin(cycle + bone.phase) - armLift; break;
+            case MonsterBoneRole::LEG: angle = swing * std::sin(cycle + bone.phase); break;
+            // Wings keep flapping and the tail keeps swaying at any gait
+            case MonsterBoneRole::WING: angle = (0.3f + swing) * std::sin(cycle + bone.phase); break;
+            case MonsterBoneRole::TAIL: angle = 0.3f * std::sin(t * PI + bone.phase); break;
         }
-        
-        return &model;
+        bones[i] = angle == 0.0f ? root : root * rotateAbout(bone.pivot, bone.axis, angle);
     }
-    return &it->second;
 }
 
-void MonsterRenderer::renderMonster(VkCommandBuffer cmd,
-                                    const std::string& monsterType,
+MonsterModelId MonsterRenderer::getModelId(const std::string& monsterType) {
+    auto it = m_models.find(monsterType);
+    if (it != m_models.end()) {
+        return it->second.id;
+    }
+    
+    // Create model on first access
+    MonsterModel& model = m_models[monsterType];
+    model.id = static_cast<MonsterModelId>(m_modelsById.size());
+    m_modelsById.push_back(&model);
+    m_batches.emplace_back();
+    
+    // Determine model type and create
+    if (monsterType == "Wolf" || monsterType == "Bear" || monsterType == "Lion") {
+        createQuadrupedModel(monsterType, model);
+    }
+    else if (monsterType == "Dragon" || monsterType == "Wyvern") {
+        createFlyingModel(monsterType, model);
+    }
+    else if (monsterType == "Slime" || monsterType == "Spider") {
+        createSpecialModel(monsterType, model);
+    }
+    else {
+        createBipedModel(monsterType, model);
+    }
+    return model.id;
+}
+
+MonsterModel* MonsterRenderer::getModel(const std::string& monsterType) {
+    return m_modelsById[getModelId(monsterType)];
+}
+
+MonsterModel* MonsterRenderer::getModel(MonsterModelId modelId) {
+    return modelId < m_modelsById.size() ? m_modelsById[modelId] : nullptr;
+}
+
+void MonsterRenderer::renderMonster(MonsterModelId modelId,
                                     const glm::vec3& position,
                                     const glm::quat& rotation,
                                     const AnimationState& anim,
-                                    float scale) {
-    (void)cmd;
-    (void)monsterType;
-    (void)position;
-    (void)rotation;
-    (void)anim;
-    (void)scale;
-    
-    // Actual rendering would bind buffers and draw
+                                    float scale,
+                                    const glm::vec4& tint) {
+    const MonsterModel* model = getModel(modelId);
+    if (!model || model->indices.empty()) return;
+    
+    const uint32_t boneCount = static_cast<uint32_t>(model->bones.size());
+    if (m_queuedInstances >= MAX_MONSTER_INSTANCES || m_paletteUsed + boneCount > MAX_BONE_MATRICES) {
+        m_dropped++;
+        return;
+    }
+    
+    GpuMonsterInstance instance;
+    instance.transform = glm::translate(glm::mat4(1.0f), position) * glm::mat4_cast(rotation);
+    instance.transform = glm::scale(instance.transform, glm::vec3(scale));
+    instance.tint = tint;
+    instance.animationTime = anim.time;
+    instance.firstBone = m_paletteUsed;
+    
+    // Straight into this frame's palette; only the instances need grouping
+    auto* palette = reinterpret_cast<glm::mat4*>(m_instanceMapped + getPaletteOffset(m_frameSlot));
+    computeBones(*model, anim, palette + m_paletteUsed);
+    m_paletteUsed += boneCount;
+    
+    m_batches[modelId].push_back(instance);
+    m_queuedInstances++;
 }
 
-void MonsterRenderer::createVulkanBuffers(MonsterModel& model) {
-    // Placeholder - actual Vulkan buffer creation
-    (void)model;
+void MonsterRenderer::setPipeline(VkPipeline pipeline, VkPipelineLayout layout) {
+    m_pipeline = pipeline;
+    m_pipelineLayout = layout;
 }
 
-void MonsterRenderer::destroyModel(MonsterModel& model) {
-    if (model.vertexBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(m_device, model.vertexBuffer, nullptr);
-    }
-    if (model.indexBuffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(m_device, model.indexBuffer, nullptr);
-    }
-    if (model.vertexMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(m_device, model.vertexMemory, nullptr);
+void MonsterRenderer::render(VkCommandBuffer cmd, const glm::mat4& viewProj) {
+    m_drawStats = {};
+    m_drawStats.boneMatrices = m_paletteUsed;
+    m_drawStats.dropped = m_dropped;
+    if (m_pipeline == VK_NULL_HANDLE || m_queuedInstances == 0) return;
+    
+    VkDescriptorSet set = m_descriptorSets[m_frameSlot];
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, &set, 0, nullptr);
+    
+    MonsterPushConstants constants{viewProj};
+    vkCmdPushConstants(cmd, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(constants), &constants);
+    
+    // Each model's instances are consecutive; firstInstance points the
+    // shader at them through gl_InstanceIndex
+    auto* instances = reinterpret_cast<GpuMonsterInstance*>(m_instanceMapped + getInstancesOffset(m_frameSlot));
+    VkBuffer heap = m_modelHeap->getBuffer();
+    uint32_t firstInstance = 0;
+    for (size_t id = 0; id < m_batches.size(); ++id) {
+        const auto& batch = m_batches[id];
+        if (batch.empty()) continue;
+        
+        std::copy(batch.begin(), batch.end(), instances + firstInstance);
+        
+        const MonsterModel& model = *m_modelsById[id];
+        VkDeviceSize offset = m_modelHeap->getOffset(model.allocation);
+        vkCmdBindVertexBuffers(cmd, 0, 1, &heap, &offset);
+        vkCmdBindIndexBuffer(cmd, heap, offset + model.indexOffset, VK_INDEX_TYPE_UINT32);
+        vkCmdDrawIndexed(cmd, static_cast<uint32_t>(model.indices.size()), static_cast<uint32_t>(batch.size()),
+                         0, 0, firstInstance);
+        
+        firstInstance += static_cast<uint32_t>(batch.size());
+        m_drawStats.drawCalls++;
     }
-    if (model.indexMemory != VK_NULL_HANDLE) {
-        vkFreeMemory(m_device, model.indexMemory, nullptr);
+    m_drawStats.instances = firstInstance;
+}
+
+void MonsterRenderer::getVertexInputDescription(VkVertexInputBindingDescription& binding,
+                                                std::vector<VkVertexInputAttributeDescription>& attributes) {
+    binding = {};
+    binding.binding = 0;
+    binding.stride = sizeof(MonsterVertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+    
+    attributes.clear();
+    attributes.push_back({0, 0, VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(MonsterVertex, position))});
+    attributes.push_back({1, 0, VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(MonsterVertex, normal))});
+    attributes.push_back({2, 0, VK_FORMAT_R32G32_SFLOAT, static_cast<uint32_t>(offsetof(MonsterVertex, texCoord))});
+    attributes.push_back({3, 0, VK_FORMAT_R32G32B32_SFLOAT, static_cast<uint32_t>(offsetof(MonsterVertex, color))});
+    attributes.push_back({4, 0, VK_FORMAT_R32_UINT, static_cast<uint32_t>(offsetof(MonsterVertex, bone))});
+}
+
+void MonsterRenderer::createVulkanBuffers(MonsterModel& model) {
+    destroyModel(model);
+    
+    const VkDeviceSize vertexBytes = model.vertices.size() * sizeof(MonsterVertex);
+    const VkDeviceSize indexBytes = model.indices.size() * sizeof(uint32_t);
+    if (indexBytes == 0) return;
+    
+    model.allocation = m_modelHeap->allocate(vertexBytes + indexBytes, 16);
+    if (!model.allocation.valid()) {
+        throw std::runtime_error("Monster model heap is full!");
     }
+    
+    auto* mapped = static_cast<uint8_t*>(m_modelHeap->getMapped(model.allocation));
+    std::memcpy(mapped, model.vertices.data(), vertexBytes);
+    std::memcpy(mapped + vertexBytes, model.indices.data(), indexBytes);
+    model.indexOffset = vertexBytes;
+}
+
+void MonsterRenderer::destroyModel(MonsterModel& model) {
+    m_modelHeap->free(model.allocation);
+    model.indexOffset = 0;
 }
 
 } // namespace clonemine
@@ -1,9 +1,15 @@
 #pragma once
 
+#include "GpuBufferHeap.h"
+#include "GpuMemoryArena.h"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <memory>
+#include <ostream>
 #include <vector>
 #include <string>
+#include <unordered_map>
 
 namespace clonemine {
 
@@ -14,21 +20,64 @@ enum class MonsterModelType {
     SPECIAL     // Unique models (Slime, Spider)
 };
 
+// How a model part moves in the procedural animations
+enum class MonsterBoneRole : uint8_t {
+    BODY,
+    HEAD,
+    ARM,
+    LEG,
+    WING,
+    TAIL
+};
+
+// Rigid part of a blocky model; it rotates about its pivot
+struct MonsterBone {
+    MonsterBoneRole role = MonsterBoneRole::BODY;
+    glm::vec3 pivot{0.0f};              // Model space, e.g. shoulder or hip
+    glm::vec3 axis{1.0f, 0.0f, 0.0f};   // Swing axis
+    float phase = 0.0f;                 // Radians; opposite limbs differ by pi
+};
+
 struct MonsterVertex {
     glm::vec3 position;
     glm::vec3 normal;
     glm::vec2 texCoord;
     glm::vec3 color;
+    uint32_t bone = 0;  // Index into MonsterModel::bones
 };
 
+using MonsterModelId = uint32_t;
+
 struct MonsterModel {
     std::vector<MonsterVertex> vertices;
     std::vector<uint32_t> indices;
-    VkBuffer vertexBuffer = VK_NULL_HANDLE;
-    VkBuffer indexBuffer = VK_NULL_HANDLE;
-    VkDeviceMemory vertexMemory = VK_NULL_HANDLE;
-    VkDeviceMemory indexMemory = VK_NULL_HANDLE;
+    std::vector<MonsterBone> bones; // Bone 0 is the body and moves everything
+    GpuHeapHandle allocation;       // Vertices then indices in the shared model heap
+    VkDeviceSize indexOffset = 0;   // From the start of the allocation
     MonsterModelType type;
+    MonsterModelId id = 0;
+};
+
+// One monster in the per-frame instance buffer (std430, see shaders/monster.vert)
+struct GpuMonsterInstance {
+    glm::mat4 transform{1.0f};
+    glm::vec4 tint{1.0f};
+    float animationTime = 0.0f;
+    uint32_t firstBone = 0;     // This instance's matrices in the bone palette
+    uint32_t padding[2] = {};
+};
+static_assert(sizeof(GpuMonsterInstance) == 96, "Must match MonsterInstance in monster.vert");
+
+struct MonsterPushConstants {
+    glm::mat4 viewProj;
+};
+
+// Work recorded by the last MonsterRenderer::render
+struct MonsterDrawStats {
+    uint32_t instances = 0;
+    uint32_t drawCalls = 0;     // One per model with instances
+    uint32_t boneMatrices = 0;
+    uint32_t dropped = 0;       // Over the instance or palette capacity
 };
 
 enum class MonsterAnimation {
@@ -48,10 +97,28 @@ struct AnimationState {
     bool looping = true;
 };
 
+// Draws monsters instanced: every monster queued in a frame gets a transform,
+// tint and animation time in the instance buffer and its bone matrices in
+// one shared palette, and each model type is a single draw however many
+// monsters use it.
 class MonsterRenderer {
 public:
-    MonsterRenderer(VkDevice device, VkPhysicalDevice physicalDevice);
+    static constexpr uint32_t FRAMES_IN_FLIGHT = 2;
+    static constexpr uint32_t MAX_MONSTER_BONES = 16;
+    static constexpr uint32_t MAX_MONSTER_INSTANCES = 4096;
+    static constexpr uint32_t MAX_BONE_MATRICES = MAX_MONSTER_INSTANCES * 8;
+    
+    // The instance buffer comes from arena, which must outlive the renderer.
+    // Throws std::runtime_error if the GPU buffers cannot be created
+    MonsterRenderer(VkDevice device, GpuMemoryArena& arena);
     ~MonsterRenderer();
+    
+    MonsterRenderer(const MonsterRenderer&) = delete;
+    MonsterRenderer& operator=(const MonsterRenderer&) = delete;
+    
+    // Once per frame after waiting on frameSlot's fence; releases replaced
+    // models and starts an empty instance list for the frame
+    void beginFrame(uint32_t frameSlot);
 
     // Create models for different monster types
     void createBipedModel(const std::string& monsterType, MonsterModel& model);
@@ -59,45 +126,103 @@ public:
     void createFlyingModel(const std::string& monsterType, MonsterModel& model);
     void createSpecialModel(const std::string& monsterType, MonsterModel& model);
     
-    // Render a monster instance
-    void renderMonster(VkCommandBuffer cmd, const std::string& monsterType,
-                      const glm::vec3& position, const glm::quat& rotation,
-                      const AnimationState& anim, float scale = 1.0f);
+    // Queue a monster for this frame's instanced draw. Resolve the id once
+    // with getModelId(), not per frame.
+    void renderMonster(MonsterModelId modelId, const glm::vec3& position, const glm::quat& rotation,
+                       const AnimationState& anim, float scale = 1.0f, const glm::vec4& tint = glm::vec4(1.0f));
+    
+    // Inside the render pass: one indexed draw per model with queued monsters
+    void render(VkCommandBuffer cmd, const glm::mat4& viewProj);
+    
+    // Pipeline for render(); its layout must use getSetLayout() as set 0 and
+    // MonsterPushConstants for the vertex stage
+    void setPipeline(VkPipeline pipeline, VkPipelineLayout layout);
+    [[nodiscard]] VkDescriptorSetLayout getSetLayout() const noexcept { return m_setLayout; }
+    static void getVertexInputDescription(VkVertexInputBindingDescription& binding,
+                                          std::vector<VkVertexInputAttributeDescription>& attributes);
+    
+    MonsterDrawStats getDrawStats() const { return m_drawStats; }
     
     // Update animation
     void updateAnimation(AnimationState& anim, float deltaTime);
     
-    // Apply animation to model (skeletal animation)
+    // Model-space matrix per bone of the model for an animation pose
     void applyAnimation(const MonsterModel& model, const AnimationState& anim,
                        std::vector<glm::mat4>& boneTransforms);
     
-    // Get model for monster type
+    // Model for a monster type, created on first use
+    MonsterModelId getModelId(const std::string& monsterType);
     MonsterModel* getModel(const std::string& monsterType);
+    MonsterModel* getModel(MonsterModelId modelId);
+    
+    // Shared model heap occupancy
+    void dumpModelHeapStats(std::ostream& out) const { m_modelHeap->dumpStats(out); }
     
     // Create blocky model parts (head, body, limbs)
     void createBlockyHead(std::vector<MonsterVertex>& verts, std::vector<uint32_t>& indices,
                          const glm::vec3& position, const glm::vec3& size,
-                         const glm::vec3& color);
+                         const glm::vec3& color, uint32_t bone = 0);
     
     void createBlockyBody(std::vector<MonsterVertex>& verts, std::vector<uint32_t>& indices,
                          const glm::vec3& position, const glm::vec3& size,
-                         const glm::vec3& color);
+                         const glm::vec3& color, uint32_t bone = 0);
     
     void createBlockyLimb(std::vector<MonsterVertex>& verts, std::vector<uint32_t>& indices,
                          const glm::vec3& position, const glm::vec3& size,
-                         const glm::vec3& color);
+                         const glm::vec3& color, uint32_t bone = 0);
 
 private:
     void createVulkanBuffers(MonsterModel& model);
     void destroyModel(MonsterModel& model);
+    void createInstanceBuffer();
+    void createDescriptors();
+    
+    // Start a model's bone list with the body bone
+    static void beginBones(MonsterModel& model);
+    static uint32_t addBone(MonsterModel& model, MonsterBoneRole role, const glm::vec3& pivot,
+                            const glm::vec3& axis, float phase = 0.0f);
+    // Writes model.bones.size() matrices
+    static void computeBones(const MonsterModel& model, const AnimationState& anim, glm::mat4* bones);
+    
+    VkDeviceSize getInstancesOffset(uint32_t frameSlot) const;
+    VkDeviceSize getPaletteOffset(uint32_t frameSlot) const;
     
     // Add a cube to the model
     void addCube(std::vector<MonsterVertex>& verts, std::vector<uint32_t>& indices,
-                const glm::vec3& center, const glm::vec3& size, const glm::vec3& color);
+                const glm::vec3& center, const glm::vec3& size, const glm::vec3& color,
+                uint32_t bone = 0);
     
     VkDevice m_device;
-    VkPhysicalDevice m_physicalDevice;
+    GpuMemoryArena& m_arena;
     std::unordered_map<std::string, MonsterModel> m_models;
+    std::vector<MonsterModel*> m_modelsById;
+    
+    // Models are small and written once, so the heap is host visible and
+    // filled directly without staging
+    std::unique_ptr<GpuBufferHeap> m_modelHeap;
+    static constexpr VkDeviceSize MODEL_HEAP_SIZE = 4 * 1024 * 1024;
+    
+    // Per frame slot: instances, then the bone palette. Host visible, as
+    // both are rewritten every frame.
+    VkBuffer m_instanceBuffer{VK_NULL_HANDLE};
+    GpuMemoryAllocation m_instanceAllocation;
+    uint8_t* m_instanceMapped = nullptr;
+    VkDeviceSize m_instanceBytes = 0;
+    VkDeviceSize m_paletteBytes = 0;
+    
+    VkDescriptorSetLayout m_setLayout{VK_NULL_HANDLE};
+    VkDescriptorPool m_descriptorPool{VK_NULL_HANDLE};
+    std::vector<VkDescriptorSet> m_descriptorSets;
+    VkPipeline m_pipeline{VK_NULL_HANDLE};
+    VkPipelineLayout m_pipelineLayout{VK_NULL_HANDLE};
+    
+    // This frame's instances grouped by model id, copied out in render()
+    std::vector<std::vector<GpuMonsterInstance>> m_batches;
+    uint32_t m_frameSlot = 0;
+    uint32_t m_queuedInstances = 0;
+    uint32_t m_paletteUsed = 0;
+    uint32_t m_dropped = 0;
+    MonsterDrawStats m_drawStats;
 };
 
 } // namespace clonemine
@@ -0,0 +1,96 @@
+#include "StagingRing.h"
+#include <stdexcept>
+
+namespace clonemine {
+
+namespace {
+    VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+    }
+}
+
+StagingRing::StagingRing(VkDevice device, GpuMemoryArena& arena, VkDeviceSize capacity, uint32_t framesInFlight)
+    : m_device(device), m_arena(arena), m_capacity(capacity), m_frames(framesInFlight) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = capacity;
+    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    if (vkCreateBuffer(m_device, &bufferInfo, nullptr, &m_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("Failed to create staging ring buffer!");
+    }
+
+    VkMemoryRequirements memRequirements;
+    vkGetBufferMemoryRequirements(m_device, m_buffer, &memRequirements);
+
+    try {
+        m_allocation = m_arena.allocate(memRequirements,
+                                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    } catch (...) {
+        vkDestroyBuffer(m_device, m_buffer, nullptr);
+        throw;
+    }
+
+    vkBindBufferMemory(m_device, m_buffer, m_allocation.memory, m_allocation.offset);
+
+    // The arena keeps host-visible blocks mapped for their whole lifetime
+    m_mapped = static_cast<uint8_t*>(m_allocation.mapped);
+}
+
+StagingRing::~StagingRing() {
+    if (m_buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(m_device, m_buffer, nullptr);
+    }
+    m_arena.free(m_allocation);
+}
+
+void StagingRing::beginFrame(uint32_t frameSlot) {
+    m_currentSlot = frameSlot;
+    m_frameBytes = 0;
+
+    // The slot's last submission has finished; its range is free again.
+    // Slots retire in order, so the tail simply moves to where it ended.
+    FrameRange& retired = m_frames[frameSlot];
+    if (retired.bytes > 0) {
+        m_used -= retired.bytes;
+        m_tail = retired.end;
+        retired = {};
+    }
+    if (m_used == 0) {
+        m_head = 0;
+        m_tail = 0;
+    }
+}
+
+void StagingRing::endFrame() {
+    m_frames[m_currentSlot] = {m_head, m_frameBytes};
+}
+
+bool StagingRing::allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset, void*& mapped) {
+    VkDeviceSize start = alignUp(m_head, alignment);
+    VkDeviceSize padding = start - m_head;
+
+    if (m_used == 0 || m_head > m_tail) {
+        // Free space runs from head to the end, then from 0 to tail
+        if (start + size > m_capacity) {
+            if (size > m_tail) {
+                return false;
+            }
+            padding = m_capacity - m_head;
+            start = 0;
+        }
+    } else if (start + size > m_tail) {
+        return false;
+    }
+
+    m_head = start + size;
+    m_used += padding + size;
+    m_frameBytes += padding + size;
+
+    offset = start;
+    mapped = m_mapped + start;
+    return true;
+}
+
+} // namespace clonemine
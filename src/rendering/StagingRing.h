@@ -0,0 +1,59 @@
+#pragma once
+
+#include "GpuMemoryArena.h"
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <vector>
+
+namespace clonemine {
+
+// Persistent host-visible upload buffer used as a ring across frames.
+//
+// Each frame allocates contiguous ranges from the head; the space is
+// reclaimed when the same frame slot comes round again, i.e. once the
+// caller has waited on that slot's fence. Nothing is allocated or mapped
+// per upload.
+class StagingRing {
+public:
+    // Memory comes from arena, which must outlive the ring.
+    // Throws std::runtime_error if the buffer cannot be created
+    StagingRing(VkDevice device, GpuMemoryArena& arena, VkDeviceSize capacity, uint32_t framesInFlight);
+    ~StagingRing();
+
+    StagingRing(const StagingRing&) = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+
+    // Start recording frameSlot; its previous uploads must have completed
+    void beginFrame(uint32_t frameSlot);
+    void endFrame();
+
+    // Reserve size bytes; false when the ring is full until older frames retire
+    bool allocate(VkDeviceSize size, VkDeviceSize alignment, VkDeviceSize& offset, void*& mapped);
+
+    [[nodiscard]] VkBuffer getBuffer() const noexcept { return m_buffer; }
+    [[nodiscard]] VkDeviceSize getCapacity() const noexcept { return m_capacity; }
+    [[nodiscard]] VkDeviceSize getUsedBytes() const noexcept { return m_used; }
+
+private:
+    VkDevice m_device;
+    GpuMemoryArena& m_arena;
+    VkBuffer m_buffer{VK_NULL_HANDLE};
+    GpuMemoryAllocation m_allocation;
+    uint8_t* m_mapped = nullptr;
+    VkDeviceSize m_capacity;
+
+    VkDeviceSize m_head = 0; // Next free byte
+    VkDeviceSize m_tail = 0; // Oldest byte still in flight
+    VkDeviceSize m_used = 0; // Bytes between tail and head, including wrap padding
+
+    // Per frame slot: where its allocations ended and how many bytes it took
+    struct FrameRange {
+        VkDeviceSize end = 0;
+        VkDeviceSize bytes = 0;
+    };
+    std::vector<FrameRange> m_frames;
+    uint32_t m_currentSlot = 0;
+    VkDeviceSize m_frameBytes = 0;
+};
+
+} // namespace clonemine
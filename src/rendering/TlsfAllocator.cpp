@@ -0,0 +1,274 @@
+#include "TlsfAllocator.h"
+#include <algorithm>
+#include <bit>
+
+namespace clonemine {
+
+namespace {
+    uint64_t alignUp(uint64_t value, uint64_t alignment) {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity)
+    : m_capacity(capacity / GRANULARITY * GRANULARITY) {
+    for (auto& lists : m_freeLists) {
+        lists.fill(NONE);
+    }
+
+    if (m_capacity > 0) {
+        m_firstBlock = newBlock();
+        m_blocks[m_firstBlock].size = m_capacity;
+        m_blocks[m_firstBlock].free = true;
+        insertFree(m_firstBlock);
+    }
+}
+
+void TlsfAllocator::mapping(uint64_t size, uint32_t& fl, uint32_t& sl) {
+    // Bins are linear below SL_COUNT units, then SL_COUNT per power of two
+    uint64_t units = size / GRANULARITY;
+    if (units < SL_COUNT) {
+        fl = 0;
+        sl = static_cast<uint32_t>(units);
+        return;
+    }
+    uint32_t f = 63 - static_cast<uint32_t>(std::countl_zero(units));
+    fl = f - SL_BITS + 1;
+    sl = static_cast<uint32_t>(units >> (f - SL_BITS)) & (SL_COUNT - 1);
+}
+
+uint32_t TlsfAllocator::findFreeBlock(uint64_t size) const {
+    // Start at the next bin up, where every block is large enough
+    uint64_t rounded = size;
+    uint64_t units = size / GRANULARITY;
+    if (units >= SL_COUNT) {
+        uint32_t f = 63 - static_cast<uint32_t>(std::countl_zero(units));
+        rounded += ((uint64_t{1} << (f - SL_BITS)) - 1) * GRANULARITY;
+    }
+
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(rounded, fl, sl);
+    if (fl < FL_COUNT) {
+        uint32_t slMap = m_slBitmap[fl] & (~0u << sl);
+        if (slMap == 0) {
+            uint64_t flMap = fl + 1 < 64 ? m_flBitmap & (~uint64_t{0} << (fl + 1)) : 0;
+            if (flMap != 0) {
+                fl = static_cast<uint32_t>(std::countr_zero(flMap));
+                slMap = m_slBitmap[fl];
+            }
+        }
+        if (slMap != 0) {
+            return m_freeLists[fl][std::countr_zero(slMap)];
+        }
+    }
+
+    // Nearly full: the request's own bin may still hold a block that fits
+    mapping(size, fl, sl);
+    for (uint32_t i = m_freeLists[fl][sl]; i != NONE; i = m_blocks[i].nextFree) {
+        if (m_blocks[i].size >= size) {
+            return i;
+        }
+    }
+    return NONE;
+}
+
+TlsfAllocator::Handle TlsfAllocator::allocate(uint64_t size, uint64_t alignment) {
+    size = alignUp(std::max<uint64_t>(size, 1), GRANULARITY);
+    alignment = std::max(alignment, GRANULARITY);
+
+    // Worst-case padding is reserved up front so the block found always fits
+    uint32_t index = findFreeBlock(size + alignment - GRANULARITY);
+    if (index == NONE) {
+        return INVALID_HANDLE;
+    }
+    return carve(index, size, alignment);
+}
+
+TlsfAllocator::Handle TlsfAllocator::allocateBelow(uint64_t size, uint64_t alignment, uint64_t below) {
+    size = alignUp(std::max<uint64_t>(size, 1), GRANULARITY);
+    alignment = std::max(alignment, GRANULARITY);
+
+    for (uint32_t i = m_firstBlock; i != NONE && m_blocks[i].offset < below; i = m_blocks[i].nextPhysical) {
+        const Block& block = m_blocks[i];
+        if (!block.free) continue;
+
+        uint64_t aligned = alignUp(block.offset, alignment);
+        if (aligned < below && aligned + size <= block.offset + block.size) {
+            return carve(i, size, alignment);
+        }
+    }
+    return INVALID_HANDLE;
+}
+
+TlsfAllocator::Handle TlsfAllocator::carve(uint32_t index, uint64_t size, uint64_t alignment) {
+    removeFree(index);
+
+    uint64_t padding = alignUp(m_blocks[index].offset, alignment) - m_blocks[index].offset;
+    if (padding > 0) {
+        // Alignment gap before the allocation stays free
+        uint32_t front = newBlock();
+        Block& block = m_blocks[index];
+        Block& gap = m_blocks[front];
+        gap.offset = block.offset;
+        gap.size = padding;
+        gap.prevPhysical = block.prevPhysical;
+        gap.nextPhysical = index;
+        gap.free = true;
+        if (gap.prevPhysical != NONE) {
+            m_blocks[gap.prevPhysical].nextPhysical = front;
+        } else {
+            m_firstBlock = front;
+        }
+        block.prevPhysical = front;
+        block.offset += padding;
+        block.size -= padding;
+        insertFree(front);
+    }
+
+    if (m_blocks[index].size > size) {
+        uint32_t back = newBlock();
+        Block& block = m_blocks[index];
+        Block& rest = m_blocks[back];
+        rest.offset = block.offset + size;
+        rest.size = block.size - size;
+        rest.prevPhysical = index;
+        rest.nextPhysical = block.nextPhysical;
+        rest.free = true;
+        if (rest.nextPhysical != NONE) {
+            m_blocks[rest.nextPhysical].prevPhysical = back;
+        }
+        block.nextPhysical = back;
+        block.size = size;
+        insertFree(back);
+    }
+
+    Block& block = m_blocks[index];
+    block.free = false;
+    m_usedBytes += block.size;
+    m_allocationCount++;
+    return index;
+}
+
+void TlsfAllocator::free(Handle handle) {
+    if (handle == INVALID_HANDLE || m_blocks[handle].free) return;
+
+    m_blocks[handle].free = true;
+    m_usedBytes -= m_blocks[handle].size;
+    m_allocationCount--;
+
+    uint32_t next = m_blocks[handle].nextPhysical;
+    if (next != NONE && m_blocks[next].free) {
+        removeFree(next);
+        m_blocks[handle].size += m_blocks[next].size;
+        m_blocks[handle].nextPhysical = m_blocks[next].nextPhysical;
+        if (m_blocks[handle].nextPhysical != NONE) {
+            m_blocks[m_blocks[handle].nextPhysical].prevPhysical = handle;
+        }
+        releaseBlock(next);
+    }
+
+    uint32_t prev = m_blocks[handle].prevPhysical;
+    if (prev != NONE && m_blocks[prev].free) {
+        removeFree(prev);
+        m_blocks[prev].size += m_blocks[handle].size;
+        m_blocks[prev].nextPhysical = m_blocks[handle].nextPhysical;
+        if (m_blocks[prev].nextPhysical != NONE) {
+            m_blocks[m_blocks[prev].nextPhysical].prevPhysical = prev;
+        }
+        releaseBlock(handle);
+        handle = prev;
+    }
+
+    insertFree(handle);
+}
+
+void TlsfAllocator::insertFree(uint32_t index) {
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(m_blocks[index].size, fl, sl);
+
+    uint32_t head = m_freeLists[fl][sl];
+    m_blocks[index].prevFree = NONE;
+    m_blocks[index].nextFree = head;
+    if (head != NONE) {
+        m_blocks[head].prevFree = index;
+    }
+    m_freeLists[fl][sl] = index;
+    m_slBitmap[fl] |= 1u << sl;
+    m_flBitmap |= uint64_t{1} << fl;
+    m_freeBlockCount++;
+}
+
+void TlsfAllocator::removeFree(uint32_t index) {
+    uint32_t fl = 0;
+    uint32_t sl = 0;
+    mapping(m_blocks[index].size, fl, sl);
+
+    Block& block = m_blocks[index];
+    if (block.prevFree != NONE) {
+        m_blocks[block.prevFree].nextFree = block.nextFree;
+    } else {
+        m_freeLists[fl][sl] = block.nextFree;
+    }
+    if (block.nextFree != NONE) {
+        m_blocks[block.nextFree].prevFree = block.prevFree;
+    }
+    block.prevFree = NONE;
+    block.nextFree = NONE;
+
+    if (m_freeLists[fl][sl] == NONE) {
+        m_slBitmap[fl] &= ~(1u << sl);
+        if (m_slBitmap[fl] == 0) {
+            m_flBitmap &= ~(uint64_t{1} << fl);
+        }
+    }
+    m_freeBlockCount--;
+}
+
+uint32_t TlsfAllocator::newBlock() {
+    if (!m_unusedBlocks.empty()) {
+        uint32_t index = m_unusedBlocks.back();
+        m_unusedBlocks.pop_back();
+        return index;
+    }
+    m_blocks.emplace_back();
+    return static_cast<uint32_t>(m_blocks.size() - 1);
+}
+
+void TlsfAllocator::releaseBlock(uint32_t index) {
+    m_blocks[index] = Block{};
+    m_unusedBlocks.push_back(index);
+}
+
+std::vector<TlsfAllocator::Handle> TlsfAllocator::getAllocations() const {
+    std::vector<Handle> allocations;
+    allocations.reserve(m_allocationCount);
+    for (uint32_t i = m_firstBlock; i != NONE; i = m_blocks[i].nextPhysical) {
+        if (!m_blocks[i].free) {
+            allocations.push_back(i);
+        }
+    }
+    return allocations;
+}
+
+TlsfStats TlsfAllocator::getStats() const {
+    TlsfStats stats;
+    stats.capacity = m_capacity;
+    stats.usedBytes = m_usedBytes;
+    stats.freeBytes = m_capacity - m_usedBytes;
+    stats.allocationCount = m_allocationCount;
+    stats.freeBlockCount = m_freeBlockCount;
+
+    // The largest free block lives in the highest non-empty bin
+    if (m_flBitmap != 0) {
+        uint32_t fl = 63 - static_cast<uint32_t>(std::countl_zero(m_flBitmap));
+        uint32_t sl = 31 - static_cast<uint32_t>(std::countl_zero(m_slBitmap[fl]));
+        for (uint32_t i = m_freeLists[fl][sl]; i != NONE; i = m_blocks[i].nextFree) {
+            stats.largestFreeBlock = std::max(stats.largestFreeBlock, m_blocks[i].size);
+        }
+    }
+    return stats;
+}
+
+} // namespace clonemine
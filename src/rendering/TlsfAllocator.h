@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace clonemine {
+
+// Snapshot of a TlsfAllocator's occupancy
+struct TlsfStats {
+    uint64_t capacity = 0;
+    uint64_t usedBytes = 0;
+    uint64_t freeBytes = 0;
+    uint64_t largestFreeBlock = 0;
+    uint32_t allocationCount = 0;
+    uint32_t freeBlockCount = 0;
+
+    // 0 when all free space is one block, towards 1 as it splinters
+    double getFragmentation() const {
+        return freeBytes > 0 ? 1.0 - static_cast<double>(largestFreeBlock) / static_cast<double>(freeBytes) : 0.0;
+    }
+};
+
+// Two-level segregated fit allocator over an abstract byte range.
+//
+// Only offsets are handed out, so the same allocator manages device memory
+// blocks and ranges inside a single buffer. allocate() and free() are O(1);
+// a freed block merges with free neighbours straight away. Sizes are rounded
+// up to 16 bytes.
+class TlsfAllocator {
+public:
+    using Handle = uint32_t;
+    static constexpr Handle INVALID_HANDLE = UINT32_MAX;
+
+    explicit TlsfAllocator(uint64_t capacity);
+
+    // INVALID_HANDLE when no free block fits; alignment must be a power of two
+    Handle allocate(uint64_t size, uint64_t alignment = 1);
+
+    // Lowest-addressed free block that fits and starts before `below`.
+    // O(blocks); used to compact live ranges towards the start.
+    Handle allocateBelow(uint64_t size, uint64_t alignment, uint64_t below);
+
+    void free(Handle handle);
+
+    uint64_t getOffset(Handle handle) const { return m_blocks[handle].offset; }
+    uint64_t getSize(Handle handle) const { return m_blocks[handle].size; }
+    uint64_t getCapacity() const { return m_capacity; }
+    bool empty() const { return m_allocationCount == 0; }
+
+    // Live allocations in address order
+    std::vector<Handle> getAllocations() const;
+
+    TlsfStats getStats() const;
+
+private:
+    static constexpr uint32_t NONE = UINT32_MAX;
+    static constexpr uint64_t GRANULARITY = 16;
+    static constexpr uint32_t SL_BITS = 4;
+    static constexpr uint32_t SL_COUNT = 1u << SL_BITS;
+    static constexpr uint32_t FL_COUNT = 64 - SL_BITS + 1;
+
+    struct Block {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+        uint32_t prevPhysical = NONE;
+        uint32_t nextPhysical = NONE;
+        uint32_t prevFree = NONE;
+        uint32_t nextFree = NONE;
+        bool free = false;
+    };
+
+    static void mapping(uint64_t size, uint32_t& fl, uint32_t& sl);
+    uint32_t findFreeBlock(uint64_t size) const;
+    Handle carve(uint32_t index, uint64_t size, uint64_t alignment);
+    void insertFree(uint32_t index);
+    void removeFree(uint32_t index);
+    uint32_t newBlock();
+    void releaseBlock(uint32_t index);
+
+    uint64_t m_capacity;
+    uint64_t m_usedBytes = 0;
+    uint32_t m_allocationCount = 0;
+    uint32_t m_freeBlockCount = 0;
+
+    std::vector<Block> m_blocks;
+    std::vector<uint32_t> m_unusedBlocks; // Recycled records
+    uint32_t m_firstBlock = NONE;         // Block at offset 0
+
+    uint64_t m_flBitmap = 0;
+    std::array<uint32_t, FL_COUNT> m_slBitmap{};
+    std::array<std::array<uint32_t, SL_COUNT>, FL_COUNT> m_freeLists;
+};
+
+} // namespace clonemine
@@ -22,62 +22,62 @@ VulkanBuffer::VulkanBuffer(const VulkanDevice& device, VkDeviceSize size,
     VkMemoryRequirements memRequirements;
     vkGetBufferMemoryRequirements(m_device.getDevice(), m_buffer, &memRequirements);
 
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = findMemoryType(memRequirements.memoryTypeBits, properties);
-
-    if (vkAllocateMemory(m_device.getDevice(), &allocInfo, nullptr, &m_memory) != VK_SUCCESS) {
-        throw std::runtime_error("Failed to allocate buffer memory!");
+    try {
+        m_allocation = m_device.getMemoryArena().allocate(memRequirements, properties);
+    } catch (...) {
+        vkDestroyBuffer(m_device.getDevice(), m_buffer, nullptr);
+        throw;
     }
 
-    vkBindBufferMemory(m_device.getDevice(), m_buffer, m_memory, 0);
+    vkBindBufferMemory(m_device.getDevice(), m_buffer, m_allocation.memory, m_allocation.offset);
 }
 
 VulkanBuffer::~VulkanBuffer() {
-    if (m_buffer != VK_NULL_HANDLE) {
-        vkDestroyBuffer(m_device.getDevice(), m_buffer, nullptr);
-    }
-    if (m_memory != VK_NULL_HANDLE) {
-        vkFreeMemory(m_device.getDevice(), m_memory, nullptr);
-    }
+    release();
 }
 
 VulkanBuffer::VulkanBuffer(VulkanBuffer&& other) noexcept
     : m_device(other.m_device)
     , m_buffer(other.m_buffer)
-    , m_memory(other.m_memory)
+    , m_allocation(other.m_allocation)
     , m_size(other.m_size)
 {
     other.m_buffer = VK_NULL_HANDLE;
-    other.m_memory = VK_NULL_HANDLE;
+    other.m_allocation = {};
 }
 
 VulkanBuffer& VulkanBuffer::operator=(VulkanBuffer&& other) noexcept {
     if (this != &other) {
-        if (m_buffer != VK_NULL_HANDLE) {
-            vkDestroyBuffer(m_device.getDevice(), m_buffer, nullptr);
-        }
-        if (m_memory != VK_NULL_HANDLE) {
-            vkFreeMemory(m_device.getDevice(), m_memory, nullptr);
-        }
+        release();
 
         m_buffer = other.m_buffer;
-        m_memory = other.m_memory;
+        m_allocation = other.m_allocation;
         m_size = other.m_size;
 
         other.m_buffer = VK_NULL_HANDLE;
-        other.m_memory = VK_NULL_HANDLE;
+        other.m_allocation = {};
     }
     return *this;
 }
 
+void VulkanBuffer::release() {
+    if (m_buffer != VK_NULL_HANDLE) {
+        vkDestroyBuffer(m_device.getDevice(), m_buffer, nullptr);
+        m_buffer = VK_NULL_HANDLE;
+    }
+    m_device.getMemoryArena().free(m_allocation);
+}
+
 void VulkanBuffer::map(void** data) {
-    vkMapMemory(m_device.getDevice(), m_memory, 0, m_size, 0, data);
+    // Host-visible arena blocks stay mapped; a second vkMapMemory would be invalid
+    if (!m_allocation.mapped) {
+        throw std::runtime_error("Buffer memory is not host visible!");
+    }
+    *data = m_allocation.mapped;
 }
 
 void VulkanBuffer::unmap() {
-    vkUnmapMemory(m_device.getDevice(), m_memory);
+    // Nothing to do: the arena keeps the block mapped
 }
 
 void VulkanBuffer::copyFrom(const void* data, VkDeviceSize size) {
@@ -87,18 +87,4 @@ void VulkanBuffer::copyFrom(const void* data, VkDeviceSize size) {
     unmap();
 }
 
-uint32_t VulkanBuffer::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(m_device.getPhysicalDevice(), &memProperties);
-
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && 
-            (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            return i;
-        }
-    }
-
-    throw std::runtime_error("Failed to find suitable memory type!");
-}
-
 } // namespace clonemine
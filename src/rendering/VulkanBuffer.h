@@ -1,5 +1,6 @@
 #pragma once
 
+#include "rendering/GpuMemoryArena.h"
 #include <vulkan/vulkan.h>
 #include <cstddef>
 
@@ -26,15 +27,16 @@ public:
     void copyFrom(const void* data, VkDeviceSize size);
 
     [[nodiscard]] VkBuffer getBuffer() const noexcept { return m_buffer; }
-    [[nodiscard]] VkDeviceMemory getMemory() const noexcept { return m_memory; }
+    [[nodiscard]] VkDeviceMemory getMemory() const noexcept { return m_allocation.memory; }
+    [[nodiscard]] VkDeviceSize getMemoryOffset() const noexcept { return m_allocation.offset; }
     [[nodiscard]] VkDeviceSize getSize() const noexcept { return m_size; }
 
 private:
-    uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    void release();
 
     const VulkanDevice& m_device;
     VkBuffer m_buffer{VK_NULL_HANDLE};
-    VkDeviceMemory m_memory{VK_NULL_HANDLE};
+    GpuMemoryAllocation m_allocation; // Sub-allocated from the device's arena
     VkDeviceSize m_size;
 };
 
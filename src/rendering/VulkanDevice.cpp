@@ -1,5 +1,6 @@
 #include "rendering/VulkanDevice.h"
 #include "rendering/VulkanContext.h"
+#include "rendering/GpuMemoryArena.h"
 #include <stdexcept>
 #include <vector>
 #include <set>
@@ -11,9 +12,11 @@ VulkanDevice::VulkanDevice(const VulkanContext& context)
 {
     pickPhysicalDevice(context);
     createLogicalDevice();
+    m_memoryArena = std::make_unique<GpuMemoryArena>(m_device, m_physicalDevice);
 }
 
 VulkanDevice::~VulkanDevice() {
+    m_memoryArena.reset();
     if (m_device != VK_NULL_HANDLE) {
         vkDestroyDevice(m_device, nullptr);
     }
@@ -64,13 +67,37 @@ void VulkanDevice::createLogicalDevice() {
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
-    VkPhysicalDeviceFeatures deviceFeatures{};
+    // The Vulkan 1.2 feature struct may only be chained on 1.2 devices
+    VkPhysicalDeviceProperties properties{};
+    vkGetPhysicalDeviceProperties(m_physicalDevice, &properties);
+    const bool vulkan12 = properties.apiVersion >= VK_API_VERSION_1_2;
+
+    VkPhysicalDeviceVulkan12Features supported12{};
+    supported12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    VkPhysicalDeviceFeatures2 supported{};
+    supported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    supported.pNext = vulkan12 ? &supported12 : nullptr;
+    vkGetPhysicalDeviceFeatures2(m_physicalDevice, &supported);
+
+    m_indirectDraw.multiDrawIndirect = supported.features.multiDrawIndirect == VK_TRUE;
+    m_indirectDraw.drawIndirectFirstInstance = supported.features.drawIndirectFirstInstance == VK_TRUE;
+    m_indirectDraw.drawIndirectCount = vulkan12 && supported12.drawIndirectCount == VK_TRUE;
+
+    // Enable only what the chunk draws use
+    VkPhysicalDeviceVulkan12Features enabled12{};
+    enabled12.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES;
+    enabled12.drawIndirectCount = m_indirectDraw.drawIndirectCount ? VK_TRUE : VK_FALSE;
+    VkPhysicalDeviceFeatures2 deviceFeatures{};
+    deviceFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+    deviceFeatures.pNext = vulkan12 ? &enabled12 : nullptr;
+    deviceFeatures.features.multiDrawIndirect = supported.features.multiDrawIndirect;
+    deviceFeatures.features.drawIndirectFirstInstance = supported.features.drawIndirectFirstInstance;
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = &deviceFeatures;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
-    createInfo.pEnabledFeatures = &deviceFeatures;
 
     std::vector<const char*> deviceExtensions = {
         VK_KHR_SWAPCHAIN_EXTENSION_NAME
@@ -2,11 +2,13 @@
 
 #include <vulkan/vulkan.h>
 #include <vector>
+#include <memory>
 #include <optional>
 
 namespace clonemine {
 
 class VulkanContext;
+class GpuMemoryArena;
 
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
@@ -17,6 +19,14 @@ struct QueueFamilyIndices {
     }
 };
 
+// Optional features the GPU-driven chunk draws rely on; each one that is
+// supported is also enabled on the device
+struct IndirectDrawFeatures {
+    bool multiDrawIndirect = false;         // More than one draw per indirect call
+    bool drawIndirectFirstInstance = false; // Non-zero firstInstance in indirect draws
+    bool drawIndirectCount = false;         // vkCmdDrawIndexedIndirectCount (Vulkan 1.2)
+};
+
 class VulkanDevice {
 public:
     explicit VulkanDevice(const VulkanContext& context);
@@ -31,6 +41,9 @@ public:
     [[nodiscard]] VkQueue getGraphicsQueue() const noexcept { return m_graphicsQueue; }
     [[nodiscard]] VkQueue getPresentQueue() const noexcept { return m_presentQueue; }
     [[nodiscard]] const QueueFamilyIndices& getQueueFamilies() const noexcept { return m_queueFamilies; }
+    // Shared by every VulkanBuffer on this device
+    [[nodiscard]] GpuMemoryArena& getMemoryArena() const noexcept { return *m_memoryArena; }
+    [[nodiscard]] const IndirectDrawFeatures& getIndirectDrawFeatures() const noexcept { return m_indirectDraw; }
 
     void waitIdle() const;
 
@@ -47,6 +60,8 @@ private:
     VkQueue m_presentQueue{VK_NULL_HANDLE};
     QueueFamilyIndices m_queueFamilies;
     VkSurfaceKHR m_surface{VK_NULL_HANDLE};
+    IndirectDrawFeatures m_indirectDraw;
+    std::unique_ptr<GpuMemoryArena> m_memoryArena;
 };
 
 } // namespace clonemine
@@ -1,10 +1,14 @@
 #include "WorldRenderer.h"
-#include <iostream>
 #include <algorithm>
 #include <cmath>
 
 namespace clonemine {
 
+StringInterner& getRenderNames() {
+    static StringInterner names;
+    return names;
+}
+
 // ============================================================================
 // WorldRenderer Implementation
 // ============================================================================
@@ -14,6 +18,9 @@ WorldRenderer::WorldRenderer() {
     for (int i = 0; i < 60; ++i) {
         m_fpsHistory[i] = 60.0f;
     }
+    
+    // Planes every point is inside of, until a view-projection is set
+    m_frustum.planes.fill(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f));
 }
 
 WorldRenderer::~WorldRenderer() {
@@ -25,14 +32,16 @@ bool WorldRenderer::initialize() {
         return true;
     }
     
-    std::cout << "[WorldRenderer] Initializing with render settings:" << std::endl;
-    std::cout << "[WorldRenderer]   World render distance: " << m_settings.worldRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Player render distance: " << m_settings.playerRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Monster render distance: " << m_settings.monsterRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Spell render distance: " << m_settings.spellRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Ability render distance: " << m_settings.abilityRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Auto-adjust quality: " << (m_settings.autoAdjustQuality ? "ON" : "OFF") << std::endl;
-    std::cout << "[WorldRenderer]   Target FPS: " << m_settings.targetFPS << std::endl;
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Initializing with render settings:\n"
+                    << "[WorldRenderer]   World render distance: " << m_settings.worldRenderDistance << " units\n"
+                    << "[WorldRenderer]   Player render distance: " << m_settings.playerRenderDistance << " units\n"
+                    << "[WorldRenderer]   Monster render distance: " << m_settings.monsterRenderDistance << " units\n"
+                    << "[WorldRenderer]   Spell render distance: " << m_settings.spellRenderDistance << " units\n"
+                    << "[WorldRenderer]   Ability render distance: " << m_settings.abilityRenderDistance << " units\n"
+                    << "[WorldRenderer]   Auto-adjust quality: " << (m_settings.autoAdjustQuality ? "ON" : "OFF") << "\n"
+                    << "[WorldRenderer]   Target FPS: " << m_settings.targetFPS << "\n";
+    }
     
     m_initialized = true;
     return true;
@@ -45,17 +54,22 @@ void WorldRenderer::shutdown() {
     
     clearAllEntities();
     m_initialized = false;
-    std::cout << "[WorldRenderer] Shutdown complete" << std::endl;
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Shutdown complete\n";
+    }
 }
 
 void WorldRenderer::setRenderSettings(const RenderSettings& settings) {
     m_settings = settings;
-    std::cout << "[WorldRenderer] Render settings updated:" << std::endl;
-    std::cout << "[WorldRenderer]   World: " << m_settings.worldRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Players: " << m_settings.playerRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Monsters: " << m_settings.monsterRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Spells: " << m_settings.spellRenderDistance << " units" << std::endl;
-    std::cout << "[WorldRenderer]   Detail level: " << m_settings.detailLevel << std::endl;
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Render settings updated:\n"
+                    << "[WorldRenderer]   World: " << m_settings.worldRenderDistance << " units\n"
+                    << "[WorldRenderer]   Players: " << m_settings.playerRenderDistance << " units\n"
+                    << "[WorldRenderer]   Monsters: " << m_settings.monsterRenderDistance << " units\n"
+                    << "[WorldRenderer]   Spells: " << m_settings.spellRenderDistance << " units\n"
+                    << "[WorldRenderer]   Detail level: " << m_settings.detailLevel << "\n"
+                    << "[WorldRenderer]   Terrain LOD from: " << m_settings.lodDistance << " units\n";
+    }
 }
 
 void WorldRenderer::adjustRenderDistanceForFPS(float currentFPS) {
@@ -74,10 +88,22 @@ void WorldRenderer::adjustRenderDistanceForFPS(float currentFPS) {
         return;
     }
     
-    // Adjust render distances based on FPS
+    // Terrain detail goes first and comes back last: coarser LOD rings cost
+    // far less to look at than terrain that is not drawn at all
     if (m_averageFPS < m_settings.minFPS) {
-        // FPS too low - reduce render distances by 10%
         float reduction = 0.9f;
+        if (m_settings.maxLodLevel > 0 && m_settings.lodDistance > 32.0f) {
+            // FPS too low - pull the LOD rings in by 10% before any distance
+            m_settings.lodDistance = std::max(32.0f, m_settings.lodDistance * reduction);
+            if (m_debugLog) {
+                *m_debugLog << "[WorldRenderer] FPS (" << m_averageFPS << ") below minimum ("
+                            << m_settings.minFPS << "), coarsening terrain LOD (now from "
+                            << m_settings.lodDistance << " units)\n";
+            }
+            return;
+        }
+        
+        // LOD is as coarse as it goes - reduce render distances by 10%
         m_settings.worldRenderDistance *= reduction;
         m_settings.playerRenderDistance *= reduction;
         m_settings.monsterRenderDistance *= reduction;
@@ -94,12 +120,21 @@ void WorldRenderer::adjustRenderDistanceForFPS(float currentFPS) {
         m_settings.spellRenderDistance = std::max(30.0f, m_settings.spellRenderDistance);
         m_settings.abilityRenderDistance = std::max(25.0f, m_settings.abilityRenderDistance);
         
-        std::cout << "[WorldRenderer] FPS (" << m_averageFPS << ") below minimum (" 
-                  << m_settings.minFPS << "), reducing render distances" << std::endl;
+        if (m_debugLog) {
+            *m_debugLog << "[WorldRenderer] FPS (" << m_averageFPS << ") below minimum (" 
+                        << m_settings.minFPS << "), reducing render distances\n";
+        }
     }
     else if (m_averageFPS > m_settings.targetFPS * 1.2f) {
-        // FPS well above target - can increase render distances by 5%
         float increase = 1.05f;
+        if (m_settings.worldRenderDistance >= 512.0f) {
+            // Distances are maxed - push the LOD rings out by 5%; past the
+            // render distance everything is full detail
+            m_settings.lodDistance = std::min(m_settings.worldRenderDistance, m_settings.lodDistance * increase);
+            return;
+        }
+        
+        // FPS well above target - can increase render distances by 5%
         m_settings.worldRenderDistance = std::min(512.0f, m_settings.worldRenderDistance * increase);
         m_settings.playerRenderDistance = std::min(200.0f, m_settings.playerRenderDistance * increase);
         m_settings.monsterRenderDistance = std::min(150.0f, m_settings.monsterRenderDistance * increase);
@@ -116,25 +151,27 @@ void WorldRenderer::setCameraDirection(const glm::vec3& direction) {
     m_cameraDirection = glm::normalize(direction);
 }
 
+void WorldRenderer::setViewProjection(const glm::mat4& viewProj) {
+    m_frustum = Frustum::fromViewProj(viewProj);
+}
+
 void WorldRenderer::beginFrame() {
     m_renderedEntityCount = 0;
     m_culledEntityCount = 0;
+    m_packets.clear();
 }
 
 void WorldRenderer::endFrame() {
-    // Clear render queues for next frame
-    m_playerQueue.clear();
-    m_monsterQueue.clear();
-    m_npcQueue.clear();
-    m_projectileQueue.clear();
-    m_spellEffectQueue.clear();
-    m_abilityEffectQueue.clear();
+    // Entities are retained across frames; nothing to clear
 }
 
 void WorldRenderer::renderWorld(const World& world) {
     // Render world terrain within render distance
-    std::cout << "[WorldRenderer] Rendering world terrain (distance: " 
-              << m_settings.worldRenderDistance << " units)" << std::endl;
+    (void)world;
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Rendering world terrain (distance: " 
+                    << m_settings.worldRenderDistance << " units)\n";
+    }
     // Actual rendering would be done by the Vulkan renderer
 }
 
@@ -152,10 +189,11 @@ void WorldRenderer::renderPlayers(const std::vector<RenderEntity>& players) {
 void WorldRenderer::renderPlayer(const RenderEntity& player) {
     if (!player.visible) return;
     
-    float distance = getDistanceFromCamera(player.position);
-    std::cout << "[WorldRenderer] Rendering player '" << player.modelName 
-              << "' at distance " << distance << " units" << std::endl;
-    // Actual rendering would use Vulkan/graphics API
+    submitEntity(player);
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Rendering player '" << getRenderNames().getString(player.modelName) 
+                    << "' at distance " << getDistanceFromCamera(player.position) << " units\n";
+    }
 }
 
 void WorldRenderer::renderMonsters(const std::vector<RenderEntity>& monsters) {
@@ -172,9 +210,11 @@ void WorldRenderer::renderMonsters(const std::vector<RenderEntity>& monsters) {
 void WorldRenderer::renderMonster(const RenderEntity& monster) {
     if (!monster.visible) return;
     
-    float distance = getDistanceFromCamera(monster.position);
-    std::cout << "[WorldRenderer] Rendering monster '" << monster.modelName 
-              << "' at distance " << distance << " units" << std::endl;
+    submitEntity(monster);
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Rendering monster '" << getRenderNames().getString(monster.modelName) 
+                    << "' at distance " << getDistanceFromCamera(monster.position) << " units\n";
+    }
 }
 
 void WorldRenderer::renderNPCs(const std::vector<RenderEntity>& npcs) {
@@ -191,9 +231,11 @@ void WorldRenderer::renderNPCs(const std::vector<RenderEntity>& npcs) {
 void WorldRenderer::renderNPC(const RenderEntity& npc) {
     if (!npc.visible) return;
     
-    float distance = getDistanceFromCamera(npc.position);
-    std::cout << "[WorldRenderer] Rendering NPC '" << npc.modelName 
-              << "' at distance " << distance << " units" << std::endl;
+    submitEntity(npc);
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Rendering NPC '" << getRenderNames().getString(npc.modelName) 
+                    << "' at distance " << getDistanceFromCamera(npc.position) << " units\n";
+    }
 }
 
 void WorldRenderer::renderProjectiles(const std::vector<RenderEntity>& projectiles) {
@@ -210,9 +252,13 @@ void WorldRenderer::renderProjectiles(const std::vector<RenderEntity>& projectil
 void WorldRenderer::renderProjectile(const RenderEntity& projectile) {
     if (!projectile.visible) return;
     
-    float distance = getDistanceFromCamera(projectile.position);
-    std::cout << "[WorldRenderer] Rendering projectile '" << projectile.modelName 
-              << "' (" << projectile.effectType << ") at distance " << distance << " units" << std::endl;
+    submitEntity(projectile);
+    if (m_debugLog) {
+        const StringInterner& names = getRenderNames();
+        *m_debugLog << "[WorldRenderer] Rendering projectile '" << names.getString(projectile.modelName) 
+                    << "' (" << names.getString(projectile.effectType) << ") at distance "
+                    << getDistanceFromCamera(projectile.position) << " units\n";
+    }
 }
 
 void WorldRenderer::renderSpellEffects(const std::vector<SpellEffect>& effects) {
@@ -229,19 +275,31 @@ void WorldRenderer::renderSpellEffects(const std::vector<SpellEffect>& effects)
 }
 
 void WorldRenderer::renderSpellEffect(const SpellEffect& effect) {
-    float distance = getDistanceFromCamera(effect.position);
-    std::cout << "[WorldRenderer] Rendering spell effect '" << effect.spellName 
-              << "' (" << effect.schoolName << ") at distance " << distance 
-              << " units, time remaining: " << effect.timeRemaining << "s" << std::endl;
+    RenderPacket& packet = m_packets.emplace_back();
+    packet.position = effect.position;
+    packet.rotation = effect.targetPosition - effect.position;
+    packet.color = effect.color;
+    packet.radius = effect.isAreaEffect ? effect.radius : 0.0f;
+    packet.type = RenderEntityType::SPELL_EFFECT;
+    packet.entityId = effect.id;
+    packet.model = effect.spellName;
+    packet.effect = effect.schoolName;
+    
+    if (!m_debugLog) return;
+    const StringInterner& names = getRenderNames();
+    *m_debugLog << "[WorldRenderer] Rendering spell effect '" << names.getString(effect.spellName) 
+                << "' (" << names.getString(effect.schoolName) << ") at distance "
+                << getDistanceFromCamera(effect.position) 
+                << " units, time remaining: " << effect.timeRemaining << "s\n";
     
     // Render projectile if it's a projectile spell
     if (effect.isProjectile) {
-        std::cout << "[WorldRenderer]   -> Projectile heading to target" << std::endl;
+        *m_debugLog << "[WorldRenderer]   -> Projectile heading to target\n";
     }
     
     // Render area effect
     if (effect.isAreaEffect) {
-        std::cout << "[WorldRenderer]   -> Area effect radius: " << effect.radius << std::endl;
+        *m_debugLog << "[WorldRenderer]   -> Area effect radius: " << effect.radius << "\n";
     }
 }
 
@@ -259,133 +317,295 @@ void WorldRenderer::renderAbilityEffects(const std::vector<AbilityEffect>& effec
 }
 
 void WorldRenderer::renderAbilityEffect(const AbilityEffect& effect) {
-    float distance = getDistanceFromCamera(effect.position);
-    std::cout << "[WorldRenderer] Rendering ability effect '" << effect.abilityName 
-              << "' (" << effect.effectType << ") at distance " << distance 
-              << " units, time remaining: " << effect.timeRemaining << "s" << std::endl;
+    RenderPacket& packet = m_packets.emplace_back();
+    packet.position = effect.position;
+    packet.rotation = glm::vec3(0.0f);
+    packet.color = effect.color;
+    packet.type = RenderEntityType::ABILITY_EFFECT;
+    packet.entityId = effect.id;
+    packet.model = effect.abilityName;
+    packet.effect = effect.effectType;
+    
+    if (m_debugLog) {
+        const StringInterner& names = getRenderNames();
+        *m_debugLog << "[WorldRenderer] Rendering ability effect '" << names.getString(effect.abilityName) 
+                    << "' (" << names.getString(effect.effectType) << ") at distance "
+                    << getDistanceFromCamera(effect.position) 
+                    << " units, time remaining: " << effect.timeRemaining << "s\n";
+    }
+}
+
+void WorldRenderer::renderWorldObject(const RenderEntity& object) {
+    if (!object.visible) return;
+    
+    submitEntity(object);
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Rendering world object '" << getRenderNames().getString(object.modelName) 
+                    << "' at distance " << getDistanceFromCamera(object.position) << " units\n";
+    }
 }
 
 void WorldRenderer::renderParticles() {
     if (!m_settings.particlesEnabled) return;
     
     // Particle rendering would be handled here
-    std::cout << "[WorldRenderer] Rendering particles (distance: " 
-              << m_settings.particleRenderDistance << " units)" << std::endl;
+    if (m_debugLog) {
+        *m_debugLog << "[WorldRenderer] Rendering particles (distance: " 
+                    << m_settings.particleRenderDistance << " units)\n";
+    }
 }
 
-void WorldRenderer::addPlayer(const RenderEntity& player) {
-    m_playerQueue.push_back(player);
+void WorldRenderer::submitEntity(const RenderEntity& entity) {
+    RenderPacket& packet = m_packets.emplace_back();
+    packet.position = entity.position;
+    packet.rotation = entity.rotation;
+    packet.scale = entity.scale;
+    packet.color = entity.effectColor;
+    packet.animationTime = entity.animationTime;
+    packet.alpha = entity.alpha;
+    packet.type = entity.type;
+    packet.entityId = entity.id;
+    packet.model = entity.modelName;
+    packet.texture = entity.textureName;
+    packet.animation = entity.currentAnimation;
+    packet.effect = entity.effectType;
+}
+
+void WorldRenderer::renderEntities() {
+    performFrustumCulling();
+    
+    auto renderLayer = [this](RenderLayer<RenderEntity>& layer, void (WorldRenderer::*render)(const RenderEntity&)) {
+        auto& entities = layer.entities.values();
+        for (size_t i = 0; i < entities.size(); ++i) {
+            if (layer.visible[i]) {
+                (this->*render)(entities[i]);
+                m_renderedEntityCount++;
+            } else {
+                m_culledEntityCount++;
+            }
+        }
+    };
+    renderLayer(m_players, &WorldRenderer::renderPlayer);
+    renderLayer(m_monsters, &WorldRenderer::renderMonster);
+    renderLayer(m_npcs, &WorldRenderer::renderNPC);
+    renderLayer(m_projectiles, &WorldRenderer::renderProjectile);
+    
+    if (m_settings.spellEffectsEnabled) {
+        auto& effects = m_spellEffects.entities.values();
+        for (size_t i = 0; i < effects.size(); ++i) {
+            if (m_spellEffects.visible[i]) {
+                renderSpellEffect(effects[i]);
+                m_renderedEntityCount++;
+            } else {
+                m_culledEntityCount++;
+            }
+        }
+    }
+    
+    if (m_settings.abilityEffectsEnabled) {
+        auto& effects = m_abilityEffects.entities.values();
+        for (size_t i = 0; i < effects.size(); ++i) {
+            if (m_abilityEffects.visible[i]) {
+                renderAbilityEffect(effects[i]);
+                m_renderedEntityCount++;
+            } else {
+                m_culledEntityCount++;
+            }
+        }
+    }
+    
+    for (uint32_t slot : m_visibleWorldObjects) {
+        renderWorldObject(m_worldObjects.atSlot(slot));
+    }
+    m_renderedEntityCount += static_cast<uint32_t>(m_visibleWorldObjects.size());
+    m_culledEntityCount += static_cast<uint32_t>(m_worldObjects.size() - m_visibleWorldObjects.size());
 }
 
-void WorldRenderer::addMonster(const RenderEntity& monster) {
-    m_monsterQueue.push_back(monster);
+RenderHandle WorldRenderer::addPlayer(const RenderEntity& player) {
+    return {m_players.add(player, getBoundingRadius(player)), RenderEntityType::PLAYER};
 }
 
-void WorldRenderer::addNPC(const RenderEntity& npc) {
-    m_npcQueue.push_back(npc);
+RenderHandle WorldRenderer::addMonster(const RenderEntity& monster) {
+    return {m_monsters.add(monster, getBoundingRadius(monster)), RenderEntityType::MONSTER};
 }
 
-void WorldRenderer::addProjectile(const RenderEntity& projectile) {
-    m_projectileQueue.push_back(projectile);
+RenderHandle WorldRenderer::addNPC(const RenderEntity& npc) {
+    return {m_npcs.add(npc, getBoundingRadius(npc)), RenderEntityType::NPC};
 }
 
-void WorldRenderer::addSpellEffect(const SpellEffect& effect) {
-    m_spellEffectQueue.push_back(effect);
+RenderHandle WorldRenderer::addProjectile(const RenderEntity& projectile) {
+    return {m_projectiles.add(projectile, getBoundingRadius(projectile)), RenderEntityType::PROJECTILE};
 }
 
-void WorldRenderer::addAbilityEffect(const AbilityEffect& effect) {
-    m_abilityEffectQueue.push_back(effect);
+RenderHandle WorldRenderer::addSpellEffect(const SpellEffect& effect) {
+    // Area effects are as large as their radius
+    float radius = std::max(getBoundingRadius(RenderEntityType::SPELL_EFFECT), effect.radius);
+    return {m_spellEffects.add(effect, radius), RenderEntityType::SPELL_EFFECT};
 }
 
-void WorldRenderer::removeEntity(uint32_t id, RenderEntityType type) {
-    switch (type) {
-        case RenderEntityType::PLAYER:
-            m_playerQueue.erase(
-                std::remove_if(m_playerQueue.begin(), m_playerQueue.end(),
-                    [id](const RenderEntity& e) { return e.id == id; }),
-                m_playerQueue.end());
-            break;
-        case RenderEntityType::MONSTER:
-            m_monsterQueue.erase(
-                std::remove_if(m_monsterQueue.begin(), m_monsterQueue.end(),
-                    [id](const RenderEntity& e) { return e.id == id; }),
-                m_monsterQueue.end());
-            break;
-        case RenderEntityType::NPC:
-            m_npcQueue.erase(
-                std::remove_if(m_npcQueue.begin(), m_npcQueue.end(),
-                    [id](const RenderEntity& e) { return e.id == id; }),
-                m_npcQueue.end());
+RenderHandle WorldRenderer::addAbilityEffect(const AbilityEffect& effect) {
+    return {m_abilityEffects.add(effect, getBoundingRadius(RenderEntityType::ABILITY_EFFECT)),
+            RenderEntityType::ABILITY_EFFECT};
+}
+
+RenderHandle WorldRenderer::addWorldObject(const RenderEntity& object) {
+    auto existing = m_worldObjectIds.find(object.id);
+    if (existing != m_worldObjectIds.end()) {
+        removeEntity({existing->second, RenderEntityType::WORLD_OBJECT});
+    }
+    
+    SlotHandle handle = m_worldObjects.insert(object);
+    m_worldObjectIds[object.id] = handle;
+    m_worldObjectGrid.insert(handle.index, object.position, getBoundingRadius(object));
+    return {handle, RenderEntityType::WORLD_OBJECT};
+}
+
+bool WorldRenderer::updateEntityPosition(const RenderHandle& handle, const glm::vec3& position) {
+    switch (handle.type) {
+        case RenderEntityType::SPELL_EFFECT: {
+            SpellEffect* effect = m_spellEffects.entities.get(handle.slot);
+            if (!effect) return false;
+            effect->position = position;
+            uint32_t dense = m_spellEffects.entities.getDenseIndex(handle.slot);
+            m_spellEffects.bounds.set(dense, position, m_spellEffects.bounds.radius[dense]);
+            return true;
+        }
+        case RenderEntityType::ABILITY_EFFECT: {
+            AbilityEffect* effect = m_abilityEffects.entities.get(handle.slot);
+            if (!effect) return false;
+            effect->position = position;
+            uint32_t dense = m_abilityEffects.entities.getDenseIndex(handle.slot);
+            m_abilityEffects.bounds.set(dense, position, m_abilityEffects.bounds.radius[dense]);
+            return true;
+        }
+        case RenderEntityType::WORLD_OBJECT: {
+            RenderEntity* object = m_worldObjects.get(handle.slot);
+            if (!object) return false;
+            object->position = position;
+            m_worldObjectGrid.move(handle.slot.index, position, getBoundingRadius(*object));
+            return true;
+        }
+        default:
             break;
-        case RenderEntityType::PROJECTILE:
-            m_projectileQueue.erase(
-                std::remove_if(m_projectileQueue.begin(), m_projectileQueue.end(),
-                    [id](const RenderEntity& e) { return e.id == id; }),
-                m_projectileQueue.end());
+    }
+    
+    RenderLayer<RenderEntity>* layer = getEntityLayer(handle.type);
+    RenderEntity* entity = layer ? layer->entities.get(handle.slot) : nullptr;
+    if (!entity) return false;
+    entity->position = position;
+    layer->bounds.set(layer->entities.getDenseIndex(handle.slot), position, getBoundingRadius(*entity));
+    return true;
+}
+
+bool WorldRenderer::removeEntity(const RenderHandle& handle) {
+    switch (handle.type) {
+        case RenderEntityType::SPELL_EFFECT:
+            return m_spellEffects.remove(handle.slot);
+        case RenderEntityType::ABILITY_EFFECT:
+            return m_abilityEffects.remove(handle.slot);
+        case RenderEntityType::WORLD_OBJECT: {
+            const RenderEntity* object = m_worldObjects.get(handle.slot);
+            if (!object) return false;
+            m_worldObjectIds.erase(object->id);
+            m_worldObjectGrid.remove(handle.slot.index);
+            m_worldObjects.erase(handle.slot);
+            return true;
+        }
+        default:
             break;
+    }
+    
+    RenderLayer<RenderEntity>* layer = getEntityLayer(handle.type);
+    return layer && layer->remove(handle.slot);
+}
+
+void WorldRenderer::removeEntity(uint32_t id, RenderEntityType type) {
+    const std::unordered_map<uint32_t, SlotHandle>* ids = nullptr;
+    switch (type) {
         case RenderEntityType::SPELL_EFFECT:
-            m_spellEffectQueue.erase(
-                std::remove_if(m_spellEffectQueue.begin(), m_spellEffectQueue.end(),
-                    [id](const SpellEffect& e) { return e.id == id; }),
-                m_spellEffectQueue.end());
+            ids = &m_spellEffects.byId;
             break;
         case RenderEntityType::ABILITY_EFFECT:
-            m_abilityEffectQueue.erase(
-                std::remove_if(m_abilityEffectQueue.begin(), m_abilityEffectQueue.end(),
-                    [id](const AbilityEffect& e) { return e.id == id; }),
-                m_abilityEffectQueue.end());
+            ids = &m_abilityEffects.byId;
+            break;
+        case RenderEntityType::WORLD_OBJECT:
+            ids = &m_worldObjectIds;
             break;
         default:
+            if (RenderLayer<RenderEntity>* layer = getEntityLayer(type)) {
+                ids = &layer->byId;
+            }
             break;
     }
+    if (!ids) return;
+    
+    auto it = ids->find(id);
+    if (it != ids->end()) {
+        removeEntity({it->second, type});
+    }
 }
 
 void WorldRenderer::clearAllEntities() {
-    m_playerQueue.clear();
-    m_monsterQueue.clear();
-    m_npcQueue.clear();
-    m_projectileQueue.clear();
-    m_spellEffectQueue.clear();
-    m_abilityEffectQueue.clear();
+    m_players.clear();
+    m_monsters.clear();
+    m_npcs.clear();
+    m_projectiles.clear();
+    m_spellEffects.clear();
+    m_abilityEffects.clear();
+    m_worldObjects.clear();
+    m_worldObjectIds.clear();
+    m_worldObjectGrid.clear();
+    m_visibleWorldObjects.clear();
+}
+
+size_t WorldRenderer::getEntityCount(RenderEntityType type) const {
+    switch (type) {
+        case RenderEntityType::PLAYER: return m_players.entities.size();
+        case RenderEntityType::MONSTER: return m_monsters.entities.size();
+        case RenderEntityType::NPC: return m_npcs.entities.size();
+        case RenderEntityType::PROJECTILE: return m_projectiles.entities.size();
+        case RenderEntityType::SPELL_EFFECT: return m_spellEffects.entities.size();
+        case RenderEntityType::ABILITY_EFFECT: return m_abilityEffects.entities.size();
+        case RenderEntityType::WORLD_OBJECT: return m_worldObjects.size();
+        default: return 0;
+    }
 }
 
 void WorldRenderer::update(float deltaTime) {
-    // Update spell effect timers
-    for (auto& effect : m_spellEffectQueue) {
-        effect.timeRemaining -= deltaTime;
+    // Update effect timers, removing expired effects. Walking backwards
+    // keeps unvisited effects in place when the last one fills a hole.
+    auto& spellEffects = m_spellEffects.entities.values();
+    for (size_t i = spellEffects.size(); i-- > 0;) {
+        spellEffects[i].timeRemaining -= deltaTime;
+        if (spellEffects[i].timeRemaining <= 0.0f) {
+            m_spellEffects.removeAt(static_cast<uint32_t>(i));
+        }
     }
     
-    // Remove expired spell effects
-    m_spellEffectQueue.erase(
-        std::remove_if(m_spellEffectQueue.begin(), m_spellEffectQueue.end(),
-            [](const SpellEffect& e) { return e.timeRemaining <= 0.0f; }),
-        m_spellEffectQueue.end());
-    
-    // Update ability effect timers
-    for (auto& effect : m_abilityEffectQueue) {
-        effect.timeRemaining -= deltaTime;
+    auto& abilityEffects = m_abilityEffects.entities.values();
+    for (size_t i = abilityEffects.size(); i-- > 0;) {
+        abilityEffects[i].timeRemaining -= deltaTime;
+        if (abilityEffects[i].timeRemaining <= 0.0f) {
+            m_abilityEffects.removeAt(static_cast<uint32_t>(i));
+        }
     }
     
-    // Remove expired ability effects
-    m_abilityEffectQueue.erase(
-        std::remove_if(m_abilityEffectQueue.begin(), m_abilityEffectQueue.end(),
-            [](const AbilityEffect& e) { return e.timeRemaining <= 0.0f; }),
-        m_abilityEffectQueue.end());
-    
     // Update entity animations
-    for (auto& player : m_playerQueue) {
+    for (auto& player : m_players.entities.values()) {
         player.animationTime += deltaTime;
     }
-    for (auto& monster : m_monsterQueue) {
+    for (auto& monster : m_monsters.entities.values()) {
         monster.animationTime += deltaTime;
     }
-    for (auto& npc : m_npcQueue) {
+    for (auto& npc : m_npcs.entities.values()) {
         npc.animationTime += deltaTime;
     }
 }
 
 bool WorldRenderer::isInRenderRange(const glm::vec3& position, RenderEntityType type) const {
-    return !shouldCull(position, type);
+    glm::vec3 diff = position - m_cameraPosition;
+    float maxDistance = getRenderDistance(type);
+    return glm::dot(diff, diff) <= maxDistance * maxDistance;
 }
 
 float WorldRenderer::getDistanceFromCamera(const glm::vec3& position) const {
@@ -420,15 +640,60 @@ float WorldRenderer::getRenderDistance(RenderEntityType type) const {
     }
 }
 
+float WorldRenderer::getBoundingRadius(RenderEntityType type) {
+    switch (type) {
+        case RenderEntityType::PLAYER:
+        case RenderEntityType::NPC:
+            return 1.0f;
+        case RenderEntityType::MONSTER:
+            return 1.5f;  // Large enough for spiders and golems
+        case RenderEntityType::PROJECTILE:
+            return 0.5f;
+        case RenderEntityType::SPELL_EFFECT:
+        case RenderEntityType::ABILITY_EFFECT:
+            return 1.5f;
+        case RenderEntityType::PARTICLE:
+            return 0.25f;
+        case RenderEntityType::WORLD_OBJECT:
+        default:
+            return 1.0f;
+    }
+}
+
+float WorldRenderer::getBoundingRadius(const RenderEntity& entity) {
+    float scale = std::max(entity.scale.x, std::max(entity.scale.y, entity.scale.z));
+    return getBoundingRadius(entity.type) * scale;
+}
+
 bool WorldRenderer::shouldCull(const glm::vec3& position, RenderEntityType type) const {
-    float distance = getDistanceFromCamera(position);
-    float maxDistance = getRenderDistance(type);
-    return distance > maxDistance;
+    return !isSphereVisible(m_frustum, m_cameraPosition, getRenderDistance(type), position, getBoundingRadius(type));
+}
+
+RenderLayer<RenderEntity>* WorldRenderer::getEntityLayer(RenderEntityType type) {
+    switch (type) {
+        case RenderEntityType::PLAYER: return &m_players;
+        case RenderEntityType::MONSTER: return &m_monsters;
+        case RenderEntityType::NPC: return &m_npcs;
+        case RenderEntityType::PROJECTILE: return &m_projectiles;
+        default: return nullptr;
+    }
 }
 
 void WorldRenderer::performFrustumCulling() {
-    // Would perform frustum culling here
-    // For now, just distance culling is implemented
+    // One batched sphere test per entity type; world objects go through the
+    // grid so far-away cells are skipped without touching their objects
+    cullSpheres(m_frustum, m_cameraPosition, m_settings.playerRenderDistance, m_players.bounds, m_players.visible);
+    cullSpheres(m_frustum, m_cameraPosition, m_settings.monsterRenderDistance, m_monsters.bounds, m_monsters.visible);
+    cullSpheres(m_frustum, m_cameraPosition, m_settings.npcRenderDistance, m_npcs.bounds, m_npcs.visible);
+    cullSpheres(m_frustum, m_cameraPosition, m_settings.projectileRenderDistance, m_projectiles.bounds,
+                m_projectiles.visible);
+    cullSpheres(m_frustum, m_cameraPosition, m_settings.spellRenderDistance, m_spellEffects.bounds,
+                m_spellEffects.visible);
+    cullSpheres(m_frustum, m_cameraPosition, m_settings.abilityRenderDistance, m_abilityEffects.bounds,
+                m_abilityEffects.visible);
+    
+    m_visibleWorldObjects.clear();
+    m_worldObjectGrid.query(m_frustum, m_cameraPosition, m_settings.worldRenderDistance, m_visibleWorldObjects);
 }
 
 // ============================================================================
@@ -442,10 +707,10 @@ RenderEntity RenderEntityFactory::createPlayerEntity(uint32_t id, const std::str
     entity.type = RenderEntityType::PLAYER;
     entity.position = position;
     entity.rotation = rotation;
-    entity.modelName = name;
-    entity.textureName = "player_default";
+    entity.modelName = getRenderNames().intern(name);
+    entity.textureName = getRenderNames().intern("player_default");
     entity.visible = true;
-    entity.currentAnimation = "idle";
+    entity.currentAnimation = getRenderNames().intern("idle");
     return entity;
 }
 
@@ -456,10 +721,10 @@ RenderEntity RenderEntityFactory::createMonsterEntity(uint32_t id, const std::st
     entity.type = RenderEntityType::MONSTER;
     entity.position = position;
     entity.rotation = rotation;
-    entity.modelName = monsterType;
-    entity.textureName = monsterType + "_texture";
+    entity.modelName = getRenderNames().intern(monsterType);
+    entity.textureName = getRenderNames().intern(monsterType + "_texture");
     entity.visible = true;
-    entity.currentAnimation = "idle";
+    entity.currentAnimation = getRenderNames().intern("idle");
     return entity;
 }
 
@@ -470,10 +735,10 @@ RenderEntity RenderEntityFactory::createNPCEntity(uint32_t id, const std::string
     entity.type = RenderEntityType::NPC;
     entity.position = position;
     entity.rotation = rotation;
-    entity.modelName = npcType;
-    entity.textureName = npcType + "_texture";
+    entity.modelName = getRenderNames().intern(npcType);
+    entity.textureName = getRenderNames().intern(npcType + "_texture");
     entity.visible = true;
-    entity.currentAnimation = "idle";
+    entity.currentAnimation = getRenderNames().intern("idle");
     return entity;
 }
 
@@ -484,18 +749,18 @@ RenderEntity RenderEntityFactory::createProjectileEntity(uint32_t id, const std:
     entity.type = RenderEntityType::PROJECTILE;
     entity.position = position;
     entity.rotation = direction;
-    entity.modelName = projectileType;
-    entity.effectType = projectileType;
+    entity.modelName = getRenderNames().intern(projectileType);
+    entity.effectType = entity.modelName;
     entity.visible = true;
     
     // Set texture based on projectile type
     if (projectileType == "arrow") {
-        entity.textureName = "arrow_texture";
+        entity.textureName = getRenderNames().intern("arrow_texture");
     } else if (projectileType == "bullet") {
-        entity.textureName = "bullet_texture";
+        entity.textureName = getRenderNames().intern("bullet_texture");
     } else if (projectileType.find("_bolt") != std::string::npos) {
         // Magic bolt (fire_bolt, ice_bolt, etc.)
-        entity.textureName = projectileType + "_texture";
+        entity.textureName = getRenderNames().intern(projectileType + "_texture");
         entity.effectColor = glm::vec3(1.0f, 0.5f, 0.0f); // Default orange for fire
         
         if (projectileType == "ice_bolt") {
@@ -524,7 +789,7 @@ RenderEntity RenderEntityFactory::createProjectileEntity(uint32_t id, const std:
             entity.effectColor = glm::vec3(0.2f, 0.5f, 1.0f); // Blue
         }
     } else {
-        entity.textureName = "projectile_default";
+        entity.textureName = getRenderNames().intern("projectile_default");
     }
     
     return entity;
@@ -535,8 +800,8 @@ SpellEffect RenderEntityFactory::createSpellEffect(uint32_t id, const std::strin
                                                    const glm::vec3& targetPos, float duration) {
     SpellEffect effect;
     effect.id = id;
-    effect.spellName = spellName;
-    effect.schoolName = school;
+    effect.spellName = getRenderNames().intern(spellName);
+    effect.schoolName = getRenderNames().intern(school);
     effect.position = position;
     effect.targetPosition = targetPos;
     effect.duration = duration;
@@ -586,9 +851,9 @@ AbilityEffect RenderEntityFactory::createAbilityEffect(uint32_t id, const std::s
                                                        float duration) {
     AbilityEffect effect;
     effect.id = id;
-    effect.abilityName = abilityName;
+    effect.abilityName = getRenderNames().intern(abilityName);
     effect.position = position;
-    effect.effectType = effectType;
+    effect.effectType = getRenderNames().intern(effectType);
     effect.duration = duration;
     effect.timeRemaining = duration;
     
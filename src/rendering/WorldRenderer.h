@@ -3,8 +3,14 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <ostream>
 #include <string>
 #include <glm/glm.hpp>
+#include "core/SlotMap.h"
+#include "core/StringInterner.h"
+#include "BoundingSpheres.h"
+#include "Frustum.h"
+#include "LooseGrid.h"
 
 namespace clonemine {
 
@@ -29,6 +35,12 @@ struct RenderSettings {
     // Detail levels (0 = low, 1 = medium, 2 = high, 3 = ultra)
     int detailLevel{2};
     
+    // Terrain level of detail (see BlockRenderer::setLodDistance): chunks
+    // beyond lodDistance are meshed in 2x2x2-block cells, beyond twice that
+    // in 4x4x4 cells, and so on up to maxLodLevel
+    float lodDistance{128.0f};
+    int maxLodLevel{3};
+    
     // FPS-based quality scaling
     bool autoAdjustQuality{true};           // Automatically adjust based on FPS
     int targetFPS{60};                      // Target FPS for auto-adjustment
@@ -50,6 +62,7 @@ struct RenderSettings {
         switch (preset) {
             case 0: // Low
                 worldRenderDistance = 128.0f;
+                lodDistance = 48.0f;
                 playerRenderDistance = 50.0f;
                 monsterRenderDistance = 40.0f;
                 spellRenderDistance = 60.0f;
@@ -63,6 +76,7 @@ struct RenderSettings {
                 break;
             case 1: // Medium
                 worldRenderDistance = 192.0f;
+                lodDistance = 64.0f;
                 playerRenderDistance = 75.0f;
                 monsterRenderDistance = 60.0f;
                 spellRenderDistance = 90.0f;
@@ -77,6 +91,7 @@ struct RenderSettings {
                 break;
             case 2: // High
                 worldRenderDistance = 256.0f;
+                lodDistance = 128.0f;
                 playerRenderDistance = 100.0f;
                 monsterRenderDistance = 80.0f;
                 spellRenderDistance = 120.0f;
@@ -91,6 +106,7 @@ struct RenderSettings {
                 break;
             case 3: // Ultra
                 worldRenderDistance = 512.0f;
+                lodDistance = 192.0f;
                 playerRenderDistance = 200.0f;
                 monsterRenderDistance = 150.0f;
                 spellRenderDistance = 200.0f;
@@ -121,6 +137,16 @@ enum class RenderEntityType {
     WORLD_OBJECT
 };
 
+/**
+ * @brief Interned id of a model, texture, animation or effect name
+ */
+using RenderNameId = StringInterner::Id;
+
+/**
+ * @brief Names used by render entities, shared process-wide
+ */
+StringInterner& getRenderNames();
+
 /**
  * @brief Renderable entity data
  */
@@ -130,15 +156,15 @@ struct RenderEntity {
     glm::vec3 position;
     glm::vec3 rotation;
     glm::vec3 scale{1.0f, 1.0f, 1.0f};
-    std::string modelName;
-    std::string textureName;
+    RenderNameId modelName{StringInterner::EMPTY};
+    RenderNameId textureName{StringInterner::EMPTY};
     float animationTime{0.0f};
-    std::string currentAnimation;
+    RenderNameId currentAnimation{StringInterner::EMPTY};
     bool visible{true};
     float alpha{1.0f};
     
     // For spell/ability effects
-    std::string effectType;
+    RenderNameId effectType{StringInterner::EMPTY};
     float effectDuration{0.0f};
     float effectTimeRemaining{0.0f};
     glm::vec3 effectColor{1.0f, 1.0f, 1.0f};
@@ -149,8 +175,8 @@ struct RenderEntity {
  */
 struct SpellEffect {
     uint32_t id;
-    std::string spellName;
-    std::string schoolName;  // fire, frost, arcane, etc.
+    RenderNameId spellName{StringInterner::EMPTY};
+    RenderNameId schoolName{StringInterner::EMPTY};  // fire, frost, arcane, etc.
     glm::vec3 position;
     glm::vec3 targetPosition;
     glm::vec3 color;
@@ -166,16 +192,94 @@ struct SpellEffect {
  */
 struct AbilityEffect {
     uint32_t id;
-    std::string abilityName;
+    RenderNameId abilityName{StringInterner::EMPTY};
     glm::vec3 position;
     glm::vec3 color;
     float duration;
     float timeRemaining;
-    std::string effectType; // "buff", "debuff", "damage", "heal"
+    RenderNameId effectType{StringInterner::EMPTY}; // "buff", "debuff", "damage", "heal"
+};
+
+/**
+ * @brief One visible entity as submitted to the graphics backend
+ *
+ * Plain data with no strings, so a frame-graph pass can sort and batch
+ * packets by model and texture id.
+ */
+struct RenderPacket {
+    glm::vec3 position;
+    glm::vec3 rotation;
+    glm::vec3 scale{1.0f, 1.0f, 1.0f};
+    glm::vec3 color{1.0f, 1.0f, 1.0f};
+    float animationTime{0.0f};
+    float alpha{1.0f};
+    float radius{0.0f};       // Area effects
+    RenderEntityType type;
+    uint32_t entityId;
+    RenderNameId model{StringInterner::EMPTY};
+    RenderNameId texture{StringInterner::EMPTY};
+    RenderNameId animation{StringInterner::EMPTY};
+    RenderNameId effect{StringInterner::EMPTY};  // Effect type, spell school or ability kind
+};
+
+/**
+ * @brief Stable reference to an entity added to the WorldRenderer
+ */
+struct RenderHandle {
+    SlotHandle slot;
+    RenderEntityType type{RenderEntityType::PLAYER};
+    
+    [[nodiscard]] bool valid() const noexcept { return slot.valid(); }
+};
+
+/**
+ * @brief Entities of one type with their bounding spheres in matching order
+ */
+template <typename T>
+struct RenderLayer {
+    SlotMap<T> entities;
+    BoundingSpheres bounds;                          // Same dense order as entities
+    std::unordered_map<uint32_t, SlotHandle> byId;
+    std::vector<uint8_t> visible;                    // From the last cull
+    
+    // An entity with the same id is replaced
+    SlotHandle add(const T& entity, float radius) {
+        auto existing = byId.find(entity.id);
+        if (existing != byId.end()) {
+            remove(existing->second);
+        }
+        SlotHandle handle = entities.insert(entity);
+        bounds.push(entity.position, radius);
+        byId[entity.id] = handle;
+        return handle;
+    }
+    
+    bool remove(SlotHandle handle) {
+        const T* entity = entities.get(handle);
+        if (!entity) return false;
+        removeAt(entities.getDenseIndex(handle));
+        return true;
+    }
+    
+    void removeAt(uint32_t dense) {
+        byId.erase(entities.values()[dense].id);
+        entities.eraseAt(dense);
+        bounds.swapRemove(dense);
+    }
+    
+    void clear() {
+        entities.clear();
+        bounds.clear();
+        byId.clear();
+        visible.clear();
+    }
 };
 
 /**
  * @brief Main world renderer that handles all visual rendering
+ *
+ * Entities are retained: they stay until removed or replaced by an entity
+ * of the same type and id, and are frustum and distance culled in batches.
  */
 class WorldRenderer {
 public:
@@ -198,10 +302,20 @@ public:
     void setCameraPosition(const glm::vec3& position);
     void setCameraDirection(const glm::vec3& direction);
     
-    // Main render methods
+    // Camera view-projection for frustum culling (distance only until set)
+    void setViewProjection(const glm::mat4& viewProj);
+    const Frustum& getFrustum() const { return m_frustum; }
+    
+    // Main render methods; beginFrame clears the packet list
     void beginFrame();
     void endFrame();
     
+    // Packets submitted since beginFrame
+    const std::vector<RenderPacket>& getRenderPackets() const { return m_packets; }
+    
+    // Trace of settings, lifecycle and every rendered entity; off (null) by default
+    void setDebugLog(std::ostream* out) { m_debugLog = out; }
+    
     // Render the world terrain/blocks
     void renderWorld(const World& world);
     
@@ -229,21 +343,35 @@ public:
     void renderAbilityEffects(const std::vector<AbilityEffect>& effects);
     void renderAbilityEffect(const AbilityEffect& effect);
     
+    // Render static world objects
+    void renderWorldObject(const RenderEntity& object);
+    
     // Render particles
     void renderParticles();
     
-    // Add entities to render queue
-    void addPlayer(const RenderEntity& player);
-    void addMonster(const RenderEntity& monster);
-    void addNPC(const RenderEntity& npc);
-    void addProjectile(const RenderEntity& projectile);
-    void addSpellEffect(const SpellEffect& effect);
-    void addAbilityEffect(const AbilityEffect& effect);
+    // Cull everything added below and render what is visible
+    void renderEntities();
+    
+    // Add entities; re-adding a type and id replaces the earlier one
+    RenderHandle addPlayer(const RenderEntity& player);
+    RenderHandle addMonster(const RenderEntity& monster);
+    RenderHandle addNPC(const RenderEntity& npc);
+    RenderHandle addProjectile(const RenderEntity& projectile);
+    RenderHandle addSpellEffect(const SpellEffect& effect);
+    RenderHandle addAbilityEffect(const AbilityEffect& effect);
+    // World objects rarely move and are kept in a spatial grid
+    RenderHandle addWorldObject(const RenderEntity& object);
+    
+    // Move an entity; false if the handle is stale
+    bool updateEntityPosition(const RenderHandle& handle, const glm::vec3& position);
     
     // Remove entities
+    bool removeEntity(const RenderHandle& handle);
     void removeEntity(uint32_t id, RenderEntityType type);
     void clearAllEntities();
     
+    size_t getEntityCount(RenderEntityType type) const;
+    
     // Update (for animations, effects timing)
     void update(float deltaTime);
     
@@ -260,17 +388,31 @@ private:
     // Render distance for entity type
     float getRenderDistance(RenderEntityType type) const;
     
+    // Append a packet for an entity that passed culling
+    void submitEntity(const RenderEntity& entity);
+    
+    // Bounding sphere radius before scaling
+    static float getBoundingRadius(RenderEntityType type);
+    static float getBoundingRadius(const RenderEntity& entity);
+    
     // Culling
     bool shouldCull(const glm::vec3& position, RenderEntityType type) const;
     void performFrustumCulling();
-    
-    // Render queues
-    std::vector<RenderEntity> m_playerQueue;
-    std::vector<RenderEntity> m_monsterQueue;
-    std::vector<RenderEntity> m_npcQueue;
-    std::vector<RenderEntity> m_projectileQueue;
-    std::vector<SpellEffect> m_spellEffectQueue;
-    std::vector<AbilityEffect> m_abilityEffectQueue;
+    RenderLayer<RenderEntity>* getEntityLayer(RenderEntityType type);
+    
+    // Retained entities, culled each frame
+    RenderLayer<RenderEntity> m_players;
+    RenderLayer<RenderEntity> m_monsters;
+    RenderLayer<RenderEntity> m_npcs;
+    RenderLayer<RenderEntity> m_projectiles;
+    RenderLayer<SpellEffect> m_spellEffects;
+    RenderLayer<AbilityEffect> m_abilityEffects;
+    
+    // Static world objects, indexed by slot in the grid
+    SlotMap<RenderEntity> m_worldObjects;
+    std::unordered_map<uint32_t, SlotHandle> m_worldObjectIds;
+    LooseGrid m_worldObjectGrid;
+    std::vector<uint32_t> m_visibleWorldObjects;
     
     // Settings
     RenderSettings m_settings;
@@ -278,6 +420,11 @@ private:
     // Camera
     glm::vec3 m_cameraPosition{0.0f, 0.0f, 0.0f};
     glm::vec3 m_cameraDirection{0.0f, 0.0f, -1.0f};
+    Frustum m_frustum;
+    
+    // Output of the current frame
+    std::vector<RenderPacket> m_packets;
+    std::ostream* m_debugLog{nullptr};
     
     // Stats
     uint32_t m_renderedEntityCount{0};
@@ -140,18 +140,14 @@ void ChatServer::handleNewConnection(std::shared_ptr<asio::ip::tcp::socket> sock
         }
         
         // Parse player name
-        if (buffer.size() < 9) {
+        network::MessageView<network::ConnectRequest> request;
+        if (!network::decodeView<network::ConnectRequest>(buffer, request)) {
             socket->close();
             return;
         }
         
-        uint32_t nameLen = buffer[5] | (buffer[6] << 8) | (buffer[7] << 16) | (buffer[8] << 24);
-        if (9 + nameLen > buffer.size()) {
-            socket->close();
-            return;
-        }
-        
-        std::string playerName(buffer.begin() + 9, buffer.begin() + 9 + nameLen);
+        auto& [requestedId, requestedName] = request;
+        std::string playerName(requestedName);
         
         // Create chat client
         uint32_t clientId = m_nextClientId++;
@@ -263,28 +259,10 @@ void ChatServer::handleNewConnection(std::shared_ptr<asio::ip::tcp::socket> sock
 }
 
 void ChatServer::handleChatMessage(uint32_t playerId, const std::vector<uint8_t>& data) {
-    if (data.size() < 10) return;
-    
-    size_t offset = 1;
-    
-    // Parse sender
-    uint32_t senderLen = data[offset] | (data[offset+1] << 8) |
-                        (data[offset+2] << 16) | (data[offset+3] << 24);
-    offset += 4;
-    
-    if (offset + senderLen + 4 > data.size()) return;
+    network::MessageView<network::ChatMessage> chat;
+    if (!network::decodeView<network::ChatMessage>(data, chat)) return;
     
-    std::string sender(data.begin() + offset, data.begin() + offset + senderLen);
-    offset += senderLen;
-    
-    // Parse message
-    uint32_t msgLen = data[offset] | (data[offset+1] << 8) |
-                     (data[offset+2] << 16) | (data[offset+3] << 24);
-    offset += 4;
-    
-    if (offset + msgLen > data.size()) return;
-    
-    std::string message(data.begin() + offset, data.begin() + offset + msgLen);
+    auto& [claimedSender, message] = chat;
     
     // Get actual sender name from client
     std::string actualSender;
@@ -297,7 +275,7 @@ void ChatServer::handleChatMessage(uint32_t playerId, const std::vector<uint8_t>
     }
     
     if (!actualSender.empty()) {
-        broadcastMessage(actualSender, message);
+        broadcastMessage(actualSender, std::string(message));
     }
 }
 
@@ -313,29 +291,28 @@ void ChatServer::broadcastMessage(const std::string& sender, const std::string&
         }
     }
     
-    // Broadcast to all clients
+    // Broadcast to all clients: serialized once, then per client only a
+    // frame header and the cipher, written straight into the send buffer
     network::ChatMessage chatMsg;
     chatMsg.sender = sender;
     chatMsg.message = message;
-    auto data = chatMsg.serialize();
+    auto packet = network::SharedPacket::create(network::encodeScratch(chatMsg));
+    
+    uint32_t size = static_cast<uint32_t>(packet.size());
     
     std::lock_guard<std::mutex> lock(m_clientsMutex);
+    m_sendBuffer.resize(4 + packet.size());
+    m_sendBuffer[0] = static_cast<uint8_t>(size & 0xFF);
+    m_sendBuffer[1] = static_cast<uint8_t>((size >> 8) & 0xFF);
+    m_sendBuffer[2] = static_cast<uint8_t>((size >> 16) & 0xFF);
+    m_sendBuffer[3] = static_cast<uint8_t>((size >> 24) & 0xFF);
+    
     for (auto& [id, client] : m_clients) {
         if (!client->connected) continue;
         
         try {
-            auto encryptedData = data;
-            client->encryption->encrypt(encryptedData);
-            
-            uint32_t size = static_cast<uint32_t>(encryptedData.size());
-            std::vector<uint8_t> sizeBytes(4);
-            sizeBytes[0] = static_cast<uint8_t>(size & 0xFF);
-            sizeBytes[1] = static_cast<uint8_t>((size >> 8) & 0xFF);
-            sizeBytes[2] = static_cast<uint8_t>((size >> 16) & 0xFF);
-            sizeBytes[3] = static_cast<uint8_t>((size >> 24) & 0xFF);
-            
-            asio::write(*client->socket, asio::buffer(sizeBytes));
-            asio::write(*client->socket, asio::buffer(encryptedData));
+            client->encryption->encrypt(packet.data(), m_sendBuffer.data() + 4, packet.size());
+            asio::write(*client->socket, asio::buffer(m_sendBuffer));
         } catch (...) {
             client->connected = false;
         }
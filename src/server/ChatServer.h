@@ -2,6 +2,7 @@
 
 #include "../network/NetworkMessage.h"
 #include "../network/PacketEncryption.h"
+#include "../network/SharedPacket.h"
 #include <asio.hpp>
 #include <memory>
 #include <unordered_map>
@@ -55,6 +56,7 @@ private:
     std::unordered_map<uint32_t, std::unique_ptr<ChatClient>> m_clients;
     std::mutex m_clientsMutex;
     uint32_t m_nextClientId{1};
+    std::vector<uint8_t> m_sendBuffer; // Broadcast frame, guarded by m_clientsMutex
     
     // Chat history (last 100 messages)
     std::deque<std::pair<std::string, std::string>> m_chatHistory;
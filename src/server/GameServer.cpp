@@ -1,5 +1,7 @@
 #include "GameServer.h"
 #include "../network/NetworkMessage.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <chrono>
 #include <filesystem>
@@ -7,8 +9,15 @@
 namespace clonemine {
 namespace server {
 
-GameServer::GameServer(uint16_t port)
-    : m_world(std::make_unique<World>())
+namespace {
+    constexpr float PLAYER_WALK_SPEED = 4.3f; // Player::WALK_SPEED
+    
+    constexpr auto BACKLOG_REPORT_INTERVAL = std::chrono::seconds(10);
+}
+
+GameServer::GameServer(uint16_t port, unsigned ioThreads)
+    : m_ioThreadCount(ioThreads > 0 ? ioThreads : std::clamp(std::thread::hardware_concurrency(), 1u, 4u))
+    , m_world(std::make_unique<World>())
     , m_port(port)
 {
     std::cout << "Initializing game server on port " << port << "..." << std::endl;
@@ -33,13 +42,17 @@ void GameServer::start() {
         asio::ip::tcp::endpoint endpoint(asio::ip::tcp::v4(), m_port);
         m_acceptor = std::make_unique<asio::ip::tcp::acceptor>(m_ioContext, endpoint);
         
-        std::cout << "Server listening on port " << m_port << std::endl;
+        std::cout << "Server listening on port " << m_port << " (" << m_ioThreadCount
+                  << " network threads)" << std::endl;
         
-        // Start accepting connections in a separate thread
-        m_networkThread = std::thread([this]() {
-            acceptConnections();
-            m_ioContext.run();
-        });
+        // Accept and read on the io_context pool; the tick thread only
+        // sees finished frames through the inbox
+        acceptConnections();
+        for (unsigned i = 0; i < m_ioThreadCount; ++i) {
+            m_ioThreads.emplace_back([this]() {
+                m_ioContext.run();
+            });
+        }
         
     } catch (const std::exception& e) {
         std::cerr << "Failed to start server: " << e.what() << std::endl;
@@ -62,6 +75,7 @@ void GameServer::stop() {
         player->disconnect();
     }
     m_players.clear();
+    m_sessionPlayers.clear();
     
     // Stop network
     if (m_acceptor) {
@@ -69,15 +83,23 @@ void GameServer::stop() {
     }
     m_ioContext.stop();
     
-    if (m_networkThread.joinable()) {
-        m_networkThread.join();
+    for (auto& thread : m_ioThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    m_ioThreads.clear();
+    
+    // Drop events nobody will handle now
+    SessionEvent event;
+    while (m_inbox.tryPop(event)) {
     }
     
     std::cout << "Server stopped." << std::endl;
 }
 
 void GameServer::run() {
-    using clock = std::chrono::high_resolution_clock;
+    using clock = std::chrono::steady_clock;
     auto lastTime = clock::now();
     const float targetFrameTime = 1.0f / 60.0f; // 60 Hz tick rate
     
@@ -89,8 +111,15 @@ void GameServer::run() {
         
         if (deltaTime >= targetFrameTime) {
             lastTime = currentTime;
+            processInbox();
             updateGame(deltaTime);
             broadcastPlayerStates();
+            flushSends();
+            
+            if (currentTime - m_lastBacklogReport >= BACKLOG_REPORT_INTERVAL) {
+                m_lastBacklogReport = currentTime;
+                reportSendBacklog();
+            }
         }
         
         // Small sleep to prevent 100% CPU usage
@@ -99,78 +128,75 @@ void GameServer::run() {
 }
 
 void GameServer::acceptConnections() {
-    auto socket = std::make_shared<asio::ip::tcp::socket>(m_ioContext);
-    
-    m_acceptor->async_accept(*socket, [this, socket](const asio::error_code& error) {
-        if (!error) {
-            std::cout << "New connection from " << socket->remote_endpoint() << std::endl;
-            handleNewConnection(socket);
-        } else {
-            std::cerr << "Accept error: " << error.message() << std::endl;
-        }
-        
-        // Continue accepting
-        if (m_running) {
-            acceptConnections();
+    // Each connection gets its own strand as its socket's executor
+    m_acceptor->async_accept(asio::make_strand(m_ioContext),
+        [this](const asio::error_code& error, asio::ip::tcp::socket socket) {
+            if (!error) {
+                auto session = std::make_shared<GameSession>(std::move(socket), m_nextSessionId++, m_inbox,
+                                                             m_sendLimits);
+                std::cout << "New connection from " << session->getRemoteAddress() << std::endl;
+                session->start();
+            } else if (error != asio::error::operation_aborted) {
+                std::cerr << "Accept error: " << error.message() << std::endl;
+            }
+            
+            // Continue accepting
+            if (m_running) {
+                acceptConnections();
+            }
+        });
+}
+
+void GameServer::processInbox() {
+    SessionEvent event;
+    while (m_inbox.tryPop(event)) {
+        switch (event.kind) {
+            case SessionEvent::Kind::CONNECT:
+                handleNewConnection(event.session, event.payload);
+                break;
+            
+            case SessionEvent::Kind::MESSAGE: {
+                auto it = m_sessionPlayers.find(event.session->getId());
+                if (it != m_sessionPlayers.end()) {
+                    handleMessage(it->second, event.payload);
+                }
+                break;
+            }
+            
+            case SessionEvent::Kind::CLOSED: {
+                // The player stays for the grace period (see updateGame)
+                auto it = m_sessionPlayers.find(event.session->getId());
+                if (it != m_sessionPlayers.end()) {
+                    auto player = m_players.find(it->second);
+                    if (player != m_players.end()) {
+                        player->second->disconnect();
+                    }
+                    m_sessionPlayers.erase(it);
+                }
+                break;
+            }
         }
-    });
+    }
 }
 
-void GameServer::handleNewConnection(std::shared_ptr<asio::ip::tcp::socket> socket) {
+void GameServer::handleNewConnection(const std::shared_ptr<GameSession>& session, const std::vector<uint8_t>& buffer) {
     try {
-        // Create a temporary encryption instance for this connection
-        auto encryption = std::make_unique<network::PacketEncryption>("CloneMineSharedSecret2024");
-        
-        // Read message size first
-        std::vector<uint8_t> sizeBuffer(4);
-        asio::read(*socket, asio::buffer(sizeBuffer));
-        
-        uint32_t messageSize = sizeBuffer[0] |
-                              (sizeBuffer[1] << 8) |
-                              (sizeBuffer[2] << 16) |
-                              (sizeBuffer[3] << 24);
-        
-        if (messageSize == 0 || messageSize > 1024) {
-            std::cerr << "Invalid connect request size" << std::endl;
-            socket->close();
-            return;
-        }
-        
-        // Read and decrypt connect request
-        std::vector<uint8_t> buffer(messageSize);
-        asio::read(*socket, asio::buffer(buffer));
-        encryption->decrypt(buffer);
-        
-        // Parse connect request
-        if (buffer.empty() || buffer[0] != static_cast<uint8_t>(network::MessageType::CONNECT_REQUEST)) {
+        network::MessageView<network::ConnectRequest> request;
+        if (!network::decodeView<network::ConnectRequest>(buffer, request)) {
             std::cerr << "Invalid connect request" << std::endl;
-            socket->close();
-            return;
-        }
-        
-        // Extract player name (skip type byte and playerId)
-        if (buffer.size() < 9) {
-            std::cerr << "Connect request too small" << std::endl;
-            socket->close();
+            session->close();
             return;
         }
         
-        uint32_t nameLen = buffer[5] | (buffer[6] << 8) | (buffer[7] << 16) | (buffer[8] << 24);
-        if (9 + nameLen > buffer.size()) {
-            std::cerr << "Invalid player name length" << std::endl;
-            socket->close();
-            return;
-        }
-        
-        std::string playerName(buffer.begin() + 9, buffer.begin() + 9 + nameLen);
+        auto& [requestedId, requestedName] = request;
+        std::string playerName(requestedName);
         
         std::cout << "Player '" << playerName << "' requesting connection (encrypted)" << std::endl;
         
         // Create new player
         uint32_t playerId = m_nextPlayerId++;
-        auto player = std::make_unique<ServerPlayer>(playerId, socket);
+        auto player = std::make_unique<ServerPlayer>(playerId, session);
         player->setName(playerName);
-        
         // Try to load saved data
         loadPlayerData(*player, playerName);
         
@@ -189,7 +215,7 @@ void GameServer::handleNewConnection(std::shared_ptr<asio::ip::tcp::socket> sock
         spawnMsg.position = player->getPlayer().getPosition();
         spawnMsg.playerName = playerName;
         spawnMsg.className = player->getPlayer().getClassName();
-        auto spawnData = spawnMsg.serialize();
+        auto spawnData = network::SharedPacket::create(network::encodeScratch(spawnMsg));
         
         for (auto& [id, existingPlayer] : m_players) {
             existingPlayer->sendData(spawnData);
@@ -197,6 +223,7 @@ void GameServer::handleNewConnection(std::shared_ptr<asio::ip::tcp::socket> sock
         
         // Add to active players
         m_players[playerId] = std::move(player);
+        m_sessionPlayers[session->getId()] = playerId;
         
         std::cout << "Player " << playerId << " (" << playerName << ") connected. Total players: " 
                   << m_players.size() << std::endl;
@@ -246,7 +273,7 @@ void GameServer::updateGame(float deltaTime) {
             // Broadcast player despawn
             network::PlayerDespawn despawnMsg;
             despawnMsg.playerId = id;
-            auto despawnData = despawnMsg.serialize();
+            auto despawnData = network::SharedPacket::create(network::encodeScratch(despawnMsg));
             
             for (auto& [otherId, otherPlayer] : m_players) {
                 if (otherId != id && otherPlayer->isConnected()) {
@@ -260,36 +287,52 @@ void GameServer::updateGame(float deltaTime) {
 }
 
 void GameServer::broadcastPlayerStates() {
-    // Send state updates to all players
+    // Players in the grace period are neither sent nor shown - they are
+    // being logged out
+    m_replicator.beginTick();
     for (auto& [id, player] : m_players) {
-        // Skip players in grace period - they are being logged out
         if (!player->isConnected() || player->shouldIgnoreActions()) {
             continue;
         }
-        
-        // Create state update message
-        network::PlayerStateUpdate update;
-        update.playerId = id;
-        update.position = player->getPlayer().getPosition();
-        update.velocity = player->getPlayer().getVelocity();
-        update.yaw = player->getPlayer().getYaw();
-        update.pitch = player->getPlayer().getPitch();
-        update.health = player->getPlayer().getHealth();
-        update.resource = player->getPlayer().getResource();
-        update.timestamp = static_cast<uint32_t>(
-            std::chrono::duration_cast<std::chrono::milliseconds>(
-                std::chrono::system_clock::now().time_since_epoch()
-            ).count()
-        );
-        
-        auto data = update.serialize();
-        
-        // Send to all other connected players (not in grace period)
-        for (auto& [otherId, otherPlayer] : m_players) {
-            if (otherId != id && otherPlayer->isConnected() && !otherPlayer->shouldIgnoreActions()) {
-                otherPlayer->sendData(data);
-            }
+        const Player& state = player->getPlayer();
+        m_replicator.addPlayer(network::QuantizedPlayerState::quantize(id, state.getPosition(), state.getVelocity(),
+                                                                      state.getYaw(), state.getPitch(),
+                                                                      state.getHealth(), state.getResource()),
+                               state.getPosition(), &player->getSnapshotHistory());
+    }
+    
+    auto serverTime = static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count()
+    );
+    m_replicator.replicate(serverTime, [this](uint32_t playerId, const std::vector<uint8_t>& data) {
+        m_players[playerId]->sendData(data);
+    });
+}
+
+void GameServer::flushSends() {
+    // One batch per player per tick, so one gather write when the socket
+    // keeps up
+    for (auto& [id, player] : m_players) {
+        player->flushSends();
+    }
+}
+
+void GameServer::reportSendBacklog() {
+    // Only connections that came anywhere near their budget or lost updates
+    for (auto& [id, player] : m_players) {
+        if (!player->isConnected()) {
+            continue;
+        }
+        SendQueueStats stats = player->getSession().takeSendStats();
+        if (stats.droppedFrames == 0 && stats.peakQueuedBytes < m_sendLimits.maxQueuedBytes / 4) {
+            continue;
         }
+        std::cout << "Player " << id << " (" << player->getName() << ") send backlog: "
+                  << stats.queuedBytes << " bytes queued, peak " << stats.peakQueuedBytes
+                  << ", " << stats.sentFrames << " sent, " << stats.droppedFrames
+                  << " state updates dropped" << std::endl;
     }
 }
 
@@ -353,39 +396,84 @@ bool GameServer::loadPlayerData(ServerPlayer& player, const std::string& playerN
     return false;
 }
 
-void GameServer::handleChatMessage(uint32_t playerId, const std::vector<uint8_t>& data) {
-    // Find the sending player
+void GameServer::handleMessage(uint32_t playerId, const std::vector<uint8_t>& data) {
+    switch (static_cast<network::MessageType>(data[0])) {
+        case network::MessageType::PLAYER_INPUT:
+            handlePlayerInput(playerId, data);
+            break;
+        case network::MessageType::CHAT_MESSAGE:
+            handleChatMessage(playerId, data);
+            break;
+        case network::MessageType::SNAPSHOT_ACK: {
+            auto it = m_players.find(playerId);
+            network::MessageView<network::SnapshotAck> ack;
+            if (it != m_players.end() && network::decodeView<network::SnapshotAck>(data, ack)) {
+                auto [sequence] = ack;
+                it->second->getSnapshotHistory().acknowledge(sequence);
+            }
+            break;
+        }
+        case network::MessageType::DISCONNECT: {
+            auto it = m_players.find(playerId);
+            if (it != m_players.end()) {
+                std::cout << "Player " << playerId << " (" << it->second->getName() << ") disconnecting" << std::endl;
+                it->second->disconnect();
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void GameServer::handlePlayerInput(uint32_t playerId, const std::vector<uint8_t>& data) {
     auto it = m_players.find(playerId);
-    if (it == m_players.end()) {
+    network::MessageView<network::PlayerInput> input;
+    if (it == m_players.end() || it->second->shouldIgnoreActions() ||
+        !network::decodeView<network::PlayerInput>(data, input)) {
         return;
     }
     
-    // Parse chat message
-    if (data.size() < 10 || data[0] != static_cast<uint8_t>(network::MessageType::CHAT_MESSAGE)) {
+    auto& [inputPlayerId, movement, yaw, pitch, jump, crouch, timestamp] = input;
+    if (!std::isfinite(movement.x) || !std::isfinite(movement.y) || !std::isfinite(movement.z) ||
+        !std::isfinite(yaw) || !std::isfinite(pitch)) {
         return;
     }
     
-    size_t offset = 1;
-    
-    // Read sender length
-    if (offset + 4 > data.size()) return;
-    uint32_t senderLen = data[offset] | (data[offset+1] << 8) | 
-                        (data[offset+2] << 16) | (data[offset+3] << 24);
-    offset += 4;
-    
-    if (offset + senderLen + 4 > data.size()) return;
-    
-    std::string sender(data.begin() + offset, data.begin() + offset + senderLen);
-    offset += senderLen;
-    
-    // Read message length
-    uint32_t msgLen = data[offset] | (data[offset+1] << 8) | 
-                     (data[offset+2] << 16) | (data[offset+3] << 24);
-    offset += 4;
+    // Movement is strafe (x) and forward (z) input; never faster than walking
+    float length = glm::length(movement);
+    if (length > 1.0f) {
+        movement /= length;
+    }
     
-    if (offset + msgLen > data.size()) return;
+    Player& player = it->second->getPlayer();
+    player.setRotation(yaw, pitch);
+    glm::vec3 forward = player.getForward();
+    glm::vec3 right = player.getRight();
+    forward.y = 0.0f;
+    right.y = 0.0f;
+    player.move((forward * movement.z + right * movement.x) * PLAYER_WALK_SPEED);
+    if (jump) {
+        player.jump();
+    }
+}
+
+void GameServer::handleChatMessage(uint32_t playerId, const std::vector<uint8_t>& data) {
+    // Find the sending player
+    auto it = m_players.find(playerId);
+    if (it == m_players.end()) {
+        return;
+    }
     
-    std::string message(data.begin() + offset, data.begin() + offset + msgLen);
+    // Parse chat message; the sender is whoever sent it, whatever it says
+    network::MessageView<network::ChatMessage> chat;
+    if (!network::decodeView<network::ChatMessage>(data, chat)) {
+        return;
+    }
+    auto& [claimedSender, message] = chat;
+    if (message.empty()) {
+        return;
+    }
     
     std::cout << "[CHAT] " << it->second->getName() << ": " << message << std::endl;
     
@@ -393,7 +481,8 @@ void GameServer::handleChatMessage(uint32_t playerId, const std::vector<uint8_t>
     network::ChatMessage chatMsg;
     chatMsg.sender = it->second->getName();
     chatMsg.message = message;
-    auto chatData = chatMsg.serialize();
+    // Serialized once; every player's queue shares it
+    auto chatData = network::SharedPacket::create(network::encodeScratch(chatMsg));
     
     for (auto& [id, player] : m_players) {
         player->sendData(chatData);
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "GameSession.h"
 #include "ServerPlayer.h"
+#include "StateReplicator.h"
 #include "../world/World.h"
 #include "../world/Chunk.h"
 #include "../save/SaveSystem.h"
@@ -9,19 +11,28 @@
 #include <unordered_map>
 #include <thread>
 #include <atomic>
+#include <chrono>
+#include <vector>
 
 namespace clonemine {
 namespace server {
 
+// Network I/O runs on a pool of io_context threads, one strand per
+// session; everything that touches game state runs on the tick thread in
+// run(), which drains the sessions' inbox at the start of every tick.
 class GameServer {
 public:
-    explicit GameServer(uint16_t port);
+    // ioThreads = 0 picks one per hardware thread, up to 4
+    explicit GameServer(uint16_t port, unsigned ioThreads = 0);
     ~GameServer();
     
     // Delete copy operations
     GameServer(const GameServer&) = delete;
     GameServer& operator=(const GameServer&) = delete;
     
+    // Applies to connections accepted after the call
+    void setSendQueueLimits(const SendQueueLimits& limits) { m_sendLimits = limits; }
+    
     void start();
     void stop();
     void run();
@@ -30,10 +41,14 @@ public:
     
 private:
     void acceptConnections();
-    void handleNewConnection(std::shared_ptr<asio::ip::tcp::socket> socket);
+    void processInbox();
+    void handleNewConnection(const std::shared_ptr<GameSession>& session, const std::vector<uint8_t>& data);
+    void handleMessage(uint32_t playerId, const std::vector<uint8_t>& data);
     void handlePlayerInput(uint32_t playerId, const std::vector<uint8_t>& data);
     void handleChatMessage(uint32_t playerId, const std::vector<uint8_t>& data);
     void broadcastPlayerStates();
+    void flushSends();
+    void reportSendBacklog();
     void updateGame(float deltaTime);
     void savePlayerData(const ServerPlayer& player);
     bool loadPlayerData(ServerPlayer& player, const std::string& playerName);
@@ -41,11 +56,21 @@ private:
     // Network
     asio::io_context m_ioContext;
     std::unique_ptr<asio::ip::tcp::acceptor> m_acceptor;
-    std::thread m_networkThread;
+    std::vector<std::thread> m_ioThreads;
+    unsigned m_ioThreadCount;
+    uint64_t m_nextSessionId{1}; // Accept handlers only
+    SendQueueLimits m_sendLimits;
+    std::chrono::steady_clock::time_point m_lastBacklogReport;
+    
+    // Session events for the tick thread; declared after the io_context
+    // so queued sessions release their sockets before it goes
+    SessionInbox m_inbox;
+    std::unordered_map<uint64_t, uint32_t> m_sessionPlayers;
     
     // Game state
     std::unique_ptr<World> m_world;
     std::unordered_map<uint32_t, std::unique_ptr<ServerPlayer>> m_players;
+    StateReplicator m_replicator;
     uint32_t m_nextPlayerId{1};
     
     // Threading
@@ -0,0 +1,268 @@
+#include "GameSession.h"
+#include "../network/NetworkMessage.h"
+#include <algorithm>
+#include <iostream>
+
+namespace clonemine {
+namespace server {
+
+namespace {
+    constexpr size_t FRAME_HEADER_SIZE = 4;
+
+    // Superseded by the next one, so the first thing to go when a client
+    // falls behind; snapshots are deltas against acknowledged ones only, so
+    // losing any of them is harmless
+    bool isStateUpdate(const network::SharedPacket& message) {
+        auto type = static_cast<network::MessageType>(message[0]);
+        return type == network::MessageType::PLAYER_STATE_SNAPSHOT ||
+               type == network::MessageType::PLAYER_STATE_UPDATE;
+    }
+}
+
+GameSession::GameSession(asio::ip::tcp::socket socket, uint64_t id, SessionInbox& inbox,
+                         const SendQueueLimits& limits)
+    : m_socket(std::move(socket))
+    , m_handshakeTimer(m_socket.get_executor())
+    , m_decryption("CloneMineSharedSecret2024")
+    , m_encryption("CloneMineSharedSecret2024")
+    , m_inbox(inbox)
+    , m_sendLimits(limits)
+    , m_id(id)
+{
+    asio::error_code error;
+    auto endpoint = m_socket.remote_endpoint(error);
+    m_remoteAddress = error ? "unknown" : endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
+}
+
+void GameSession::start() {
+    auto self = shared_from_this();
+    asio::dispatch(m_socket.get_executor(), [this, self]() {
+        m_handshakeTimer.expires_after(HANDSHAKE_TIMEOUT);
+        m_handshakeTimer.async_wait([this, self](const asio::error_code& error) {
+            if (!error && !m_handshakeDone) {
+                std::cerr << "Session " << m_id << " (" << m_remoteAddress << ") handshake timed out" << std::endl;
+                closeSocket();
+            }
+        });
+        readHeader();
+    });
+}
+
+void GameSession::close() {
+    auto self = shared_from_this();
+    asio::post(m_socket.get_executor(), [this, self]() {
+        closeSocket();
+    });
+}
+
+void GameSession::send(std::vector<network::SharedPacket> messages) {
+    if (messages.empty()) {
+        return;
+    }
+    auto self = shared_from_this();
+    asio::post(m_socket.get_executor(), [this, self, messages = std::move(messages)]() mutable {
+        enqueue(messages);
+    });
+}
+
+SendQueueStats GameSession::takeSendStats() {
+    SendQueueStats stats;
+    stats.queuedBytes = m_queuedBytes.load(std::memory_order_relaxed);
+    stats.peakQueuedBytes = m_peakQueuedBytes.exchange(stats.queuedBytes, std::memory_order_relaxed);
+    stats.sentFrames = m_sentFrames.exchange(0, std::memory_order_relaxed);
+    stats.droppedFrames = m_droppedFrames.exchange(0, std::memory_order_relaxed);
+    return stats;
+}
+
+void GameSession::enqueue(std::vector<network::SharedPacket>& messages) {
+    if (!m_socket.is_open()) {
+        return;
+    }
+
+    size_t queued = m_queuedBytes.load(std::memory_order_relaxed);
+    for (auto& message : messages) {
+        if (message.empty()) {
+            continue;
+        }
+        queued += FRAME_HEADER_SIZE + message.size();
+        m_sendQueue.push_back(std::move(message));
+    }
+    m_queuedBytes.store(queued, std::memory_order_relaxed);
+
+    if (queued > m_sendLimits.maxQueuedBytes) {
+        enforceSendBudget();
+        if (!m_socket.is_open()) {
+            return;
+        }
+    }
+
+    // Peak after trimming, i.e. what the connection actually held
+    queued = m_queuedBytes.load(std::memory_order_relaxed);
+    if (queued > m_peakQueuedBytes.load(std::memory_order_relaxed)) {
+        m_peakQueuedBytes.store(queued, std::memory_order_relaxed);
+    }
+
+    if (!m_writeInProgress) {
+        writeQueued();
+    }
+}
+
+void GameSession::enforceSendBudget() {
+    size_t queued = m_queuedBytes.load(std::memory_order_relaxed);
+
+    if (m_sendLimits.policy == SendOverflowPolicy::DROP_STATE_UPDATES) {
+        // Only unsent messages can go; the in-flight write is already
+        // encrypted. Oldest first, keeping everything else in order.
+        uint64_t dropped = 0;
+        size_t kept = 0;
+        for (size_t i = 0; i < m_sendQueue.size(); ++i) {
+            auto& message = m_sendQueue[i];
+            if (queued > m_sendLimits.maxQueuedBytes && isStateUpdate(message)) {
+                queued -= FRAME_HEADER_SIZE + message.size();
+                ++dropped;
+                continue;
+            }
+            if (kept != i) {
+                m_sendQueue[kept] = std::move(message);
+            }
+            ++kept;
+        }
+        m_sendQueue.resize(kept);
+        m_queuedBytes.store(queued, std::memory_order_relaxed);
+        m_droppedFrames.fetch_add(dropped, std::memory_order_relaxed);
+
+        if (queued <= m_sendLimits.maxQueuedBytes) {
+            return;
+        }
+    }
+
+    std::cerr << "Session " << m_id << " (" << m_remoteAddress << ") send queue over budget ("
+              << queued << " of " << m_sendLimits.maxQueuedBytes << " bytes), disconnecting" << std::endl;
+    closeSocket();
+}
+
+void GameSession::writeQueued() {
+    // Frame everything queued, in order, into the send buffer; the cipher
+    // reads each shared packet and writes straight into the buffer
+    size_t total = 0;
+    for (const auto& message : m_sendQueue) {
+        total += FRAME_HEADER_SIZE + message.size();
+    }
+    m_sendBuffer.resize(total);
+
+    uint8_t* out = m_sendBuffer.data();
+    for (const auto& message : m_sendQueue) {
+        uint32_t size = static_cast<uint32_t>(message.size());
+        out[0] = static_cast<uint8_t>(size & 0xFF);
+        out[1] = static_cast<uint8_t>((size >> 8) & 0xFF);
+        out[2] = static_cast<uint8_t>((size >> 16) & 0xFF);
+        out[3] = static_cast<uint8_t>((size >> 24) & 0xFF);
+        m_encryption.encrypt(message.data(), out + FRAME_HEADER_SIZE, size);
+        out += FRAME_HEADER_SIZE + size;
+    }
+    m_writingFrames = m_sendQueue.size();
+    m_sendQueue.clear();
+
+    m_writeInProgress = true;
+    auto self = shared_from_this();
+    asio::async_write(m_socket, asio::buffer(m_sendBuffer),
+        [this, self](const asio::error_code& error, size_t) {
+            m_writeInProgress = false;
+            m_queuedBytes.fetch_sub(m_sendBuffer.size(), std::memory_order_relaxed);
+            if (error) {
+                // The pending read fails too and reports CLOSED
+                if (error != asio::error::operation_aborted) {
+                    std::cerr << "Session " << m_id << " (" << m_remoteAddress << ") write failed: "
+                              << error.message() << std::endl;
+                }
+                m_sendQueue.clear();
+                m_queuedBytes.store(0, std::memory_order_relaxed);
+                closeSocket();
+                return;
+            }
+
+            m_sentFrames.fetch_add(m_writingFrames, std::memory_order_relaxed);
+            m_writingFrames = 0;
+            if (!m_sendQueue.empty()) {
+                writeQueued();
+            }
+        });
+}
+
+void GameSession::readHeader() {
+    auto self = shared_from_this();
+    asio::async_read(m_socket, asio::buffer(m_header),
+        [this, self](const asio::error_code& error, size_t) {
+            if (error) {
+                fail(error.message());
+                return;
+            }
+
+            uint32_t size = m_header[0] | (m_header[1] << 8) | (m_header[2] << 16) |
+                            (static_cast<uint32_t>(m_header[3]) << 24);
+            uint32_t limit = m_handshakeDone ? MAX_MESSAGE_SIZE : MAX_HANDSHAKE_SIZE;
+            if (size == 0 || size > limit) {
+                fail("invalid frame size " + std::to_string(size));
+                return;
+            }
+            readBody(size);
+        });
+}
+
+void GameSession::readBody(uint32_t size) {
+    m_body.resize(size);
+    auto self = shared_from_this();
+    asio::async_read(m_socket, asio::buffer(m_body),
+        [this, self](const asio::error_code& error, size_t) {
+            if (error) {
+                fail(error.message());
+                return;
+            }
+
+            m_decryption.decrypt(m_body);
+
+            SessionEvent event;
+            event.session = self;
+            if (!m_handshakeDone) {
+                if (m_body[0] != static_cast<uint8_t>(network::MessageType::CONNECT_REQUEST)) {
+                    fail("first frame is not a connect request");
+                    return;
+                }
+                m_handshakeDone = true;
+                m_handshakeTimer.cancel();
+                event.kind = SessionEvent::Kind::CONNECT;
+            }
+            event.payload = std::move(m_body);
+            m_body = {};
+            m_inbox.push(std::move(event));
+
+            readHeader();
+        });
+}
+
+void GameSession::closeSocket() {
+    // Aborts the pending read, which reports CLOSED, and any write
+    asio::error_code ignored;
+    m_handshakeTimer.cancel();
+    if (m_socket.is_open()) {
+        m_socket.shutdown(asio::ip::tcp::socket::shutdown_both, ignored);
+        m_socket.close(ignored);
+    }
+}
+
+void GameSession::fail(const std::string& reason) {
+    // The read chain ends here, so CLOSED is reported exactly once
+    if (m_socket.is_open()) {
+        std::cerr << "Session " << m_id << " (" << m_remoteAddress << ") closed: " << reason << std::endl;
+    }
+
+    closeSocket();
+
+    SessionEvent event;
+    event.kind = SessionEvent::Kind::CLOSED;
+    event.session = shared_from_this();
+    m_inbox.push(std::move(event));
+}
+
+} // namespace server
+} // namespace clonemine
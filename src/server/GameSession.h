@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../core/MpscQueue.h"
+#include "../network/PacketEncryption.h"
+#include "../network/SharedPacket.h"
+#include <asio.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clonemine {
+namespace server {
+
+class GameSession;
+
+// What a session hands the tick thread
+struct SessionEvent {
+    enum class Kind {
+        CONNECT,  // The first frame, a decrypted CONNECT_REQUEST
+        MESSAGE,  // A later frame, decrypted
+        CLOSED    // Read failed, peer left, handshake timed out or close() was called; always last
+    };
+
+    Kind kind{Kind::MESSAGE};
+    std::shared_ptr<GameSession> session;
+    std::vector<uint8_t> payload;
+};
+
+// Filled by the io_context threads, drained by the tick thread
+using SessionInbox = MpscQueue<SessionEvent>;
+
+// What a session does when its send queue outgrows its byte budget
+enum class SendOverflowPolicy {
+    DROP_STATE_UPDATES, // Drop the oldest unsent state snapshots, then disconnect if still over
+    DISCONNECT
+};
+
+struct SendQueueLimits {
+    size_t maxQueuedBytes{256 * 1024}; // Unsent plus in-flight, frame headers included
+    SendOverflowPolicy policy{SendOverflowPolicy::DROP_STATE_UPDATES};
+};
+
+// Send queue counters; all but queuedBytes are since the last takeSendStats()
+struct SendQueueStats {
+    size_t queuedBytes{0};
+    size_t peakQueuedBytes{0};
+    uint64_t sentFrames{0};
+    uint64_t droppedFrames{0};
+};
+
+// One client connection.
+//
+// Frames are a 4-byte little-endian length followed by the encrypted body,
+// read with async_read so no connection ever blocks an io_context thread.
+// All of a session's handlers run on its own strand, which lets a pool of
+// threads serve every session. The first frame must be a CONNECT_REQUEST
+// that arrives within HANDSHAKE_TIMEOUT.
+//
+// Sends are queued on the strand as shared plaintext packets and encrypted
+// only when they are written, so dropping an unsent state update never
+// desyncs the client's cipher. Everything queued while a write is in
+// flight goes out in the next one: each frame's header and its packet,
+// encrypted on the way, are written into one reused send buffer.
+// Broadcast packets are never copied per session otherwise.
+class GameSession : public std::enable_shared_from_this<GameSession> {
+public:
+    static constexpr uint32_t MAX_HANDSHAKE_SIZE = 1024;
+    static constexpr uint32_t MAX_MESSAGE_SIZE = 64 * 1024;
+    static constexpr std::chrono::seconds HANDSHAKE_TIMEOUT{5};
+
+    // The socket's executor should be a strand (see asio::make_strand)
+    GameSession(asio::ip::tcp::socket socket, uint64_t id, SessionInbox& inbox,
+                const SendQueueLimits& limits = {});
+
+    // Delete copy operations
+    GameSession(const GameSession&) = delete;
+    GameSession& operator=(const GameSession&) = delete;
+
+    // Arm the handshake timer and start reading frames
+    void start();
+
+    // Safe from any thread; the session then reports CLOSED. Unsent
+    // messages are dropped.
+    void close();
+
+    // Queue one tick's messages, unencrypted and unframed; safe from any
+    // thread. Overflowing the budget applies the session's policy.
+    void send(std::vector<network::SharedPacket> messages);
+
+    // Safe from any thread
+    SendQueueStats takeSendStats();
+
+    uint64_t getId() const { return m_id; }
+    const std::string& getRemoteAddress() const { return m_remoteAddress; }
+
+private:
+    void readHeader();
+    void readBody(uint32_t size);
+    void closeSocket();
+    void fail(const std::string& reason);
+    void enqueue(std::vector<network::SharedPacket>& messages);
+    void enforceSendBudget();
+    void writeQueued();
+
+    asio::ip::tcp::socket m_socket;
+    asio::steady_timer m_handshakeTimer;
+    network::PacketEncryption m_decryption; // Client-to-server stream
+    network::PacketEncryption m_encryption; // Server-to-client stream
+    SessionInbox& m_inbox;
+    SendQueueLimits m_sendLimits;
+    uint64_t m_id;
+    std::string m_remoteAddress;
+
+    std::array<uint8_t, 4> m_header{};
+    std::vector<uint8_t> m_body;
+    bool m_handshakeDone{false};
+
+    // Strand only
+    std::vector<network::SharedPacket> m_sendQueue; // Plaintext, oldest first
+    std::vector<uint8_t> m_sendBuffer;               // Framed and encrypted, being written
+    size_t m_writingFrames{0};
+    bool m_writeInProgress{false};
+
+    // Written on the strand, read by takeSendStats()
+    std::atomic<size_t> m_queuedBytes{0};
+    std::atomic<size_t> m_peakQueuedBytes{0};
+    std::atomic<uint64_t> m_sentFrames{0};
+    std::atomic<uint64_t> m_droppedFrames{0};
+};
+
+} // namespace server
+} // namespace clonemine
@@ -0,0 +1,52 @@
+#include "InterestGrid.h"
+#include <cmath>
+
+namespace clonemine {
+namespace server {
+
+namespace {
+    // Cell coordinates packed into one key (signed 32-bit each)
+    uint64_t packCell(int32_t cx, int32_t cz) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cz);
+    }
+}
+
+InterestGrid::InterestGrid(float cellSize) : m_cellSize(cellSize) {
+}
+
+void InterestGrid::clear() {
+    // Keep the buckets players are likely to be in again next tick
+    for (auto it = m_cells.begin(); it != m_cells.end();) {
+        if (it->second.empty()) {
+            it = m_cells.erase(it);
+        } else {
+            it->second.clear();
+            ++it;
+        }
+    }
+}
+
+void InterestGrid::insert(uint32_t id, const glm::vec3& position) {
+    auto cx = static_cast<int32_t>(std::floor(position.x / m_cellSize));
+    auto cz = static_cast<int32_t>(std::floor(position.z / m_cellSize));
+    m_cells[packCell(cx, cz)].push_back(id);
+}
+
+void InterestGrid::query(const glm::vec3& position, float radius, std::vector<uint32_t>& out) const {
+    auto minX = static_cast<int32_t>(std::floor((position.x - radius) / m_cellSize));
+    auto maxX = static_cast<int32_t>(std::floor((position.x + radius) / m_cellSize));
+    auto minZ = static_cast<int32_t>(std::floor((position.z - radius) / m_cellSize));
+    auto maxZ = static_cast<int32_t>(std::floor((position.z + radius) / m_cellSize));
+
+    for (int32_t cx = minX; cx <= maxX; ++cx) {
+        for (int32_t cz = minZ; cz <= maxZ; ++cz) {
+            auto it = m_cells.find(packCell(cx, cz));
+            if (it != m_cells.end()) {
+                out.insert(out.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+}
+
+} // namespace server
+} // namespace clonemine
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace clonemine {
+namespace server {
+
+// Uniform grid over the XZ plane for area-of-interest queries, rebuilt
+// every tick from scratch since players move all the time.
+class InterestGrid {
+public:
+    explicit InterestGrid(float cellSize = 64.0f);
+
+    // Empties every cell; cells that were already empty are released
+    void clear();
+
+    // ids are chosen by the caller, e.g. indices into its own list
+    void insert(uint32_t id, const glm::vec3& position);
+
+    // Appends the ids in every cell overlapping the square around position;
+    // callers test the actual distance
+    void query(const glm::vec3& position, float radius, std::vector<uint32_t>& out) const;
+
+    [[nodiscard]] size_t getCellCount() const noexcept { return m_cells.size(); }
+
+private:
+    float m_cellSize;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+};
+
+} // namespace server
+} // namespace clonemine
@@ -215,38 +215,16 @@ void LoginServer::handleLoginRequest(uint32_t sessionId, const std::vector<uint8
     
     auto& session = it->second;
     
-    // Parse login request (simplified - should use proper message format)
-    if (data.size() < 10) {
+    network::MessageView<network::LoginRequest> request;
+    if (!network::decodeView<network::LoginRequest>(data, request)) {
         std::cerr << "Invalid login request" << std::endl;
         session->connected = false;
         return;
     }
     
-    // Parse username
-    size_t offset = 1; // Skip message type
-    uint32_t usernameLen = data[offset] | (data[offset+1] << 8) |
-                          (data[offset+2] << 16) | (data[offset+3] << 24);
-    offset += 4;
-    
-    if (offset + usernameLen + 4 > data.size()) {
-        session->connected = false;
-        return;
-    }
-    
-    std::string username(data.begin() + offset, data.begin() + offset + usernameLen);
-    offset += usernameLen;
-    
-    // Parse password
-    uint32_t passwordLen = data[offset] | (data[offset+1] << 8) |
-                          (data[offset+2] << 16) | (data[offset+3] << 24);
-    offset += 4;
-    
-    if (offset + passwordLen > data.size()) {
-        session->connected = false;
-        return;
-    }
-    
-    std::string password(data.begin() + offset, data.begin() + offset + passwordLen);
+    auto& [usernameView, passwordView] = request;
+    std::string username(usernameView);
+    std::string password(passwordView);
     
     std::cout << "Login attempt: " << username << std::endl;
     
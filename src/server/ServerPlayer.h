@@ -1,9 +1,10 @@
 #pragma once
 
+#include "GameSession.h"
+#include "StateReplicator.h"
 #include "../world/Player.h"
-#include "../network/PacketEncryption.h"
 #include <memory>
-#include <asio.hpp>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace clonemine {
@@ -12,7 +13,7 @@ namespace server {
 // Server-side player session
 class ServerPlayer {
 public:
-    ServerPlayer(uint32_t id, std::shared_ptr<asio::ip::tcp::socket> socket);
+    ServerPlayer(uint32_t id, std::shared_ptr<GameSession> session);
     ~ServerPlayer() = default;
     
     // Delete copy operations
@@ -28,10 +29,16 @@ public:
     // Setters
     void setName(const std::string& name) { m_name = name; }
     
-    // Network operations
-    void sendData(const std::vector<uint8_t>& data);
+    // Network operations. sendData only queues; flushSends() hands the
+    // tick's messages to the session, which writes them in one go. A
+    // packet broadcast to several players is shared, not copied.
+    void sendData(const network::SharedPacket& packet);
+    void sendData(const std::vector<uint8_t>& data) { sendData(network::SharedPacket::create(data)); }
+    void flushSends();
     bool isConnected() const { return m_connected; }
     void disconnect();
+    GameSession& getSession() { return *m_session; }
+    SnapshotHistory& getSnapshotHistory() { return m_snapshots; }
     
     // Disconnect grace period (15 seconds)
     // Player remains in combat during grace period and can still die!
@@ -63,7 +70,9 @@ private:
     uint32_t m_id;
     std::string m_name;
     Player m_player;
-    std::shared_ptr<asio::ip::tcp::socket> m_socket;
+    std::shared_ptr<GameSession> m_session;
+    std::vector<network::SharedPacket> m_outbox; // This tick's messages
+    SnapshotHistory m_snapshots;                  // Other players' state as sent to this one
     bool m_connected{true};
     
     // Disconnect grace period (15 seconds)
@@ -75,9 +84,6 @@ private:
     bool m_isDead{false};
     bool m_isGhost{false};
     glm::vec3 m_corpseLocation{0.0f, 0.0f, 0.0f};
-    
-    // Encryption
-    std::unique_ptr<network::PacketEncryption> m_encryption;
 };
 
 } // namespace server
@@ -0,0 +1,135 @@
+#include "StateReplicator.h"
+#include <algorithm>
+#include <utility>
+
+namespace clonemine {
+namespace server {
+
+void SnapshotHistory::acknowledge(uint32_t sequence) {
+    if (sequence > m_ackedSequence && sequence <= m_lastSequence) {
+        m_ackedSequence = sequence;
+    }
+}
+
+bool SnapshotHistory::writeSnapshot(network::PlayerSnapshotView& view, uint32_t serverTime,
+                                    std::vector<uint8_t>& out) {
+    if (m_lastSequence != 0 && view == getLastSent()) {
+        return false;
+    }
+
+    uint32_t sequence = m_lastSequence + 1;
+    const network::PlayerSnapshotView* baseline = nullptr;
+    if (m_ackedSequence != 0 && sequence - m_ackedSequence < WINDOW) {
+        baseline = &m_sent[m_ackedSequence % WINDOW];
+    }
+    network::encodePlayerSnapshot(sequence, m_ackedSequence, serverTime, baseline, view, out);
+
+    // Keep the view; the caller gets the slot's old storage back to reuse
+    std::swap(m_sent[sequence % WINDOW], view);
+    m_lastSequence = sequence;
+    return true;
+}
+
+StateReplicator::StateReplicator() : m_grid(INTEREST_RADIUS / 2.0f) {
+}
+
+void StateReplicator::beginTick() {
+    ++m_tick;
+    m_entries.clear();
+}
+
+void StateReplicator::addPlayer(const network::QuantizedPlayerState& state, const glm::vec3& position,
+                                SnapshotHistory* history) {
+    m_entries.push_back({state, position, history});
+}
+
+uint32_t StateReplicator::getSendInterval(float distanceSquared) const {
+    for (const auto& tier : SEND_TIERS) {
+        if (distanceSquared <= tier.maxDistance * tier.maxDistance) {
+            return tier.interval;
+        }
+    }
+    return SEND_TIERS.back().interval;
+}
+
+void StateReplicator::replicate(uint32_t serverTime, const SendFunction& send) {
+    constexpr float radiusSquared = INTEREST_RADIUS * INTEREST_RADIUS;
+
+    // With entries in id order, sorting a query's indices sorts the view
+    std::sort(m_entries.begin(), m_entries.end(),
+              [](const Entry& a, const Entry& b) { return a.state.playerId < b.state.playerId; });
+    m_intervals.assign(m_entries.size(), 0);
+    m_grid.clear();
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        m_grid.insert(static_cast<uint32_t>(i), m_entries[i].position);
+    }
+
+    for (size_t r = 0; r < m_entries.size(); ++r) {
+        const Entry& recipient = m_entries[r];
+        if (!recipient.history) {
+            continue;
+        }
+        const network::PlayerSnapshotView& lastSent = recipient.history->getLastSent();
+
+        // Players in range, in id order
+        m_candidates.clear();
+        m_grid.query(recipient.position, INTEREST_RADIUS, m_candidates);
+        m_inRange.clear();
+        for (uint32_t index : m_candidates) {
+            if (index == r) {
+                continue;
+            }
+            // Horizontal distance, like the grid
+            const glm::vec3& position = m_entries[index].position;
+            float dx = position.x - recipient.position.x;
+            float dz = position.z - recipient.position.z;
+            float distanceSquared = dx * dx + dz * dz;
+            if (distanceSquared <= radiusSquared) {
+                m_inRange.push_back({index, getSendInterval(distanceSquared)});
+            }
+        }
+        if (m_inRange.size() * 8 >= m_entries.size()) {
+            // Crowded: one pass over a mark per player beats sorting
+            for (const InRange& candidate : m_inRange) {
+                m_intervals[candidate.index] = static_cast<uint8_t>(candidate.interval);
+            }
+            m_inRange.clear();
+            for (uint32_t i = 0; i < m_intervals.size(); ++i) {
+                if (m_intervals[i] != 0) {
+                    m_inRange.push_back({i, m_intervals[i]});
+                    m_intervals[i] = 0;
+                }
+            }
+        } else {
+            std::sort(m_inRange.begin(), m_inRange.end(),
+                      [](const InRange& a, const InRange& b) { return a.index < b.index; });
+        }
+
+        m_view.clear();
+        auto last = lastSent.begin();
+        for (const InRange& candidate : m_inRange) {
+            const network::QuantizedPlayerState& state = m_entries[candidate.index].state;
+
+            // Off-beat for its tier: repeat what this recipient last got.
+            // Staggered by id so distant players don't all refresh at once.
+            if (((m_tick + state.playerId) & (candidate.interval - 1)) != 0) {
+                while (last != lastSent.end() && last->playerId < state.playerId) {
+                    ++last;
+                }
+                if (last != lastSent.end() && last->playerId == state.playerId) {
+                    m_view.push_back(*last);
+                    continue;
+                }
+            }
+            m_view.push_back(state);
+        }
+
+        m_buffer.clear();
+        if (recipient.history->writeSnapshot(m_view, serverTime, m_buffer)) {
+            send(recipient.state.playerId, m_buffer);
+        }
+    }
+}
+
+} // namespace server
+} // namespace clonemine
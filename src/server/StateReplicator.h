@@ -0,0 +1,96 @@
+#pragma once
+
+#include "InterestGrid.h"
+#include "../network/PlayerSnapshot.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace clonemine {
+namespace server {
+
+// One recipient's sent snapshots and the newest one its client acknowledged
+class SnapshotHistory {
+public:
+    // Ignores acks for snapshots never sent or older than the current one
+    void acknowledge(uint32_t sequence);
+
+    // Appends a snapshot of view, delta-encoded against the acknowledged
+    // one when it is still in the window. Returns false, writing nothing,
+    // if view matches the last snapshot sent.
+    bool writeSnapshot(network::PlayerSnapshotView& view, uint32_t serverTime, std::vector<uint8_t>& out);
+
+    const network::PlayerSnapshotView& getLastSent() const { return m_sent[m_lastSequence % WINDOW]; }
+    uint32_t getLastSequence() const { return m_lastSequence; }
+    uint32_t getAckedSequence() const { return m_ackedSequence; }
+
+private:
+    static constexpr uint32_t WINDOW = network::PlayerSnapshotDecoder::WINDOW;
+
+    std::array<network::PlayerSnapshotView, WINDOW> m_sent;
+    uint32_t m_lastSequence{0};  // 0 = nothing sent
+    uint32_t m_ackedSequence{0}; // 0 = nothing acknowledged
+};
+
+// Builds every recipient's PLAYER_STATE_SNAPSHOT for one tick.
+//
+// Each recipient sees the players within INTEREST_RADIUS, found through an
+// InterestGrid. Nearby players are refreshed every tick and distant ones
+// less often (the rest of the time the recipient's last sent state is
+// repeated, which the delta then leaves out). Every player is quantised
+// once per tick; only the delta against each recipient's acknowledged
+// snapshot is encoded per recipient.
+class StateReplicator {
+public:
+    static constexpr float INTEREST_RADIUS = 128.0f;
+
+    // Refresh interval in ticks (a power of two, under 256) by distance
+    struct SendTier {
+        float maxDistance;
+        uint32_t interval;
+    };
+    static constexpr std::array<SendTier, 3> SEND_TIERS{{{32.0f, 1}, {64.0f, 2}, {INTEREST_RADIUS, 4}}};
+
+    using SendFunction = std::function<void(uint32_t playerId, const std::vector<uint8_t>& data)>;
+
+    StateReplicator();
+
+    // Start a tick; then add every player in it, in any order
+    void beginTick();
+
+    // history is the recipient's, or nullptr for a player only others see
+    void addPlayer(const network::QuantizedPlayerState& state, const glm::vec3& position, SnapshotHistory* history);
+
+    // Calls send for every recipient whose view changed
+    void replicate(uint32_t serverTime, const SendFunction& send);
+
+private:
+    struct Entry {
+        network::QuantizedPlayerState state;
+        glm::vec3 position;
+        SnapshotHistory* history;
+    };
+
+    struct InRange {
+        uint32_t index;
+        uint32_t interval;
+    };
+
+    uint32_t getSendInterval(float distanceSquared) const;
+
+    InterestGrid m_grid;
+    std::vector<Entry> m_entries;
+    uint64_t m_tick{0};
+
+    // Per-recipient scratch
+    std::vector<uint32_t> m_candidates;
+    std::vector<InRange> m_inRange;
+    std::vector<uint8_t> m_intervals; // By entry, 0 = out of range
+    network::PlayerSnapshotView m_view;
+    std::vector<uint8_t> m_buffer;
+};
+
+} // namespace server
+} // namespace clonemine
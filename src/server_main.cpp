@@ -48,6 +48,13 @@ int main(int argc, char* argv[]) {
                   << ":" << config.questServerPort << "\n" << std::endl;
         
         g_server = std::make_unique<clonemine::server::GameServer>(port);
+        
+        clonemine::server::SendQueueLimits sendLimits;
+        sendLimits.maxQueuedBytes = static_cast<size_t>(config.gameSendBudgetKB) * 1024;
+        sendLimits.policy = config.gameSendOverflowPolicy == "disconnect"
+            ? clonemine::server::SendOverflowPolicy::DISCONNECT
+            : clonemine::server::SendOverflowPolicy::DROP_STATE_UPDATES;
+        g_server->setSendQueueLimits(sendLimits);
         g_server->start();
         g_server->run();
         
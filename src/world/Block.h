@@ -25,6 +25,8 @@ struct Block {
     [[nodiscard]] bool isTransparent() const noexcept {
         return type == BlockType::Air || type == BlockType::Water || type == BlockType::Leaves;
     }
+
+    bool operator==(const Block&) const = default;
 };
 
 } // namespace clonemine
@@ -1,49 +1,105 @@
 #include "world/Chunk.h"
-#include <cmath>
+#include <algorithm>
+#include <vector>
 
 namespace clonemine {
 
-Chunk::Chunk(int x, int z)
+namespace {
+    // TerrainGenerator block codes -> Block (types this enum lacks fall
+    // back to the closest look-alike)
+    constexpr std::array<Block, 256> makeTerrainBlockTable() {
+        std::array<Block, 256> table{};
+        for (auto& block : table) {
+            block = Block{BlockType::Stone};
+        }
+        table[TerrainBlock::AIR] = Block{BlockType::Air};
+        table[TerrainBlock::GRASS] = Block{BlockType::Grass};
+        table[TerrainBlock::DIRT] = Block{BlockType::Dirt};
+        table[TerrainBlock::SAND] = Block{BlockType::Sand};
+        table[TerrainBlock::WATER] = Block{BlockType::Water};
+        return table;
+    }
+
+    constexpr std::array<Block, 256> TERRAIN_BLOCK_TABLE = makeTerrainBlockTable();
+}
+
+Chunk::Chunk(int x, int z, const TerrainGenerator& terrain)
     : m_x(x)
     , m_z(z)
-    , m_blocks(std::make_unique<std::array<Block, SIZE * HEIGHT * SIZE>>())
 {
-    generate();
+    generate(terrain);
 }
 
 void Chunk::setBlock(int x, int y, int z, BlockType type) {
     if (x >= 0 && x < SIZE && y >= 0 && y < HEIGHT && z >= 0 && z < SIZE) {
-        (*m_blocks)[getIndex(x, y, z)].type = type;
+        auto& section = m_sections[y / SECTION_HEIGHT];
+        if (!section) {
+            if (type == BlockType::Air) {
+                return;
+            }
+            section = std::make_unique<Section>();
+        }
+        section->set(getSectionIndex(x, y, z), Block{type});
     }
 }
 
 Block Chunk::getBlock(int x, int y, int z) const {
     if (x >= 0 && x < SIZE && y >= 0 && y < HEIGHT && z >= 0 && z < SIZE) {
-        return (*m_blocks)[getIndex(x, y, z)];
+        const auto& section = m_sections[y / SECTION_HEIGHT];
+        if (section) {
+            return section->get(getSectionIndex(x, y, z));
+        }
     }
     return Block{BlockType::Air};
 }
 
-void Chunk::generate() {
-    // Simple terrain generation
-    for (int x = 0; x < SIZE; ++x) {
-        for (int z = 0; z < SIZE; ++z) {
-            // Simple height map using sine wave
-            int worldX = m_x * SIZE + x;
-            int worldZ = m_z * SIZE + z;
-            int height = 64 + static_cast<int>(8 * std::sin(worldX * 0.1) + 8 * std::cos(worldZ * 0.1));
-            
-            for (int y = 0; y < HEIGHT; ++y) {
-                if (y < height - 4) {
-                    setBlock(x, y, z, BlockType::Stone);
-                } else if (y < height - 1) {
-                    setBlock(x, y, z, BlockType::Dirt);
-                } else if (y < height) {
-                    setBlock(x, y, z, BlockType::Grass);
-                } else {
-                    setBlock(x, y, z, BlockType::Air);
-                }
-            }
+uint16_t Chunk::getSectionMask() const noexcept {
+    uint16_t mask = 0;
+    for (int i = 0; i < SECTION_COUNT; ++i) {
+        if (m_sections[i]) {
+            mask |= static_cast<uint16_t>(1u << i);
+        }
+    }
+    return mask;
+}
+
+size_t Chunk::getMemoryUsage() const noexcept {
+    size_t bytes = sizeof(m_sections);
+    for (const auto& section : m_sections) {
+        if (section) {
+            bytes += section->getMemoryUsage();
+        }
+    }
+    return bytes;
+}
+
+void Chunk::generate(const TerrainGenerator& terrain) {
+    // Height and biome once per column, then each column written as runs
+    TerrainColumns columns;
+    terrain.generateColumns(m_x, m_z, columns);
+
+    std::vector<uint8_t> codes(static_cast<size_t>(SIZE) * SIZE * HEIGHT);
+    int top = 0;
+    for (int z = 0; z < SIZE; ++z) {
+        for (int x = 0; x < SIZE; ++x) {
+            top = std::max(top, terrain.fillColumn(columns, x, z, codes.data() + (z * SIZE + x) * HEIGHT));
+        }
+    }
+
+    // One bulk load per section; sections above the surface stay unallocated
+    std::vector<Block> blocks(SECTION_VOLUME);
+    for (int s = 0; s < SECTION_COUNT; ++s) {
+        auto& section = m_sections[s];
+        section.reset();
+        if (s * SECTION_HEIGHT >= top) {
+            continue;
+        }
+
+        gatherTerrainSection(codes.data(), s * SECTION_HEIGHT, SECTION_HEIGHT, TERRAIN_BLOCK_TABLE, blocks.data());
+        section = std::make_unique<Section>();
+        section->assign(blocks.data());
+        if (section->isUniform() && section->getUniformValue().type == BlockType::Air) {
+            section.reset();
         }
     }
 }
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "world/Block.h"
+#include "world/PalettedStorage.h"
+#include "world/TerrainGenerator.h"
 #include <array>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
 namespace clonemine {
@@ -10,8 +14,14 @@ class Chunk {
 public:
     static constexpr int SIZE = 16;
     static constexpr int HEIGHT = 256;
+    static constexpr int SECTION_HEIGHT = 16;
+    static constexpr int SECTION_COUNT = HEIGHT / SECTION_HEIGHT;
+    static constexpr int SECTION_VOLUME = SIZE * SECTION_HEIGHT * SIZE;
 
-    Chunk(int x, int z);
+    // 16x16x16 slice of a chunk; missing sections are all air
+    using Section = PalettedStorage<Block, SECTION_VOLUME>;
+
+    Chunk(int x, int z, const TerrainGenerator& terrain);
     ~Chunk() = default;
 
     // Delete copy operations
@@ -27,17 +37,25 @@ public:
     
     [[nodiscard]] int getX() const noexcept { return m_x; }
     [[nodiscard]] int getZ() const noexcept { return m_z; }
+
+    // Sections are allocated on first non-air write and released when
+    // they compact back to all air
+    [[nodiscard]] bool isSectionEmpty(int sectionY) const noexcept { return !m_sections[sectionY]; }
+    [[nodiscard]] uint16_t getSectionMask() const noexcept;
+
+    // Bytes held by the block storage (palette + packed indices)
+    [[nodiscard]] size_t getMemoryUsage() const noexcept;
     
-    void generate();
+    void generate(const TerrainGenerator& terrain);
 
 private:
-    [[nodiscard]] size_t getIndex(int x, int y, int z) const noexcept {
-        return static_cast<size_t>(x + y * SIZE + z * SIZE * HEIGHT);
+    [[nodiscard]] size_t getSectionIndex(int x, int y, int z) const noexcept {
+        return static_cast<size_t>(x + z * SIZE + (y % SECTION_HEIGHT) * SIZE * SIZE);
     }
 
     int m_x;
     int m_z;
-    std::unique_ptr<std::array<Block, SIZE * HEIGHT * SIZE>> m_blocks;
+    std::array<std::unique_ptr<Section>, SECTION_COUNT> m_sections;
 };
 
 } // namespace clonemine
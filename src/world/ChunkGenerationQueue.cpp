@@ -0,0 +1,176 @@
+#include "ChunkGenerationQueue.h"
+#include <algorithm>
+#include <limits>
+
+namespace clonemine {
+
+void ChunkGenerationQueue::push(const glm::ivec3& chunkPos) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_shutdown || m_pending.count(chunkPos)) {
+            return;
+        }
+
+        uint64_t sequence = m_nextSequence++;
+        m_pending[chunkPos] = Pending{Clock::now(), sequence};
+        m_heap.push_back(Entry{chunkPos, priorityFor(chunkPos), sequence, m_focusEpoch});
+        std::push_heap(m_heap.begin(), m_heap.end(), EntryCompare{});
+    }
+
+    m_enqueued++;
+    m_condition.notify_one();
+}
+
+bool ChunkGenerationQueue::cancel(const glm::ivec3& chunkPos) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // The heap entry is dropped lazily when it reaches the top, or by a
+    // rebuild once dead entries outnumber live ones
+    if (m_pending.erase(chunkPos) == 0) {
+        return false;
+    }
+    if (m_heap.size() > 2 * m_pending.size() + 64) {
+        rebuildHeap();
+    }
+
+    m_cancelled++;
+    return true;
+}
+
+std::optional<ChunkGenerationQueue::Job> ChunkGenerationQueue::pop() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        m_condition.wait(lock, [this]() { return m_shutdown || !m_heap.empty(); });
+        if (m_shutdown) {
+            return std::nullopt;
+        }
+
+        std::pop_heap(m_heap.begin(), m_heap.end(), EntryCompare{});
+        Entry entry = m_heap.back();
+        m_heap.pop_back();
+
+        // Skip cancelled entries and stale duplicates left by a re-queue
+        auto it = m_pending.find(entry.chunkPos);
+        if (it == m_pending.end() || it->second.sequence != entry.sequence) {
+            continue;
+        }
+        
+        // Scored before a focus point moved: put it back if it fell behind
+        if (entry.focusEpoch != m_focusEpoch) {
+            int priority = priorityFor(entry.chunkPos);
+            entry.focusEpoch = m_focusEpoch;
+            if (priority > entry.priority) {
+                entry.priority = priority;
+                m_heap.push_back(entry);
+                std::push_heap(m_heap.begin(), m_heap.end(), EntryCompare{});
+                continue;
+            }
+        }
+
+        Job job{entry.chunkPos, it->second.enqueueTime};
+        m_pending.erase(it);
+        return job;
+    }
+}
+
+void ChunkGenerationQueue::setFocusPoint(uint32_t id, const glm::ivec3& chunkPos) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_focusEpoch++;
+
+    auto [it, inserted] = m_focusPoints.try_emplace(id, FocusPoint{chunkPos, chunkPos});
+    if (inserted) {
+        return;
+    }
+    it->second.chunkPos = chunkPos;
+
+    // Re-scoring at pop only catches entries that got further away; ones a
+    // viewer moved towards wait for a rebuild, so bound how far it can drift
+    glm::ivec3 drift = glm::abs(chunkPos - it->second.anchor);
+    if (std::max(drift.x, drift.z) >= RESCORE_DISTANCE) {
+        rebuildHeap();
+    }
+}
+
+void ChunkGenerationQueue::removeFocusPoint(uint32_t id) {
+    // Priorities only get worse, which re-scoring at pop handles
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_focusPoints.erase(id)) {
+        m_focusEpoch++;
+    }
+}
+
+void ChunkGenerationQueue::rebuildHeap() {
+    for (auto& [id, focus] : m_focusPoints) {
+        focus.anchor = focus.chunkPos;
+    }
+
+    // Live entries only, which also discards cancelled ones
+    m_heap.clear();
+    m_heap.reserve(m_pending.size());
+    for (const auto& [pos, pending] : m_pending) {
+        m_heap.push_back(Entry{pos, priorityFor(pos), pending.sequence, m_focusEpoch});
+    }
+    std::make_heap(m_heap.begin(), m_heap.end(), EntryCompare{});
+}
+
+void ChunkGenerationQueue::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_condition.notify_all();
+}
+
+void ChunkGenerationQueue::recordCompletion(const Job& job, Clock::time_point startTime, Clock::time_point endTime) {
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    uint64_t waitUs = static_cast<uint64_t>(duration_cast<microseconds>(startTime - job.enqueueTime).count());
+    uint64_t genUs = static_cast<uint64_t>(duration_cast<microseconds>(endTime - startTime).count());
+
+    m_generated++;
+    m_totalWaitUs += waitUs;
+    m_totalGenerationUs += genUs;
+
+    uint64_t previousMax = m_maxGenerationUs.load();
+    while (genUs > previousMax && !m_maxGenerationUs.compare_exchange_weak(previousMax, genUs)) {
+    }
+}
+
+size_t ChunkGenerationQueue::size() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_pending.size();
+}
+
+ChunkGenerationStats ChunkGenerationQueue::getStats() const {
+    ChunkGenerationStats stats;
+    stats.queueDepth = size();
+    stats.enqueuedCount = m_enqueued.load();
+    stats.generatedCount = m_generated.load();
+    stats.cancelledCount = m_cancelled.load();
+    stats.maxGenerationMs = m_maxGenerationUs.load() / 1000.0;
+
+    if (stats.generatedCount > 0) {
+        stats.averageQueueWaitMs = m_totalWaitUs.load() / 1000.0 / stats.generatedCount;
+        stats.averageGenerationMs = m_totalGenerationUs.load() / 1000.0 / stats.generatedCount;
+    }
+
+    return stats;
+}
+
+int ChunkGenerationQueue::priorityFor(const glm::ivec3& chunkPos) const {
+    if (m_focusPoints.empty()) {
+        return 0;
+    }
+
+    int best = std::numeric_limits<int>::max();
+    for (const auto& [id, focus] : m_focusPoints) {
+        int dx = chunkPos.x - focus.chunkPos.x;
+        int dz = chunkPos.z - focus.chunkPos.z;
+        best = std::min(best, dx * dx + dz * dz);
+    }
+    return best;
+}
+
+} // namespace clonemine
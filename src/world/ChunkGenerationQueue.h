@@ -0,0 +1,126 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace clonemine {
+
+// Snapshot of generation queue counters
+struct ChunkGenerationStats {
+    size_t queueDepth = 0;
+    uint64_t enqueuedCount = 0;
+    uint64_t generatedCount = 0;
+    uint64_t cancelledCount = 0;
+    double averageQueueWaitMs = 0.0;
+    double averageGenerationMs = 0.0;
+    double maxGenerationMs = 0.0;
+};
+
+// Blocking priority queue of chunks waiting for generation.
+// Chunks closest to any focus point (player chunk) are served first.
+// Workers block in pop() until work arrives or the queue is shut down.
+//
+// Moving a focus point does not touch the heap. Entries scored before the
+// move are re-scored when they reach the top; the heap is only rebuilt once
+// a focus point drifts RESCORE_DISTANCE chunks from where it was at the
+// last rebuild, or cancelled entries outnumber live ones.
+class ChunkGenerationQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Job {
+        glm::ivec3 chunkPos;
+        Clock::time_point enqueueTime;
+    };
+
+    ChunkGenerationQueue() = default;
+    ~ChunkGenerationQueue() = default;
+
+    ChunkGenerationQueue(const ChunkGenerationQueue&) = delete;
+    ChunkGenerationQueue& operator=(const ChunkGenerationQueue&) = delete;
+
+    // Queue a chunk (no-op if already queued)
+    void push(const glm::ivec3& chunkPos);
+
+    // Drop a queued chunk, e.g. because it was unloaded before generation
+    bool cancel(const glm::ivec3& chunkPos);
+
+    // Block until a job is available; returns nullopt after shutdown()
+    std::optional<Job> pop();
+
+    // Add or move one viewer's focus point, or drop it
+    void setFocusPoint(uint32_t id, const glm::ivec3& chunkPos);
+    void removeFocusPoint(uint32_t id);
+
+    // Wake all workers and make pop() return nullopt
+    void shutdown();
+
+    // Record timings for a finished job
+    void recordCompletion(const Job& job, Clock::time_point startTime, Clock::time_point endTime);
+
+    size_t size() const;
+    ChunkGenerationStats getStats() const;
+
+    // Chunks a focus point may drift before pending work is re-sorted
+    static constexpr int RESCORE_DISTANCE = 4;
+
+private:
+    struct Entry {
+        glm::ivec3 chunkPos;
+        int priority;        // Squared chunk distance to nearest focus point
+        uint64_t sequence;   // FIFO among equal priorities
+        uint64_t focusEpoch; // Focus points the priority was computed for
+    };
+
+    struct EntryCompare {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.priority != b.priority) return a.priority > b.priority;
+            return a.sequence > b.sequence;
+        }
+    };
+
+    struct Pending {
+        Clock::time_point enqueueTime;
+        uint64_t sequence;
+    };
+
+    struct FocusPoint {
+        glm::ivec3 chunkPos;
+        glm::ivec3 anchor; // Position at the last rebuild
+    };
+
+    struct PosHash {
+        std::size_t operator()(const glm::ivec3& pos) const {
+            return std::hash<int>()(pos.x) ^ (std::hash<int>()(pos.y) << 1) ^ (std::hash<int>()(pos.z) << 2);
+        }
+    };
+
+    int priorityFor(const glm::ivec3& chunkPos) const;
+    void rebuildHeap();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::vector<Entry> m_heap;
+    std::unordered_map<glm::ivec3, Pending, PosHash> m_pending;
+    std::unordered_map<uint32_t, FocusPoint> m_focusPoints;
+    uint64_t m_focusEpoch = 0;
+    uint64_t m_nextSequence = 0;
+    bool m_shutdown = false;
+
+    // Counters
+    std::atomic<uint64_t> m_enqueued{0};
+    std::atomic<uint64_t> m_generated{0};
+    std::atomic<uint64_t> m_cancelled{0};
+    std::atomic<uint64_t> m_totalWaitUs{0};
+    std::atomic<uint64_t> m_totalGenerationUs{0};
+    std::atomic<uint64_t> m_maxGenerationUs{0};
+};
+
+} // namespace clonemine
@@ -1,45 +1,279 @@
 #include "ChunkManager.h"
+#include "ChunkSaver.h"
 #include <cmath>
 #include <algorithm>
+#include <cstring>
 #include <fstream>
+#include <iostream>
 
 namespace clonemine {
 
+namespace {
+    // Air below this height is filled with water
+    constexpr int WATER_LEVEL = 60;
+    
+    // TerrainGenerator block codes -> Block
+    constexpr std::array<Block, 256> makeTerrainBlockTable() {
+        std::array<Block, 256> table{};
+        table[TerrainBlock::STONE] = Block{BlockType::STONE, 0};
+        table[TerrainBlock::GRASS] = Block{BlockType::GRASS, 0};
+        table[TerrainBlock::DIRT] = Block{BlockType::DIRT, 0};
+        table[TerrainBlock::BEDROCK] = Block{BlockType::BEDROCK, 0};
+        table[TerrainBlock::OBSIDIAN] = Block{BlockType::OBSIDIAN, 0};
+        table[TerrainBlock::SAND] = Block{BlockType::SAND, 0};
+        table[TerrainBlock::IRON_ORE] = Block{BlockType::IRON_ORE, 0};
+        table[TerrainBlock::DIAMOND_ORE] = Block{BlockType::DIAMOND_ORE, 0};
+        table[TerrainBlock::GOLD_ORE] = Block{BlockType::GOLD_ORE, 0};
+        table[TerrainBlock::SNOW] = Block{BlockType::SNOW, 0};
+        table[TerrainBlock::WATER] = Block{BlockType::WATER, 0};
+        return table;
+    }
+    
+    constexpr std::array<Block, 256> TERRAIN_BLOCK_TABLE = makeTerrainBlockTable();
+    
+    // The renderer maps EditedChunk block ids by value
+    static_assert(static_cast<int>(BlockType::SNOW) + 1 == WORLD_BLOCK_ID_COUNT, "Update WORLD_BLOCK_ID_COUNT");
+}
+
 // Chunk implementation
 Chunk::Chunk(const glm::ivec3& position)
     : m_position(position)
-    , m_blocks(BLOCKS_PER_CHUNK)
 {
-    // Initialize all blocks to air
-    for (auto& block : m_blocks) {
-        block.type = BlockType::AIR;
-        block.light = 0;
+    // All sections start unallocated (air)
+}
+
+Block Chunk::getBlock(int x, int y, int z) const {
+    const auto& section = m_sections[y / SECTION_SIZE_Y];
+    if (!section) {
+        return Block{};
     }
+    return section->get(getSectionIndex(x, y, z));
 }
 
-Block& Chunk::getBlock(int x, int y, int z) {
-    return m_blocks[getIndex(x, y, z)];
+void Chunk::setBlock(int x, int y, int z, BlockType type) {
+    Block block = getBlock(x, y, z);
+    block.type = type;
+    setBlock(x, y, z, block);
 }
 
-const Block& Chunk::getBlock(int x, int y, int z) const {
-    return m_blocks[getIndex(x, y, z)];
+void Chunk::setBlock(int x, int y, int z, const Block& block) {
+    int sectionY = y / SECTION_SIZE_Y;
+    auto& section = m_sections[sectionY];
+    if (!section) {
+        if (block == Block{}) {
+            return;
+        }
+        section = std::make_shared<ChunkSection>();
+    } else {
+        detach(sectionY);
+    }
+    section->set(getSectionIndex(x, y, z), block);
+    m_dirty = true;
 }
 
-void Chunk::setBlock(int x, int y, int z, BlockType type) {
-    m_blocks[getIndex(x, y, z)].type = type;
+uint16_t Chunk::getSectionMask() const {
+    uint16_t mask = 0;
+    for (int i = 0; i < SECTIONS_PER_CHUNK; ++i) {
+        if (m_sections[i]) {
+            mask |= static_cast<uint16_t>(1u << i);
+        }
+    }
+    return mask;
+}
+
+void Chunk::copyBlocks(std::vector<Block>& out) const {
+    // Flat index (x + z*16 + y*256) is the concatenation of all sections
+    out.assign(BLOCKS_PER_CHUNK, Block{});
+    for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+        const auto& section = m_sections[s];
+        if (!section) {
+            continue;
+        }
+        Block* dst = out.data() + s * BLOCKS_PER_SECTION;
+        for (int i = 0; i < BLOCKS_PER_SECTION; ++i) {
+            dst[i] = section->get(i);
+        }
+    }
+}
+
+void Chunk::loadBlocks(const std::vector<Block>& blocks) {
+    std::vector<Block> sectionBlocks;
+    for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+        size_t begin = static_cast<size_t>(s) * BLOCKS_PER_SECTION;
+        size_t end = std::min(blocks.size(), begin + BLOCKS_PER_SECTION);
+        sectionBlocks.assign(BLOCKS_PER_SECTION, Block{});
+        if (begin < end) {
+            std::copy(blocks.begin() + begin, blocks.begin() + end, sectionBlocks.begin());
+        }
+        loadSectionBlocks(s, sectionBlocks);
+    }
+}
+
+void Chunk::copySectionBlocks(int sectionY, std::vector<Block>& out) const {
+    out.assign(BLOCKS_PER_SECTION, Block{});
+    const auto& section = m_sections[sectionY];
+    if (!section) {
+        return;
+    }
+    for (int i = 0; i < BLOCKS_PER_SECTION; ++i) {
+        out[i] = section->get(i);
+    }
+}
+
+void Chunk::loadSectionBlocks(int sectionY, const std::vector<Block>& blocks) {
+    if (blocks.empty()) {
+        m_sections[sectionY].reset();
+        m_snapshotMask &= static_cast<uint16_t>(~(1u << sectionY));
+        m_dirty = true;
+        return;
+    }
+    
+    auto section = std::make_shared<ChunkSection>();
+    if (blocks.size() >= static_cast<size_t>(BLOCKS_PER_SECTION)) {
+        section->assign(blocks.data());
+    } else {
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            section->set(i, blocks[i]);
+        }
+        section->compact();
+    }
+    
+    if (section->isUniform() && section->getUniformValue() == Block{}) {
+        m_sections[sectionY].reset();
+    } else {
+        m_sections[sectionY] = std::move(section);
+    }
+    m_snapshotMask &= static_cast<uint16_t>(~(1u << sectionY));
     m_dirty = true;
 }
 
+ChunkSnapshot Chunk::snapshot() const {
+    m_snapshotMask = getSectionMask();
+    return captureSections();
+}
+
+void Chunk::restore(const ChunkSnapshot& snapshot) {
+    // Writes copy a section before changing it, so sharing is safe
+    for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+        m_sections[s] = std::const_pointer_cast<ChunkSection>(snapshot.sections[s]);
+    }
+    m_snapshotMask = getSectionMask();
+}
+
+ChunkSnapshot Chunk::captureSections() const {
+    ChunkSnapshot snapshot;
+    snapshot.position = m_position;
+    for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+        snapshot.sections[s] = m_sections[s];
+    }
+    return snapshot;
+}
+
+void Chunk::serialize(std::vector<uint8_t>& out) const {
+    // The sections are released before this returns, so none are marked
+    captureSections().serialize(out);
+}
+
+void ChunkSnapshot::serialize(std::vector<uint8_t>& out) const {
+    uint16_t mask = 0;
+    size_t count = 0;
+    for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+        if (sections[s]) {
+            mask |= static_cast<uint16_t>(1u << s);
+            count++;
+        }
+    }
+    
+    out.resize(sizeof(mask) + count * BLOCKS_PER_SECTION * sizeof(Block));
+    std::memcpy(out.data(), &mask, sizeof(mask));
+    
+    Block* dst = reinterpret_cast<Block*>(out.data() + sizeof(mask));
+    for (const auto& section : sections) {
+        if (!section) continue;
+        for (int i = 0; i < BLOCKS_PER_SECTION; ++i) {
+            *dst++ = section->get(i);
+        }
+    }
+}
+
+bool Chunk::deserialize(const std::vector<uint8_t>& data) {
+    if (data.size() == BLOCKS_PER_CHUNK * sizeof(Block)) {
+        // Legacy format: all 256 levels written flat
+        std::vector<Block> blocks(BLOCKS_PER_CHUNK);
+        std::memcpy(blocks.data(), data.data(), data.size());
+        loadBlocks(blocks);
+        return true;
+    }
+    
+    uint16_t mask = 0;
+    if (data.size() < sizeof(mask)) return false;
+    std::memcpy(&mask, data.data(), sizeof(mask));
+    
+    const uint8_t* src = data.data() + sizeof(mask);
+    const uint8_t* end = data.data() + data.size();
+    std::vector<Block> blocks(BLOCKS_PER_SECTION);
+    for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+        if (mask & (1u << s)) {
+            size_t bytes = BLOCKS_PER_SECTION * sizeof(Block);
+            if (static_cast<size_t>(end - src) < bytes) return false;
+            std::memcpy(blocks.data(), src, bytes);
+            src += bytes;
+            loadSectionBlocks(s, blocks);
+        } else {
+            loadSectionBlocks(s, {});
+        }
+    }
+    return true;
+}
+
+void Chunk::compact() {
+    for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+        auto& section = m_sections[s];
+        if (!section) {
+            continue;
+        }
+        detach(s);
+        section->compact();
+        if (section->isUniform() && section->getUniformValue() == Block{}) {
+            section.reset();
+        }
+    }
+}
+
+size_t Chunk::getMemoryUsage() const {
+    size_t bytes = sizeof(m_sections);
+    for (const auto& section : m_sections) {
+        if (section) {
+            bytes += section->getMemoryUsage();
+        }
+    }
+    return bytes;
+}
+
 // ChunkManager implementation
-ChunkManager::ChunkManager() {
-    // Start 4 worker threads for chunk generation
-    for (int i = 0; i < 4; ++i) {
+ChunkManager::ChunkManager(unsigned workerCount, uint32_t seed)
+    : m_terrain(seed)
+{
+    if (workerCount == 0) {
+        // Leave one core for the main/tick thread
+        unsigned hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+    }
+    
+    for (unsigned i = 0; i < workerCount; ++i) {
         m_generationThreads.emplace_back(&ChunkManager::generationWorker, this);
     }
 }
 
 ChunkManager::~ChunkManager() {
-    m_running = false;
+    // Persist outstanding edits before anything is torn down
+    if (m_saver) {
+        snapshotDirtyChunks();
+        std::unique_lock<std::shared_mutex> lock(m_saverMutex);
+        m_saver.reset();
+    }
+    
+    m_generationQueue.shutdown();
     for (auto& thread : m_generationThreads) {
         if (thread.joinable()) {
             thread.join();
@@ -48,58 +282,165 @@ ChunkManager::~ChunkManager() {
 }
 
 void ChunkManager::update(const glm::vec3& playerPos, float deltaTime) {
-    // Load chunks around player
-    loadChunksAroundPlayer(playerPos);
+    // Single-player convenience: the local player is the only viewer
+    updateViewer(LOCAL_VIEWER, playerPos);
+    update(deltaTime);
+}
+
+void ChunkManager::update(float deltaTime) {
+    applyPendingEdits();
+    processUnloads();
     
-    // Unload distant chunks
-    unloadDistantChunks(playerPos);
+    // Hand modified chunks to the background saver
+    m_saveTimer += deltaTime;
+    if (m_saver && m_saveTimer >= m_saveInterval) {
+        m_saveTimer = 0.0f;
+        snapshotDirtyChunks();
+        m_saver->requestFlush();
+    }
+    
+    // Periodically reclaim space left behind by rewritten chunks, on the
+    // saver thread
+    m_compactionTimer += deltaTime;
+    if (m_saver && m_compactionTimer >= COMPACTION_INTERVAL) {
+        m_compactionTimer = 0.0f;
+        m_saver->requestCompaction();
+    }
 }
 
-Chunk* ChunkManager::getChunk(const glm::ivec3& chunkPos) {
-    std::lock_guard<std::mutex> lock(m_chunkMutex);
-    auto it = m_chunks.find(chunkPos);
-    if (it != m_chunks.end()) {
-        return it->second.get();
+void ChunkManager::updateViewer(uint32_t viewerId, const glm::vec3& position) {
+    glm::ivec3 newChunk = worldToChunk(glm::ivec3(position));
+    newChunk.y = 0;
+    
+    auto it = m_viewers.find(viewerId);
+    if (it != m_viewers.end() && it->second == newChunk) {
+        return; // Same chunk as last time: nothing to do
+    }
+    
+    // Move the focus first so chunks queued below are scored around it
+    m_generationQueue.setFocusPoint(viewerId, newChunk);
+    if (it == m_viewers.end()) {
+        applyViewerMove(nullptr, &newChunk);
+        m_viewers.emplace(viewerId, newChunk);
+    } else {
+        glm::ivec3 oldChunk = it->second;
+        it->second = newChunk;
+        applyViewerMove(&oldChunk, &newChunk);
     }
-    return nullptr;
 }
 
-Chunk* ChunkManager::getOrCreateChunk(const glm::ivec3& chunkPos) {
-    std::lock_guard<std::mutex> lock(m_chunkMutex);
-    auto it = m_chunks.find(chunkPos);
-    if (it != m_chunks.end()) {
-        return it->second.get();
+void ChunkManager::removeViewer(uint32_t viewerId) {
+    auto it = m_viewers.find(viewerId);
+    if (it == m_viewers.end()) {
+        return;
     }
     
-    // Create new chunk
-    auto chunk = std::make_unique<Chunk>(chunkPos);
-    Chunk* chunkPtr = chunk.get();
-    m_chunks[chunkPos] = std::move(chunk);
+    glm::ivec3 oldChunk = it->second;
+    m_viewers.erase(it);
+    m_generationQueue.removeFocusPoint(viewerId);
+    applyViewerMove(&oldChunk, nullptr);
+}
+
+ChunkPtr ChunkManager::getChunk(const glm::ivec3& chunkPos) const {
+    return m_chunks.find(chunkPos);
+}
+
+ChunkPtr ChunkManager::getOrCreateChunk(const glm::ivec3& chunkPos) {
+    auto [chunk, inserted] = m_chunks.findOrInsert(chunkPos, [&chunkPos]() {
+        return std::make_shared<Chunk>(chunkPos);
+    });
     
-    // Add to generation queue
-    m_generationQueue.push(chunkPos);
+    // New chunks are placeholders until a worker publishes the generated one
+    if (inserted) {
+        m_generationQueue.push(chunkPos);
+        
+        // Chunks created outside every viewer's range (e.g. by setBlock)
+        // are released again like any other out-of-range chunk
+        if (!m_interest.count(chunkPos)) {
+            m_unloadQueue.push_back(chunkPos);
+        }
+    }
     
-    return chunkPtr;
+    return chunk;
 }
 
-Block* ChunkManager::getBlock(const glm::ivec3& worldPos) {
+std::optional<Block> ChunkManager::getBlock(const glm::ivec3& worldPos) {
     glm::ivec3 chunkPos = worldToChunk(worldPos);
     glm::ivec3 localPos = worldToLocal(worldPos);
     
-    Chunk* chunk = getChunk(chunkPos);
+    ChunkPtr chunk = getChunk(chunkPos);
     if (!chunk) {
-        return nullptr;
+        return std::nullopt;
     }
     
-    return &chunk->getBlock(localPos.x, localPos.y, localPos.z);
+    return chunk->getBlock(localPos.x, localPos.y, localPos.z);
 }
 
 void ChunkManager::setBlock(const glm::ivec3& worldPos, BlockType type) {
     glm::ivec3 chunkPos = worldToChunk(worldPos);
     glm::ivec3 localPos = worldToLocal(worldPos);
     
-    Chunk* chunk = getOrCreateChunk(chunkPos);
+    ChunkPtr chunk = getOrCreateChunk(chunkPos);
+    if (!chunk->isGenerated()) {
+        // The worker replaces the placeholder wholesale, so hold the edit
+        m_pendingEdits[chunkPos].push_back({localPos, type});
+        return;
+    }
+    
+    // Earlier edits queued for this chunk go first
+    applyPendingEdits(chunkPos, *chunk);
     chunk->setBlock(localPos.x, localPos.y, localPos.z, type);
+    m_dirtyChunks.insert(chunkPos);
+    m_editedChunks.insert(chunkPos);
+}
+
+void ChunkManager::collectEditedChunks(std::vector<EditedChunk>& edited) {
+    for (const glm::ivec3& chunkPos : m_editedChunks) {
+        ChunkPtr chunk = m_chunks.find(chunkPos);
+        if (!chunk) {
+            continue; // Unloaded since the edit
+        }
+        
+        EditedChunk& out = edited.emplace_back();
+        out.position = chunkPos;
+        out.sectionMask = chunk->getSectionMask();
+        out.blockIds.assign(BLOCKS_PER_CHUNK, static_cast<uint8_t>(BlockType::AIR));
+        for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+            const ChunkSection* section = chunk->getSection(s);
+            if (!section) {
+                continue;
+            }
+            uint8_t* dst = out.blockIds.data() + s * BLOCKS_PER_SECTION;
+            for (int i = 0; i < BLOCKS_PER_SECTION; ++i) {
+                dst[i] = static_cast<uint8_t>(section->get(i).type);
+            }
+        }
+    }
+    m_editedChunks.clear();
+}
+
+void ChunkManager::applyPendingEdits() {
+    for (auto it = m_pendingEdits.begin(); it != m_pendingEdits.end();) {
+        glm::ivec3 chunkPos = it->first;
+        ++it; // The entry is erased once applied
+        ChunkPtr chunk = m_chunks.find(chunkPos);
+        if (chunk && chunk->isGenerated()) {
+            applyPendingEdits(chunkPos, *chunk);
+        }
+    }
+}
+
+void ChunkManager::applyPendingEdits(const glm::ivec3& chunkPos, Chunk& chunk) {
+    auto it = m_pendingEdits.find(chunkPos);
+    if (it == m_pendingEdits.end()) {
+        return;
+    }
+    for (const PendingEdit& edit : it->second) {
+        chunk.setBlock(edit.localPos.x, edit.localPos.y, edit.localPos.z, edit.type);
+    }
+    m_pendingEdits.erase(it);
+    m_dirtyChunks.insert(chunkPos);
+    m_editedChunks.insert(chunkPos);
 }
 
 glm::ivec3 ChunkManager::worldToChunk(const glm::ivec3& worldPos) {
@@ -119,151 +460,365 @@ glm::ivec3 ChunkManager::worldToLocal(const glm::ivec3& worldPos) {
     );
 }
 
-std::vector<Chunk*> ChunkManager::getLoadedChunks() {
-    std::lock_guard<std::mutex> lock(m_chunkMutex);
-    std::vector<Chunk*> chunks;
+std::vector<ChunkPtr> ChunkManager::getLoadedChunks() const {
+    std::vector<ChunkPtr> chunks;
     chunks.reserve(m_chunks.size());
     
-    for (auto& pair : m_chunks) {
-        if (pair.second->isGenerated()) {
-            chunks.push_back(pair.second.get());
+    m_chunks.forEach([&chunks](const glm::ivec3&, const ChunkPtr& chunk) {
+        if (chunk->isGenerated()) {
+            chunks.push_back(chunk);
         }
-    }
+    });
     
     return chunks;
 }
 
-void ChunkManager::loadChunksAroundPlayer(const glm::vec3& playerPos) {
-    glm::ivec3 playerChunk = worldToChunk(glm::ivec3(playerPos));
+ChunkMemoryStats ChunkManager::getMemoryStats() const {
+    ChunkMemoryStats stats;
+    
+    // Only generated chunks: placeholders may still be written by workers
+    for (const auto& chunk : getLoadedChunks()) {
+        size_t bytes = chunk->getMemoryUsage();
+        if (stats.chunkCount == 0 || bytes < stats.minBytes) {
+            stats.minBytes = bytes;
+        }
+        stats.maxBytes = std::max(stats.maxBytes, bytes);
+        stats.totalBytes += bytes;
+        stats.chunkCount++;
+    }
+    
+    return stats;
+}
+
+namespace {
+    // Half the z extent of a disc of the given radius at each x offset
+    std::vector<int> discHalfWidths(int radius) {
+        std::vector<int> halfWidths(radius + 1);
+        for (int dx = 0; dx <= radius; ++dx) {
+            int half = static_cast<int>(std::sqrt(static_cast<double>(radius * radius - dx * dx)));
+            while (half * half + dx * dx > radius * radius) --half;
+            while ((half + 1) * (half + 1) + dx * dx <= radius * radius) ++half;
+            halfWidths[dx] = half;
+        }
+        return halfWidths;
+    }
     
-    // Load chunks within load distance
-    for (int x = -m_loadDistance; x <= m_loadDistance; ++x) {
-        for (int z = -m_loadDistance; z <= m_loadDistance; ++z) {
-            glm::ivec3 chunkPos = playerChunk + glm::ivec3(x, 0, z);
+    // Calls fn for every cell in the disc around from that is not in the
+    // disc around to. Each row is at most two runs, so a one-chunk step
+    // costs O(radius) rather than O(radius^2).
+    template <typename Fn>
+    void forEachUncovered(const glm::ivec3& from, const glm::ivec3* to,
+                          const std::vector<int>& halfWidths, Fn&& fn) {
+        const int r = static_cast<int>(halfWidths.size()) - 1;
+        auto visit = [&fn, &from](int x, int zBegin, int zEnd) {
+            for (int z = zBegin; z <= zEnd; ++z) {
+                fn(glm::ivec3(x, from.y, z));
+            }
+        };
+        
+        for (int dx = -r; dx <= r; ++dx) {
+            int x = from.x + dx;
+            int half = halfWidths[std::abs(dx)];
+            int zBegin = from.z - half;
+            int zEnd = from.z + half;
             
-            // Check distance
-            float dist = std::sqrt(x * x + z * z);
-            if (dist <= m_loadDistance) {
-                getOrCreateChunk(chunkPos);
+            int toDx = to ? x - to->x : r + 1;
+            if (std::abs(toDx) > r) {
+                visit(x, zBegin, zEnd);
+                continue;
             }
+            
+            // Only the parts of this row outside the other disc's row
+            int toHalf = halfWidths[std::abs(toDx)];
+            visit(x, zBegin, std::min(zEnd, to->z - toHalf - 1));
+            visit(x, std::max(zBegin, to->z + toHalf + 1), zEnd);
         }
     }
 }
 
-void ChunkManager::unloadDistantChunks(const glm::vec3& playerPos) {
-    glm::ivec3 playerChunk = worldToChunk(glm::ivec3(playerPos));
-    
-    std::lock_guard<std::mutex> lock(m_chunkMutex);
+void ChunkManager::applyViewerMove(const glm::ivec3* oldChunk, const glm::ivec3* newChunk) {
+    const std::vector<int> loadHalfWidths = discHalfWidths(m_loadDistance);
+    const std::vector<int> retainHalfWidths = discHalfWidths(m_unloadDistance);
     
-    // Find chunks to unload
-    std::vector<glm::ivec3> toUnload;
-    for (const auto& pair : m_chunks) {
-        glm::ivec3 delta = pair.first - playerChunk;
-        float dist = std::sqrt(delta.x * delta.x + delta.z * delta.z);
+    // Release cells the viewer no longer covers. Cells covered by both the
+    // old and new position are never visited.
+    if (oldChunk) {
+        forEachUncovered(*oldChunk, newChunk, loadHalfWidths, [this](const glm::ivec3& pos) {
+            auto it = m_interest.find(pos);
+            if (it != m_interest.end()) {
+                it->second.loadRefs--;
+            }
+        });
         
-        if (dist > m_unloadDistance) {
-            toUnload.push_back(pair.first);
-        }
+        forEachUncovered(*oldChunk, newChunk, retainHalfWidths, [this](const glm::ivec3& pos) {
+            auto it = m_interest.find(pos);
+            if (it == m_interest.end()) return;
+            
+            // Out of every viewer's unload range: unload later
+            if (--it->second.retainRefs <= 0) {
+                m_interest.erase(it);
+                m_unloadQueue.push_back(pos);
+            }
+        });
     }
     
-    // Unload chunks
-    for (const auto& pos : toUnload) {
-        m_chunks.erase(pos);
+    // Acquire cells newly covered by the viewer; retain first so a chunk
+    // created for loading is already in the interest set
+    if (newChunk) {
+        forEachUncovered(*newChunk, oldChunk, retainHalfWidths, [this](const glm::ivec3& pos) {
+            m_interest[pos].retainRefs++;
+        });
+        
+        forEachUncovered(*newChunk, oldChunk, loadHalfWidths, [this](const glm::ivec3& pos) {
+            if (m_interest[pos].loadRefs++ == 0) {
+                getOrCreateChunk(pos);
+            }
+        });
     }
 }
 
-void ChunkManager::generationWorker() {
-    while (m_running) {
-        glm::ivec3 chunkPos;
-        bool hasWork = false;
+void ChunkManager::processUnloads() {
+    // Bounded per call so a teleport does not stall a single frame
+    // Chunks put back below are looked at again on the next call
+    size_t budget = m_maxUnloadsPerUpdate;
+    size_t remaining = m_unloadQueue.size();
+    while (budget > 0 && remaining-- > 0) {
+        glm::ivec3 pos = m_unloadQueue.front();
+        m_unloadQueue.pop_front();
         
-        {
-            std::lock_guard<std::mutex> lock(m_chunkMutex);
-            if (!m_generationQueue.empty()) {
-                chunkPos = m_generationQueue.front();
-                m_generationQueue.pop();
-                hasWork = true;
-            }
+        // A viewer came back into range before the unload ran
+        if (m_interest.count(pos)) {
+            continue;
+        }
+        
+        // Keep a chunk with queued edits until it is generated and they
+        // are applied, so the edits reach the saver
+        if (m_pendingEdits.count(pos)) {
+            m_unloadQueue.push_back(pos);
+            continue;
         }
         
-        if (hasWork) {
-            Chunk* chunk = getChunk(chunkPos);
-            if (chunk && !chunk->isGenerated()) {
-                generateChunk(chunk);
-                chunk->setGenerated(true);
-                chunk->setDirty(true);
+        // Drop any generation request still queued for the chunk
+        m_generationQueue.cancel(pos);
+        
+        // Unsaved edits go to the saver before the chunk is dropped; an
+        // ungenerated placeholder has nothing worth writing over the region
+        if (m_saver && m_dirtyChunks.erase(pos)) {
+            ChunkPtr chunk = m_chunks.find(pos);
+            if (chunk && chunk->isGenerated() && chunk->isDirty()) {
+                m_saver->enqueue(chunk->snapshot());
+                chunk->setDirty(false);
             }
-        } else {
-            std::this_thread::sleep_for(std::chrono::milliseconds(10));
         }
+        
+        if (m_chunks.erase(pos)) {
+            budget--;
+        }
+    }
+}
+
+void ChunkManager::generationWorker() {
+    // Blocks until work arrives; returns once the queue is shut down
+    while (auto job = m_generationQueue.pop()) {
+        ChunkPtr placeholder = getChunk(job->chunkPos);
+        if (!placeholder || placeholder->isGenerated()) {
+            continue;
+        }
+        
+        // Build into a private chunk, then publish it in one swap so readers
+        // never see a half-written chunk. Saved chunks carry earlier edits,
+        // so only chunks never saved are generated from the seed.
+        auto startTime = ChunkGenerationQueue::Clock::now();
+        ChunkPtr chunk = findSavedChunk(job->chunkPos);
+        if (!chunk) {
+            chunk = std::make_shared<Chunk>(job->chunkPos);
+            generateChunk(chunk.get());
+        }
+        chunk->setGenerated(true);
+        chunk->setDirty(false); // Already saved or reproducible from the seed
+        
+        // Fails if the chunk was unloaded or replaced by loadChunk meanwhile
+        m_chunks.replaceIf(job->chunkPos, placeholder, std::move(chunk));
+        m_generationQueue.recordCompletion(*job, startTime, ChunkGenerationQueue::Clock::now());
     }
 }
 
 void ChunkManager::generateChunk(Chunk* chunk) {
     const glm::ivec3& chunkPos = chunk->getPosition();
     
-    // Simple terrain generation (heightmap based)
-    for (int x = 0; x < CHUNK_SIZE_X; ++x) {
-        for (int z = 0; z < CHUNK_SIZE_Z; ++z) {
-            int worldX = chunkPos.x * CHUNK_SIZE_X + x;
-            int worldZ = chunkPos.z * CHUNK_SIZE_Z + z;
-            
-            // Simple height calculation (can be replaced with noise)
-            int height = 64 + static_cast<int>(std::sin(worldX * 0.1f) * 10 + std::cos(worldZ * 0.1f) * 10);
-            
-            for (int y = 0; y < CHUNK_SIZE_Y; ++y) {
-                BlockType type = BlockType::AIR;
-                
-                if (y < height - 5) {
-                    type = BlockType::STONE;
-                } else if (y < height - 1) {
-                    type = BlockType::DIRT;
-                } else if (y == height - 1) {
-                    type = BlockType::GRASS;
-                } else if (y < 60) {
-                    type = BlockType::WATER;
-                }
-                
-                chunk->setBlock(x, y, z, type);
+    // 2D pass: height, biome and ore field once per chunk column
+    TerrainColumns columns;
+    m_terrain.generateColumns(chunkPos.x, chunkPos.z, columns);
+    
+    // Fill every column as runs, in column-major order, flooding the air
+    // below the water line
+    std::vector<uint8_t> codes(static_cast<size_t>(CHUNK_SIZE_X) * CHUNK_SIZE_Z * CHUNK_SIZE_Y);
+    int top = WATER_LEVEL;
+    for (int z = 0; z < CHUNK_SIZE_Z; ++z) {
+        for (int x = 0; x < CHUNK_SIZE_X; ++x) {
+            uint8_t* column = codes.data() + (z * CHUNK_SIZE_X + x) * CHUNK_SIZE_Y;
+            int columnTop = m_terrain.fillColumn(columns, x, z, column);
+            if (columnTop < WATER_LEVEL) {
+                std::fill(column + columnTop, column + WATER_LEVEL, TerrainBlock::WATER);
             }
+            top = std::max(top, columnTop);
+        }
+    }
+    
+    // Build each section in one bulk load; sections above the terrain and
+    // the water line stay unallocated
+    std::vector<Block> sectionBlocks(BLOCKS_PER_SECTION);
+    for (int s = 0; s < SECTIONS_PER_CHUNK; ++s) {
+        int baseY = s * SECTION_SIZE_Y;
+        if (baseY >= top) {
+            chunk->loadSectionBlocks(s, {});
+            continue;
         }
+        
+        gatherTerrainSection(codes.data(), baseY, SECTION_SIZE_Y, TERRAIN_BLOCK_TABLE, sectionBlocks.data());
+        chunk->loadSectionBlocks(s, sectionBlocks);
     }
 }
 
-void ChunkManager::saveChunk(const glm::ivec3& chunkPos, const std::string& saveDir) {
-    Chunk* chunk = getChunk(chunkPos);
-    if (!chunk) return;
+ChunkPtr ChunkManager::findSavedChunk(const glm::ivec3& chunkPos) {
+    std::shared_lock<std::shared_mutex> lock(m_saverMutex);
+    if (!m_saver) return nullptr;
+    
+    // A snapshot the saver has not finished writing is newer than the disk
+    ChunkSnapshot snapshot;
+    if (m_saver->findQueued(chunkPos, snapshot)) {
+        auto chunk = std::make_shared<Chunk>(chunkPos);
+        chunk->restore(snapshot);
+        return chunk;
+    }
+    return readStoredChunk(m_saver->getStorage(), chunkPos);
+}
+
+ChunkPtr ChunkManager::readStoredChunk(RegionStorage& storage, const glm::ivec3& chunkPos) {
+    std::vector<uint8_t> data;
+    bool found = false;
+    try {
+        found = storage.loadChunk(chunkPos.x, chunkPos.z, data);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to open region for chunk (" << chunkPos.x << ", " << chunkPos.z << "): "
+                  << e.what() << std::endl;
+        return nullptr;
+    }
     
-    std::string filename = saveDir + "/chunk_" + 
-                          std::to_string(chunkPos.x) + "_" +
-                          std::to_string(chunkPos.y) + "_" +
-                          std::to_string(chunkPos.z) + ".dat";
+    if (!found) {
+        // Fall back to a legacy per-chunk file not yet converted
+        std::string filename = storage.getDirectory() + "/chunk_" +
+                              std::to_string(chunkPos.x) + "_" +
+                              std::to_string(chunkPos.y) + "_" +
+                              std::to_string(chunkPos.z) + ".dat";
+        
+        std::ifstream file(filename, std::ios::binary | std::ios::ate);
+        if (!file) return nullptr;
+        
+        data.resize(static_cast<size_t>(file.tellg()));
+        file.seekg(0);
+        file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file) return nullptr;
+    }
     
-    std::ofstream file(filename, std::ios::binary);
-    if (file) {
-        const auto& blocks = chunk->getBlocks();
-        file.write(reinterpret_cast<const char*>(blocks.data()), 
-                   blocks.size() * sizeof(Block));
+    auto chunk = std::make_shared<Chunk>(chunkPos);
+    if (!chunk->deserialize(data)) {
+        std::cerr << "Corrupt save data for chunk (" << chunkPos.x << ", " << chunkPos.z << ")" << std::endl;
+        return nullptr;
     }
+    return chunk;
 }
 
-bool ChunkManager::loadChunk(const glm::ivec3& chunkPos, const std::string& saveDir) {
-    std::string filename = saveDir + "/chunk_" + 
-                          std::to_string(chunkPos.x) + "_" +
-                          std::to_string(chunkPos.y) + "_" +
-                          std::to_string(chunkPos.z) + ".dat";
+RegionStorage& ChunkManager::getRegionStorage(const std::string& saveDir) {
+    auto& storage = m_regionStorage[saveDir];
+    if (!storage) {
+        storage = std::make_unique<RegionStorage>(saveDir);
+    }
+    return *storage;
+}
+
+void ChunkManager::setSaveDirectory(const std::string& saveDir, float flushIntervalSeconds) {
+    if (m_saver) {
+        snapshotDirtyChunks();
+    }
     
-    std::ifstream file(filename, std::ios::binary);
-    if (!file) return false;
+    m_saveInterval = flushIntervalSeconds;
+    m_saveTimer = 0.0f;
+    auto interval = std::chrono::milliseconds(static_cast<int64_t>(flushIntervalSeconds * 1000.0f));
+    RegionStorage& storage = getRegionStorage(saveDir);
     
-    Chunk* chunk = getOrCreateChunk(chunkPos);
-    file.read(reinterpret_cast<char*>(&chunk->getBlock(0, 0, 0)), 
-              BLOCKS_PER_CHUNK * sizeof(Block));
+    // The old saver finishes its writes before workers can read the new one
+    std::unique_lock<std::shared_mutex> lock(m_saverMutex);
+    m_saver.reset();
+    m_saver = std::make_unique<ChunkSaver>(storage, interval);
+}
+
+void ChunkManager::snapshotDirtyChunks() {
+    // Cost is proportional to the edited chunks, not the loaded ones.
+    // Chunks still awaiting generation stay queued for the next pass.
+    for (auto it = m_dirtyChunks.begin(); it != m_dirtyChunks.end();) {
+        ChunkPtr chunk = m_chunks.find(*it);
+        if (chunk && !chunk->isGenerated()) {
+            ++it;
+            continue;
+        }
+        if (chunk && chunk->isDirty()) {
+            m_saver->enqueue(chunk->snapshot());
+            chunk->setDirty(false);
+        }
+        it = m_dirtyChunks.erase(it);
+    }
+}
+
+void ChunkManager::flushSaves() {
+    if (!m_saver) return;
+    snapshotDirtyChunks();
+    m_saver->flush();
+}
+
+ChunkSaveStats ChunkManager::getSaveStats() const {
+    ChunkSaveStats stats;
+    if (m_saver) {
+        stats = m_saver->getStats();
+    }
+    stats.dirtyBacklog += m_dirtyChunks.size();
+    return stats;
+}
+
+void ChunkManager::saveChunk(const glm::ivec3& chunkPos, const std::string& saveDir) {
+    ChunkPtr chunk = getChunk(chunkPos);
+    if (!chunk || !chunk->isGenerated()) return;
+    
+    std::vector<uint8_t> data;
+    chunk->serialize(data);
+    if (getRegionStorage(saveDir).saveChunk(chunkPos.x, chunkPos.z, data)) {
+        chunk->setDirty(false);
+    }
+}
+
+bool ChunkManager::loadChunk(const glm::ivec3& chunkPos, const std::string& saveDir) {
+    // Build the chunk off-map and publish it once fully loaded
+    ChunkPtr chunk = readStoredChunk(getRegionStorage(saveDir), chunkPos);
+    if (!chunk) {
+        return false;
+    }
     
     chunk->setGenerated(true);
-    chunk->setDirty(true);
+    chunk->setDirty(false);
+    
+    // A loaded chunk supersedes any pending generation for the same slot
+    m_generationQueue.cancel(chunkPos);
+    m_chunks.insertOrReplace(chunkPos, std::move(chunk));
     
     return true;
 }
 
+size_t ChunkManager::compactRegions(bool force) {
+    size_t compacted = 0;
+    for (auto& [dir, storage] : m_regionStorage) {
+        compacted += storage->compact(force);
+    }
+    return compacted;
+}
+
 } // namespace clonemine
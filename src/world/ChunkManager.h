@@ -1,15 +1,30 @@
 #pragma once
 
+#include "ChunkGenerationQueue.h"
+#include "ChunkMap.h"
+#include "EditedChunk.h"
+#include "PalettedStorage.h"
+#include "RegionFile.h"
+#include "TerrainGenerator.h"
 #include <glm/glm.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <memory>
-#include <mutex>
+#include <shared_mutex>
 #include <thread>
-#include <queue>
 
 namespace clonemine {
 
+class ChunkSaver;
+struct ChunkSaveStats;
+
 // Block type definition
 enum class BlockType : uint8_t {
     AIR = 0,
@@ -26,7 +41,9 @@ enum class BlockType : uint8_t {
     GOLD_ORE,
     DIAMOND_ORE,
     IRON_ORE,
-    COAL_ORE
+    COAL_ORE,
+    BEDROCK,
+    SNOW
 };
 
 // Single block in the world
@@ -41,6 +58,8 @@ struct Block {
     bool isTransparent() const {
         return type == BlockType::AIR || type == BlockType::WATER || type == BlockType::GLASS;
     }
+    
+    bool operator==(const Block&) const = default;
 };
 
 // Chunk dimensions
@@ -49,39 +68,108 @@ constexpr int CHUNK_SIZE_Y = 256;
 constexpr int CHUNK_SIZE_Z = 16;
 constexpr int BLOCKS_PER_CHUNK = CHUNK_SIZE_X * CHUNK_SIZE_Y * CHUNK_SIZE_Z;
 
+// Vertical sections (16x16x16) - chunks allocate them lazily
+constexpr int SECTION_SIZE_Y = 16;
+constexpr int SECTIONS_PER_CHUNK = CHUNK_SIZE_Y / SECTION_SIZE_Y;
+constexpr int BLOCKS_PER_SECTION = CHUNK_SIZE_X * SECTION_SIZE_Y * CHUNK_SIZE_Z;
+
+using ChunkSection = PalettedStorage<Block, BLOCKS_PER_SECTION>;
+
+// Read-only view of a chunk's blocks, safe to hand to another thread.
+// It shares section storage with the chunk; the chunk copies a section
+// the first time it writes to it after a snapshot (copy-on-write).
+struct ChunkSnapshot {
+    glm::ivec3 position{0, 0, 0};
+    std::array<std::shared_ptr<const ChunkSection>, SECTIONS_PER_CHUNK> sections;
+    
+    // Same payload as Chunk::serialize()
+    void serialize(std::vector<uint8_t>& out) const;
+};
+
 // Single chunk
+// Generation workers fill a private Chunk and publish it whole; after that
+// its blocks are only written from the game thread.
 class Chunk {
 public:
     Chunk(const glm::ivec3& position);
     ~Chunk() = default;
     
-    // Block access
-    Block& getBlock(int x, int y, int z);
-    const Block& getBlock(int x, int y, int z) const;
+    // Block access (blocks are palette-compressed, so reads return by value)
+    Block getBlock(int x, int y, int z) const;
     
     void setBlock(int x, int y, int z, BlockType type);
+    void setBlock(int x, int y, int z, const Block& block);
     
-    // Position and state
+    // Position and state (flags are read from render/worker threads)
     const glm::ivec3& getPosition() const { return m_position; }
-    bool isGenerated() const { return m_generated; }
-    void setGenerated(bool generated) { m_generated = generated; }
-    bool isDirty() const { return m_dirty; }
-    void setDirty(bool dirty) { m_dirty = dirty; }
+    bool isGenerated() const { return m_generated.load(std::memory_order_acquire); }
+    void setGenerated(bool generated) { m_generated.store(generated, std::memory_order_release); }
+    bool isDirty() const { return m_dirty.load(std::memory_order_acquire); }
+    void setDirty(bool dirty) { m_dirty.store(dirty, std::memory_order_release); }
+    
+    // Unpacked copy of all blocks (for rendering and saving)
+    void copyBlocks(std::vector<Block>& out) const;
+    void loadBlocks(const std::vector<Block>& blocks);
+    
+    // Sections: a null section is all air and is never allocated
+    bool isSectionEmpty(int sectionY) const { return !m_sections[sectionY]; }
+    uint16_t getSectionMask() const;
+    const ChunkSection* getSection(int sectionY) const { return m_sections[sectionY].get(); }
     
-    // Get blocks for rendering
-    const std::vector<Block>& getBlocks() const { return m_blocks; }
+    // Unpacked copy of one section, and bulk load of one section
+    void copySectionBlocks(int sectionY, std::vector<Block>& out) const;
+    void loadSectionBlocks(int sectionY, const std::vector<Block>& blocks);
+    
+    // O(sections) snapshot for background saving; never copies blocks.
+    // Game thread only: the next write to each captured section copies it.
+    ChunkSnapshot snapshot() const;
+    // Take over a snapshot's sections, sharing them the same way
+    void restore(const ChunkSnapshot& snapshot);
+    
+    // Save payload: section mask followed by each non-empty section.
+    // deserialize() also accepts the legacy flat 256-level layout.
+    void serialize(std::vector<uint8_t>& out) const;
+    bool deserialize(const std::vector<uint8_t>& data);
+    
+    // Shrink palettes after bulk edits such as generation and release
+    // sections that ended up all air
+    void compact();
+    
+    // Bytes held by the block storage
+    size_t getMemoryUsage() const;
     
 private:
     glm::ivec3 m_position;
-    std::vector<Block> m_blocks;
-    bool m_generated = false;
-    bool m_dirty = false;
+    std::array<std::shared_ptr<ChunkSection>, SECTIONS_PER_CHUNK> m_sections;
+    std::atomic<bool> m_generated{false};
+    std::atomic<bool> m_dirty{false};
+    
+    // Sections handed to a snapshot since they were last written. The
+    // snapshot may live on another thread, so its holder count says
+    // nothing reliable about when it lets go.
+    mutable uint16_t m_snapshotMask = 0;
     
-    inline int getIndex(int x, int y, int z) const {
-        return x + z * CHUNK_SIZE_X + y * CHUNK_SIZE_X * CHUNK_SIZE_Z;
+    inline int getSectionIndex(int x, int y, int z) const {
+        return x + z * CHUNK_SIZE_X + (y % SECTION_SIZE_Y) * CHUNK_SIZE_X * CHUNK_SIZE_Z;
     }
+    
+    // Copy-on-write: clone a section a snapshot may still be reading
+    void detach(int sectionY) {
+        uint16_t bit = static_cast<uint16_t>(1u << sectionY);
+        if (m_snapshotMask & bit) {
+            m_snapshotMask &= static_cast<uint16_t>(~bit);
+            auto& section = m_sections[sectionY];
+            if (section) {
+                section = std::make_shared<ChunkSection>(*section);
+            }
+        }
+    }
+    
+    ChunkSnapshot captureSections() const;
 };
 
+using ChunkPtr = std::shared_ptr<Chunk>;
+
 // Hash function for chunk positions
 struct ChunkPosHash {
     std::size_t operator()(const glm::ivec3& pos) const {
@@ -89,57 +177,155 @@ struct ChunkPosHash {
     }
 };
 
+// Memory used by loaded chunk block storage
+struct ChunkMemoryStats {
+    size_t chunkCount = 0;
+    size_t totalBytes = 0;
+    size_t minBytes = 0;
+    size_t maxBytes = 0;
+    
+    size_t averageBytes() const { return chunkCount ? totalBytes / chunkCount : 0; }
+};
+
 // Chunk manager - handles all chunks in the world
 class ChunkManager {
 public:
-    ChunkManager();
+    static constexpr uint32_t DEFAULT_SEED = 12345;
+    
+    // workerCount = 0 sizes the generation pool from hardware_concurrency()
+    explicit ChunkManager(unsigned workerCount = 0, uint32_t seed = DEFAULT_SEED);
     ~ChunkManager();
     
     // Chunk lifecycle
+    // Chunks are shared: a chunk unloaded while another thread holds it
+    // stays valid until that reference is dropped
     void update(const glm::vec3& playerPos, float deltaTime);
-    Chunk* getChunk(const glm::ivec3& chunkPos);
-    Chunk* getOrCreateChunk(const glm::ivec3& chunkPos);
+    ChunkPtr getChunk(const glm::ivec3& chunkPos) const;
+    ChunkPtr getOrCreateChunk(const glm::ivec3& chunkPos);
     
     // Block access (world coordinates)
-    Block* getBlock(const glm::ivec3& worldPos);
+    std::optional<Block> getBlock(const glm::ivec3& worldPos);
     void setBlock(const glm::ivec3& worldPos, BlockType type);
     
+    // Chunks whose blocks were edited since the last call, each once with
+    // its current blocks, for remeshing (game thread only). Pass each to
+    // BlockRenderer::updateChunk; it also remeshes the border parts of
+    // loaded neighbours whose shared edge changed.
+    void collectEditedChunks(std::vector<EditedChunk>& edited);
+    
     // Chunk <-> World coordinate conversion
     static glm::ivec3 worldToChunk(const glm::ivec3& worldPos);
     static glm::ivec3 worldToLocal(const glm::ivec3& worldPos);
     
+    // Streaming (game thread only)
+    // Each viewer keeps chunks within the load distance loaded and retains
+    // them until it is beyond the unload distance. Work is only done when a
+    // viewer crosses a chunk boundary; unloads are spread over update() calls.
+    void updateViewer(uint32_t viewerId, const glm::vec3& position);
+    void removeViewer(uint32_t viewerId);
+    void update(float deltaTime);
+    size_t getPendingUnloadCount() const { return m_unloadQueue.size(); }
+    
     // Configuration
     void setRenderDistance(int distance) { m_renderDistance = distance; }
     int getRenderDistance() const { return m_renderDistance; }
+    void setMaxUnloadsPerUpdate(size_t count) { m_maxUnloadsPerUpdate = count; }
     
     // Get all loaded chunks for rendering
-    std::vector<Chunk*> getLoadedChunks();
+    std::vector<ChunkPtr> getLoadedChunks() const;
+    size_t getChunkCount() const { return m_chunks.size(); }
+    
+    // Memory-per-chunk metric for loaded chunks
+    ChunkMemoryStats getMemoryStats() const;
+    
+    // Generation queue depth and per-chunk latency
+    ChunkGenerationStats getGenerationStats() const { return m_generationQueue.getStats(); }
+    size_t getWorkerCount() const { return m_generationThreads.size(); }
+    
+    // Seeded terrain shared by the generation workers
+    const TerrainGenerator& getTerrainGenerator() const { return m_terrain; }
     
-    // Save/Load
+    // Save/Load (region files under saveDir; loadChunk also reads the
+    // legacy per-chunk chunk_x_y_z.dat files)
     void saveChunk(const glm::ivec3& chunkPos, const std::string& saveDir);
     bool loadChunk(const glm::ivec3& chunkPos, const std::string& saveDir);
     
+    // Rewrite region files whose dead space outweighs their live data.
+    // Blocks the caller; update() has the saver do this in the background.
+    size_t compactRegions(bool force = false);
+    
+    // Write-behind saving (game thread only). Modified chunks are
+    // snapshotted every interval and written by a background thread;
+    // dirty chunks are also saved when unloaded and on destruction.
+    void setSaveDirectory(const std::string& saveDir, float flushIntervalSeconds = 5.0f);
+    void flushSaves();
+    ChunkSaveStats getSaveStats() const;
+    
 private:
-    std::unordered_map<glm::ivec3, std::unique_ptr<Chunk>, ChunkPosHash> m_chunks;
-    std::mutex m_chunkMutex;
+    // Sharded map: block reads only take a shared lock on one shard
+    ChunkMap m_chunks;
+    
+    // Region storage per save directory
+    std::unordered_map<std::string, std::unique_ptr<RegionStorage>> m_regionStorage;
+    float m_compactionTimer = 0.0f;
+    static constexpr float COMPACTION_INTERVAL = 300.0f; // Seconds
+    
+    // Write-behind saver and the chunks modified since the last snapshot.
+    // Workers read saved chunks through the saver under a shared lock; the
+    // game thread replaces it under an exclusive one.
+    std::unique_ptr<ChunkSaver> m_saver;
+    mutable std::shared_mutex m_saverMutex;
+    std::unordered_set<glm::ivec3, ChunkPosHash> m_dirtyChunks;
+    std::unordered_set<glm::ivec3, ChunkPosHash> m_editedChunks; // Not yet remeshed
+    float m_saveTimer = 0.0f;
+    float m_saveInterval = 5.0f;
+    
+    // Terrain pipeline: 2D column pass, then per-section fill
+    TerrainGenerator m_terrain;
     
-    // Generation queue
-    std::queue<glm::ivec3> m_generationQueue;
+    // Generation queue (prioritised by distance to the player)
+    ChunkGenerationQueue m_generationQueue;
     std::vector<std::thread> m_generationThreads;
-    bool m_running = true;
+    
+    // Shared interest set: how many viewers want each chunk loaded/retained
+    struct Interest {
+        int loadRefs = 0;   // Viewers within load distance
+        int retainRefs = 0; // Viewers within unload distance
+    };
+    
+    std::unordered_map<uint32_t, glm::ivec3> m_viewers; // Viewer -> chunk
+    std::unordered_map<glm::ivec3, Interest, ChunkPosHash> m_interest;
+    std::deque<glm::ivec3> m_unloadQueue;
     
     // Settings
     int m_renderDistance = 12;  // 12 chunks = 192 blocks
     int m_loadDistance = 16;    // 16 chunks
     int m_unloadDistance = 20;  // 20 chunks
+    size_t m_maxUnloadsPerUpdate = 32;
+    
+    // Edits to chunks still awaiting generation, applied once the generated
+    // chunk is published (a placeholder's blocks are thrown away)
+    struct PendingEdit {
+        glm::ivec3 localPos;
+        BlockType type;
+    };
+    std::unordered_map<glm::ivec3, std::vector<PendingEdit>, ChunkPosHash> m_pendingEdits;
+    
+    static constexpr uint32_t LOCAL_VIEWER = 0;
     
     // Worker thread for chunk generation
     void generationWorker();
     void generateChunk(Chunk* chunk);
+    ChunkPtr findSavedChunk(const glm::ivec3& chunkPos);
+    static ChunkPtr readStoredChunk(RegionStorage& storage, const glm::ivec3& chunkPos);
+    RegionStorage& getRegionStorage(const std::string& saveDir);
+    void snapshotDirtyChunks();
     
-    // Chunk loading/unloading based on player position
-    void loadChunksAroundPlayer(const glm::vec3& playerPos);
-    void unloadDistantChunks(const glm::vec3& playerPos);
+    // Interest bookkeeping for a viewer moving between chunks
+    void applyViewerMove(const glm::ivec3* oldChunk, const glm::ivec3* newChunk);
+    void processUnloads();
+    void applyPendingEdits();
+    void applyPendingEdits(const glm::ivec3& chunkPos, Chunk& chunk);
 };
 
 } // namespace clonemine
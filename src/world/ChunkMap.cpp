@@ -0,0 +1,101 @@
+#include "ChunkMap.h"
+#include <mutex>
+
+namespace clonemine {
+
+namespace {
+    // Spread neighbouring chunks across shards
+    size_t shardIndex(const glm::ivec3& chunkPos) {
+        uint32_t h = static_cast<uint32_t>(chunkPos.x) * 73856093u ^
+                     static_cast<uint32_t>(chunkPos.y) * 19349663u ^
+                     static_cast<uint32_t>(chunkPos.z) * 83492791u;
+        return (h ^ (h >> 16)) % ChunkMap::SHARD_COUNT;
+    }
+}
+
+ChunkMap::Shard& ChunkMap::shardFor(const glm::ivec3& chunkPos) {
+    return m_shards[shardIndex(chunkPos)];
+}
+
+const ChunkMap::Shard& ChunkMap::shardFor(const glm::ivec3& chunkPos) const {
+    return m_shards[shardIndex(chunkPos)];
+}
+
+ChunkMap::ChunkPtr ChunkMap::find(const glm::ivec3& chunkPos) const {
+    const Shard& shard = shardFor(chunkPos);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.chunks.find(chunkPos);
+    return it != shard.chunks.end() ? it->second : nullptr;
+}
+
+std::pair<ChunkMap::ChunkPtr, bool> ChunkMap::findOrInsert(const glm::ivec3& chunkPos,
+                                                           const std::function<ChunkPtr()>& create) {
+    // Fast path: most calls hit an existing chunk
+    if (auto existing = find(chunkPos)) {
+        return {existing, false};
+    }
+
+    Shard& shard = shardFor(chunkPos);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.chunks.find(chunkPos);
+    if (it != shard.chunks.end()) {
+        return {it->second, false};
+    }
+
+    ChunkPtr chunk = create();
+    shard.chunks.emplace(chunkPos, chunk);
+    return {chunk, true};
+}
+
+void ChunkMap::insertOrReplace(const glm::ivec3& chunkPos, ChunkPtr chunk) {
+    Shard& shard = shardFor(chunkPos);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.chunks[chunkPos] = std::move(chunk);
+}
+
+bool ChunkMap::replaceIf(const glm::ivec3& chunkPos, const ChunkPtr& expected, ChunkPtr replacement) {
+    Shard& shard = shardFor(chunkPos);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.chunks.find(chunkPos);
+    if (it == shard.chunks.end() || it->second != expected) {
+        return false;
+    }
+    it->second = std::move(replacement);
+    return true;
+}
+
+bool ChunkMap::erase(const glm::ivec3& chunkPos) {
+    ChunkPtr removed;
+    {
+        Shard& shard = shardFor(chunkPos);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto it = shard.chunks.find(chunkPos);
+        if (it == shard.chunks.end()) {
+            return false;
+        }
+        removed = std::move(it->second);
+        shard.chunks.erase(it);
+    }
+    // removed is released here, outside the shard lock
+    return true;
+}
+
+void ChunkMap::forEach(const std::function<void(const glm::ivec3&, const ChunkPtr&)>& visit) const {
+    for (const Shard& shard : m_shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& [pos, chunk] : shard.chunks) {
+            visit(pos, chunk);
+        }
+    }
+}
+
+size_t ChunkMap::size() const {
+    size_t total = 0;
+    for (const Shard& shard : m_shards) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.chunks.size();
+    }
+    return total;
+}
+
+} // namespace clonemine
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <array>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace clonemine {
+
+class Chunk;
+
+// Concurrent chunk map sharded by chunk coordinate.
+//
+// Each shard has its own reader/writer lock, so block reads from gameplay
+// code only take a shared lock on one shard and never contend with the
+// generation workers or with readers of other shards. Chunks are handed
+// out as shared_ptr, so a chunk erased by unloading stays alive until the
+// last thread holding it lets go.
+class ChunkMap {
+public:
+    using ChunkPtr = std::shared_ptr<Chunk>;
+
+    static constexpr size_t SHARD_COUNT = 64;
+
+    ChunkMap() = default;
+    ~ChunkMap() = default;
+
+    ChunkMap(const ChunkMap&) = delete;
+    ChunkMap& operator=(const ChunkMap&) = delete;
+
+    ChunkPtr find(const glm::ivec3& chunkPos) const;
+
+    // Return the existing chunk, or insert the one built by create().
+    // The bool is true if a new chunk was inserted.
+    std::pair<ChunkPtr, bool> findOrInsert(const glm::ivec3& chunkPos,
+                                           const std::function<ChunkPtr()>& create);
+
+    // Insert or overwrite unconditionally
+    void insertOrReplace(const glm::ivec3& chunkPos, ChunkPtr chunk);
+
+    // Swap in a replacement only if the slot still holds expected
+    bool replaceIf(const glm::ivec3& chunkPos, const ChunkPtr& expected, ChunkPtr replacement);
+
+    bool erase(const glm::ivec3& chunkPos);
+
+    // Visit every chunk; each shard is held under a shared lock while visited
+    void forEach(const std::function<void(const glm::ivec3&, const ChunkPtr&)>& visit) const;
+
+    size_t size() const;
+
+private:
+    struct PosHash {
+        std::size_t operator()(const glm::ivec3& pos) const {
+            return std::hash<int>()(pos.x) ^ (std::hash<int>()(pos.y) << 1) ^ (std::hash<int>()(pos.z) << 2);
+        }
+    };
+
+    // Padded so neighbouring shard locks do not share a cache line
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<glm::ivec3, ChunkPtr, PosHash> chunks;
+    };
+
+    Shard& shardFor(const glm::ivec3& chunkPos);
+    const Shard& shardFor(const glm::ivec3& chunkPos) const;
+
+    std::array<Shard, SHARD_COUNT> m_shards;
+};
+
+} // namespace clonemine
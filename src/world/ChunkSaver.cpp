@@ -0,0 +1,161 @@
+#include "ChunkSaver.h"
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace clonemine {
+
+ChunkSaver::ChunkSaver(RegionStorage& storage, std::chrono::milliseconds flushInterval)
+    : m_storage(storage)
+    , m_flushInterval(flushInterval)
+{
+    m_thread = std::thread(&ChunkSaver::run, this);
+}
+
+ChunkSaver::~ChunkSaver() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wake.notify_one();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void ChunkSaver::enqueue(ChunkSnapshot snapshot) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    glm::ivec3 position = snapshot.position;
+    m_pending.insert_or_assign(position, std::move(snapshot));
+}
+
+bool ChunkSaver::findQueued(const glm::ivec3& position, ChunkSnapshot& out) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_pending.find(position);
+    if (it == m_pending.end()) {
+        it = m_batch.find(position);
+        if (it == m_batch.end()) {
+            return false;
+        }
+    }
+    out = it->second;
+    return true;
+}
+
+void ChunkSaver::requestFlush() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_requestedFlush;
+    }
+    m_wake.notify_one();
+}
+
+void ChunkSaver::flush() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    uint64_t ticket = ++m_requestedFlush;
+    m_wake.notify_one();
+    m_flushed.wait(lock, [this, ticket]() { return m_completedFlush >= ticket; });
+}
+
+void ChunkSaver::requestCompaction() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_compactionRequested = true;
+    }
+    m_wake.notify_one();
+}
+
+void ChunkSaver::setFlushInterval(std::chrono::milliseconds interval) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_flushInterval = interval;
+    }
+    m_wake.notify_one();
+}
+
+ChunkSaveStats ChunkSaver::getStats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    ChunkSaveStats stats = m_stats;
+    stats.dirtyBacklog = m_pending.size() + m_batch.size();
+    return stats;
+}
+
+void ChunkSaver::run() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (true) {
+        m_wake.wait_for(lock, m_flushInterval, [this]() {
+            return m_shutdown || m_compactionRequested || m_requestedFlush != m_completedFlush;
+        });
+
+        uint64_t target = m_requestedFlush;
+        bool stopping = m_shutdown;
+        m_batch.swap(m_pending);
+
+        if (!m_batch.empty()) {
+            lock.unlock();
+
+            // Serialize and write outside the lock so enqueue() never waits;
+            // findQueued() only reads the batch meanwhile
+            auto start = Clock::now();
+            uint64_t bytes = 0;
+            uint64_t written = 0;
+            std::vector<glm::ivec3> failed;
+            std::vector<uint8_t> payload;
+            for (const auto& [position, snapshot] : m_batch) {
+                snapshot.serialize(payload);
+                try {
+                    if (m_storage.saveChunk(position.x, position.z, payload)) {
+                        bytes += payload.size();
+                        written++;
+                    } else {
+                        failed.push_back(position);
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Failed to save chunk (" << position.x << ", " << position.z << "): "
+                              << e.what() << std::endl;
+                    failed.push_back(position);
+                }
+            }
+            double elapsedMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+            // Written, so readers find these chunks on disk from now on. A
+            // failed write is retried with the next batch unless a newer
+            // snapshot replaced it; dropping it would lose the edits.
+            lock.lock();
+            if (!stopping) {
+                for (const glm::ivec3& position : failed) {
+                    auto it = m_batch.find(position);
+                    m_pending.try_emplace(position, std::move(it->second));
+                }
+            }
+            m_batch.clear();
+            m_stats.flushCount++;
+            m_stats.chunksWritten += written;
+            m_stats.bytesWritten += bytes;
+            m_stats.failedWrites += failed.size();
+            m_stats.lastFlushMs = elapsedMs;
+            m_stats.maxFlushMs = std::max(m_stats.maxFlushMs, elapsedMs);
+            m_totalFlushMs += elapsedMs;
+            m_stats.averageFlushMs = m_totalFlushMs / static_cast<double>(m_stats.flushCount);
+        }
+
+        m_completedFlush = std::max(m_completedFlush, target);
+        m_flushed.notify_all();
+
+        if (m_compactionRequested && !stopping) {
+            m_compactionRequested = false;
+            lock.unlock();
+            // Failures are logged per region; the old files stay in use
+            size_t compacted = m_storage.compact();
+            lock.lock();
+            m_stats.regionsCompacted += compacted;
+        }
+
+        if (stopping && m_pending.empty()) {
+            break;
+        }
+    }
+}
+
+} // namespace clonemine
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "ChunkManager.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace clonemine {
+
+// Snapshot of write-behind saver counters
+struct ChunkSaveStats {
+    size_t dirtyBacklog = 0;    // Chunks modified but not yet written
+    uint64_t flushCount = 0;    // Batches written
+    uint64_t chunksWritten = 0;
+    uint64_t bytesWritten = 0;  // Uncompressed payload bytes
+    uint64_t failedWrites = 0;
+    uint64_t regionsCompacted = 0;
+    double lastFlushMs = 0.0;
+    double averageFlushMs = 0.0;
+    double maxFlushMs = 0.0;
+};
+
+// Background writer for chunk snapshots.
+//
+// The game thread hands over copy-on-write snapshots, so it never waits on
+// disk. Snapshots are batched per flush; a newer snapshot of a chunk that
+// has not been written yet replaces the older one. Batches are written
+// every flush interval, on requestFlush(), and on destruction; failed
+// writes are retried with the next batch. Until a snapshot is on disk,
+// findQueued() hands it to chunk loading instead of the stale copy. Region
+// compaction also runs here, after the next batch, so it never stalls
+// the game thread.
+class ChunkSaver {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    ChunkSaver(RegionStorage& storage, std::chrono::milliseconds flushInterval);
+    ~ChunkSaver();
+
+    ChunkSaver(const ChunkSaver&) = delete;
+    ChunkSaver& operator=(const ChunkSaver&) = delete;
+
+    void enqueue(ChunkSnapshot snapshot);
+
+    // The newest snapshot of a chunk not yet on disk, queued or being
+    // written; false once the storage holds the latest copy
+    bool findQueued(const glm::ivec3& position, ChunkSnapshot& out) const;
+
+    RegionStorage& getStorage() const { return m_storage; }
+
+    // Start writing the current batch now; flush() also waits for it
+    void requestFlush();
+    void flush();
+
+    // Compact the storage's regions that need it on the saver thread
+    void requestCompaction();
+
+    void setFlushInterval(std::chrono::milliseconds interval);
+    ChunkSaveStats getStats() const;
+
+private:
+    void run();
+
+    RegionStorage& m_storage;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_flushed;
+    std::unordered_map<glm::ivec3, ChunkSnapshot, ChunkPosHash> m_pending;
+    // Batch being written; only swapped and cleared under the lock
+    std::unordered_map<glm::ivec3, ChunkSnapshot, ChunkPosHash> m_batch;
+    std::chrono::milliseconds m_flushInterval;
+    uint64_t m_requestedFlush = 0;
+    uint64_t m_completedFlush = 0;
+    bool m_compactionRequested = false;
+    bool m_shutdown = false;
+
+    ChunkSaveStats m_stats;
+    double m_totalFlushMs = 0.0;
+
+    std::thread m_thread;
+};
+
+} // namespace clonemine
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace clonemine {
+
+// Number of world block ids (ChunkManager's BlockType, AIR to SNOW)
+constexpr int WORLD_BLOCK_ID_COUNT = 17;
+
+// Blocks of a chunk changed through ChunkManager::setBlock, as raw world
+// BlockType values. Free of either BlockType enum so the renderer, which
+// has its own, can take it (see BlockRenderer::updateChunk).
+struct EditedChunk {
+    glm::ivec3 position{0, 0, 0};
+    uint16_t sectionMask = 0;      // Bit N set = section N holds non-air blocks
+    std::vector<uint8_t> blockIds; // Indexed x + z*16 + y*256
+};
+
+} // namespace clonemine
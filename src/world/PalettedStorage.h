@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace clonemine {
+
+// Palette-compressed storage for a fixed number of values.
+//
+// Each distinct value is stored once in a palette and every slot holds a
+// bit-packed index into it. The index width starts at 0 bits (the whole
+// container is a single value) and widens on demand through 1/2/4/8 bits,
+// with a 16-bit tier for value types that have more than 256 states.
+// Widths are powers of two so an index never straddles a 64-bit word.
+template <typename T, size_t Count>
+class PalettedStorage {
+public:
+    static constexpr size_t SIZE = Count;
+
+    PalettedStorage() : m_palette{T{}} {}
+    explicit PalettedStorage(const T& value) : m_palette{value} {}
+
+    [[nodiscard]] T get(size_t index) const {
+        if (m_bits == 0) {
+            return m_palette[0];
+        }
+        return m_palette[readIndex(index)];
+    }
+
+    void set(size_t index, const T& value) {
+        if (m_bits == 0 && m_palette[0] == value) {
+            return;
+        }
+        writeIndex(index, findOrAdd(value));
+    }
+
+    // Reset every slot to a single value and release the index data
+    void fill(const T& value) {
+        m_palette.assign(1, value);
+        m_palette.shrink_to_fit();
+        m_data.clear();
+        m_data.shrink_to_fit();
+        setBits(0);
+    }
+
+    // Bulk load Count values in one pass. The palette is built first and
+    // the index width chosen once, so runs of equal values (the common
+    // case for generated terrain) cost a single comparison each.
+    void assign(const T* values) {
+        std::vector<T> palette{values[0]};
+        std::vector<uint32_t> indices(Count);
+        uint32_t last = 0;
+        for (size_t i = 0; i < Count; ++i) {
+            if (!(values[i] == palette[last])) {
+                last = static_cast<uint32_t>(palette.size());
+                for (uint32_t p = 0; p < palette.size(); ++p) {
+                    if (palette[p] == values[i]) {
+                        last = p;
+                        break;
+                    }
+                }
+                if (last == palette.size()) {
+                    palette.push_back(values[i]);
+                }
+            }
+            indices[i] = last;
+        }
+
+        if (palette.size() == 1) {
+            fill(palette[0]);
+            return;
+        }
+
+        m_palette = std::move(palette);
+        setBits(bitsFor(m_palette.size()));
+        m_data.assign((Count + m_entriesMask) >> m_entriesShift, 0);
+        for (size_t i = 0; i < Count; ++i) {
+            writeIndex(i, indices[i]);
+        }
+    }
+
+    // Drop palette entries that are no longer referenced and narrow the
+    // index width to match. Call after bulk edits such as generation.
+    void compact() {
+        if (m_bits == 0) {
+            return;
+        }
+
+        std::vector<uint32_t> remap(m_palette.size(), UNUSED);
+        std::vector<T> palette;
+        for (size_t i = 0; i < Count; ++i) {
+            uint32_t old = readIndex(i);
+            if (remap[old] == UNUSED) {
+                remap[old] = static_cast<uint32_t>(palette.size());
+                palette.push_back(m_palette[old]);
+            }
+        }
+
+        if (palette.size() == m_palette.size()) {
+            return;
+        }
+        if (palette.size() == 1) {
+            fill(palette[0]);
+            return;
+        }
+
+        repack(bitsFor(palette.size()), remap);
+        m_palette = std::move(palette);
+    }
+
+    // Single-value containers carry no index data at all
+    [[nodiscard]] bool isUniform() const noexcept { return m_bits == 0; }
+    [[nodiscard]] const T& getUniformValue() const noexcept { return m_palette[0]; }
+
+    [[nodiscard]] int getBitsPerEntry() const noexcept { return m_bits; }
+    [[nodiscard]] size_t getPaletteSize() const noexcept { return m_palette.size(); }
+    [[nodiscard]] const std::vector<T>& getPalette() const noexcept { return m_palette; }
+
+    // Heap plus inline bytes held by this container
+    [[nodiscard]] size_t getMemoryUsage() const noexcept {
+        return sizeof(*this) + m_palette.capacity() * sizeof(T) + m_data.capacity() * sizeof(uint64_t);
+    }
+
+private:
+    static constexpr uint32_t UNUSED = 0xFFFFFFFFu;
+
+    [[nodiscard]] static int bitsFor(size_t paletteSize) noexcept {
+        int bits = 1;
+        while ((size_t{1} << bits) < paletteSize) {
+            bits *= 2;
+        }
+        return bits;
+    }
+
+    void setBits(int bits) noexcept {
+        m_bits = bits;
+        if (bits == 0) {
+            m_entriesShift = 0;
+            m_entriesMask = 0;
+            m_valueMask = 0;
+            return;
+        }
+        int log2Bits = 0;
+        while ((1 << log2Bits) < bits) {
+            ++log2Bits;
+        }
+        m_entriesShift = 6 - log2Bits;
+        m_entriesMask = (size_t{1} << m_entriesShift) - 1;
+        m_valueMask = (uint64_t{1} << bits) - 1;
+    }
+
+    [[nodiscard]] uint32_t readIndex(size_t index) const noexcept {
+        const uint64_t word = m_data[index >> m_entriesShift];
+        const unsigned offset = static_cast<unsigned>(index & m_entriesMask) * static_cast<unsigned>(m_bits);
+        return static_cast<uint32_t>((word >> offset) & m_valueMask);
+    }
+
+    void writeIndex(size_t index, uint32_t paletteIndex) noexcept {
+        uint64_t& word = m_data[index >> m_entriesShift];
+        const unsigned offset = static_cast<unsigned>(index & m_entriesMask) * static_cast<unsigned>(m_bits);
+        word = (word & ~(m_valueMask << offset)) | (static_cast<uint64_t>(paletteIndex) << offset);
+    }
+
+    uint32_t findOrAdd(const T& value) {
+        for (size_t i = 0; i < m_palette.size(); ++i) {
+            if (m_palette[i] == value) {
+                return static_cast<uint32_t>(i);
+            }
+        }
+
+        m_palette.push_back(value);
+        if (m_bits == 0 || m_palette.size() > (size_t{1} << m_bits)) {
+            std::vector<uint32_t> identity;
+            repack(bitsFor(m_palette.size()), identity);
+        }
+        return static_cast<uint32_t>(m_palette.size() - 1);
+    }
+
+    // Rewrite every index at a new width, optionally through a remap table
+    void repack(int newBits, const std::vector<uint32_t>& remap) {
+        const int oldBits = m_bits;
+        std::vector<uint64_t> oldData = std::move(m_data);
+        const size_t oldShift = m_entriesShift;
+        const size_t oldMask = m_entriesMask;
+        const uint64_t oldValueMask = m_valueMask;
+
+        setBits(newBits);
+        m_data.assign((Count + m_entriesMask) >> m_entriesShift, 0);
+
+        if (oldBits == 0) {
+            return; // Every slot already refers to palette entry 0
+        }
+
+        for (size_t i = 0; i < Count; ++i) {
+            const unsigned offset = static_cast<unsigned>(i & oldMask) * static_cast<unsigned>(oldBits);
+            uint32_t old = static_cast<uint32_t>((oldData[i >> oldShift] >> offset) & oldValueMask);
+            writeIndex(i, remap.empty() ? old : remap[old]);
+        }
+    }
+
+    std::vector<T> m_palette;
+    std::vector<uint64_t> m_data;
+    int m_bits{0};
+    size_t m_entriesShift{0};
+    size_t m_entriesMask{0};
+    uint64_t m_valueMask{0};
+};
+
+} // namespace clonemine
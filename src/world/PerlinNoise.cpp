@@ -0,0 +1,279 @@
+#include "PerlinNoise.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CLONEMINE_NOISE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define CLONEMINE_TARGET(isa)
+#else
+#define CLONEMINE_TARGET(isa) __attribute__((target(isa)))
+#endif
+#endif
+
+namespace clonemine {
+
+namespace {
+    // Scalar reference: the SIMD kernels below mirror these expressions
+    // operation for operation
+    inline float fade(float t) {
+        return t * t * t * (t * (t * 6 - 15) + 10);
+    }
+
+    inline float lerp(float t, float a, float b) {
+        return a + t * (b - a);
+    }
+
+    inline float grad(int hash, float x, float y) {
+        int h = hash & 15;
+        float u = h < 8 ? x : y;
+        float v = h < 4 ? y : (h == 12 || h == 14 ? x : 0);
+        return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+    }
+
+#ifdef CLONEMINE_NOISE_X86
+    // ---- SSE4.1 (4 lanes) ----
+
+    CLONEMINE_TARGET("sse4.1")
+    inline __m128i gather4(const int* table, __m128i indices) {
+        alignas(16) int idx[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(idx), indices);
+        return _mm_setr_epi32(table[idx[0]], table[idx[1]], table[idx[2]], table[idx[3]]);
+    }
+
+    CLONEMINE_TARGET("sse4.1")
+    inline __m128 fade4(__m128 t) {
+        __m128 inner = _mm_add_ps(_mm_mul_ps(t, _mm_sub_ps(_mm_mul_ps(t, _mm_set1_ps(6.0f)), _mm_set1_ps(15.0f))),
+                                  _mm_set1_ps(10.0f));
+        return _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(t, t), t), inner);
+    }
+
+    CLONEMINE_TARGET("sse4.1")
+    inline __m128 lerp4(__m128 t, __m128 a, __m128 b) {
+        return _mm_add_ps(a, _mm_mul_ps(t, _mm_sub_ps(b, a)));
+    }
+
+    CLONEMINE_TARGET("sse4.1")
+    inline __m128 grad4(__m128i hash, __m128 x, __m128 y) {
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128i h = _mm_and_si128(hash, _mm_set1_epi32(15));
+
+        __m128 useX = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(8)));
+        __m128 u = _mm_blendv_ps(y, x, useX);
+
+        __m128 vUseY = _mm_castsi128_ps(_mm_cmplt_epi32(h, _mm_set1_epi32(4)));
+        __m128 vUseX = _mm_castsi128_ps(_mm_or_si128(_mm_cmpeq_epi32(h, _mm_set1_epi32(12)),
+                                                     _mm_cmpeq_epi32(h, _mm_set1_epi32(14))));
+        __m128 v = _mm_blendv_ps(_mm_and_ps(vUseX, x), y, vUseY);
+
+        __m128 negU = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(1)), 31));
+        __m128 negV = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(h, _mm_set1_epi32(2)), 30));
+        u = _mm_xor_ps(u, _mm_and_ps(negU, signMask));
+        v = _mm_xor_ps(v, _mm_and_ps(negV, signMask));
+        return _mm_add_ps(u, v);
+    }
+
+    CLONEMINE_TARGET("sse4.1")
+    void perlinSSE41(const int* perm, const float* xs, const float* ys, float scale, float* out, size_t count) {
+        const __m128 scaleV = _mm_set1_ps(scale);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128i mask255 = _mm_set1_epi32(255);
+        const __m128i oneI = _mm_set1_epi32(1);
+
+        for (size_t i = 0; i < count; i += 4) {
+            __m128 x = _mm_mul_ps(_mm_loadu_ps(xs + i), scaleV);
+            __m128 y = _mm_mul_ps(_mm_loadu_ps(ys + i), scaleV);
+            __m128 fx = _mm_floor_ps(x);
+            __m128 fy = _mm_floor_ps(y);
+            __m128i X = _mm_and_si128(_mm_cvttps_epi32(fx), mask255);
+            __m128i Y = _mm_and_si128(_mm_cvttps_epi32(fy), mask255);
+            x = _mm_sub_ps(x, fx);
+            y = _mm_sub_ps(y, fy);
+
+            __m128 u = fade4(x);
+            __m128 v = fade4(y);
+
+            __m128i A = _mm_add_epi32(gather4(perm, X), Y);
+            __m128i AA = gather4(perm, A);
+            __m128i AB = gather4(perm, _mm_add_epi32(A, oneI));
+            __m128i B = _mm_add_epi32(gather4(perm, _mm_add_epi32(X, oneI)), Y);
+            __m128i BA = gather4(perm, B);
+            __m128i BB = gather4(perm, _mm_add_epi32(B, oneI));
+
+            __m128 x1 = _mm_sub_ps(x, one);
+            __m128 y1 = _mm_sub_ps(y, one);
+            __m128 result = lerp4(v,
+                lerp4(u, grad4(gather4(perm, AA), x, y),
+                         grad4(gather4(perm, BA), x1, y)),
+                lerp4(u, grad4(gather4(perm, AB), x, y1),
+                         grad4(gather4(perm, BB), x1, y1)));
+            _mm_storeu_ps(out + i, result);
+        }
+    }
+
+    // ---- AVX2 (8 lanes, hardware gathers) ----
+
+    CLONEMINE_TARGET("avx2")
+    inline __m256i gather8(const int* table, __m256i indices) {
+        return _mm256_i32gather_epi32(table, indices, 4);
+    }
+
+    CLONEMINE_TARGET("avx2")
+    inline __m256 fade8(__m256 t) {
+        __m256 inner = _mm256_add_ps(_mm256_mul_ps(t, _mm256_sub_ps(_mm256_mul_ps(t, _mm256_set1_ps(6.0f)),
+                                                                   _mm256_set1_ps(15.0f))),
+                                     _mm256_set1_ps(10.0f));
+        return _mm256_mul_ps(_mm256_mul_ps(_mm256_mul_ps(t, t), t), inner);
+    }
+
+    CLONEMINE_TARGET("avx2")
+    inline __m256 lerp8(__m256 t, __m256 a, __m256 b) {
+        return _mm256_add_ps(a, _mm256_mul_ps(t, _mm256_sub_ps(b, a)));
+    }
+
+    CLONEMINE_TARGET("avx2")
+    inline __m256 grad8(__m256i hash, __m256 x, __m256 y) {
+        const __m256 signMask = _mm256_set1_ps(-0.0f);
+        __m256i h = _mm256_and_si256(hash, _mm256_set1_epi32(15));
+
+        __m256 useX = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(8), h));
+        __m256 u = _mm256_blendv_ps(y, x, useX);
+
+        __m256 vUseY = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_set1_epi32(4), h));
+        __m256 vUseX = _mm256_castsi256_ps(_mm256_or_si256(_mm256_cmpeq_epi32(h, _mm256_set1_epi32(12)),
+                                                           _mm256_cmpeq_epi32(h, _mm256_set1_epi32(14))));
+        __m256 v = _mm256_blendv_ps(_mm256_and_ps(vUseX, x), y, vUseY);
+
+        __m256 negU = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(1)), 31));
+        __m256 negV = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(h, _mm256_set1_epi32(2)), 30));
+        u = _mm256_xor_ps(u, _mm256_and_ps(negU, signMask));
+        v = _mm256_xor_ps(v, _mm256_and_ps(negV, signMask));
+        return _mm256_add_ps(u, v);
+    }
+
+    CLONEMINE_TARGET("avx2")
+    void perlinAVX2(const int* perm, const float* xs, const float* ys, float scale, float* out, size_t count) {
+        const __m256 scaleV = _mm256_set1_ps(scale);
+        const __m256 one = _mm256_set1_ps(1.0f);
+        const __m256i mask255 = _mm256_set1_epi32(255);
+        const __m256i oneI = _mm256_set1_epi32(1);
+
+        for (size_t i = 0; i < count; i += 8) {
+            __m256 x = _mm256_mul_ps(_mm256_loadu_ps(xs + i), scaleV);
+            __m256 y = _mm256_mul_ps(_mm256_loadu_ps(ys + i), scaleV);
+            __m256 fx = _mm256_floor_ps(x);
+            __m256 fy = _mm256_floor_ps(y);
+            __m256i X = _mm256_and_si256(_mm256_cvttps_epi32(fx), mask255);
+            __m256i Y = _mm256_and_si256(_mm256_cvttps_epi32(fy), mask255);
+            x = _mm256_sub_ps(x, fx);
+            y = _mm256_sub_ps(y, fy);
+
+            __m256 u = fade8(x);
+            __m256 v = fade8(y);
+
+            __m256i A = _mm256_add_epi32(gather8(perm, X), Y);
+            __m256i AA = gather8(perm, A);
+            __m256i AB = gather8(perm, _mm256_add_epi32(A, oneI));
+            __m256i B = _mm256_add_epi32(gather8(perm, _mm256_add_epi32(X, oneI)), Y);
+            __m256i BA = gather8(perm, B);
+            __m256i BB = gather8(perm, _mm256_add_epi32(B, oneI));
+
+            __m256 x1 = _mm256_sub_ps(x, one);
+            __m256 y1 = _mm256_sub_ps(y, one);
+            __m256 result = lerp8(v,
+                lerp8(u, grad8(gather8(perm, AA), x, y),
+                         grad8(gather8(perm, BA), x1, y)),
+                lerp8(u, grad8(gather8(perm, AB), x, y1),
+                         grad8(gather8(perm, BB), x1, y1)));
+            _mm256_storeu_ps(out + i, result);
+        }
+    }
+#endif
+}
+
+SimdLevel detectSimdLevel() {
+#ifdef CLONEMINE_NOISE_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int maxLeaf = info[0];
+    __cpuid(info, 1);
+    const bool sse41 = (info[2] & (1 << 19)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    bool avx2 = false;
+    if (maxLeaf >= 7 && osxsave && avx && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        avx2 = (info[1] & (1 << 5)) != 0;
+    }
+    if (avx2) return SimdLevel::AVX2;
+    if (sse41) return SimdLevel::SSE41;
+#else
+    if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+    if (__builtin_cpu_supports("sse4.1")) return SimdLevel::SSE41;
+#endif
+#endif
+    return SimdLevel::Scalar;
+}
+
+const char* getSimdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::SSE41: return "SSE4.1";
+        default: return "Scalar";
+    }
+}
+
+float perlinNoise(const int* permutation, float x, float y, float scale) {
+    x *= scale;
+    y *= scale;
+
+    int X = static_cast<int>(std::floor(x)) & 255;
+    int Y = static_cast<int>(std::floor(y)) & 255;
+
+    x -= std::floor(x);
+    y -= std::floor(y);
+
+    float u = fade(x);
+    float v = fade(y);
+
+    int A = permutation[X] + Y;
+    int AA = permutation[A];
+    int AB = permutation[A + 1];
+    int B = permutation[X + 1] + Y;
+    int BA = permutation[B];
+    int BB = permutation[B + 1];
+
+    return lerp(v,
+        lerp(u, grad(permutation[AA], x, y),
+                grad(permutation[BA], x - 1, y)),
+        lerp(u, grad(permutation[AB], x, y - 1),
+                grad(permutation[BB], x - 1, y - 1)));
+}
+
+void perlinNoiseBatch(SimdLevel level, const int* permutation,
+                      const float* xs, const float* ys, float scale,
+                      float* out, size_t count) {
+    static const SimdLevel supported = detectSimdLevel();
+    level = std::min(level, supported);
+
+    size_t done = 0;
+#ifdef CLONEMINE_NOISE_X86
+    if (level == SimdLevel::AVX2) {
+        done = count & ~size_t{7};
+        perlinAVX2(permutation, xs, ys, scale, out, done);
+    } else if (level == SimdLevel::SSE41) {
+        done = count & ~size_t{3};
+        perlinSSE41(permutation, xs, ys, scale, out, done);
+    }
+#endif
+
+    // Scalar path and any tail that does not fill a vector
+    for (size_t i = done; i < count; ++i) {
+        out[i] = perlinNoise(permutation, xs[i], ys[i], scale);
+    }
+}
+
+} // namespace clonemine
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+namespace clonemine {
+
+// Instruction set used by the batched noise kernels
+enum class SimdLevel {
+    Scalar,
+    SSE41,
+    AVX2
+};
+
+// Best level supported by the running CPU (Scalar off x86)
+SimdLevel detectSimdLevel();
+const char* getSimdLevelName(SimdLevel level);
+
+// 2D Perlin noise over a 512-entry (256 duplicated) permutation table.
+// Every level performs the same float operations in the same order (no FMA),
+// so batched results are bit-for-bit identical to perlinNoise().
+float perlinNoise(const int* permutation, float x, float y, float scale);
+
+// out[i] = perlinNoise(permutation, xs[i], ys[i], scale) for i < count.
+// Levels above detectSimdLevel() fall back to the best supported one.
+void perlinNoiseBatch(SimdLevel level, const int* permutation,
+                      const float* xs, const float* ys, float scale,
+                      float* out, size_t count);
+
+} // namespace clonemine
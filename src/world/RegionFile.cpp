@@ -0,0 +1,473 @@
+#include "RegionFile.h"
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CLONEMINE_REGION_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef CLONEMINE_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef CLONEMINE_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+namespace clonemine {
+
+namespace {
+    constexpr char REGION_MAGIC[4] = {'C', 'M', 'R', 'G'};
+
+    // CRC-32 (IEEE), table driven
+    uint32_t crc32(const uint8_t* data, size_t size) {
+        static const auto table = []() {
+            std::array<uint32_t, 256> t{};
+            for (uint32_t i = 0; i < 256; ++i) {
+                uint32_t c = i;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                t[i] = c;
+            }
+            return t;
+        }();
+
+        uint32_t crc = 0xFFFFFFFFu;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    // Returns false if the codec is unavailable or does not shrink the data
+    bool compressPayload(RegionCompression compression, const std::vector<uint8_t>& raw,
+                         std::vector<uint8_t>& stored) {
+        switch (compression) {
+#ifdef CLONEMINE_HAVE_ZLIB
+            case RegionCompression::Zlib: {
+                uLongf size = compressBound(static_cast<uLong>(raw.size()));
+                stored.resize(size);
+                if (compress2(stored.data(), &size, raw.data(), static_cast<uLong>(raw.size()),
+                              Z_DEFAULT_COMPRESSION) != Z_OK) {
+                    return false;
+                }
+                stored.resize(size);
+                return size < raw.size();
+            }
+#endif
+#ifdef CLONEMINE_HAVE_LZ4
+            case RegionCompression::LZ4: {
+                int bound = LZ4_compressBound(static_cast<int>(raw.size()));
+                stored.resize(static_cast<size_t>(bound));
+                int size = LZ4_compress_default(reinterpret_cast<const char*>(raw.data()),
+                                                reinterpret_cast<char*>(stored.data()),
+                                                static_cast<int>(raw.size()), bound);
+                if (size <= 0) {
+                    return false;
+                }
+                stored.resize(static_cast<size_t>(size));
+                return stored.size() < raw.size();
+            }
+#endif
+            default:
+                (void)raw;
+                (void)stored;
+                return false;
+        }
+    }
+
+    bool decompressPayload(RegionCompression compression, const std::vector<uint8_t>& stored,
+                           uint32_t rawSize, std::vector<uint8_t>& out) {
+        switch (compression) {
+            case RegionCompression::None:
+                out = stored;
+                return out.size() == rawSize;
+#ifdef CLONEMINE_HAVE_ZLIB
+            case RegionCompression::Zlib: {
+                out.resize(rawSize);
+                uLongf size = rawSize;
+                return uncompress(out.data(), &size, stored.data(), static_cast<uLong>(stored.size())) == Z_OK &&
+                       size == rawSize;
+            }
+#endif
+#ifdef CLONEMINE_HAVE_LZ4
+            case RegionCompression::LZ4: {
+                out.resize(rawSize);
+                int size = LZ4_decompress_safe(reinterpret_cast<const char*>(stored.data()),
+                                               reinterpret_cast<char*>(out.data()),
+                                               static_cast<int>(stored.size()), static_cast<int>(rawSize));
+                return size == static_cast<int>(rawSize);
+            }
+#endif
+            default:
+                return false;
+        }
+    }
+}
+
+RegionCompression getDefaultRegionCompression() {
+#if defined(CLONEMINE_HAVE_LZ4)
+    return RegionCompression::LZ4;
+#elif defined(CLONEMINE_HAVE_ZLIB)
+    return RegionCompression::Zlib;
+#else
+    return RegionCompression::None;
+#endif
+}
+
+bool isRegionCompressionAvailable(RegionCompression compression) {
+    switch (compression) {
+        case RegionCompression::None:
+            return true;
+#ifdef CLONEMINE_HAVE_ZLIB
+        case RegionCompression::Zlib:
+            return true;
+#endif
+#ifdef CLONEMINE_HAVE_LZ4
+        case RegionCompression::LZ4:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+// RegionFile implementation
+RegionFile::RegionFile(const std::string& path, RegionCompression compression)
+    : m_path(path)
+    , m_compression(isRegionCompressionAvailable(compression) ? compression : RegionCompression::None)
+{
+    open();
+}
+
+RegionFile::~RegionFile() {
+    close();
+}
+
+void RegionFile::open() {
+    if (!std::filesystem::exists(m_path) || std::filesystem::file_size(m_path) == 0) {
+        createEmpty();
+    }
+
+    m_file.open(m_path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!m_file) {
+        throw std::runtime_error("Failed to open region file: " + m_path);
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    m_file.read(magic, sizeof(magic));
+    m_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    m_file.read(reinterpret_cast<char*>(m_entries.data()), sizeof(Entry) * CHUNKS_PER_REGION);
+    if (!m_file || std::memcmp(magic, REGION_MAGIC, sizeof(magic)) != 0 || version != VERSION) {
+        throw std::runtime_error("Invalid region file header: " + m_path);
+    }
+
+    m_file.seekg(0, std::ios::end);
+    m_fileSize = static_cast<uint64_t>(m_file.tellg());
+
+#ifdef CLONEMINE_REGION_MMAP
+    m_mapFd = ::open(m_path.c_str(), O_RDONLY);
+#endif
+}
+
+void RegionFile::close() {
+    unmap();
+#ifdef CLONEMINE_REGION_MMAP
+    if (m_mapFd >= 0) {
+        ::close(m_mapFd);
+        m_mapFd = -1;
+    }
+#endif
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+void RegionFile::createEmpty() {
+    std::ofstream file(m_path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Failed to create region file: " + m_path);
+    }
+
+    std::vector<char> header(DATA_OFFSET, 0);
+    std::memcpy(header.data(), REGION_MAGIC, sizeof(REGION_MAGIC));
+    std::memcpy(header.data() + sizeof(REGION_MAGIC), &VERSION, sizeof(VERSION));
+    file.write(header.data(), static_cast<std::streamsize>(header.size()));
+}
+
+void RegionFile::unmap() {
+#ifdef CLONEMINE_REGION_MMAP
+    if (m_map) {
+        munmap(m_map, m_mapSize);
+        m_map = nullptr;
+        m_mapSize = 0;
+    }
+#endif
+}
+
+bool RegionFile::ensureMapped(uint64_t end) {
+#ifdef CLONEMINE_REGION_MMAP
+    if (m_map && end <= m_mapSize) {
+        return true;
+    }
+    unmap();
+    if (m_mapFd < 0 || m_fileSize == 0) {
+        return false;
+    }
+
+    void* map = mmap(nullptr, static_cast<size_t>(m_fileSize), PROT_READ, MAP_SHARED, m_mapFd, 0);
+    if (map == MAP_FAILED) {
+        return false;
+    }
+    m_map = map;
+    m_mapSize = static_cast<size_t>(m_fileSize);
+    return end <= m_mapSize;
+#else
+    (void)end;
+    return false;
+#endif
+}
+
+bool RegionFile::hasChunk(int localX, int localZ) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries[entryIndex(localX, localZ)].storedSize != 0;
+}
+
+bool RegionFile::readPayload(const Entry& entry, std::vector<uint8_t>& stored) {
+    uint64_t end = entry.offset + entry.storedSize;
+    if (entry.offset < DATA_OFFSET || end > m_fileSize) {
+        return false;
+    }
+
+    stored.resize(entry.storedSize);
+    if (ensureMapped(end)) {
+        std::memcpy(stored.data(), static_cast<const uint8_t*>(m_map) + entry.offset, entry.storedSize);
+        return true;
+    }
+
+    // No mapping available: fall back to a stream read
+    m_file.seekg(static_cast<std::streamoff>(entry.offset));
+    m_file.read(reinterpret_cast<char*>(stored.data()), entry.storedSize);
+    return static_cast<bool>(m_file);
+}
+
+bool RegionFile::readChunk(int localX, int localZ, std::vector<uint8_t>& out) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const Entry& entry = m_entries[entryIndex(localX, localZ)];
+    if (entry.storedSize == 0) {
+        return false;
+    }
+
+    std::vector<uint8_t> stored;
+    if (!readPayload(entry, stored)) {
+        std::cerr << "Region " << m_path << ": chunk (" << localX << ", " << localZ << ") out of bounds" << std::endl;
+        return false;
+    }
+    if (crc32(stored.data(), stored.size()) != entry.crc) {
+        std::cerr << "Region " << m_path << ": CRC mismatch for chunk (" << localX << ", " << localZ << ")" << std::endl;
+        return false;
+    }
+    if (!decompressPayload(static_cast<RegionCompression>(entry.compression), stored, entry.rawSize, out)) {
+        std::cerr << "Region " << m_path << ": cannot decompress chunk (" << localX << ", " << localZ << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RegionFile::writeChunk(int localX, int localZ, const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> compressed;
+    bool useCompressed = compressPayload(m_compression, data, compressed);
+    const std::vector<uint8_t>& stored = useCompressed ? compressed : data;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Append the payload first; the table entry is only updated afterwards
+    Entry entry{};
+    entry.offset = m_fileSize;
+    entry.storedSize = static_cast<uint32_t>(stored.size());
+    entry.rawSize = static_cast<uint32_t>(data.size());
+    entry.crc = crc32(stored.data(), stored.size());
+    entry.compression = static_cast<uint8_t>(useCompressed ? m_compression : RegionCompression::None);
+
+    m_file.seekp(static_cast<std::streamoff>(entry.offset));
+    m_file.write(reinterpret_cast<const char*>(stored.data()), static_cast<std::streamsize>(stored.size()));
+    m_file.flush();
+    if (!m_file) {
+        // Any partial payload is overwritten by the next append
+        std::cerr << "Region " << m_path << ": failed to write chunk (" << localX << ", " << localZ << ")" << std::endl;
+        m_file.clear();
+        return false;
+    }
+    m_fileSize += stored.size();
+
+    int index = entryIndex(localX, localZ);
+    Entry previous = m_entries[index];
+    m_entries[index] = entry;
+    writeEntry(index);
+    m_file.flush();
+    if (!m_file) {
+        std::cerr << "Region " << m_path << ": failed to update table for chunk (" << localX << ", " << localZ << ")" << std::endl;
+        m_file.clear();
+        m_entries[index] = previous;
+        return false;
+    }
+    return true;
+}
+
+void RegionFile::writeEntry(int index) {
+    m_file.seekp(static_cast<std::streamoff>(TABLE_OFFSET + sizeof(Entry) * index));
+    m_file.write(reinterpret_cast<const char*>(&m_entries[index]), sizeof(Entry));
+}
+
+uint64_t RegionFile::getFileSize() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_fileSize;
+}
+
+uint64_t RegionFile::getLiveBytes() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t live = 0;
+    for (const auto& entry : m_entries) {
+        live += entry.storedSize;
+    }
+    return live;
+}
+
+size_t RegionFile::getChunkCount() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t count = 0;
+    for (const auto& entry : m_entries) {
+        count += entry.storedSize != 0 ? 1 : 0;
+    }
+    return count;
+}
+
+bool RegionFile::needsCompaction() const {
+    uint64_t live = getLiveBytes();
+    uint64_t dead = getFileSize() - DATA_OFFSET - live;
+    return dead > MIN_COMPACTION_BYTES && dead > live;
+}
+
+void RegionFile::compact() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Copy live payloads as stored (no recompression) into a fresh file
+    std::string tempPath = m_path + ".tmp";
+    std::array<Entry, CHUNKS_PER_REGION> entries = m_entries;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Failed to create region file: " + tempPath);
+        }
+
+        std::vector<char> header(DATA_OFFSET, 0);
+        out.write(header.data(), static_cast<std::streamsize>(header.size()));
+
+        uint64_t offset = DATA_OFFSET;
+        std::vector<uint8_t> stored;
+        for (auto& entry : entries) {
+            if (entry.storedSize == 0) {
+                continue;
+            }
+            if (!readPayload(entry, stored)) {
+                entry = Entry{}; // Drop unreadable chunks rather than copy garbage
+                continue;
+            }
+            out.write(reinterpret_cast<const char*>(stored.data()), static_cast<std::streamsize>(stored.size()));
+            entry.offset = offset;
+            offset += stored.size();
+        }
+
+        out.seekp(0);
+        out.write(REGION_MAGIC, sizeof(REGION_MAGIC));
+        out.write(reinterpret_cast<const char*>(&VERSION), sizeof(VERSION));
+        out.write(reinterpret_cast<const char*>(entries.data()), sizeof(Entry) * CHUNKS_PER_REGION);
+        out.flush();
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tempPath);
+            throw std::runtime_error("Failed to write region file: " + tempPath);
+        }
+    }
+
+    close();
+    std::error_code error;
+    std::filesystem::rename(tempPath, m_path, error);
+    open(); // The compacted file, or the original if the rename failed
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        throw std::runtime_error("Failed to replace region file: " + m_path);
+    }
+}
+
+// RegionStorage implementation
+RegionStorage::RegionStorage(const std::string& directory, RegionCompression compression)
+    : m_directory(directory)
+    , m_compression(compression)
+{
+    std::filesystem::create_directories(m_directory);
+}
+
+std::string RegionStorage::getRegionPath(const std::string& directory, int regionX, int regionZ) {
+    return directory + "/r." + std::to_string(regionX) + "." + std::to_string(regionZ) + ".cmr";
+}
+
+RegionFile* RegionStorage::getRegion(int chunkX, int chunkZ, bool create) {
+    // Arithmetic shift floors negative coordinates into the right region
+    int regionX = chunkX >> 5;
+    int regionZ = chunkZ >> 5;
+    uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(regionX)) << 32) | static_cast<uint32_t>(regionZ);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_regions.find(key);
+    if (it != m_regions.end()) {
+        return it->second.get();
+    }
+
+    std::string path = getRegionPath(m_directory, regionX, regionZ);
+    if (!create && !std::filesystem::exists(path)) {
+        return nullptr;
+    }
+
+    auto region = std::make_unique<RegionFile>(path, m_compression);
+    RegionFile* result = region.get();
+    m_regions[key] = std::move(region);
+    return result;
+}
+
+bool RegionStorage::loadChunk(int chunkX, int chunkZ, std::vector<uint8_t>& out) {
+    RegionFile* region = getRegion(chunkX, chunkZ, false);
+    return region && region->readChunk(chunkX & (RegionFile::REGION_SIZE - 1),
+                                       chunkZ & (RegionFile::REGION_SIZE - 1), out);
+}
+
+bool RegionStorage::saveChunk(int chunkX, int chunkZ, const std::vector<uint8_t>& data) {
+    RegionFile* region = getRegion(chunkX, chunkZ, true);
+    return region->writeChunk(chunkX & (RegionFile::REGION_SIZE - 1),
+                       chunkZ & (RegionFile::REGION_SIZE - 1), data);
+}
+
+size_t RegionStorage::compact(bool force) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    size_t compacted = 0;
+    for (auto& [key, region] : m_regions) {
+        if (!force && !region->needsCompaction()) {
+            continue;
+        }
+        try {
+            region->compact();
+            compacted++;
+        } catch (const std::exception& e) {
+            std::cerr << "Region compaction failed: " << e.what() << std::endl;
+        }
+    }
+    return compacted;
+}
+
+} // namespace clonemine
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace clonemine {
+
+// Per-chunk payload compression. Values are stored on disk.
+enum class RegionCompression : uint8_t {
+    None = 0,
+    Zlib = 1,
+    LZ4 = 2
+};
+
+// Best compression compiled in (LZ4, then zlib, then none)
+RegionCompression getDefaultRegionCompression();
+bool isRegionCompressionAvailable(RegionCompression compression);
+
+// One 32x32-chunk region file.
+//
+// Layout: an 8-byte header ("CMRG" + version) followed by a fixed table of
+// 1024 entries (offset, stored size, raw size, CRC32, compression), then
+// chunk payloads. Writes append a new payload and then rewrite the table
+// entry, so a crash mid-write leaves the previous copy valid. Superseded
+// payloads become dead space until compact() rewrites the file.
+// On POSIX systems reads go through a read-only memory map.
+class RegionFile {
+public:
+    static constexpr int REGION_SIZE = 32;
+    static constexpr int CHUNKS_PER_REGION = REGION_SIZE * REGION_SIZE;
+    static constexpr uint32_t VERSION = 1;
+
+    // Opens or creates the file; throws std::runtime_error on failure
+    RegionFile(const std::string& path, RegionCompression compression);
+    ~RegionFile();
+
+    RegionFile(const RegionFile&) = delete;
+    RegionFile& operator=(const RegionFile&) = delete;
+
+    // Local chunk coordinates are in [0, REGION_SIZE)
+    bool hasChunk(int localX, int localZ) const;
+
+    // Decompress into out; false if missing, corrupt or CRC mismatch
+    bool readChunk(int localX, int localZ, std::vector<uint8_t>& out);
+    // False if the write failed; the previous copy stays current
+    bool writeChunk(int localX, int localZ, const std::vector<uint8_t>& data);
+
+    // Compaction is worthwhile once dead space outweighs live data
+    // compact() throws std::runtime_error and leaves the old file in use
+    bool needsCompaction() const;
+    void compact();
+
+    uint64_t getFileSize() const;
+    uint64_t getLiveBytes() const;
+    size_t getChunkCount() const;
+
+private:
+    struct Entry {
+        uint64_t offset;
+        uint32_t storedSize;
+        uint32_t rawSize;
+        uint32_t crc;
+        uint8_t compression;
+        uint8_t reserved[3];
+    };
+    static_assert(sizeof(Entry) == 24, "Region table entry layout changed");
+
+    static constexpr size_t HEADER_SIZE = 8;
+    static constexpr size_t TABLE_OFFSET = HEADER_SIZE;
+    static constexpr size_t DATA_OFFSET = TABLE_OFFSET + sizeof(Entry) * CHUNKS_PER_REGION;
+    static constexpr uint64_t MIN_COMPACTION_BYTES = 1024 * 1024;
+
+    static int entryIndex(int localX, int localZ) { return localX + localZ * REGION_SIZE; }
+
+    void open();
+    void close();
+    void createEmpty();
+    void writeEntry(int index);
+    bool readPayload(const Entry& entry, std::vector<uint8_t>& stored);
+
+    // Read-only mapping, refreshed when the file grows past it
+    void unmap();
+    bool ensureMapped(uint64_t end);
+
+    std::string m_path;
+    RegionCompression m_compression;
+    std::fstream m_file;
+    std::array<Entry, CHUNKS_PER_REGION> m_entries{};
+    uint64_t m_fileSize = 0;
+
+    int m_mapFd = -1;
+    void* m_map = nullptr;
+    size_t m_mapSize = 0;
+
+    mutable std::mutex m_mutex;
+};
+
+// Region files for one save directory, opened on demand.
+// Chunk positions are chunk coordinates (x/z); y is ignored.
+class RegionStorage {
+public:
+    explicit RegionStorage(const std::string& directory,
+                           RegionCompression compression = getDefaultRegionCompression());
+
+    RegionStorage(const RegionStorage&) = delete;
+    RegionStorage& operator=(const RegionStorage&) = delete;
+
+    bool loadChunk(int chunkX, int chunkZ, std::vector<uint8_t>& out);
+    bool saveChunk(int chunkX, int chunkZ, const std::vector<uint8_t>& data);
+
+    // Compact every open region that has accumulated enough dead space
+    // (or all of them when forced); returns the number compacted. Regions
+    // that fail are logged and skipped. Blocks writes while it runs.
+    size_t compact(bool force = false);
+
+    const std::string& getDirectory() const { return m_directory; }
+    static std::string getRegionPath(const std::string& directory, int regionX, int regionZ);
+
+private:
+    RegionFile* getRegion(int chunkX, int chunkZ, bool create);
+
+    std::string m_directory;
+    RegionCompression m_compression;
+    std::mutex m_mutex;
+    std::unordered_map<uint64_t, std::unique_ptr<RegionFile>> m_regions;
+};
+
+} // namespace clonemine
@@ -4,7 +4,17 @@
 
 namespace clonemine {
 
-TerrainGenerator::TerrainGenerator(uint32_t seed) : m_seed(seed) {
+namespace {
+    // Mountain noise is squared (keeping its sign) to sharpen peaks
+    inline float amplifyPeaks(float noise) {
+        return noise * noise * (noise > 0.0f ? 1.0f : -1.0f);
+    }
+}
+
+TerrainGenerator::TerrainGenerator(uint32_t seed)
+    : m_seed(seed)
+    , m_simdLevel(detectSimdLevel())
+{
     // Initialize permutation table for Perlin noise
     m_permutation.resize(512);
     for (int i = 0; i < 256; i++) {
@@ -22,11 +32,10 @@ TerrainGenerator::TerrainGenerator(uint32_t seed) : m_seed(seed) {
 }
 
 float TerrainGenerator::getHeight(float x, float z) const {
-    float continental = continentalNoise(x, z);
-    float mountain = mountainNoise(x, z);
-    float hill = hillNoise(x, z);
-    float detail = detailNoise(x, z);
-    
+    return combineHeight(continentalNoise(x, z), mountainNoise(x, z), hillNoise(x, z), detailNoise(x, z));
+}
+
+float TerrainGenerator::combineHeight(float continental, float mountain, float hill, float detail) {
     // Combine layers with weights
     float height = SEA_LEVEL;
     height += continental * 30.0f;  // Continental variation
@@ -38,10 +47,12 @@ float TerrainGenerator::getHeight(float x, float z) const {
 }
 
 Biome TerrainGenerator::getBiome(float x, float z) const {
-    float temperature = perlin(x, z, 0.0005f);
-    float moisture = perlin(x + 1000.0f, z + 1000.0f, 0.0005f);
-    float height = getHeight(x, z);
-    
+    float temperature = perlin(x, z, TEMPERATURE_SCALE);
+    float moisture = perlin(x + MOISTURE_OFFSET, z + MOISTURE_OFFSET, TEMPERATURE_SCALE);
+    return classifyBiome(temperature, moisture, getHeight(x, z));
+}
+
+Biome TerrainGenerator::classifyBiome(float temperature, float moisture, float height) {
     // Underground biome
     if (height < SEA_LEVEL) {
         return Biome::UNDERGROUND;
@@ -80,51 +91,154 @@ uint8_t TerrainGenerator::getBlockType(int x, int y, int z) const {
     float height = getHeight(static_cast<float>(x), static_cast<float>(z));
     Biome biome = getBiome(static_cast<float>(x), static_cast<float>(z));
     
+    if (auto block = columnBlock(y, height, biome)) {
+        return *block;
+    }
+    return stoneBlock(y, perlin(static_cast<float>(x), static_cast<float>(y * 10), ORE_SCALE));
+}
+
+uint8_t TerrainGenerator::getBlockType(const TerrainColumns& columns, int localX, int y, int localZ) const {
+    if (auto block = columnBlock(y, columns.getHeight(localX, localZ), columns.getBiome(localX, localZ))) {
+        return *block;
+    }
+    return stoneBlock(y, columns.getOreChance(localX, y));
+}
+
+void TerrainGenerator::generateColumns(int chunkX, int chunkZ, TerrainColumns& columns) const {
+    constexpr int SIZE = TerrainColumns::SIZE;
+    constexpr int AREA = SIZE * SIZE;
+    constexpr int ORE_COUNT = TerrainColumns::HEIGHT * SIZE;
+    
+    columns.originX = chunkX * SIZE;
+    columns.originZ = chunkZ * SIZE;
+    
+    // Sample coordinates for the 16x16 footprint
+    alignas(32) float xs[AREA];
+    alignas(32) float zs[AREA];
+    alignas(32) float moistureXs[AREA];
+    alignas(32) float moistureZs[AREA];
+    for (int z = 0; z < SIZE; ++z) {
+        for (int x = 0; x < SIZE; ++x) {
+            int i = z * SIZE + x;
+            xs[i] = static_cast<float>(columns.originX + x);
+            zs[i] = static_cast<float>(columns.originZ + z);
+            moistureXs[i] = xs[i] + MOISTURE_OFFSET;
+            moistureZs[i] = zs[i] + MOISTURE_OFFSET;
+        }
+    }
+    
+    // One batched pass per noise layer
+    const int* perm = m_permutation.data();
+    alignas(32) float continental[AREA];
+    alignas(32) float mountain[AREA];
+    alignas(32) float hill[AREA];
+    alignas(32) float detail[AREA];
+    alignas(32) float temperature[AREA];
+    alignas(32) float moisture[AREA];
+    perlinNoiseBatch(m_simdLevel, perm, xs, zs, CONTINENTAL_SCALE, continental, AREA);
+    perlinNoiseBatch(m_simdLevel, perm, xs, zs, MOUNTAIN_SCALE, mountain, AREA);
+    perlinNoiseBatch(m_simdLevel, perm, xs, zs, HILL_SCALE, hill, AREA);
+    perlinNoiseBatch(m_simdLevel, perm, xs, zs, DETAIL_SCALE, detail, AREA);
+    perlinNoiseBatch(m_simdLevel, perm, xs, zs, TEMPERATURE_SCALE, temperature, AREA);
+    perlinNoiseBatch(m_simdLevel, perm, moistureXs, moistureZs, TEMPERATURE_SCALE, moisture, AREA);
+    
+    for (int i = 0; i < AREA; ++i) {
+        columns.heights[i] = combineHeight(continental[i], amplifyPeaks(mountain[i]), hill[i], detail[i]);
+        columns.biomes[i] = classifyBiome(temperature[i], moisture[i], columns.heights[i]);
+    }
+    
+    // Ore noise samples (x, y * 10), so one row per y covers every z
+    alignas(32) float oreXs[ORE_COUNT];
+    alignas(32) float oreYs[ORE_COUNT];
+    for (int y = 0; y < TerrainColumns::HEIGHT; ++y) {
+        for (int x = 0; x < SIZE; ++x) {
+            oreXs[y * SIZE + x] = static_cast<float>(columns.originX + x);
+            oreYs[y * SIZE + x] = static_cast<float>(y * 10);
+        }
+    }
+    perlinNoiseBatch(m_simdLevel, perm, oreXs, oreYs, ORE_SCALE, columns.oreField.data(), ORE_COUNT);
+}
+
+int TerrainGenerator::fillColumn(const TerrainColumns& columns, int localX, int localZ, uint8_t* out) const {
+    constexpr int HEIGHT = TerrainColumns::HEIGHT;
+    float height = columns.getHeight(localX, localZ);
+    Biome biome = columns.getBiome(localX, localZ);
+    
+    // Air run above the surface (height is clamped to [0, MAX_HEIGHT])
+    int top = std::min(static_cast<int>(height) + 1, HEIGHT);
+    std::fill(out + top, out + HEIGHT, TerrainBlock::AIR);
+    
+    // Surface and dirt cap, walking down until the stone layer starts
+    int y = top - 1;
+    for (; y >= 0; --y) {
+        auto block = columnBlock(y, height, biome);
+        if (!block) {
+            break;
+        }
+        out[y] = *block;
+    }
+    
+    // Stone run with ores from the cached ore field; y = 0 is bedrock
+    for (; y > 0; --y) {
+        out[y] = stoneBlock(y, columns.getOreChance(localX, y));
+    }
+    if (y == 0) {
+        out[0] = TerrainBlock::BEDROCK;
+    }
+    
+    return top;
+}
+
+std::optional<uint8_t> TerrainGenerator::columnBlock(int y, float height, Biome biome) {
     // Air above surface
     if (y > height) {
-        return 0; // AIR
+        return TerrainBlock::AIR;
     }
     
     // Bedrock at bottom
     if (y == 0) {
-        return 7; // BEDROCK
+        return TerrainBlock::BEDROCK;
     }
     
     // Surface layer based on biome
     if (y == static_cast<int>(height)) {
         switch (biome) {
             case Biome::DESERT:
-                return 12; // SAND
+                return TerrainBlock::SAND;
             case Biome::FOREST:
             case Biome::PLAINS:
-                return 2; // GRASS
+                return TerrainBlock::GRASS;
             case Biome::MOUNTAINS:
-                return y > 140 ? 16 : 1; // SNOW or STONE
+                return y > 140 ? TerrainBlock::SNOW : TerrainBlock::STONE;
             case Biome::SWAMP:
-                return 3; // DIRT
+                return TerrainBlock::DIRT;
             case Biome::VOLCANIC:
-                return 10; // OBSIDIAN
+                return TerrainBlock::OBSIDIAN;
             default:
-                return 2; // GRASS
+                return TerrainBlock::GRASS;
         }
     }
     
     // Subsurface layers
     if (y > height - 4) {
-        return 3; // DIRT
+        return TerrainBlock::DIRT;
     }
     
+    // Stone layer: depends on the ore field
+    return std::nullopt;
+}
+
+uint8_t TerrainGenerator::stoneBlock(int y, float oreChance) {
     // Stone layer with ore generation
-    float oreChance = perlin(static_cast<float>(x), static_cast<float>(y * 10), 0.1f);
     if (oreChance > 0.95f && y < 32) {
-        return 14; // DIAMOND_ORE
+        return TerrainBlock::DIAMOND_ORE;
     } else if (oreChance > 0.90f && y < 64) {
-        return 15; // GOLD_ORE
+        return TerrainBlock::GOLD_ORE;
     } else if (oreChance > 0.85f) {
-        return 13; // IRON_ORE
+        return TerrainBlock::IRON_ORE;
     }
     
-    return 1; // STONE
+    return TerrainBlock::STONE;
 }
 
 bool TerrainGenerator::shouldSpawnDungeon(int x, int z) const {
@@ -174,9 +288,7 @@ float TerrainGenerator::continentalNoise(float x, float z) const {
 }
 
 float TerrainGenerator::mountainNoise(float x, float z) const {
-    float noise = perlin(x, z, MOUNTAIN_SCALE);
-    // Amplify peaks
-    return noise * noise * (noise > 0.0f ? 1.0f : -1.0f);
+    return amplifyPeaks(perlin(x, z, MOUNTAIN_SCALE));
 }
 
 float TerrainGenerator::hillNoise(float x, float z) const {
@@ -188,47 +300,7 @@ float TerrainGenerator::detailNoise(float x, float z) const {
 }
 
 float TerrainGenerator::perlin(float x, float y, float scale) const {
-    x *= scale;
-    y *= scale;
-    
-    int X = static_cast<int>(std::floor(x)) & 255;
-    int Y = static_cast<int>(std::floor(y)) & 255;
-    
-    x -= std::floor(x);
-    y -= std::floor(y);
-    
-    float u = fade(x);
-    float v = fade(y);
-    
-    int A = m_permutation[X] + Y;
-    int AA = m_permutation[A];
-    int AB = m_permutation[A + 1];
-    int B = m_permutation[X + 1] + Y;
-    int BA = m_permutation[B];
-    int BB = m_permutation[B + 1];
-    
-    float result = lerp(v,
-        lerp(u, grad(m_permutation[AA], x, y),
-                grad(m_permutation[BA], x - 1, y)),
-        lerp(u, grad(m_permutation[AB], x, y - 1),
-                grad(m_permutation[BB], x - 1, y - 1)));
-    
-    return result;
-}
-
-float TerrainGenerator::fade(float t) const {
-    return t * t * t * (t * (t * 6 - 15) + 10);
-}
-
-float TerrainGenerator::lerp(float t, float a, float b) const {
-    return a + t * (b - a);
-}
-
-float TerrainGenerator::grad(int hash, float x, float y) const {
-    int h = hash & 15;
-    float u = h < 8 ? x : y;
-    float v = h < 4 ? y : (h == 12 || h == 14 ? x : 0);
-    return ((h & 1) == 0 ? u : -u) + ((h & 2) == 0 ? v : -v);
+    return perlinNoise(m_permutation.data(), x, y, scale);
 }
 
 } // namespace clonemine
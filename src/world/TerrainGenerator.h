@@ -1,6 +1,9 @@
 #pragma once
 
+#include "PerlinNoise.h"
 #include <glm/glm.hpp>
+#include <array>
+#include <optional>
 #include <vector>
 #include <random>
 #include <memory>
@@ -17,10 +20,68 @@ enum class Biome {
     VOLCANIC
 };
 
+// Block codes produced by the generator; callers map them onto their own
+// block enum
+namespace TerrainBlock {
+    constexpr uint8_t AIR = 0;
+    constexpr uint8_t STONE = 1;
+    constexpr uint8_t GRASS = 2;
+    constexpr uint8_t DIRT = 3;
+    constexpr uint8_t BEDROCK = 7;
+    constexpr uint8_t OBSIDIAN = 10;
+    constexpr uint8_t SAND = 12;
+    constexpr uint8_t IRON_ORE = 13;
+    constexpr uint8_t DIAMOND_ORE = 14;
+    constexpr uint8_t GOLD_ORE = 15;
+    constexpr uint8_t SNOW = 16;
+    // Never generated; for callers that flood air below their sea level
+    constexpr uint8_t WATER = 17;
+}
+
+// Per-chunk noise evaluated in one batch for a 16x16 column footprint
+struct TerrainColumns {
+    static constexpr int SIZE = 16;
+    static constexpr int HEIGHT = 256;
+    
+    int originX = 0; // World coordinates of local (0, 0)
+    int originZ = 0;
+    std::array<float, SIZE * SIZE> heights{};   // [z * SIZE + x]
+    std::array<Biome, SIZE * SIZE> biomes{};    // [z * SIZE + x]
+    std::array<float, HEIGHT * SIZE> oreField{}; // [y * SIZE + x], ore noise ignores z
+    
+    float getHeight(int localX, int localZ) const { return heights[localZ * SIZE + localX]; }
+    Biome getBiome(int localX, int localZ) const { return biomes[localZ * SIZE + localX]; }
+    float getOreChance(int localX, int y) const { return oreField[y * SIZE + localX]; }
+};
+
+// Cut sectionHeight levels from baseY out of a chunk's fillColumn output
+// (column (x, z) at (z * SIZE + x) * HEIGHT) into section order, x fastest
+// then z then y, mapping codes through table. Both chunk types generate
+// through this, one bulk section load each.
+template <typename BlockT>
+void gatherTerrainSection(const uint8_t* codes, int baseY, int sectionHeight,
+                          const std::array<BlockT, 256>& table, BlockT* out) {
+    constexpr int SIZE = TerrainColumns::SIZE;
+    constexpr int HEIGHT = TerrainColumns::HEIGHT;
+    for (int y = baseY; y < baseY + sectionHeight; ++y) {
+        for (int z = 0; z < SIZE; ++z) {
+            const uint8_t* row = codes + z * SIZE * HEIGHT + y;
+            for (int x = 0; x < SIZE; ++x) {
+                *out++ = table[row[x * HEIGHT]];
+            }
+        }
+    }
+}
+
 class TerrainGenerator {
 public:
     explicit TerrainGenerator(uint32_t seed);
     
+    // Noise kernel selection (defaults to the best the CPU supports).
+    // Every level produces bit-identical terrain.
+    void setSimdLevel(SimdLevel level) { m_simdLevel = level; }
+    SimdLevel getSimdLevel() const { return m_simdLevel; }
+    
     // Generate terrain height at world position
     float getHeight(float x, float z) const;
     
@@ -30,6 +91,16 @@ public:
     // Get block type at specific position
     uint8_t getBlockType(int x, int y, int z) const;
     
+    // Batched path: evaluate heights, biomes and the ore field for a whole
+    // chunk once, then classify blocks from the cached columns
+    void generateColumns(int chunkX, int chunkZ, TerrainColumns& columns) const;
+    uint8_t getBlockType(const TerrainColumns& columns, int localX, int y, int localZ) const;
+    
+    // Write a whole column (TerrainColumns::HEIGHT codes, bottom up) as
+    // runs: air above the surface, the surface/dirt cap, then stone and
+    // ores. Returns the number of non-air blocks from y = 0.
+    int fillColumn(const TerrainColumns& columns, int localX, int localZ, uint8_t* out) const;
+    
     // Check if structure should spawn at location
     bool shouldSpawnDungeon(int x, int z) const;
     bool shouldSpawnTown(int x, int z) const;
@@ -41,14 +112,18 @@ private:
     float hillNoise(float x, float z) const;
     float detailNoise(float x, float z) const;
     
+    // Shared by the per-block and batched paths so both agree exactly
+    static float combineHeight(float continental, float mountain, float hill, float detail);
+    static Biome classifyBiome(float temperature, float moisture, float height);
+    static std::optional<uint8_t> columnBlock(int y, float height, Biome biome);
+    static uint8_t stoneBlock(int y, float oreChance);
+    
     // Perlin noise implementation
     float perlin(float x, float y, float scale) const;
-    float fade(float t) const;
-    float lerp(float t, float a, float b) const;
-    float grad(int hash, float x, float y) const;
     
     uint32_t m_seed;
     std::vector<int> m_permutation;
+    SimdLevel m_simdLevel;
     
     // Terrain parameters
     static constexpr float CONTINENTAL_SCALE = 0.0001f;
@@ -56,6 +131,10 @@ private:
     static constexpr float HILL_SCALE = 0.01f;
     static constexpr float DETAIL_SCALE = 0.1f;
     
+    static constexpr float TEMPERATURE_SCALE = 0.0005f;
+    static constexpr float ORE_SCALE = 0.1f;
+    static constexpr float MOISTURE_OFFSET = 1000.0f;
+    
     static constexpr float SEA_LEVEL = 64.0f;
     static constexpr float MAX_HEIGHT = 256.0f;
 };
@@ -3,7 +3,9 @@
 
 namespace clonemine {
 
-World::World() {
+World::World(uint32_t seed)
+    : m_terrain(seed)
+{
     generateInitialChunks();
 }
 
@@ -45,7 +47,7 @@ void World::generateInitialChunks() {
     // Generate a 4x4 grid of chunks around origin
     for (int x = -2; x < 2; ++x) {
         for (int z = -2; z < 2; ++z) {
-            auto chunk = std::make_unique<Chunk>(x, z);
+            auto chunk = std::make_unique<Chunk>(x, z, m_terrain);
             uint64_t key = chunkKey(x, z);
             m_chunkMap[key] = m_chunks.size();
             m_chunks.push_back(std::move(chunk));
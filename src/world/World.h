@@ -1,5 +1,6 @@
 #pragma once
 
+#include "world/TerrainGenerator.h"
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -12,7 +13,9 @@ enum class BlockType : uint8_t;
 
 class World {
 public:
-    World();
+    static constexpr uint32_t DEFAULT_SEED = 12345;
+
+    explicit World(uint32_t seed = DEFAULT_SEED);
     ~World() = default;
 
     // Delete copy operations
@@ -31,6 +34,7 @@ private:
     void generateInitialChunks();
     [[nodiscard]] Chunk* getChunk(int chunkX, int chunkZ) const;
 
+    TerrainGenerator m_terrain;
     std::vector<std::unique_ptr<Chunk>> m_chunks;
     std::unordered_map<uint64_t, size_t> m_chunkMap;
     
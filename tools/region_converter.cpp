@@ -0,0 +1,129 @@
+// Legacy chunk file converter
+//
+// Usage: region_converter <saveDir> [--compression none|zlib|lz4] [--delete]
+//
+// Packs every chunk_x_y_z.dat in saveDir into 32x32 region files. Payloads
+// are copied as-is (both the flat and the section-mask layouts load through
+// Chunk::deserialize). With --delete the legacy files are removed once all
+// of them converted successfully.
+
+#include "world/RegionFile.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace clonemine;
+
+namespace {
+    // Sizes mirror ChunkManager: 16x16x256 chunks of 2-byte blocks in 16-high sections
+    constexpr size_t BLOCK_SIZE = 2;
+    constexpr size_t SECTION_BYTES = 16 * 16 * 16 * BLOCK_SIZE;
+    constexpr size_t FLAT_CHUNK_BYTES = 16 * SECTION_BYTES;
+
+    bool isValidPayload(const std::vector<uint8_t>& data) {
+        if (data.size() == FLAT_CHUNK_BYTES) {
+            return true;
+        }
+        if (data.size() < 2) {
+            return false;
+        }
+        uint16_t mask = static_cast<uint16_t>(data[0] | (data[1] << 8));
+        size_t sections = 0;
+        for (int s = 0; s < 16; ++s) {
+            sections += (mask >> s) & 1u;
+        }
+        return data.size() == 2 + sections * SECTION_BYTES;
+    }
+
+    bool parseCompression(const std::string& name, RegionCompression& out) {
+        if (name == "none") out = RegionCompression::None;
+        else if (name == "zlib") out = RegionCompression::Zlib;
+        else if (name == "lz4") out = RegionCompression::LZ4;
+        else return false;
+        return isRegionCompressionAvailable(out);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <saveDir> [--compression none|zlib|lz4] [--delete]" << std::endl;
+        return 1;
+    }
+
+    std::string saveDir = argv[1];
+    RegionCompression compression = getDefaultRegionCompression();
+    bool deleteLegacy = false;
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--delete") {
+            deleteLegacy = true;
+        } else if (arg == "--compression" && i + 1 < argc) {
+            if (!parseCompression(argv[++i], compression)) {
+                std::cerr << "Unsupported compression: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else {
+            std::cerr << "Unknown argument: " << arg << std::endl;
+            return 1;
+        }
+    }
+
+    RegionStorage storage(saveDir, compression);
+    std::vector<std::filesystem::path> converted;
+    size_t failed = 0;
+    uint64_t legacyBytes = 0;
+
+    for (const auto& item : std::filesystem::directory_iterator(saveDir)) {
+        int x = 0, y = 0, z = 0;
+        std::string name = item.path().filename().string();
+        if (!item.is_regular_file() || std::sscanf(name.c_str(), "chunk_%d_%d_%d.dat", &x, &y, &z) != 3) {
+            continue;
+        }
+
+        std::ifstream file(item.path(), std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (!file.good() && !file.eof()) {
+            failed++;
+            continue;
+        }
+        if (!isValidPayload(data)) {
+            std::cerr << "Skipping malformed chunk file: " << name << std::endl;
+            failed++;
+            continue;
+        }
+
+        if (!storage.saveChunk(x, z, data)) {
+            failed++;
+            continue;
+        }
+        legacyBytes += data.size();
+        converted.push_back(item.path());
+    }
+
+    // Region files were only appended to; pack them tightly
+    storage.compact(true);
+
+    uint64_t regionBytes = 0;
+    for (const auto& item : std::filesystem::directory_iterator(saveDir)) {
+        if (item.path().extension() == ".cmr") {
+            regionBytes += item.file_size();
+        }
+    }
+
+    std::cout << "Converted " << converted.size() << " chunks (" << legacyBytes << " bytes) into "
+              << regionBytes << " bytes of region files";
+    if (failed > 0) {
+        std::cout << ", " << failed << " failed";
+    }
+    std::cout << std::endl;
+
+    if (deleteLegacy && failed == 0) {
+        for (const auto& path : converted) {
+            std::filesystem::remove(path);
+        }
+    }
+    return failed == 0 ? 0 : 2;
+}